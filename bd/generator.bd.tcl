@@ -40,7 +40,7 @@ if { [string first $scripts_vivado_version $current_vivado_version] == -1 } {
 
 # The design that will be created by this Tcl script contains the following 
 # module references:
-# mm2s_dds_modulator
+# mm2s_dds_modulator, dds_capture_combiner
 
 # Please add the sources of those modules before sourcing this Tcl script.
 
@@ -59,6 +59,42 @@ if { $list_projs eq "" } {
 variable design_name
 set design_name generator
 
+# Generator channels: mm2s_dds_modulator/dds_compiler pairs sharing the
+# capture DMA. Must match GENERATOR_NUM_CHANNELS in sw/src/generator.h.
+# Capture bandwidth is 4 bytes per sample, see dds_clk_mhz.
+variable num_channels
+set num_channels 2
+
+# DDS clock (MMCM from FCLK0): sequencer, modulators, DDS Compilers and capture
+# combiner. Registers stay on FCLK0 (125 MHz). Firmware reads it from REG_8.
+# Captures go through an async FIFO to the DMA: HP0 takes 8 bytes per FCLK0
+# clock, capturing every channel without gaps needs
+# num_channels * dds_lanes * 4 * dds_clk_mhz <= 1000, checked below. See
+# vivado/timing_sweep.tcl for the fastest clock the modulator closes at.
+variable dds_clk_mhz
+set dds_clk_mhz 125
+
+# Samples per DDS clock (dds_polyphase): each channel has dds_lanes SIN/COS
+# LUT DDS Compilers, sample rate is dds_clk_mhz * dds_lanes. Firmware reads
+# it from REG_9. MAX_DEBUG_PACKETS must be a multiple of it.
+variable dds_lanes
+set dds_lanes 1
+
+# DDS Compiler latency, phase in to data out, clocks. Pinned instead of Auto so
+# the armed start latency (1 + 3 + dds_latency) does not move with the IP
+# version or dds_clk_mhz. Same value as DDS_LATENCY in tb/ and sw/host/.
+variable dds_latency
+set dds_latency 6
+
+# The capture combiner can't stall the DDS outputs: past HP0 bandwidth the
+# capture FIFO overflows, samples are lost and a lost tlast hangs the S2MM
+# transfer. Lower dds_clk_mhz, dds_lanes or num_channels.
+if { [expr $num_channels * $dds_lanes * 4 * $dds_clk_mhz] > 1000 } {
+   catch {common::send_msg_id "BD_TCL-120" "ERROR" "Capturing $num_channels channels at $dds_clk_mhz MHz, $dds_lanes samples per clock needs [expr $num_channels * $dds_lanes * 4 * $dds_clk_mhz] MB/s, HP0 takes 1000 MB/s."}
+
+   return 1
+}
+
 # This script was generated for a remote BD. To create a non-remote design,
 # change the variable <run_remote_bd_flow> to <0>.
 
@@ -130,8 +166,12 @@ set bCheckIPs 1
 if { $bCheckIPs == 1 } {
    set list_check_ips "\ 
 xilinx.com:ip:axi_dma:7.1\
+xilinx.com:ip:axis_data_fifo:2.0\
+xilinx.com:ip:clk_wiz:6.0\
 xilinx.com:ip:dds_compiler:6.0\
 xilinx.com:ip:xlconstant:1.1\
+xilinx.com:ip:xlconcat:2.1\
+xilinx.com:ip:xlslice:1.0\
 xilinx.com:ip:processing_system7:5.5\
 xilinx.com:ip:proc_sys_reset:5.0\
 "
@@ -160,6 +200,7 @@ set bCheckModules 1
 if { $bCheckModules == 1 } {
    set list_check_mods "\ 
 mm2s_dds_modulator\
+dds_capture_combiner\
 "
 
    set list_mods_missing ""
@@ -195,6 +236,10 @@ proc create_root_design { parentCell } {
 
   variable script_folder
   variable design_name
+  variable num_channels
+  variable dds_clk_mhz
+  variable dds_lanes
+  variable dds_latency
 
   if { $parentCell eq "" } {
      set parentCell [get_bd_cells /]
@@ -228,13 +273,20 @@ proc create_root_design { parentCell } {
 
 
   # Create ports
+  # External trigger, PMOD JA1 (xdc/Arty-Z7-10-Master.xdc)
+  set trigger_i [ create_bd_port -dir I trigger_i ]
 
   # Create instance: axi_dma_0, and set properties
   set axi_dma_0 [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_dma:7.1 axi_dma_0 ]
   set_property -dict [ list \
-   CONFIG.c_include_mm2s {0} \
+   CONFIG.c_include_mm2s {1} \
    CONFIG.c_include_sg {0} \
+   CONFIG.c_m_axi_mm2s_data_width {32} \
+   CONFIG.c_m_axis_mm2s_tdata_width {32} \
+   CONFIG.c_mm2s_burst_size {256} \
    CONFIG.c_sg_include_stscntrl_strm {0} \
+   CONFIG.c_m_axi_s2mm_data_width {64} \
+   CONFIG.c_s_axis_s2mm_tdata_width [expr 32 * $num_channels * $dds_lanes] \
    CONFIG.c_sg_length_width {20} \
  ] $axi_dma_0
 
@@ -242,46 +294,102 @@ proc create_root_design { parentCell } {
   set axi_mem_intercon [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_interconnect:2.1 axi_mem_intercon ]
   set_property -dict [ list \
    CONFIG.NUM_MI {1} \
+   CONFIG.NUM_SI {2} \
  ] $axi_mem_intercon
 
-  # Create instance: dds_compiler, and set properties
-  set dds_compiler [ create_bd_cell -type ip -vlnv xilinx.com:ip:dds_compiler:6.0 dds_compiler ]
+  # Create instance: capture_fifo, combiner (DDS clock) to DMA S2MM (FCLK0)
+  set capture_fifo [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_data_fifo:2.0 capture_fifo ]
   set_property -dict [ list \
-   CONFIG.DATA_Has_TLAST {Packet_Framing} \
-   CONFIG.DDS_Clock_Rate {125} \
-   CONFIG.Has_ACLKEN {true} \
-   CONFIG.Has_ARESETn {true} \
-   CONFIG.Has_Phase_Out {false} \
-   CONFIG.Has_TREADY {true} \
-   CONFIG.Latency {14} \
-   CONFIG.M_DATA_Has_TUSER {Not_Required} \
-   CONFIG.Negative_Sine {true} \
-   CONFIG.Noise_Shaping {None} \
-   CONFIG.Output_Frequency1 {0} \
-   CONFIG.Output_Width {14} \
-   CONFIG.PINC1 {0} \
-   CONFIG.Parameter_Entry {Hardware_Parameters} \
-   CONFIG.Phase_Increment {Streaming} \
-   CONFIG.Phase_Width {30} \
-   CONFIG.Phase_offset {Streaming} \
-   CONFIG.Resync {true} \
-   CONFIG.S_PHASE_Has_TUSER {Not_Required} \
- ] $dds_compiler
-
-  # Create instance: dds_tready_const, and set properties
-  set dds_tready_const [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconstant:1.1 dds_tready_const ]
-
-  # Create instance: mm2s_dds_modulator, and set properties
-  set block_name mm2s_dds_modulator
-  set block_cell_name mm2s_dds_modulator
-  if { [catch {set mm2s_dds_modulator [create_bd_cell -type module -reference $block_name $block_cell_name] } errmsg] } {
+   CONFIG.FIFO_DEPTH {512} \
+   CONFIG.HAS_TLAST {1} \
+   CONFIG.IS_ACLK_ASYNC {1} \
+   CONFIG.TDATA_NUM_BYTES [expr 4 * $num_channels * $dds_lanes] \
+ ] $capture_fifo
+
+  # Create instance: dds_capture_combiner, and set properties
+  set block_name dds_capture_combiner
+  set block_cell_name dds_capture_combiner
+  if { [catch {set dds_capture_combiner [create_bd_cell -type module -reference $block_name $block_cell_name] } errmsg] } {
      catch {common::send_msg_id "BD_TCL-105" "ERROR" "Unable to add referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
      return 1
-   } elseif { $mm2s_dds_modulator eq "" } {
+   } elseif { $dds_capture_combiner eq "" } {
      catch {common::send_msg_id "BD_TCL-106" "ERROR" "Unable to referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
      return 1
    }
-  
+  set_property -dict [ list \
+   CONFIG.NUM_CHANNELS $num_channels \
+   CONFIG.DATA_BITS [expr 32 * $dds_lanes] \
+ ] $dds_capture_combiner
+
+  # Create instances: capture_*_concat, pack channel DDS outputs for the combiner.
+  # Channel lanes are adjacent, tvalid/tlast/tuser from lane 0
+  set capture_tdata_concat [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconcat:2.1 capture_tdata_concat ]
+  set capture_tvalid_concat [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconcat:2.1 capture_tvalid_concat ]
+  set capture_tlast_concat [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconcat:2.1 capture_tlast_concat ]
+  set capture_tuser_concat [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconcat:2.1 capture_tuser_concat ]
+  set_property -dict [ list CONFIG.NUM_PORTS $num_channels ] $capture_tvalid_concat
+  set_property -dict [ list CONFIG.NUM_PORTS $num_channels ] $capture_tlast_concat
+  set_property -dict [ list CONFIG.NUM_PORTS $num_channels ] $capture_tuser_concat
+  set_property -dict [ list CONFIG.NUM_PORTS [expr $num_channels * $dds_lanes] ] $capture_tdata_concat
+  for {set i 0} {$i < $num_channels * $dds_lanes} {incr i} {
+    set_property CONFIG.IN${i}_WIDTH {32} $capture_tdata_concat
+  }
+
+  # Create instance: dds_tready_const, and set properties
+  set dds_tready_const [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconstant:1.1 dds_tready_const ]
+
+  # Create instances: mm2s_dds_modulator_<n> and its lanes, dds_compiler_<n>_<k>
+  # (SIN/COS LUT only, phase from the modulator polyphase generator) with
+  # phase_slice_<n>_<k> picking the lane phase
+  for {set i 0} {$i < $num_channels} {incr i} {
+    for {set k 0} {$k < $dds_lanes} {incr k} {
+      set dds_compiler [ create_bd_cell -type ip -vlnv xilinx.com:ip:dds_compiler:6.0 dds_compiler_${i}_${k} ]
+      set_property -dict [ list \
+       CONFIG.PartsPresent {SIN_COS_LUT_only} \
+       CONFIG.DATA_Has_TLAST {Packet_Framing} \
+       CONFIG.DDS_Clock_Rate $dds_clk_mhz \
+       CONFIG.Has_ACLKEN {true} \
+       CONFIG.Has_ARESETn {true} \
+       CONFIG.Has_Phase_Out {false} \
+       CONFIG.Has_TREADY {true} \
+       CONFIG.Latency $dds_latency \
+       CONFIG.Latency_Configuration {Configurable} \
+       CONFIG.M_DATA_Has_TUSER {User_Field} \
+       CONFIG.Negative_Sine {true} \
+       CONFIG.Noise_Shaping {None} \
+       CONFIG.Output_Width {14} \
+       CONFIG.Parameter_Entry {Hardware_Parameters} \
+       CONFIG.Phase_Width {16} \
+       CONFIG.S_PHASE_Has_TUSER {User_Field} \
+       CONFIG.S_PHASE_TUSER_Width {1} \
+     ] $dds_compiler
+
+      set phase_slice [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlslice:1.0 phase_slice_${i}_${k} ]
+      set_property -dict [ list \
+       CONFIG.DIN_WIDTH [expr 16 * $dds_lanes] \
+       CONFIG.DIN_FROM [expr 16 * $k + 15] \
+       CONFIG.DIN_TO [expr 16 * $k] \
+       CONFIG.DOUT_WIDTH {16} \
+     ] $phase_slice
+    }
+
+    set block_name mm2s_dds_modulator
+    set block_cell_name mm2s_dds_modulator_$i
+    if { [catch {set mm2s_dds_modulator [create_bd_cell -type module -reference $block_name $block_cell_name] } errmsg] } {
+       catch {common::send_msg_id "BD_TCL-105" "ERROR" "Unable to add referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+       return 1
+     } elseif { $mm2s_dds_modulator eq "" } {
+       catch {common::send_msg_id "BD_TCL-106" "ERROR" "Unable to referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+       return 1
+     }
+    set_property -dict [ list \
+     CONFIG.CHANNEL $i \
+     CONFIG.DDS_CLK_KHZ [expr $dds_clk_mhz * 1000] \
+     CONFIG.DDS_LANES $dds_lanes \
+     CONFIG.TRIGGER_SYNC [expr $i == 0] \
+   ] $mm2s_dds_modulator
+  }
+
   # Create instance: processing_system7_0, and set properties
   set processing_system7_0 [ create_bd_cell -type ip -vlnv xilinx.com:ip:processing_system7:5.5 processing_system7_0 ]
   set_property -dict [ list \
@@ -1058,34 +1166,124 @@ proc create_root_design { parentCell } {
   # Create instance: ps7_0_axi_periph, and set properties
   set ps7_0_axi_periph [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_interconnect:2.1 ps7_0_axi_periph ]
   set_property -dict [ list \
-   CONFIG.NUM_MI {2} \
+   CONFIG.NUM_MI [expr $num_channels + 1] \
  ] $ps7_0_axi_periph
 
   # Create instance: rst_ps7_0_125M, and set properties
   set rst_ps7_0_125M [ create_bd_cell -type ip -vlnv xilinx.com:ip:proc_sys_reset:5.0 rst_ps7_0_125M ]
 
+  # Create instance: dds_clk_wiz, DDS clock from FCLK0
+  set dds_clk_wiz [ create_bd_cell -type ip -vlnv xilinx.com:ip:clk_wiz:6.0 dds_clk_wiz ]
+  set_property -dict [ list \
+   CONFIG.CLKOUT1_REQUESTED_OUT_FREQ $dds_clk_mhz \
+   CONFIG.PRIM_IN_FREQ {125.000} \
+   CONFIG.USE_LOCKED {true} \
+   CONFIG.USE_RESET {false} \
+ ] $dds_clk_wiz
+
+  # Create instance: rst_dds, DDS clock domain reset, held until the MMCM locks
+  set rst_dds [ create_bd_cell -type ip -vlnv xilinx.com:ip:proc_sys_reset:5.0 rst_dds ]
+
   # Create interface connections
   connect_bd_intf_net -intf_net axi_dma_0_M_AXI_S2MM [get_bd_intf_pins axi_dma_0/M_AXI_S2MM] [get_bd_intf_pins axi_mem_intercon/S00_AXI]
+  connect_bd_intf_net -intf_net axi_dma_0_M_AXI_MM2S [get_bd_intf_pins axi_dma_0/M_AXI_MM2S] [get_bd_intf_pins axi_mem_intercon/S01_AXI]
   connect_bd_intf_net -intf_net axi_mem_intercon_M00_AXI [get_bd_intf_pins axi_mem_intercon/M00_AXI] [get_bd_intf_pins processing_system7_0/S_AXI_HP0]
-  connect_bd_intf_net -intf_net dds_compiler_M_AXIS_DATA [get_bd_intf_pins axi_dma_0/S_AXIS_S2MM] [get_bd_intf_pins dds_compiler/M_AXIS_DATA]
-  connect_bd_intf_net -intf_net mm2s_dds_modulator_0_m_axis_modulation [get_bd_intf_pins dds_compiler/S_AXIS_PHASE] [get_bd_intf_pins mm2s_dds_modulator/m_axis_modulation]
+  connect_bd_intf_net -intf_net dds_capture_combiner_m_axis [get_bd_intf_pins capture_fifo/S_AXIS] [get_bd_intf_pins dds_capture_combiner/m_axis]
+  connect_bd_intf_net -intf_net capture_fifo_M_AXIS [get_bd_intf_pins axi_dma_0/S_AXIS_S2MM] [get_bd_intf_pins capture_fifo/M_AXIS]
   connect_bd_intf_net -intf_net processing_system7_0_DDR [get_bd_intf_ports DDR] [get_bd_intf_pins processing_system7_0/DDR]
   connect_bd_intf_net -intf_net processing_system7_0_FIXED_IO [get_bd_intf_ports FIXED_IO] [get_bd_intf_pins processing_system7_0/FIXED_IO]
   connect_bd_intf_net -intf_net processing_system7_0_M_AXI_GP0 [get_bd_intf_pins processing_system7_0/M_AXI_GP0] [get_bd_intf_pins ps7_0_axi_periph/S00_AXI]
-  connect_bd_intf_net -intf_net ps7_0_axi_periph_M00_AXI [get_bd_intf_pins mm2s_dds_modulator/S_AXI] [get_bd_intf_pins ps7_0_axi_periph/M00_AXI]
-  connect_bd_intf_net -intf_net ps7_0_axi_periph_M01_AXI [get_bd_intf_pins axi_dma_0/S_AXI_LITE] [get_bd_intf_pins ps7_0_axi_periph/M01_AXI]
+  set dma_mi [format "M%02d" $num_channels]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_${dma_mi}_AXI [get_bd_intf_pins axi_dma_0/S_AXI_LITE] [get_bd_intf_pins ps7_0_axi_periph/${dma_mi}_AXI]
+
+  # Per channel connections. Clock and reset pins are collected for the shared nets,
+  # FCLK0 (registers) and DDS clock (modulators, DDS Compilers, capture)
+  set channel_clk_pins [list [get_bd_pins capture_fifo/m_axis_aclk] [get_bd_pins ps7_0_axi_periph/${dma_mi}_ACLK]]
+  set channel_rst_pins [list [get_bd_pins ps7_0_axi_periph/${dma_mi}_ARESETN]]
+  set dds_clk_pins [list [get_bd_pins dds_clk_wiz/clk_out1] [get_bd_pins rst_dds/slowest_sync_clk] [get_bd_pins dds_capture_combiner/clk_i] [get_bd_pins capture_fifo/s_axis_aclk]]
+  set dds_rst_pins [list [get_bd_pins rst_dds/peripheral_aresetn] [get_bd_pins dds_capture_combiner/resetn_i] [get_bd_pins capture_fifo/s_axis_aresetn]]
+  set capture_trig_pins [list [get_bd_pins mm2s_dds_modulator_0/capture_trig_o]]
+  # External trigger: channel 0 synchronizes the pin, the others take its synchronized copy
+  set trigger_sync_pins [list [get_bd_pins mm2s_dds_modulator_0/trigger_sync_o]]
+  # Table loader stream is broadcast, packets carry the channel. Loaders never stall
+  set table_tdata_pins [list [get_bd_pins axi_dma_0/m_axis_mm2s_tdata]]
+  set table_tvalid_pins [list [get_bd_pins axi_dma_0/m_axis_mm2s_tvalid]]
+  set table_tlast_pins [list [get_bd_pins axi_dma_0/m_axis_mm2s_tlast]]
+  for {set i 0} {$i < $num_channels} {incr i} {
+    set mi [format "M%02d" $i]
+    connect_bd_intf_net -intf_net ps7_0_axi_periph_${mi}_AXI [get_bd_intf_pins mm2s_dds_modulator_$i/S_AXI] [get_bd_intf_pins ps7_0_axi_periph/${mi}_AXI]
+    # Lanes share tvalid/tlast/tuser/aclken and run in lockstep, tready from lane 0
+    set phase_tdata_pins [list [get_bd_pins mm2s_dds_modulator_$i/m_axis_modulation_tdata]]
+    set phase_tvalid_pins [list [get_bd_pins mm2s_dds_modulator_$i/m_axis_modulation_tvalid]]
+    set phase_tlast_pins [list [get_bd_pins mm2s_dds_modulator_$i/m_axis_modulation_tlast]]
+    set phase_tuser_pins [list [get_bd_pins mm2s_dds_modulator_$i/m_axis_modulation_tuser]]
+    set dds_en_pins [list [get_bd_pins mm2s_dds_modulator_$i/dds_en_o]]
+    connect_bd_net -net mm2s_dds_modulator_${i}_m_axis_modulation_tready [get_bd_pins dds_compiler_${i}_0/s_axis_phase_tready] [get_bd_pins mm2s_dds_modulator_$i/m_axis_modulation_tready]
+    connect_bd_net -net dds_compiler_${i}_m_axis_data_tvalid [get_bd_pins dds_compiler_${i}_0/m_axis_data_tvalid] [get_bd_pins capture_tvalid_concat/In$i]
+    connect_bd_net -net dds_compiler_${i}_m_axis_data_tlast [get_bd_pins dds_compiler_${i}_0/m_axis_data_tlast] [get_bd_pins capture_tlast_concat/In$i]
+    connect_bd_net -net dds_compiler_${i}_m_axis_data_tuser [get_bd_pins dds_compiler_${i}_0/m_axis_data_tuser] [get_bd_pins capture_tuser_concat/In$i]
+    for {set k 0} {$k < $dds_lanes} {incr k} {
+      set lane ${i}_${k}
+      connect_bd_net -net phase_slice_${lane}_dout [get_bd_pins phase_slice_$lane/Dout] [get_bd_pins dds_compiler_$lane/s_axis_phase_tdata]
+      connect_bd_net -net dds_compiler_${lane}_m_axis_data_tdata [get_bd_pins dds_compiler_$lane/m_axis_data_tdata] [get_bd_pins capture_tdata_concat/In[expr $i * $dds_lanes + $k]]
+      lappend phase_tdata_pins [get_bd_pins phase_slice_$lane/Din]
+      lappend phase_tvalid_pins [get_bd_pins dds_compiler_$lane/s_axis_phase_tvalid]
+      lappend phase_tlast_pins [get_bd_pins dds_compiler_$lane/s_axis_phase_tlast]
+      lappend phase_tuser_pins [get_bd_pins dds_compiler_$lane/s_axis_phase_tuser]
+      lappend dds_en_pins [get_bd_pins dds_compiler_$lane/aclken]
+      lappend dds_clk_pins [get_bd_pins dds_compiler_$lane/aclk]
+      lappend dds_rst_pins [get_bd_pins dds_compiler_$lane/aresetn]
+    }
+    connect_bd_net -net mm2s_dds_modulator_${i}_m_axis_modulation_tdata {*}$phase_tdata_pins
+    connect_bd_net -net mm2s_dds_modulator_${i}_m_axis_modulation_tvalid {*}$phase_tvalid_pins
+    connect_bd_net -net mm2s_dds_modulator_${i}_m_axis_modulation_tlast {*}$phase_tlast_pins
+    connect_bd_net -net mm2s_dds_modulator_${i}_m_axis_modulation_tuser {*}$phase_tuser_pins
+    connect_bd_net -net mm2s_dds_modulator_${i}_dds_en_o {*}$dds_en_pins
+    lappend channel_clk_pins [get_bd_pins mm2s_dds_modulator_$i/S_AXI_CLK] [get_bd_pins ps7_0_axi_periph/${mi}_ACLK]
+    lappend channel_rst_pins [get_bd_pins mm2s_dds_modulator_$i/S_AXI_ARESETN] [get_bd_pins ps7_0_axi_periph/${mi}_ARESETN]
+    lappend dds_clk_pins [get_bd_pins mm2s_dds_modulator_$i/DDS_CLK]
+    lappend dds_rst_pins [get_bd_pins mm2s_dds_modulator_$i/DDS_ARESETN]
+    lappend capture_trig_pins [get_bd_pins mm2s_dds_modulator_$i/capture_trig_i]
+    if { $i > 0 } {
+      lappend trigger_sync_pins [get_bd_pins mm2s_dds_modulator_$i/trigger_i]
+    }
+    lappend table_tdata_pins [get_bd_pins mm2s_dds_modulator_$i/s_axis_table_tdata]
+    lappend table_tvalid_pins [get_bd_pins mm2s_dds_modulator_$i/s_axis_table_tvalid]
+    lappend table_tlast_pins [get_bd_pins mm2s_dds_modulator_$i/s_axis_table_tlast]
+  }
+  connect_bd_net -net capture_trig {*}$capture_trig_pins
+  connect_bd_net -net trigger_i [get_bd_ports trigger_i] [get_bd_pins mm2s_dds_modulator_0/trigger_i]
+  if { $num_channels > 1 } {
+    connect_bd_net -net trigger_sync {*}$trigger_sync_pins
+  }
+  connect_bd_net -net table_tdata {*}$table_tdata_pins
+  connect_bd_net -net table_tvalid {*}$table_tvalid_pins
+  connect_bd_net -net table_tlast {*}$table_tlast_pins
+  connect_bd_net -net table_tready [get_bd_pins axi_dma_0/m_axis_mm2s_tready] [get_bd_pins mm2s_dds_modulator_0/s_axis_table_tready]
+  connect_bd_net -net capture_tdata_concat_dout [get_bd_pins capture_tdata_concat/dout] [get_bd_pins dds_capture_combiner/s_axis_tdata]
+  connect_bd_net -net capture_tvalid_concat_dout [get_bd_pins capture_tvalid_concat/dout] [get_bd_pins dds_capture_combiner/s_axis_tvalid]
+  connect_bd_net -net capture_tlast_concat_dout [get_bd_pins capture_tlast_concat/dout] [get_bd_pins dds_capture_combiner/s_axis_tlast]
+  connect_bd_net -net capture_tuser_concat_dout [get_bd_pins capture_tuser_concat/dout] [get_bd_pins dds_capture_combiner/s_axis_tuser]
+  # Capture header timestamp, channels share the DDS clock reset so channel 0 counter stands for all
+  connect_bd_net -net mm2s_dds_modulator_0_capture_ts_o [get_bd_pins mm2s_dds_modulator_0/capture_ts_o] [get_bd_pins dds_capture_combiner/capture_ts_i]
 
   # Create port connections
-  connect_bd_net -net mm2s_dds_modulator_0_dds_en_o [get_bd_pins dds_compiler/aclken] [get_bd_pins mm2s_dds_modulator/dds_en_o]
-  connect_bd_net -net processing_system7_0_FCLK_CLK0 [get_bd_pins axi_dma_0/m_axi_s2mm_aclk] [get_bd_pins axi_dma_0/s_axi_lite_aclk] [get_bd_pins axi_mem_intercon/ACLK] [get_bd_pins axi_mem_intercon/M00_ACLK] [get_bd_pins axi_mem_intercon/S00_ACLK] [get_bd_pins dds_compiler/aclk] [get_bd_pins mm2s_dds_modulator/S_AXI_CLK] [get_bd_pins processing_system7_0/FCLK_CLK0] [get_bd_pins processing_system7_0/M_AXI_GP0_ACLK] [get_bd_pins processing_system7_0/S_AXI_HP0_ACLK] [get_bd_pins ps7_0_axi_periph/ACLK] [get_bd_pins ps7_0_axi_periph/M00_ACLK] [get_bd_pins ps7_0_axi_periph/M01_ACLK] [get_bd_pins ps7_0_axi_periph/S00_ACLK] [get_bd_pins rst_ps7_0_125M/slowest_sync_clk]
-  connect_bd_net -net processing_system7_0_FCLK_RESET0_N [get_bd_pins processing_system7_0/FCLK_RESET0_N] [get_bd_pins rst_ps7_0_125M/ext_reset_in]
-  connect_bd_net -net rst_ps7_0_125M_peripheral_aresetn [get_bd_pins axi_dma_0/axi_resetn] [get_bd_pins axi_mem_intercon/ARESETN] [get_bd_pins axi_mem_intercon/M00_ARESETN] [get_bd_pins axi_mem_intercon/S00_ARESETN] [get_bd_pins dds_compiler/aresetn] [get_bd_pins mm2s_dds_modulator/S_AXI_ARESETN] [get_bd_pins ps7_0_axi_periph/ARESETN] [get_bd_pins ps7_0_axi_periph/M00_ARESETN] [get_bd_pins ps7_0_axi_periph/M01_ARESETN] [get_bd_pins ps7_0_axi_periph/S00_ARESETN] [get_bd_pins rst_ps7_0_125M/peripheral_aresetn]
-  connect_bd_net -net xlconstant_1_dout [get_bd_pins dds_compiler/m_axis_data_tready] [get_bd_pins dds_tready_const/dout]
+  connect_bd_net -net processing_system7_0_FCLK_CLK0 [get_bd_pins axi_dma_0/m_axi_mm2s_aclk] [get_bd_pins axi_dma_0/m_axi_s2mm_aclk] [get_bd_pins axi_dma_0/s_axi_lite_aclk] [get_bd_pins axi_mem_intercon/ACLK] [get_bd_pins axi_mem_intercon/M00_ACLK] [get_bd_pins axi_mem_intercon/S00_ACLK] [get_bd_pins axi_mem_intercon/S01_ACLK] [get_bd_pins processing_system7_0/FCLK_CLK0] [get_bd_pins processing_system7_0/M_AXI_GP0_ACLK] [get_bd_pins processing_system7_0/S_AXI_HP0_ACLK] [get_bd_pins ps7_0_axi_periph/ACLK] [get_bd_pins ps7_0_axi_periph/S00_ACLK] [get_bd_pins rst_ps7_0_125M/slowest_sync_clk] [get_bd_pins dds_clk_wiz/clk_in1] {*}$channel_clk_pins
+  connect_bd_net -net processing_system7_0_FCLK_RESET0_N [get_bd_pins processing_system7_0/FCLK_RESET0_N] [get_bd_pins rst_ps7_0_125M/ext_reset_in] [get_bd_pins rst_dds/ext_reset_in]
+  connect_bd_net -net rst_ps7_0_125M_peripheral_aresetn [get_bd_pins axi_dma_0/axi_resetn] [get_bd_pins axi_mem_intercon/ARESETN] [get_bd_pins axi_mem_intercon/M00_ARESETN] [get_bd_pins axi_mem_intercon/S00_ARESETN] [get_bd_pins axi_mem_intercon/S01_ARESETN] [get_bd_pins ps7_0_axi_periph/ARESETN] [get_bd_pins ps7_0_axi_periph/S00_ARESETN] [get_bd_pins rst_ps7_0_125M/peripheral_aresetn] {*}$channel_rst_pins
+  connect_bd_net -net dds_clk_wiz_clk_out1 {*}$dds_clk_pins
+  connect_bd_net -net dds_clk_wiz_locked [get_bd_pins dds_clk_wiz/locked] [get_bd_pins rst_dds/dcm_locked]
+  connect_bd_net -net rst_dds_peripheral_aresetn {*}$dds_rst_pins
+  connect_bd_net -net xlconstant_1_dout [get_bd_pins dds_tready_const/dout] [get_bd_pins dds_compiler_*/m_axis_data_tready]
 
   # Create address segments
   assign_bd_address -offset 0x00000000 -range 0x20000000 -target_address_space [get_bd_addr_spaces axi_dma_0/Data_S2MM] [get_bd_addr_segs processing_system7_0/S_AXI_HP0/HP0_DDR_LOWOCM] -force
+  assign_bd_address -offset 0x00000000 -range 0x20000000 -target_address_space [get_bd_addr_spaces axi_dma_0/Data_MM2S] [get_bd_addr_segs processing_system7_0/S_AXI_HP0/HP0_DDR_LOWOCM] -force
   assign_bd_address -offset 0x40400000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs axi_dma_0/S_AXI_LITE/Reg] -force
-  assign_bd_address -offset 0x40000000 -range 0x00000080 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs mm2s_dds_modulator/S_AXI/reg0] -force
+  # Channel n registers at 0x40000000 + n * 0x10000
+  for {set i 0} {$i < $num_channels} {incr i} {
+    assign_bd_address -offset [format 0x%08X [expr 0x40000000 + $i * 0x10000]] -range 0x00001000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs mm2s_dds_modulator_$i/S_AXI/reg0] -force
+  }
 
 
   # Restore current instance
@@ -7,7 +7,33 @@
  * Provides memory-mapped access from PS side of Xilinx Zynq SoC.
  */
 
-module axi_lite_mm2dds_mod_registers(
+/**
+ *  @param DDS_CLK_KHZ: DDS clock frequency, read only in REG_8. Firmware
+ *      converts times and frequencies with it
+ *  @param DDS_LANES: Samples per DDS clock (dds_polyphase), read only in
+ *      REG_9. Sample rate is DDS_CLK_KHZ * DDS_LANES
+ *
+ *  Timestamps (DDS clocks, read only) are 64 bit, low word first: reading
+ *  the low word holds the high word for the next read of its pair.
+ *      REG_10/11: free running counter
+ *      REG_12/13: last pulse start
+ *      REG_14/15: last commit
+ *      REG_16/17: last capture start
+ *
+ *  Performance counters (read only, 32 bit, wrap around):
+ *      REG_18: pulses started
+ *      REG_19: DDS clocks enabled with tready low (backpressure)
+ *      REG_20: capture beats sent to the DDS
+ *      REG_21: captures ended (tlast)
+ *      REG_22: commits latched
+ *      REG_23: config register writes (REG_0 to REG_6, AXI side)
+ *      REG_24: trigger edges seen in triggered mode (dds_trigger)
+ *      REG_25: trigger edges missed, running or in holdoff
+ */
+
+module axi_lite_mm2dds_mod_registers
+    import dds_modulator_pkg::*;
+    #(parameter DDS_CLK_KHZ = 125000, parameter DDS_LANES = 1)(
     /* Register outputs */ 
     output [31:0] config_reg_0_o,
     output [31:0] config_reg_1_o,
@@ -15,6 +41,22 @@ module axi_lite_mm2dds_mod_registers(
     output [31:0] config_reg_3_o,
     output [31:0] config_reg_4_o,
     output [31:0] config_reg_5_o,
+    /* Sequencer length */
+    output [31:0] config_reg_6_o,
+    /* Sequencer table write port */
+    output         table_wr_en_o,
+    output  [$clog2(SEQ_DEPTH * SEQ_ENTRY_WORDS) - 1:0] table_wr_addr_o,
+    output  [31:0] table_wr_data_o,
+    output  [3:0]  table_wr_strb_o,
+    /* Sequencer entry being played, read only */
+    input   [31:0] seq_status_i,
+    /* Timestamps, read only */
+    input   [TIMESTAMP_BITS-1:0] ts_now_i,
+    input   [TIMESTAMP_BITS-1:0] ts_pulse_i,
+    input   [TIMESTAMP_BITS-1:0] ts_commit_i,
+    input   [TIMESTAMP_BITS-1:0] ts_capture_i,
+    /* DDS side performance counters, PERF_* in package */
+    input   [PERF_COUNTERS*32-1:0] perf_i,
 
     /* AXI4-Lite Clock and reset signals */
     input          S_AXI_CLK,
@@ -45,23 +87,16 @@ module axi_lite_mm2dds_mod_registers(
     output         S_AXI_RVALID, 
 
     /* Debug ended signal */
-    input logic dbg_tlast
+    input logic dbg_tlast,
+    /* Staged config latched by modulator */
+    input logic commit_done
 );
 
-localparam ADDR_BITS = 8;
-
-import dds_modulator_pkg::*;
+localparam ADDR_BITS = 12;
 
-/* AXI Write FSM States */ 
-typedef enum logic [1:0] {  WIDLE_S,
-                    WDATA_S,
-                    WRESP_S
-} axi_wstate_e;
-
-/* AXI Read FSM States */ 
-typedef enum logic {    RIDLE_S,
-                        RDATA_S
-} axi_rstate_e;
+/* AXI responses */
+localparam  RESP_OKAY = 2'b00,
+            RESP_SLVERR = 2'b10;
 
 /* AXI Registers addresses */ 
 localparam  REG_0 = 'h0,
@@ -69,65 +104,113 @@ localparam  REG_0 = 'h0,
             REG_2 = 'h8,
             REG_3 = 'hc,
             REG_4 = 'h10,
-            REG_5 = 'h14;
+            REG_5 = 'h14,
+            REG_6 = 'h18,
+            REG_7 = 'h1c,
+            REG_8 = 'h20,
+            REG_9 = 'h24,
+            REG_10 = 'h28,
+            REG_11 = 'h2c,
+            REG_12 = 'h30,
+            REG_13 = 'h34,
+            REG_14 = 'h38,
+            REG_15 = 'h3c,
+            REG_16 = 'h40,
+            REG_17 = 'h44,
+            REG_18 = 'h48,
+            REG_19 = 'h4c,
+            REG_20 = 'h50,
+            REG_21 = 'h54,
+            REG_22 = 'h58,
+            REG_23 = 'h5c,
+            REG_24 = 'h60,
+            REG_25 = 'h64;
+
+/**
+ * Merges the enabled byte lanes of new data into a register value.
+ */
+function automatic logic [31:0] wstrb_merge(input logic [31:0] current,
+                                            input logic [31:0] data,
+                                            input logic [3:0] strb);
+    for (int b = 0; b < 4; b++)
+        wstrb_merge[8*b +: 8] = strb[b] ? data[8*b +: 8] : current[8*b +: 8];
+endfunction
 
 /* AXI Write */
-axi_wstate_e wstate_reg, wstate_next;
-logic [ADDR_BITS - 1:0] waddr_reg;
+/*
+ * Address and data channels are independent. Each one has a holding
+ * register for when it arrives before its pair (or while the response
+ * channel is stalled). When both are present the write is done and the
+ * response is issued in the same cycle, so with AWVALID, WVALID and BREADY
+ * held high the slave takes one write per clock.
+ */
+logic aw_full_reg;
+logic [ADDR_BITS - 1:0] aw_addr_reg;
+logic w_full_reg;
+logic [31:0] w_data_reg;
+logic [3:0] w_strb_reg;
+logic bvalid_reg;
+logic [1:0] bresp_reg;
 
 /* AXI Read */ 
-axi_rstate_e rstate_reg, rstate_next;
-logic [ADDR_BITS - 1:0] raddr_reg;
+logic rvalid_reg;
 logic [31:0] rdata_reg;
+logic [1:0] rresp_reg;
 
 /* AXI signals */
 /* WRITE */
 /* 
- * Inform we are ready to receive an address if on idle state
+ * Ready to receive an address/data unless one is already held
  */
-assign S_AXI_AWREADY = (wstate_reg == WIDLE_S);
+assign S_AXI_AWREADY = !aw_full_reg;
+assign S_AXI_WREADY = !w_full_reg;
 
-/* 
- * Inform we are ready to receive data if on write data state
- */
-assign S_AXI_WREADY = (wstate_reg == WDATA_S);
+assign S_AXI_BVALID = bvalid_reg;
+assign S_AXI_BRESP = bresp_reg;
 
-/* 
- * Inform we are sending a valid write response if on write response state
+/*
+ * Current write address and data: the held one, or the one on the bus
  */
-assign S_AXI_BVALID = (wstate_reg == WRESP_S);
+logic aw_present, w_present;
+assign aw_present = aw_full_reg || S_AXI_AWVALID;
+assign w_present = w_full_reg || S_AXI_WVALID;
+
+logic [ADDR_BITS - 1:0] write_addr;
+logic [31:0] write_data;
+logic [3:0] write_strb;
+assign write_addr = aw_full_reg ? aw_addr_reg : S_AXI_AWADDR[ADDR_BITS - 1:0];
+assign write_data = w_full_reg ? w_data_reg : S_AXI_WDATA;
+assign write_strb = w_full_reg ? w_strb_reg : S_AXI_WSTRB;
 
 /*
- * Will have a write address request from master when:
- *     - Slave is ready (S_AXI_AWREADY) -> We are on idle state
- *     - Master writes a valid address (S_AXI_AWVALID)
+ * Will do a write when:
+ *     - Address and data are present (held or valid on the bus)
+ *     - Response channel is free or being emptied this cycle
  */
-logic write_address_request;
-assign write_address_request = S_AXI_AWREADY && S_AXI_AWVALID;
+logic write_request;
+assign write_request = aw_present && w_present && (!bvalid_reg || S_AXI_BREADY);
 
 /*
- * Will have a write request from master when:
- *     - Slave is ready (S_AXI_WREADY) -> We are on write data state
- *     - Master writes a valid data (S_AXI_WVALID)
+ * REG_0 to REG_6 and the sequencer table are writable.
+ * REG_7 to REG_25 (read only) and the gap up to the table answer SLVERR.
  */
-logic write_data_request;
-assign write_data_request = S_AXI_WREADY && S_AXI_WVALID;
+logic write_table, write_valid;
+assign write_table = (write_addr >= SEQ_TABLE_BASE);
+assign write_valid = write_table || ({write_addr[ADDR_BITS - 1:2], 2'b00} <= REG_6);
 
 /* READ */
 
 /* 
- * Inform we are ready to receive an address if on idle state
+ * Ready to receive an address when there is no read data waiting,
+ * or it is being taken this cycle
  */
-assign S_AXI_ARREADY = (rstate_reg == RIDLE_S);
+assign S_AXI_ARREADY = !rvalid_reg || S_AXI_RREADY;
 
-/* 
- * Inform we are sending a valid data if on read response state
- */
-assign S_AXI_RVALID = (rstate_reg == RDATA_S);
+assign S_AXI_RVALID = rvalid_reg;
 
 /*
  * Will have a read address request from master when:
- *     - Slave is ready (S_AXI_ARREADY) -> We are on idle state
+ *     - Slave is ready (S_AXI_ARREADY)
  *     - Master writes a valid address (S_AXI_ARVALID)
  */
 logic read_request;
@@ -140,6 +223,7 @@ logic [31:0] config_reg_2;
 logic [31:0] config_reg_3;
 logic [31:0] config_reg_4;
 logic [31:0] config_reg_5;
+logic [31:0] config_reg_6;
 
 /* I/O Assigns */
 assign config_reg_0_o = config_reg_0;
@@ -148,55 +232,69 @@ assign config_reg_2_o = config_reg_2;
 assign config_reg_3_o = config_reg_3;
 assign config_reg_4_o = config_reg_4;
 assign config_reg_5_o = config_reg_5;
+assign config_reg_6_o = config_reg_6;
 
-assign S_AXI_RDATA = rdata_reg;
+/* Writes from SEQ_TABLE_BASE up go to the sequencer table */
+assign table_wr_en_o = write_request && write_table;
+assign table_wr_addr_o = (write_addr - SEQ_TABLE_BASE) >> 2;
+assign table_wr_data_o = write_data;
+assign table_wr_strb_o = write_strb;
 
-/*
- * Not evaluating bus errors. Always OK.
- */
-assign S_AXI_BRESP = 2'b00;
-assign S_AXI_RRESP = 2'b00;
+assign S_AXI_RDATA = rdata_reg;
+assign S_AXI_RRESP = rresp_reg;
 
-/* AXI Write FSM */
+/* AXI Write holding registers */
 always_ff @(posedge S_AXI_CLK)
 begin
     if (!S_AXI_ARESETN)
-        wstate_reg <= WIDLE_S;
+    begin
+        aw_full_reg <= 0;
+        aw_addr_reg <= 0;
+        w_full_reg <= 0;
+        w_data_reg <= 0;
+        w_strb_reg <= 0;
+    end
     else
-        wstate_reg <= wstate_next;
-end
-
-/* AXI Write FSM Next State Logic */
-always_comb
-begin
-    case(wstate_reg)
-        WIDLE_S:
-            // Go to write data state if input address is valid
-            wstate_next = S_AXI_AWVALID ? WDATA_S : WIDLE_S;
-        WDATA_S:
-            // Go to response state if input data is valid
-            wstate_next = S_AXI_WVALID ? WRESP_S : WDATA_S;
-        WRESP_S:
-            // Go to idle state if master is ready to accept response
-            wstate_next = S_AXI_BREADY ? WIDLE_S : WRESP_S;
-        default:
-            wstate_next = WIDLE_S;
-    endcase
+    begin
+        // Hold an accepted address until its write is done
+        if (write_request)
+            aw_full_reg <= 0;
+        else if (S_AXI_AWVALID && S_AXI_AWREADY)
+        begin
+            aw_full_reg <= 1;
+            aw_addr_reg <= S_AXI_AWADDR[ADDR_BITS - 1:0];
+        end
+
+        // Same for data
+        if (write_request)
+            w_full_reg <= 0;
+        else if (S_AXI_WVALID && S_AXI_WREADY)
+        begin
+            w_full_reg <= 1;
+            w_data_reg <= S_AXI_WDATA;
+            w_strb_reg <= S_AXI_WSTRB;
+        end
+    end
 end
 
-/* AXI Write Incoming address register */
+/* AXI Write response */
 always_ff @(posedge S_AXI_CLK)
 begin
     if (!S_AXI_ARESETN)
-        waddr_reg <= 0;   
-    else if (write_address_request) // Register the incoming address when on a write request
-        waddr_reg <= S_AXI_AWADDR[ADDR_BITS - 1:0];
-    else
-        waddr_reg <= waddr_reg;
+    begin
+        bvalid_reg <= 0;
+        bresp_reg <= RESP_OKAY;
+    end
+    else if (write_request)
+    begin
+        bvalid_reg <= 1;
+        bresp_reg <= write_valid ? RESP_OKAY : RESP_SLVERR;
+    end
+    else if (S_AXI_BREADY)
+        bvalid_reg <= 0;
 end
 
 /* Registers write */
-// TODO: Add S_AXI_WSTRB logic
 always_ff @(posedge S_AXI_CLK)
 begin
     if (!S_AXI_ARESETN)
@@ -207,71 +305,71 @@ begin
         config_reg_3 <= 0;
         config_reg_4 <= 0;
         config_reg_5 <= 0;
+        config_reg_6 <= 0;
     end
-    else if (write_data_request) begin
-        case(waddr_reg)
-            REG_0:
-                config_reg_0 <= S_AXI_WDATA;
-            REG_1:
-                config_reg_1 <= S_AXI_WDATA;
-            REG_2:
-                config_reg_2 <= S_AXI_WDATA;
-            REG_3:
-                config_reg_3 <= S_AXI_WDATA;
-            REG_4:
-                config_reg_4 <= S_AXI_WDATA;
-            REG_5:
-                config_reg_5 <= S_AXI_WDATA;    
-            default:
-            begin
-                config_reg_0 <= config_reg_0;
-                config_reg_1 <= config_reg_1;
-                config_reg_2 <= config_reg_2;
-                config_reg_3 <= config_reg_3;
-                config_reg_4 <= config_reg_4;
-                config_reg_5 <= config_reg_5; 
-            end
-        endcase  
-    end
-
-    if (config_reg_0[DEBUG_BIT]) begin
-        config_reg_0[DEBUG_BIT] <= ~(config_reg_0[DEBUG_BIT] & dbg_tlast);    
+    else
+    begin
+        if (write_request)
+        begin
+            case({write_addr[ADDR_BITS - 1:2], 2'b00})
+                REG_0:
+                    config_reg_0 <= wstrb_merge(config_reg_0, write_data, write_strb);
+                REG_1:
+                    config_reg_1 <= wstrb_merge(config_reg_1, write_data, write_strb);
+                REG_2:
+                    config_reg_2 <= wstrb_merge(config_reg_2, write_data, write_strb);
+                REG_3:
+                    config_reg_3 <= wstrb_merge(config_reg_3, write_data, write_strb);
+                REG_4:
+                    config_reg_4 <= wstrb_merge(config_reg_4, write_data, write_strb);
+                REG_5:
+                    config_reg_5 <= wstrb_merge(config_reg_5, write_data, write_strb);
+                REG_6:
+                    config_reg_6 <= wstrb_merge(config_reg_6, write_data, write_strb);
+                default: ;
+            endcase
+        end
+
+        if (config_reg_0[DEBUG_BIT]) begin
+            config_reg_0[DEBUG_BIT] <= ~(config_reg_0[DEBUG_BIT] & dbg_tlast);    
+        end
+
+        /* Commit bit reads 1 until the modulator latches the staged config */
+        if (config_reg_0[COMMIT_BIT]) begin
+            config_reg_0[COMMIT_BIT] <= ~commit_done;
+        end
     end
-    
-
 end
 
-/* AXI Read FSM */
+/* Config register writes, performance counter */
+logic [31:0] config_writes_reg;
 always_ff @(posedge S_AXI_CLK)
 begin
     if (!S_AXI_ARESETN)
-        rstate_reg <= RIDLE_S;
-    else
-        rstate_reg <= rstate_next;
+        config_writes_reg <= 0;
+    else if (write_request && write_valid && !write_table)
+        config_writes_reg <= config_writes_reg + 1;
 end
 
-/* AXI Read FSM Next State Logic */
-always_comb
-begin
-    case(rstate_reg)
-        RIDLE_S:
-            // Go to read data state if input address is valid
-            rstate_next = S_AXI_ARVALID ? RDATA_S : RIDLE_S;
-        RDATA_S:
-            // Go to response state if input data is valid
-            rstate_next = S_AXI_RREADY ? RIDLE_S : RDATA_S;
-        default:
-            rstate_next = RIDLE_S;
-    endcase
-end
+/* Timestamp high words, held on low word reads: now, pulse, commit, capture */
+logic [31:0] ts_high_hold [4];
 
-/* AXI Read register */ 
+/* AXI Read data */ 
 always_ff @(posedge S_AXI_CLK)
 begin
     if (!S_AXI_ARESETN)
+    begin
+        rvalid_reg <= 0;
         rdata_reg <= 0;
+        rresp_reg <= RESP_OKAY;
+        for (int t = 0; t < 4; t++)
+            ts_high_hold[t] <= 0;
+    end
     else if(read_request)
-        case(S_AXI_ARADDR[ADDR_BITS - 1:0])
+    begin
+        rvalid_reg <= 1;
+        rresp_reg <= RESP_OKAY;
+        case({S_AXI_ARADDR[ADDR_BITS - 1:2], 2'b00})
             REG_0:
                 rdata_reg <= config_reg_0;
             REG_1:
@@ -284,9 +382,68 @@ begin
                 rdata_reg <= config_reg_4;
             REG_5:
                 rdata_reg <= config_reg_5; 
+            REG_6:
+                rdata_reg <= config_reg_6;
+            REG_7:
+                rdata_reg <= seq_status_i;
+            REG_8:
+                rdata_reg <= DDS_CLK_KHZ;
+            REG_9:
+                rdata_reg <= DDS_LANES;
+            REG_10:
+            begin
+                rdata_reg <= ts_now_i[31:0];
+                ts_high_hold[0] <= ts_now_i[63:32];
+            end
+            REG_11:
+                rdata_reg <= ts_high_hold[0];
+            REG_12:
+            begin
+                rdata_reg <= ts_pulse_i[31:0];
+                ts_high_hold[1] <= ts_pulse_i[63:32];
+            end
+            REG_13:
+                rdata_reg <= ts_high_hold[1];
+            REG_14:
+            begin
+                rdata_reg <= ts_commit_i[31:0];
+                ts_high_hold[2] <= ts_commit_i[63:32];
+            end
+            REG_15:
+                rdata_reg <= ts_high_hold[2];
+            REG_16:
+            begin
+                rdata_reg <= ts_capture_i[31:0];
+                ts_high_hold[3] <= ts_capture_i[63:32];
+            end
+            REG_17:
+                rdata_reg <= ts_high_hold[3];
+            REG_18:
+                rdata_reg <= perf_i[PERF_PULSES*32 +: 32];
+            REG_19:
+                rdata_reg <= perf_i[PERF_STALLS*32 +: 32];
+            REG_20:
+                rdata_reg <= perf_i[PERF_CAPTURE_BEATS*32 +: 32];
+            REG_21:
+                rdata_reg <= perf_i[PERF_TLASTS*32 +: 32];
+            REG_22:
+                rdata_reg <= perf_i[PERF_COMMITS*32 +: 32];
+            REG_23:
+                rdata_reg <= config_writes_reg;
+            REG_24:
+                rdata_reg <= perf_i[PERF_TRIGGERS*32 +: 32];
+            REG_25:
+                rdata_reg <= perf_i[PERF_TRIGGERS_MISSED*32 +: 32];
             default:
+            begin
+                // Sequencer table is write only
                 rdata_reg <= 0;
+                rresp_reg <= RESP_SLVERR;
+            end
         endcase
+    end
+    else if (S_AXI_RREADY)
+        rvalid_reg <= 0;
 end
 
-endmodule
\ No newline at end of file
+endmodule
@@ -0,0 +1,124 @@
+`timescale 1ns / 1ps
+/**
+ * @file dds_capture_combiner.sv
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Debug capture combiner for multi-channel generators. Joins the DDS
+ * output streams of every channel into a single wide stream for one DMA.
+ */
+
+/**
+ *  Output word layout: channel n beat in bits [n*DATA_BITS +: DATA_BITS],
+ *  so in memory beat k of channel n is at word k*NUM_CHANNELS + n.
+ *  Polyphase builds carry the channel lanes in the beat (DATA_BITS =
+ *  32 * lanes): sample k of channel n is word
+ *  (k / lanes) * NUM_CHANNELS * lanes + n * lanes + k % lanes.
+ *
+ *  Channels are triggered together (capture_trig from channel 0), DDS latency
+ *  is the same for all of them, so enabled channels run in lockstep.
+ *  Lanes of channels not running are zero.
+ *
+ *  Each capture starts with a header of HEADER_BEATS beats holding the
+ *  capture start timestamp (capture_ts_i, zero extended), so in memory
+ *  words 0 and 1 are its low and high halves and samples start after the
+ *  header. The first sample is flagged by TUSER (from the modulator through
+ *  the DDS Compilers); the stream goes through a HEADER_BEATS delay line
+ *  while the header is sent. Only the capture reaches the DMA: from the
+ *  header to the tlast beat. A TUSER beat during a capture restarts it.
+ *
+ *  As with the single channel design, DDS outputs can't be stalled:
+ *  m_axis_tready is not used.
+ *
+ *  @param NUM_CHANNELS: Generator channels
+ *  @param DATA_BITS: DDS output beat width ([Sine|Cosine] per lane)
+ */
+module dds_capture_combiner #(parameter NUM_CHANNELS = 2, parameter DATA_BITS = 32)(
+    input clk_i,
+    input resetn_i,
+    /* Packed DDS outputs, channel n in [n*DATA_BITS +: DATA_BITS] */
+    input [NUM_CHANNELS*DATA_BITS-1:0] s_axis_tdata,
+    input [NUM_CHANNELS-1:0] s_axis_tvalid,
+    input [NUM_CHANNELS-1:0] s_axis_tlast,
+    input [NUM_CHANNELS-1:0] s_axis_tuser,
+    /* Capture start timestamp, from channel 0 modulator */
+    input [63:0] capture_ts_i,
+    /* AXI-Stream to DMA */
+    output logic [NUM_CHANNELS*DATA_BITS-1:0] m_axis_tdata,
+    output logic m_axis_tvalid,
+    output logic m_axis_tlast,
+    input m_axis_tready
+    );
+
+    localparam WIDTH = NUM_CHANNELS * DATA_BITS;
+    localparam HEADER_BEATS = (64 + WIDTH - 1) / WIDTH;
+
+    /* Joined beat: lanes of channels not running zeroed */
+    logic [WIDTH-1:0] beat_data;
+    always_comb
+        for (int n = 0; n < NUM_CHANNELS; n++)
+            beat_data[n*DATA_BITS +: DATA_BITS] = s_axis_tvalid[n] ? s_axis_tdata[n*DATA_BITS +: DATA_BITS] : '0;
+
+    logic capture_start;
+    assign capture_start = |(s_axis_tvalid & s_axis_tuser);
+
+    /* Delay line, beats wait here while the header goes out */
+    logic [WIDTH-1:0] delay_data [HEADER_BEATS];
+    logic [HEADER_BEATS-1:0] delay_valid, delay_last;
+
+    logic [HEADER_BEATS*WIDTH-1:0] header_reg;
+    logic [$clog2(HEADER_BEATS+1)-1:0] header_left;
+    logic capturing;
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            for (int b = 0; b < HEADER_BEATS; b++)
+                delay_data[b] <= 0;
+            delay_valid <= 0;
+            delay_last <= 0;
+            header_reg <= 0;
+            header_left <= 0;
+            capturing <= 0;
+            m_axis_tdata <= 0;
+            m_axis_tvalid <= 0;
+            m_axis_tlast <= 0;
+        end
+        else
+        begin
+            delay_data[0] <= beat_data;
+            for (int b = 1; b < HEADER_BEATS; b++)
+                delay_data[b] <= delay_data[b-1];
+            delay_valid <= HEADER_BEATS'({delay_valid, |s_axis_tvalid});
+            delay_last <= HEADER_BEATS'({delay_last, |(s_axis_tvalid & s_axis_tlast)});
+
+            if (capture_start) begin
+                // First header beat, the rest follow
+                header_reg <= (HEADER_BEATS*WIDTH)'(capture_ts_i);
+                header_left <= HEADER_BEATS - 1;
+                capturing <= 1;
+                m_axis_tdata <= WIDTH'(capture_ts_i);
+                m_axis_tvalid <= 1;
+                m_axis_tlast <= 0;
+            end
+            else if (header_left != 0) begin
+                m_axis_tdata <= header_reg[(HEADER_BEATS - header_left)*WIDTH +: WIDTH];
+                m_axis_tvalid <= 1;
+                m_axis_tlast <= 0;
+                header_left <= header_left - 1;
+            end
+            else if (capturing) begin
+                m_axis_tdata <= delay_data[HEADER_BEATS-1];
+                m_axis_tvalid <= delay_valid[HEADER_BEATS-1];
+                m_axis_tlast <= delay_valid[HEADER_BEATS-1] & delay_last[HEADER_BEATS-1];
+                if (delay_valid[HEADER_BEATS-1] & delay_last[HEADER_BEATS-1])
+                    capturing <= 0;
+            end
+            else begin
+                m_axis_tdata <= 0;
+                m_axis_tvalid <= 0;
+                m_axis_tlast <= 0;
+            end
+        end
+    end
+
+endmodule
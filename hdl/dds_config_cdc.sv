@@ -0,0 +1,246 @@
+`timescale 1ns / 1ps
+/**
+ * @file dds_config_cdc.sv
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Clock domain crossing between the AXI-Lite register bank and the DDS clock
+ * domain (sequencer and modulator). Moves the config registers with a
+ * request/acknowledge handshake, so multi-bit values cross coherently.
+ */
+
+/**
+ *  The AXI side takes a snapshot of config_reg_0..6, toggles req and holds
+ *  the snapshot until ack comes back. The DDS side loads the snapshot when it
+ *  sees the toggle and answers with ack. Rounds run back to back, a register
+ *  write reaches the DDS domain in a few clocks of each side.
+ *
+ *  COMMIT_BIT and DEBUG_BIT are self-clearing, they also cross as events:
+ *      - Setting them in the register bank is flagged in the next snapshot,
+ *        the DDS side holds its own copy of the bit from there.
+ *      - The DDS side clears its copy on commit_done / dbg_tlast, and sends
+ *        the event back with the next ack, clearing the register bank bit.
+ *  Clearing them from AXI also clears the DDS copy. A snapshot taken before
+ *  the clear event came back can't set them again.
+ *
+ *  seq_status, the timestamps and the performance counters cross back with
+ *  each ack, the AXI side copy is a few clocks old.
+ */
+module dds_config_cdc
+    import dds_modulator_pkg::*;
+    (
+    /* Register bank (AXI) clock domain */
+    input axi_clk_i,
+    input axi_resetn_i,
+    input [31:0] config_reg_0_i,
+    input [31:0] config_reg_1_i,
+    input [31:0] config_reg_2_i,
+    input [31:0] config_reg_3_i,
+    input [31:0] config_reg_4_i,
+    input [31:0] config_reg_5_i,
+    input [31:0] config_reg_6_i,
+    /* Events back to register bank, one axi_clk_i pulse */
+    output commit_done_o,
+    output dbg_tlast_o,
+    output [31:0] seq_status_o,
+    output [TIMESTAMP_BITS-1:0] ts_now_o,
+    output [TIMESTAMP_BITS-1:0] ts_pulse_o,
+    output [TIMESTAMP_BITS-1:0] ts_commit_o,
+    output [TIMESTAMP_BITS-1:0] ts_capture_o,
+    output [PERF_COUNTERS*32-1:0] perf_o,
+
+    /* DDS clock domain */
+    input dds_clk_i,
+    input dds_resetn_i,
+    output [31:0] config_reg_0_o,
+    output [31:0] config_reg_1_o,
+    output [31:0] config_reg_2_o,
+    output [31:0] config_reg_3_o,
+    output [31:0] config_reg_4_o,
+    output [31:0] config_reg_5_o,
+    output [31:0] config_reg_6_o,
+    input commit_done_i,
+    input dbg_tlast_i,
+    input [31:0] seq_status_i,
+    input [TIMESTAMP_BITS-1:0] ts_now_i,
+    input [TIMESTAMP_BITS-1:0] ts_pulse_i,
+    input [TIMESTAMP_BITS-1:0] ts_commit_i,
+    input [TIMESTAMP_BITS-1:0] ts_capture_i,
+    input [PERF_COUNTERS*32-1:0] perf_i
+    );
+
+    localparam REGS = 7;
+    /* Timestamps: now, pulse, commit, capture */
+    localparam TIMESTAMPS = 4;
+
+    /* AXI side */
+    logic [31:0] snapshot [REGS];
+    logic snapshot_commit, snapshot_debug;
+    logic req_reg;
+    (* ASYNC_REG = "TRUE" *) logic [CDC_SYNC_STAGES-1:0] ack_sync;
+    logic ack_seen;
+
+    /* DDS side */
+    logic [31:0] dds_reg [REGS];
+    logic dds_commit, dds_debug;
+    (* ASYNC_REG = "TRUE" *) logic [CDC_SYNC_STAGES-1:0] req_sync;
+    logic ack_reg;
+    /* Ack payload */
+    logic [31:0] status_reg;
+    logic [TIMESTAMP_BITS-1:0] ts_reg [TIMESTAMPS];
+    logic [PERF_COUNTERS*32-1:0] perf_reg;
+    logic done_commit, done_tlast;
+
+    /*
+     * AXI side. A new round starts when the last one was acknowledged.
+     */
+    logic round_done;
+    assign round_done = (ack_sync[CDC_SYNC_STAGES-1] == req_reg) & (ack_seen != req_reg);
+
+    logic idle;
+    assign idle = (ack_sync[CDC_SYNC_STAGES-1] == req_reg);
+
+    /* Bits set since the last snapshot, flagged in the next one */
+    logic commit_q, debug_q;
+    logic commit_pending, debug_pending;
+    logic commit_set, debug_set;
+    assign commit_set = config_reg_0_i[COMMIT_BIT] & ~commit_q;
+    assign debug_set = config_reg_0_i[DEBUG_BIT] & ~debug_q;
+
+    logic commit_done_reg, dbg_tlast_reg;
+    logic [31:0] seq_status_reg;
+    logic [TIMESTAMP_BITS-1:0] ts_axi_reg [TIMESTAMPS];
+    logic [PERF_COUNTERS*32-1:0] perf_axi_reg;
+
+    always_ff @(posedge axi_clk_i)
+    begin
+        if (axi_resetn_i == 0) begin
+            for (int r = 0; r < REGS; r++)
+                snapshot[r] <= 0;
+            snapshot_commit <= 0;
+            snapshot_debug <= 0;
+            req_reg <= 0;
+            ack_sync <= 0;
+            ack_seen <= 0;
+            commit_q <= 0;
+            debug_q <= 0;
+            commit_pending <= 0;
+            debug_pending <= 0;
+            commit_done_reg <= 0;
+            dbg_tlast_reg <= 0;
+            seq_status_reg <= 0;
+            for (int t = 0; t < TIMESTAMPS; t++)
+                ts_axi_reg[t] <= 0;
+            perf_axi_reg <= 0;
+        end
+        else begin
+            ack_sync <= {ack_sync[CDC_SYNC_STAGES-2:0], ack_reg};
+            ack_seen <= ack_sync[CDC_SYNC_STAGES-1];
+            commit_q <= config_reg_0_i[COMMIT_BIT];
+            debug_q <= config_reg_0_i[DEBUG_BIT];
+
+            // Ack payload is stable once ack went through the synchronizer
+            commit_done_reg <= round_done & done_commit;
+            dbg_tlast_reg <= round_done & done_tlast;
+            if (round_done) begin
+                seq_status_reg <= status_reg;
+                for (int t = 0; t < TIMESTAMPS; t++)
+                    ts_axi_reg[t] <= ts_reg[t];
+                perf_axi_reg <= perf_reg;
+            end
+
+            if (idle) begin
+                snapshot[0] <= config_reg_0_i;
+                snapshot[1] <= config_reg_1_i;
+                snapshot[2] <= config_reg_2_i;
+                snapshot[3] <= config_reg_3_i;
+                snapshot[4] <= config_reg_4_i;
+                snapshot[5] <= config_reg_5_i;
+                snapshot[6] <= config_reg_6_i;
+                snapshot_commit <= commit_pending | commit_set;
+                snapshot_debug <= debug_pending | debug_set;
+                commit_pending <= 0;
+                debug_pending <= 0;
+                req_reg <= ~req_reg;
+            end
+            else begin
+                commit_pending <= commit_pending | commit_set;
+                debug_pending <= debug_pending | debug_set;
+            end
+        end
+    end
+
+    assign commit_done_o = commit_done_reg;
+    assign dbg_tlast_o = dbg_tlast_reg;
+    assign seq_status_o = seq_status_reg;
+    assign ts_now_o = ts_axi_reg[0];
+    assign ts_pulse_o = ts_axi_reg[1];
+    assign ts_commit_o = ts_axi_reg[2];
+    assign ts_capture_o = ts_axi_reg[3];
+    assign perf_o = perf_axi_reg;
+
+    /*
+     * DDS side. Snapshot is stable while req differs from ack.
+     */
+    logic req_edge;
+    assign req_edge = (req_sync[CDC_SYNC_STAGES-1] != ack_reg);
+
+    /* Events since the last ack, sent with the next one */
+    logic commit_done_pending, dbg_tlast_pending;
+
+    always_ff @(posedge dds_clk_i)
+    begin
+        if (dds_resetn_i == 0) begin
+            for (int r = 0; r < REGS; r++)
+                dds_reg[r] <= 0;
+            dds_commit <= 0;
+            dds_debug <= 0;
+            req_sync <= 0;
+            ack_reg <= 0;
+            status_reg <= 0;
+            for (int t = 0; t < TIMESTAMPS; t++)
+                ts_reg[t] <= 0;
+            perf_reg <= 0;
+            done_commit <= 0;
+            done_tlast <= 0;
+            commit_done_pending <= 0;
+            dbg_tlast_pending <= 0;
+        end
+        else begin
+            req_sync <= {req_sync[CDC_SYNC_STAGES-2:0], req_reg};
+
+            if (req_edge) begin
+                for (int r = 0; r < REGS; r++)
+                    dds_reg[r] <= snapshot[r];
+                dds_commit <= ((dds_commit & ~commit_done_i) | snapshot_commit) & snapshot[0][COMMIT_BIT];
+                dds_debug <= ((dds_debug & ~dbg_tlast_i) | snapshot_debug) & snapshot[0][DEBUG_BIT];
+                status_reg <= seq_status_i;
+                ts_reg[0] <= ts_now_i;
+                ts_reg[1] <= ts_pulse_i;
+                ts_reg[2] <= ts_commit_i;
+                ts_reg[3] <= ts_capture_i;
+                perf_reg <= perf_i;
+                done_commit <= commit_done_pending | commit_done_i;
+                done_tlast <= dbg_tlast_pending | dbg_tlast_i;
+                commit_done_pending <= 0;
+                dbg_tlast_pending <= 0;
+                ack_reg <= req_sync[CDC_SYNC_STAGES-1];
+            end
+            else begin
+                dds_commit <= dds_commit & ~commit_done_i;
+                dds_debug <= dds_debug & ~dbg_tlast_i;
+                commit_done_pending <= commit_done_pending | commit_done_i;
+                dbg_tlast_pending <= dbg_tlast_pending | dbg_tlast_i;
+            end
+        end
+    end
+
+    assign config_reg_0_o = (dds_reg[0] & ~((32'b1 << COMMIT_BIT) | (32'b1 << DEBUG_BIT))) |
+                            (dds_commit << COMMIT_BIT) | (dds_debug << DEBUG_BIT);
+    assign config_reg_1_o = dds_reg[1];
+    assign config_reg_2_o = dds_reg[2];
+    assign config_reg_3_o = dds_reg[3];
+    assign config_reg_4_o = dds_reg[4];
+    assign config_reg_5_o = dds_reg[5];
+    assign config_reg_6_o = dds_reg[6];
+
+endmodule
@@ -8,30 +8,119 @@
 
 
 /**
- *  @param PINC_BITS: Phase increment accumulator bits in DDS IP Core
+ *  @param PINC_BITS: Phase accumulator bits, see dds_polyphase
  *  @param PERIOD_COUNTER_BITS: Period Counter must count high enough to accomodate pulse length time
- *      Example @125MHz, 15 bit => Max pulse length = 262,136 us.
+ *      Example @200MHz, 16 bit => Max period = 327,675 us.
+ *  @param DDS_LANES: Samples per clock after dds_polyphase. Debug captures
+ *      are MAX_DEBUG_PACKETS samples, MAX_DEBUG_PACKETS / DDS_LANES beats.
+ *
+ *  Pipelining: mode decode and counter constants are registered when a
+ *  config is latched, the modulation counter expiration is computed one
+ *  clock ahead and the AXI-Stream output and DDS enable are registered.
+ *  Every output is delayed by the same OUTPUT_LATENCY clocks.
+ *
+ *  Armed state (ARM_BIT set, ENABLE_BIT clear): the DDS is kept running
+ *  on prime beats, tvalid low with the prime and resync bits set, so the
+ *  downstream pipeline is flushed and its phase accumulator held at 0
+ *  while no sample is produced. The period counter is held at 0, the
+ *  first pulse starts with the enable. Setting ENABLE_BIT is then a
+ *  single clock gate: the first beat follows it by OUTPUT_LATENCY clocks,
+ *  always with the same phase.
  */
-module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS = 30)(
+module dds_modulator #(parameter PERIOD_COUNTER_BITS = 16, parameter PINC_BITS = 30,
+                       parameter DDS_LANES = 1)(
     input clk_i,
     input resetn_i,
+    /* Table write ports clock, tables are read on clk_i */
+    input wr_clk_i,
     output dds_en_o,
-    /* AXI-Stream bus for DDS IP Core configuration */
+    /* AXI-Stream bus for DDS IP Core configuration,
+     * {6'b0, prime, resync, 2'b00, offset, 2'b00, pinc} */
     output [71:0] m_axis_modulation_tdata,
     output m_axis_modulation_tvalid,
     output m_axis_modulation_tlast,
+    /* First beat of a debug capture */
+    output m_axis_modulation_tuser,
     input m_axis_modulation_tready,
-    /* Configuration inputs from registers */
+    /* Configuration inputs from registers.
+     * config_reg_1..5 are staging values, see commit logic */
     input [31:0] config_reg_0,
     input [31:0] config_reg_1,
     input [31:0] config_reg_2,
     input [31:0] config_reg_3,
     input [31:0] config_reg_4,
-    input [31:0] config_reg_5
+    input [31:0] config_reg_5,
+    /* Staged config was latched, clears commit bit */
+    output commit_done_o,
+    /* Debug capture trigger shared by all channels (multi-channel designs) */
+    input capture_trig_i,
+    /* Timestamps, clk_i clocks since reset: free running counter and its
+     * value at the last pulse start, commit and capture start */
+    output [dds_modulator_pkg::TIMESTAMP_BITS - 1:0] ts_now_o,
+    output [dds_modulator_pkg::TIMESTAMP_BITS - 1:0] ts_pulse_o,
+    output [dds_modulator_pkg::TIMESTAMP_BITS - 1:0] ts_commit_o,
+    output [dds_modulator_pkg::TIMESTAMP_BITS - 1:0] ts_capture_o,
+    /* Performance counters, counter c in [c*32 +: 32] (PERF_* in package) */
+    output [dds_modulator_pkg::PERF_COUNTERS * 32 - 1:0] perf_o,
+    /* Trigger edges seen and missed (dds_trigger), counted in perf_o */
+    input trig_received_i,
+    input trig_missed_i,
+    /* Last clock of an enabled period, ends a triggered PRI (dds_trigger) */
+    output period_end_o,
+    /* Phase code table write port, from table loader */
+    input code_wr_en_i,
+    input [$clog2(dds_modulator_pkg::CODE_DEPTH) - 1:0] code_wr_addr_i,
+    input [31:0] code_wr_data_i,
+    /* PINC table write port, from table loader */
+    input pinc_wr_en_i,
+    input [$clog2(2 * dds_modulator_pkg::PINC_DEPTH) - 1:0] pinc_wr_addr_i,
+    input [31:0] pinc_wr_data_i,
+    /* Hop table write port, from table loader */
+    input hop_wr_en_i,
+    input [$clog2(2 * dds_modulator_pkg::HOP_DEPTH) - 1:0] hop_wr_addr_i,
+    input [31:0] hop_wr_data_i
     );
     
     import dds_modulator_pkg::*;
 
+    localparam CODE_ADDR_BITS = $clog2(CODE_DEPTH);
+    localparam PINC_ADDR_BITS = $clog2(PINC_DEPTH);
+    localparam DEBUG_PACKETS = MAX_DEBUG_PACKETS / DDS_LANES;
+    localparam HOP_ADDR_BITS = $clog2(HOP_DEPTH);
+
+    /* Clocks from counters to DDS configuration outputs */
+    localparam OUTPUT_LATENCY = 1;
+
+    /* Decoded config_reg_1 state */
+    typedef enum logic [2:0] {  MODE_NONE,
+                                MODE_CONT_NO_MOD,
+                                MODE_CONT_MOD_FREC,
+                                MODE_CONT_MOD_PHASE,
+                                MODE_PULS_NO_MOD,
+                                MODE_PULS_MOD_FREC,
+                                MODE_PULS_MOD_PHASE
+    } mode_e;
+
+    function automatic mode_e decode_mode(input logic [STATE_BITS-1:0] bits);
+        casez (bits)
+            CONT_NO_MOD:    return MODE_CONT_NO_MOD;
+            CONT_MOD_FREC:  return MODE_CONT_MOD_FREC;
+            CONT_MOD_PHASE: return MODE_CONT_MOD_PHASE;
+            PULS_NO_MOD:    return MODE_PULS_NO_MOD;
+            PULS_MOD_FREC:  return MODE_PULS_MOD_FREC;
+            PULS_MOD_PHASE: return MODE_PULS_MOD_PHASE;
+            default:        return MODE_NONE;
+        endcase
+    endfunction
+
+    /* Active copy of config registers 1 to 5, the one the
+     * modulator runs on. Loaded from staging registers on commit */
+    logic [31:0] active_reg_1;
+    logic [31:0] active_reg_2;
+    logic [31:0] active_reg_3;
+    logic [31:0] active_reg_4;
+    logic [31:0] active_reg_5;
+
     /* Re-synchronization signal to Stall DDS to a fixed
      * value. Used to restart DDS output value to a known state */
     logic resync;
@@ -41,51 +130,64 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
     assign modulator_en = config_reg_0[ENABLE_BIT];
 
     logic dbg_en;
-    assign dbg_en = config_reg_0[DEBUG_BIT];
+    assign dbg_en = config_reg_0[DEBUG_BIT] | capture_trig_i;
+
+    /* Armed: disabled with the DDS running on prime beats */
+    logic armed;
+    assign armed = config_reg_0[ARM_BIT] & ~modulator_en;
 
     /* Config register 1 signals */
     logic pulsed_mode;
-    assign pulsed_mode = config_reg_1[0];
+    assign pulsed_mode = active_reg_1[0];
 
     logic modulation_type;
-    assign modulation_type = config_reg_1[2];
+    assign modulation_type = active_reg_1[2];
     parameter FREQ_MODULATION = 1;
     parameter PHASE_MODULATION = 0;
-    
-    logic [STATE_BITS-1:0] state_bits;
-    assign  state_bits = config_reg_1[STATE_BITS-1:0];
+
+    /* Registered decode of active_reg_1 state bits */
+    mode_e active_mode;
+
+    logic code_table_en;
+    assign code_table_en = active_reg_1[CODE_TABLE_BIT];
+
+    logic pinc_table_en;
+    assign pinc_table_en = active_reg_1[PINC_TABLE_BIT];
+
+    logic hop_table_en;
+    assign hop_table_en = active_reg_1[HOP_TABLE_BIT];
 
     /* Config register 2 signals */
     logic [PERIOD_COUNTER_BITS-1:0] period; // For period length
     logic [PERIOD_COUNTER_BITS-1:0] tau; // For pulse length                         
     
-    assign period = config_reg_2[PERIOD_COUNTER_BITS-1:0];
-    assign tau = config_reg_2[PERIOD_COUNTER_BITS-1+16:16];
+    assign period = active_reg_2[PERIOD_COUNTER_BITS-1:0];
+    assign tau = active_reg_2[PERIOD_COUNTER_BITS-1+16:16];
 
     /* Config register 3 signals */
     logic [29:0] pinc, pinc_low;
 
-    assign pinc = config_reg_3[PINC_BITS-1:0];
-    assign pinc_low = config_reg_3[PINC_BITS-1:0];
+    assign pinc = active_reg_3[PINC_BITS-1:0];
+    assign pinc_low = active_reg_3[PINC_BITS-1:0];
 
     /* Config register 4 signals */
     logic [PINC_BITS-1:0] barker_subpulse_length;
     logic [PINC_BITS-1:0] pinc_high;
 
-    assign barker_subpulse_length = config_reg_4;
-    assign pinc_high = config_reg_4[PINC_BITS-1:0];
-
-    /* Config register 5 signals */
-    logic [31:0] delta_pinc, barker_seq;
+    assign barker_subpulse_length = active_reg_4;
+    assign pinc_high = active_reg_4[PINC_BITS-1:0];
 
-    assign delta_pinc = config_reg_5;
-    assign barker_seq = config_reg_5;
-
-    logic [3:0] barker_seq_num;
-    assign barker_seq_num = config_reg_5[31:28];
+    /* PINC table entry length */
+    logic [PINC_BITS-1:0] pinc_entry_length;
+    assign pinc_entry_length = active_reg_4[PINC_BITS-1:0];
 
+    /* Config register 5 signals (delta PINC, Barker length and
+     * code / table length are decoded on commit, see commit logic) */
     logic [12:0] barker_sequence;
-    assign barker_sequence = config_reg_5[12:0];
+    assign barker_sequence = active_reg_5[12:0];
+
+    /* Last chip in the phase code or last entry in the frequency law being played */
+    logic [15:0] active_chip_last;
 
     /* Output signal constructs */
     logic [29:0] tdata_pinc;
@@ -94,7 +196,7 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
     logic tlast;
 
     /* Signal to count the amount of debug samples thrown to the bus */
-    logic [$clog2(MAX_DEBUG_PACKETS):0] packet_counter;
+    logic [$clog2(DEBUG_PACKETS):0] packet_counter;
     
     /* Period counter for pulsed mode   */
     /*    ____                   ____   */
@@ -109,28 +211,220 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
     /**
      * Modulation counter for frequency modulated mode
      * and phase modulation mode (counts length of barker
-     * code subpulses)
+     * code subpulses). Next count and its stop compare are
+     * registered along with the count, see modulation counter logic
      */
-    logic [PINC_BITS-1:0] modulation_counter_reg, modulation_counter_next, modulation_counter_start, modulation_counter_stop;
+    logic [PINC_BITS-1:0] modulation_counter_reg, modulation_counter_next, modulation_counter_stop;
+    logic [PINC_BITS-1:0] modulation_counter_inc_reg, modulation_counter_inc_next;
+    logic modulation_counter_tc_reg, modulation_counter_tc_next;
     logic modulation_counter_en;
-    logic modulation_counter_counting_subpulse_length;     // Am I counting subpulse length? flag
-    
+
+    /* Modulation counter constants of the active config: start
+     * value, increment (1 when counting lengths, delta PINC in a
+     * ramp), start plus increment and start at or past stop */
+    logic [PINC_BITS-1:0] active_modulation_counter_start;
+    logic [PINC_BITS-1:0] active_modulation_counter_inc;
+    logic [PINC_BITS-1:0] active_modulation_counter_start_inc;
+    logic active_modulation_counter_start_tc;
+        
+
+    /**
+     * Chip counter for phase modulated mode. Barker sequence bit
+     * or code table address (from first chip) of the current chip.
+     * Counts PINC or hop table entries in frequency table modes
+     */
+    logic [CODE_ADDR_BITS-1:0] chip_counter_reg, chip_counter_next, chip_counter_d;
+    logic chip_counter_en;
+    logic chip_counter_run;
+    logic chip_counter_wrap;
+
+    /**
+     * Table read address, first chip (or entry) plus chip counter.
+     * Counted along with the chip counter so no adder sits in front
+     * of the BRAM address
+     */
+    logic [CODE_ADDR_BITS-1:0] table_addr_reg, table_addr_d;
 
     /**
-     * Barker subpulse counter for phase modulated mode
+     * Phase code table, simple dual port BRAM, written on wr_clk_i. Read address is
+     * the chip counter next value, so the registered read lines up
+     * with chip_counter_reg
      */
-    logic [3:0] barker_subpulse_counter_reg, barker_subpulse_counter_next;
-    logic barker_subpulse_counter_en;
+    logic [CODE_PHASE_BITS-1:0] code_mem [CODE_DEPTH];
+    logic [CODE_ADDR_BITS-1:0] code_rd_addr;
+    logic [CODE_PHASE_BITS-1:0] code_phase;
+    logic [PINC_BITS-1:0] code_offset;
+
+    always_ff @(posedge wr_clk_i)
+    begin
+        if (code_wr_en_i)
+            code_mem[code_wr_addr_i] <= code_wr_data_i[CODE_PHASE_BITS-1:0];
+    end
+
+    always_ff @(posedge clk_i)
+    begin
+        code_phase <= code_mem[code_rd_addr];
+    end
+
+    /* Chip phase to DDS phase offset, a turn is 2^PINC_BITS */
+    assign code_offset = {code_phase, {(PINC_BITS - CODE_PHASE_BITS){1'b0}}};
+
+    /**
+     * PINC table, simple dual port BRAMs for entry PINC and slope,
+     * read like the code table. Slope is accumulated over the entry
+     * for linear interpolation
+     */
+    logic [PINC_BITS-1:0] pinc_mem [PINC_DEPTH];
+    logic signed [31:0] slope_mem [PINC_DEPTH];
+    logic [PINC_ADDR_BITS-1:0] pinc_rd_addr;
+    logic [PINC_BITS-1:0] pinc_entry;
+    logic signed [31:0] pinc_slope, pinc_slope_q;
+    logic pinc_interp_first, pinc_interp_run;
+    logic signed [PINC_BITS+PINC_SLOPE_FRAC_BITS:0] pinc_interp_reg, pinc_interp_next;
+    logic signed [PINC_BITS-1:0] pinc_interp;
+    logic [PINC_BITS-1:0] pinc_table_pinc;
+
+    always_ff @(posedge wr_clk_i)
+    begin
+        if (pinc_wr_en_i & ~pinc_wr_addr_i[0])
+            pinc_mem[pinc_wr_addr_i[PINC_ADDR_BITS:1]] <= pinc_wr_data_i[PINC_BITS-1:0];
+        if (pinc_wr_en_i & pinc_wr_addr_i[0])
+            slope_mem[pinc_wr_addr_i[PINC_ADDR_BITS:1]] <= pinc_wr_data_i;
+    end
+
+    always_ff @(posedge clk_i)
+    begin
+        pinc_entry <= pinc_mem[pinc_rd_addr];
+        pinc_slope <= slope_mem[pinc_rd_addr];
+    end
+
+    /* Interpolation offset, slope fraction dropped. Wraps like the DDS accumulator */
+    assign pinc_interp = pinc_interp_reg >>> PINC_SLOPE_FRAC_BITS;
+    assign pinc_table_pinc = pinc_entry + pinc_interp;
+
+    /**
+     * Hop table, simple dual port BRAMs for dwell PINC and
+     * {phase, dwell length}, read like the code table. Dwell length
+     * is the modulation counter stop value, so the next dwell starts
+     * on the clock after the current one ends. Dwells are 2 clocks
+     * minimum: expiration is computed one clock ahead, before the
+     * next dwell length is read
+     */
+    logic [PINC_BITS-1:0] hop_pinc_mem [HOP_DEPTH];
+    logic [31:0] hop_dwell_mem [HOP_DEPTH];
+    logic [HOP_ADDR_BITS-1:0] hop_rd_addr;
+    logic [PINC_BITS-1:0] hop_pinc;
+    logic [31:0] hop_dwell_word;
+    logic [PINC_BITS-1:0] hop_dwell_length;
+    logic [PINC_BITS-1:0] hop_offset;
+
+    always_ff @(posedge wr_clk_i)
+    begin
+        if (hop_wr_en_i & ~hop_wr_addr_i[0])
+            hop_pinc_mem[hop_wr_addr_i[HOP_ADDR_BITS:1]] <= hop_wr_data_i[PINC_BITS-1:0];
+        if (hop_wr_en_i & hop_wr_addr_i[0])
+            hop_dwell_mem[hop_wr_addr_i[HOP_ADDR_BITS:1]] <= hop_wr_data_i;
+    end
+
+    always_ff @(posedge clk_i)
+    begin
+        hop_pinc <= hop_pinc_mem[hop_rd_addr];
+        hop_dwell_word <= hop_dwell_mem[hop_rd_addr];
+    end
+
+    assign hop_dwell_length = hop_dwell_word[HOP_DWELL_BITS-1:0];
+    assign hop_offset = {hop_dwell_word[31 -: CODE_PHASE_BITS], {(PINC_BITS - CODE_PHASE_BITS){1'b0}}};
     
+    /**
+     * Commit logic
+     * Writing COMMIT_BIT requests the staged config. It is latched on
+     * the next period counter wrap, so no pulse is truncated, or right
+     * away in continuous mode. While disabled the active copy follows
+     * the staging registers and no commit is needed.
+     */
+    logic commit_req;
+    assign commit_req = config_reg_0[COMMIT_BIT];
+
+    logic continuous_mode;
+    assign continuous_mode = active_reg_1[0];
+
+    logic period_wrap;
+    logic commit_done;
+    assign commit_done = commit_req & (~modulator_en | continuous_mode | period_wrap);
+    assign commit_done_o = commit_done;
+
+    /* Active config is loaded from staging registers on next clock */
+    logic config_load;
+    assign config_load = ~modulator_en | commit_done;
+
+    /**
+     * Staged config decode. Precomputed from the staging registers,
+     * which are stable before a commit, and latched with them
+     */
+    logic staged_freq_mod, staged_ramp;
+    assign staged_freq_mod = config_reg_1[1] && config_reg_1[2] == FREQ_MODULATION;
+    assign staged_ramp = staged_freq_mod && !config_reg_1[PINC_TABLE_BIT] && !config_reg_1[HOP_TABLE_BIT];
+
+    logic staged_hop;
+    assign staged_hop = staged_freq_mod && !config_reg_1[PINC_TABLE_BIT] && config_reg_1[HOP_TABLE_BIT];
+
+    /* Modulation counter start value of the staged config, loaded on commit */
+    logic [PINC_BITS-1:0] staged_modulation_counter_start;
+    assign staged_modulation_counter_start = staged_ramp ? config_reg_3[PINC_BITS-1:0] : 0;
+
+    /* Ramp adds delta PINC, other modes count clocks */
+    logic [PINC_BITS-1:0] staged_modulation_counter_inc;
+    assign staged_modulation_counter_inc = staged_ramp ? config_reg_5[PINC_BITS-1:0] : 1;
+
+    logic [PINC_BITS-1:0] staged_modulation_counter_start_inc;
+    assign staged_modulation_counter_start_inc = staged_modulation_counter_start + staged_modulation_counter_inc;
+
+    /* Hop stop value is read from the table, dwells are 2 clocks minimum */
+    logic staged_modulation_counter_start_tc;
+    assign staged_modulation_counter_start_tc = ~staged_hop & (staged_modulation_counter_start >= config_reg_4[PINC_BITS-1:0]);
+
+    /* Chips in the phase code or entries in the frequency law */
+    logic [15:0] staged_chip_count;
+    assign staged_chip_count = (config_reg_1[CODE_TABLE_BIT] | config_reg_1[PINC_TABLE_BIT] | config_reg_1[HOP_TABLE_BIT]) ?
+                               config_reg_5[15:0] : config_reg_5[31:28];
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            active_reg_1 <= 0;
+            active_reg_2 <= 0;
+            active_reg_3 <= 0;
+            active_reg_4 <= 0;
+            active_reg_5 <= 0;
+            active_mode <= MODE_NONE;
+            active_modulation_counter_start <= 0;
+            active_modulation_counter_inc <= 0;
+            active_modulation_counter_start_inc <= 0;
+            active_modulation_counter_start_tc <= 0;
+            active_chip_last <= 0;
+        end
+        else if (config_load) begin
+            active_reg_1 <= config_reg_1;
+            active_reg_2 <= config_reg_2;
+            active_reg_3 <= config_reg_3;
+            active_reg_4 <= config_reg_4;
+            active_reg_5 <= config_reg_5;
+            active_mode <= decode_mode(config_reg_1[STATE_BITS-1:0]);
+            active_modulation_counter_start <= staged_modulation_counter_start;
+            active_modulation_counter_inc <= staged_modulation_counter_inc;
+            active_modulation_counter_start_inc <= staged_modulation_counter_start_inc;
+            active_modulation_counter_start_tc <= staged_modulation_counter_start_tc;
+            active_chip_last <= staged_chip_count - 1;
+        end
+    end
+
     /* State logic decoding */
     always_comb
     begin
         /* Default values */
         modulation_counter_en = 0;
-        modulation_counter_start = 0;
         modulation_counter_stop = 0;
-        modulation_counter_counting_subpulse_length = 0;
-        barker_subpulse_counter_en = 0;
+        chip_counter_en = 0;
         period_counter_en = 0;
         period_counter_stop = 0;
         pulse_length = 0;
@@ -138,8 +432,8 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
         tdata_pinc = 0;
         tvalid = 1;
 
-        casez(state_bits)
-            CONT_NO_MOD:
+        case (active_mode)
+            MODE_CONT_NO_MOD:
                 /* Continuous mode no modulation */
                 begin
                     modulation_counter_en = 0;
@@ -149,38 +443,56 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
                     tdata_pinc = pinc;
                 end
 
-            CONT_MOD_FREC:
+            MODE_CONT_MOD_FREC:
                 /* Continuous mode frequency modulated */
                 begin
-                    /* Modulation counter generates a linear PINC ramp */
-                    modulation_counter_en = 1;
-                    modulation_counter_start = pinc_low;
-                    modulation_counter_stop = pinc_high;
+                    if (pinc_table_en) begin
+                        /* Modulation counter counts each table entry length,
+                         * chip counter tells wich entry is valid */
+                        modulation_counter_en = 1;
+                        modulation_counter_stop = pinc_entry_length;
+                        chip_counter_en = 1;
+                        tdata_pinc = pinc_table_pinc;
+                        tdata_offset = 0;
+                    end
+                    else if (hop_table_en) begin
+                        /* Modulation counter counts each dwell length,
+                         * chip counter tells wich hop is valid */
+                        modulation_counter_en = 1;
+                        modulation_counter_stop = hop_dwell_length;
+                        chip_counter_en = 1;
+                        tdata_pinc = hop_pinc;
+                        tdata_offset = hop_offset;
+                    end
+                    else begin
+                        /* Modulation counter generates a linear PINC ramp */
+                        modulation_counter_en = 1;
+                        modulation_counter_stop = pinc_high;
+                        tdata_pinc = modulation_counter_reg;
+                        tdata_offset = 0;
+                    end
                     period_counter_en = 0;
-                    tdata_offset = 0;
-                    tdata_pinc = modulation_counter_reg;
                 end
 
-            CONT_MOD_PHASE:
+            MODE_CONT_MOD_PHASE:
                 /* Continuous mode phase modulated */
                 begin
                     /* Modulation counter counts each barker subpulse length*/
                     modulation_counter_en = 1;
-                    modulation_counter_start = 0;
                     modulation_counter_stop = barker_subpulse_length;
-                    modulation_counter_counting_subpulse_length = 1;
 
-                    /* Barker supulse counter tells wich barker bit is valid*/
-                    barker_subpulse_counter_en = 1;
-                    /* Phase offset is applied according to actual valid barker sequence bit */
-                    tdata_offset = (barker_sequence[barker_subpulse_counter_reg]) ? 0 : PHASE_OFFSET_180;
+                    /* Chip counter tells wich barker bit or code chip is valid*/
+                    chip_counter_en = 1;
+                    /* Phase offset is applied according to actual chip */
+                    tdata_offset = code_table_en ? code_offset :
+                                   (barker_sequence[chip_counter_reg]) ? 0 : PHASE_OFFSET_180;
                     /* Output constant PINC => Constant frequency */
                     tdata_pinc = pinc[29:0];
 
                     period_counter_en = 0;
                 end
 
-            PULS_NO_MOD:
+            MODE_PULS_NO_MOD:
                 /* Pulsed mode without modulation */
                 begin
                     /* Period counter counts pulse width and period */
@@ -193,23 +505,37 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
                     tdata_pinc = pinc[29:0];
                 end
             
-            PULS_MOD_FREC:
+            MODE_PULS_MOD_FREC:
                 /* Pulsed mode frequency modulated */
                 begin
                     /* Period counter counts pulse width and period */
                     period_counter_en = 1;
                     period_counter_stop = period;
                     pulse_length = tau;
-                    /* Modulation counter generates a linear PINC ramp */
                     modulation_counter_en = pulse_timeout_n;
-                    modulation_counter_start = pinc_low;
-                    modulation_counter_stop = pinc_high;
-
-                    tdata_offset = 0;
-                    tdata_pinc = modulation_counter_reg;
+                    if (pinc_table_en) begin
+                        /* Frequency law from PINC table, restarts every pulse */
+                        modulation_counter_stop = pinc_entry_length;
+                        chip_counter_en = pulse_timeout_n;
+                        tdata_pinc = pinc_table_pinc;
+                        tdata_offset = 0;
+                    end
+                    else if (hop_table_en) begin
+                        /* Hop pattern from hop table, restarts every pulse */
+                        modulation_counter_stop = hop_dwell_length;
+                        chip_counter_en = pulse_timeout_n;
+                        tdata_pinc = hop_pinc;
+                        tdata_offset = hop_offset;
+                    end
+                    else begin
+                        /* Modulation counter generates a linear PINC ramp */
+                        modulation_counter_stop = pinc_high;
+                        tdata_pinc = modulation_counter_reg;
+                        tdata_offset = 0;
+                    end
                 end
 
-            PULS_MOD_PHASE:
+            MODE_PULS_MOD_PHASE:
                 /* Pulsed mode phase modulated */
                 begin
                     /* Period counter counts pulse width and period */
@@ -217,18 +543,17 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
                     period_counter_stop = period;
                     pulse_length = tau;
                     
-                    /* Barker supulse counter tells wich barker bit is valid
+                    /* Chip counter tells wich barker bit or code chip is valid
                      * but gets disabled when pulse ends */
-                    barker_subpulse_counter_en = pulse_timeout_n;
+                    chip_counter_en = pulse_timeout_n;
 
                     /* Modulation counter counts each barker subpulse length*/
                     modulation_counter_en = pulse_timeout_n;
-                    modulation_counter_start = 0;
                     modulation_counter_stop = barker_subpulse_length;
-                    modulation_counter_counting_subpulse_length = 1;
 
-                    /* Phase offset is applied according to actual valid barker sequence bit */
-                    tdata_offset = (barker_sequence[barker_subpulse_counter_reg]) ? 0 : PHASE_OFFSET_180;
+                    /* Phase offset is applied according to actual chip */
+                    tdata_offset = code_table_en ? code_offset :
+                                   (barker_sequence[chip_counter_reg]) ? 0 : PHASE_OFFSET_180;
                     /* Output constant PINC => Constant frequency */
                     tdata_pinc = pinc[29:0];
                     
@@ -252,7 +577,7 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
 
     always_comb // Next count logic
     begin 
-        if (period_counter_reg == period_counter_stop) period_counter_next = 0; // Reset on max count
+        if ((period_counter_reg == period_counter_stop) | armed) period_counter_next = 0; // Reset on max count or while armed
         else
         begin
             if (modulator_en & period_counter_en) period_counter_next = period_counter_reg + 1;   // Increment if enabled
@@ -260,94 +585,177 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
         end
     end
     
+    assign period_wrap = period_counter_en & (period_counter_reg == period_counter_stop);
+    assign period_end_o = modulator_en & period_wrap;
+
     // Pulse timeout goes to zero when period counter exceeds pulse length
     assign pulse_timeout_n = pulsed_mode ? 1 : (period_counter_reg < pulse_length);
 
     /*
      * Modulation counter logic
+     * inc_reg holds the count plus its increment (the next count) and
+     * tc_reg tells the count is at or past the stop value, both computed
+     * a clock ahead so no adder or compare sits in the counter loop.
      */
 
     logic modulation_counter_expired;
-    
+
     always_ff @(posedge clk_i)
     begin
         if (resetn_i == 0) begin
-            modulation_counter_reg <= modulation_counter_start;
+            modulation_counter_reg <= 0;
+            modulation_counter_inc_reg <= 0;
+            modulation_counter_tc_reg <= 0;
         end
         else begin
             modulation_counter_reg <= modulation_counter_next;
+            modulation_counter_inc_reg <= modulation_counter_inc_next;
+            modulation_counter_tc_reg <= modulation_counter_tc_next;
         end
     end
 
+    // We've expired -> Tell barker subpulse counter
+    assign modulation_counter_expired = modulator_en & modulation_counter_en & modulation_counter_tc_reg & ~commit_done;
+
     always_comb
     begin
-        modulation_counter_expired = 0;        
-        if (modulator_en & modulation_counter_en) begin         
-            if (modulation_counter_reg >= modulation_counter_stop) begin    // Reset to start count on max count
-                modulation_counter_next = modulation_counter_start;
-                modulation_counter_expired = 1;                             // We've expired -> Tell barker subpulse counter
-            end
-            else begin
-                // Increment by 1 if counting barker subpulse length
-                // Otherwise increment by delta_pinc, we're modulating frequency
-                modulation_counter_next = modulation_counter_reg + (modulation_counter_counting_subpulse_length ? 1 : delta_pinc); 
-            end
-        end            
-        else    modulation_counter_next = modulation_counter_start;
+        if (config_load) begin
+            // New config starts its own modulation from the beginning
+            modulation_counter_next = staged_modulation_counter_start;
+            modulation_counter_inc_next = staged_modulation_counter_start_inc;
+            modulation_counter_tc_next = staged_modulation_counter_start_tc;
+        end
+        else if (modulation_counter_en & ~modulation_counter_tc_reg) begin
+            // Increment by 1 if counting barker subpulse length
+            // Otherwise increment by delta_pinc, we're modulating frequency
+            modulation_counter_next = modulation_counter_inc_reg;
+            modulation_counter_inc_next = modulation_counter_inc_reg + active_modulation_counter_inc;
+            modulation_counter_tc_next = (modulation_counter_inc_reg >= modulation_counter_stop);
+        end
+        else begin
+            // Reset to start count on max count, or hold it while disabled
+            modulation_counter_next = active_modulation_counter_start;
+            modulation_counter_inc_next = active_modulation_counter_start_inc;
+            modulation_counter_tc_next = active_modulation_counter_start_tc;
+        end
     end
 
     /*
-     * Barker subpulse counter logic
+     * Chip counter logic
      */
     
-    // Este contador se incrementa de a uno para saber en qué subpulso estoy (Va de 1 a 13 como máximo)
+    // Este contador se incrementa de a uno para saber en qué chip estoy (Barker: 13 como máximo)
     always_ff @(posedge clk_i)
     begin
         if (resetn_i == 0) begin
-            barker_subpulse_counter_reg <= 0;
+            chip_counter_reg <= 0;
+            table_addr_reg <= 0;
         end
         else begin
-            if (barker_subpulse_counter_en) begin
-                barker_subpulse_counter_reg <= barker_subpulse_counter_next;
-            end
-            else begin
-                barker_subpulse_counter_reg <= 0;
-            end
+            chip_counter_reg <= chip_counter_d;
+            table_addr_reg <= table_addr_d;
         end
     end
 
+    assign chip_counter_wrap = ({{(16 - CODE_ADDR_BITS){1'b0}}, chip_counter_reg} == active_chip_last);
+
     always_comb
     begin
-        if (modulation_counter_expired) begin         
-            if (barker_subpulse_counter_reg == barker_seq_num - 1) begin
-                barker_subpulse_counter_next = 0;
+        if (modulation_counter_expired) begin
+            if (chip_counter_wrap) begin
+                chip_counter_next = 0;
             end
             else begin
-                barker_subpulse_counter_next = barker_subpulse_counter_reg + 1;
+                chip_counter_next = chip_counter_reg + 1;
             end
         end
-        else    barker_subpulse_counter_next = barker_subpulse_counter_reg;
+        else    chip_counter_next = chip_counter_reg;
+    end
+
+    /* Counter value on next clock. New configs start from their first chip */
+    assign chip_counter_run = chip_counter_en & modulator_en & ~commit_done;
+    assign chip_counter_d = chip_counter_run ? chip_counter_next : 0;
+
+    /* First chip (or PINC / hop table entry) of the config active on next clock */
+    logic [CODE_ADDR_BITS-1:0] table_start, table_start_d;
+    assign table_start = active_reg_5[16 +: CODE_ADDR_BITS];
+    assign table_start_d = config_load ? config_reg_5[16 +: CODE_ADDR_BITS] : table_start;
+
+    /* Table address on next clock, always table_start_d + chip_counter_d */
+    always_comb
+    begin
+        if (~chip_counter_run)
+            table_addr_d = table_start_d;
+        else if (modulation_counter_expired)
+            table_addr_d = chip_counter_wrap ? table_start : table_addr_reg + 1;
+        else
+            table_addr_d = table_addr_reg;
+    end
+
+    assign code_rd_addr = table_addr_d;
+    assign pinc_rd_addr = table_addr_d[PINC_ADDR_BITS-1:0];
+    assign hop_rd_addr = table_addr_d[HOP_ADDR_BITS-1:0];
+
+    /*
+     * PINC table interpolation logic. Accumulated slope restarts
+     * with every entry, together with the modulation counter.
+     * The first clock of an entry takes the slope straight from the
+     * table, the next ones add a registered copy of it
+     */
+    assign pinc_interp_run = chip_counter_run & ~modulation_counter_expired;
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            pinc_interp_reg <= 0;
+            pinc_interp_first <= 1;
+        end
+        else begin
+            pinc_interp_reg <= pinc_interp_next;
+            pinc_interp_first <= ~pinc_interp_run;
+        end
+    end
+
+    always_ff @(posedge clk_i)
+    begin
+        pinc_slope_q <= pinc_slope;
+    end
+
+    always_comb
+    begin
+        if (pinc_interp_run)
+            pinc_interp_next = pinc_interp_first ? pinc_slope : pinc_interp_reg + pinc_slope_q;
+        else
+            pinc_interp_next = 0;
     end
 
     // Envío una señal de resync al terminar un ciclo del pulso (Hubo timeout_n)
     assign resync = ~pulse_timeout_n & modulator_en;     
     
-    // DDS is enabled whenever this modulator is enabled
-    assign dds_en_o = modulator_en;     
+    // DDS is enabled whenever this modulator is enabled or armed
+    logic dds_en_q;
 
     // AXI-Stream TLAST Circuit
+    // One capture per debug request: after the last sample counting
+    // stops until the debug bit is cleared
+    logic capture_done;
+    logic capture_run;
+    assign capture_run = m_axis_modulation_tready & modulator_en & dbg_en & ~capture_done;
+
     always_ff @(posedge clk_i)
     begin
         if (resetn_i == 0) begin
             packet_counter <= 0;
+            capture_done <= 0;
         end
         else
         begin
-            if (m_axis_modulation_tready & modulator_en & dbg_en)
+            if (capture_run)
             begin
-                if (packet_counter == MAX_DEBUG_PACKETS - 1)
+                if (packet_counter == DEBUG_PACKETS - 1)
                 begin
                     packet_counter <= 0;
+                    capture_done <= 1;
                 end
                 else 
                 begin
@@ -358,14 +766,112 @@ module dds_modulator #(parameter PERIOD_COUNTER_BITS = 15, parameter PINC_BITS =
             begin
                 packet_counter <= 0;
             end
+            if (~dbg_en)
+                capture_done <= 0;
+        end
+    end
+
+    assign tlast = (capture_run && packet_counter == DEBUG_PACKETS - 1) ? 1 : 0;
+
+    // Capture start marks the first sample, TUSER through the DDS
+    // Compiler tells the capture combiner where to put the header
+    logic capture_start;
+    assign capture_start = capture_run & (packet_counter == 0);
+
+    /*
+     * Timestamps. Counter is free running from reset, every channel
+     * shares the DDS clock reset so they count the same
+     */
+    logic [TIMESTAMP_BITS-1:0] ts_now_reg, ts_pulse_reg, ts_commit_reg, ts_capture_reg;
+    logic pulse_start;
+    assign pulse_start = modulator_en & period_counter_en & (period_counter_reg == 0);
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            ts_now_reg <= 0;
+            ts_pulse_reg <= 0;
+            ts_commit_reg <= 0;
+            ts_capture_reg <= 0;
+        end
+        else begin
+            ts_now_reg <= ts_now_reg + 1;
+            if (pulse_start)
+                ts_pulse_reg <= ts_now_reg;
+            if (commit_done)
+                ts_commit_reg <= ts_now_reg;
+            if (capture_start)
+                ts_capture_reg <= ts_now_reg;
+        end
+    end
+
+    assign ts_now_o = ts_now_reg;
+    assign ts_pulse_o = ts_pulse_reg;
+    assign ts_commit_o = ts_commit_reg;
+    assign ts_capture_o = ts_capture_reg;
+
+    /*
+     * Performance counters, free running and wrapping: firmware takes
+     * the difference of two snapshots
+     */
+    logic [31:0] perf_reg [PERF_COUNTERS];
+    logic [PERF_COUNTERS-1:0] perf_event;
+    always_comb begin
+        perf_event[PERF_PULSES] = pulse_start;
+        perf_event[PERF_STALLS] = modulator_en & ~m_axis_modulation_tready;
+        perf_event[PERF_CAPTURE_BEATS] = capture_run;
+        perf_event[PERF_TLASTS] = tlast;
+        perf_event[PERF_COMMITS] = commit_done;
+        perf_event[PERF_TRIGGERS] = trig_received_i;
+        perf_event[PERF_TRIGGERS_MISSED] = trig_missed_i;
+    end
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            for (int c = 0; c < PERF_COUNTERS; c++)
+                perf_reg[c] <= 0;
+        end
+        else begin
+            for (int c = 0; c < PERF_COUNTERS; c++)
+                if (perf_event[c])
+                    perf_reg[c] <= perf_reg[c] + 1;
         end
     end
 
-    assign tlast = (packet_counter == MAX_DEBUG_PACKETS - 1) ? 1 : 0;
+    for (genvar c = 0; c < PERF_COUNTERS; c++)
+        assign perf_o[c*32 +: 32] = perf_reg[c];
+
+    // AXI-Stream master output construct, registered (OUTPUT_LATENCY)
+    logic [71:0] tdata_q;
+    logic tvalid_q;
+    logic tlast_q;
+    logic tuser_q;
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            tdata_q <= 0;
+            tvalid_q <= 0;
+            tlast_q <= 0;
+            tuser_q <= 0;
+            dds_en_q <= 0;
+        end
+        else begin
+            // Prime beat: phase accumulator to 0, no sample
+            tdata_q <= armed ? {6'b0,2'b11,64'b0} :
+                       {7'b0,resync,2'b00,tdata_offset,2'b00, resync ? 30'b0 : tdata_pinc};
+            tvalid_q <= tvalid & modulator_en;
+            tlast_q <= tlast;
+            tuser_q <= capture_start;
+            dds_en_q <= modulator_en | armed;
+        end
+    end
 
-    // AXI-Stream master output construct
-    assign m_axis_modulation_tdata = {7'b0,resync,2'b00,tdata_offset,2'b00, resync ? 30'b0 : tdata_pinc};
-    assign m_axis_modulation_tvalid = tvalid & modulator_en & m_axis_modulation_tready;
-    assign m_axis_modulation_tlast = tlast;
+    assign m_axis_modulation_tdata = tdata_q;
+    assign m_axis_modulation_tvalid = tvalid_q & m_axis_modulation_tready;
+    assign m_axis_modulation_tlast = tlast_q;
+    assign m_axis_modulation_tuser = tuser_q;
+    assign dds_en_o = dds_en_q;
 
 endmodule
\ No newline at end of file
@@ -8,11 +8,24 @@
 package dds_modulator_pkg;
 
 /* General params */
-parameter FCLK_MHZ = 125;
+parameter FCLK_MHZ = 125;       // DDS clock in testbenches. Hardware reports it in REG_8
 
 /* Bit position definitions for config_reg_0 */
 parameter ENABLE_BIT = 0;
 parameter DEBUG_BIT = 1;
+parameter COMMIT_BIT = 2;   // Latch staged config_reg_1..5, cleared by hw when done
+parameter SEQ_EN_BIT = 3;   // Run from waveform sequencer table
+parameter ARM_BIT = 4;      // While disabled, keep the DDS pipeline primed, see dds_modulator
+parameter TRIG_EN_BIT = 5;  // Triggered mode, trigger_i edges start the output, see dds_trigger
+parameter TRIG_EDGE_BIT = 6;        // [7:6] trigger edge, TRIG_EDGE_*
+parameter TRIG_TRAIN_BIT = 8;       // Trigger starts the train instead of one PRI
+parameter TRIG_HOLDOFF_BIT = 16;    // [31:16] clocks with edges ignored after a trigger
+
+/* Trigger edge select */
+parameter TRIG_EDGE_RISING = 2'd0;
+parameter TRIG_EDGE_FALLING = 2'd1;
+parameter TRIG_EDGE_BOTH = 2'd2;
+parameter TRIG_HOLDOFF_BITS = 16;
 
 /**
  * config_reg_1 parameters 
@@ -28,11 +41,17 @@ parameter PULS_MOD_PHASE =  3'b010;
 // Parameters used in testbenchs ('?' generates 'Z' values when applied to a signal)
 parameter PULS_NO_MOD_TB =     3'b000;
 parameter CONT_NO_MOD_TB =  3'b001;    
+/* Phase modulation from code table instead of Barker sequence bits */
+parameter CODE_TABLE_BIT = 3;
+/* Frequency modulation from PINC table instead of linear ramp */
+parameter PINC_TABLE_BIT = 4;
+/* Frequency hopping from hop table */
+parameter HOP_TABLE_BIT = 5;
 
 /**
  * config_reg_2 parameters 
  */
-parameter PERIOD_COUNTER_BITS = 15;
+parameter PERIOD_COUNTER_BITS = 16;   // 250 us periods up to 262 MHz DDS clock
 
 /**
  * config_reg_3,4,5 parameters 
@@ -55,8 +74,78 @@ parameter BARKER_13 = 13'b1111100110101;
  * to OFFSET configuration of DDS IP Core*/
 parameter PHASE_OFFSET_180 = 536870911;
 
+/**
+ * Phase code table (polyphase and user codes). Chip phase is a fraction
+ * of a turn, 2^CODE_PHASE_BITS = 360°. With CODE_TABLE_BIT set,
+ * config_reg_5 = {first chip [31:16], chips [15:0]}
+ */
+parameter CODE_DEPTH = 4096;
+parameter CODE_PHASE_BITS = 16;
+
+/**
+ * PINC table (frequency law). Entry is two words: PINC and a signed
+ * per-sample slope with PINC_SLOPE_FRAC_BITS fractional bits, added
+ * while the entry is played (0 holds the entry PINC). With
+ * PINC_TABLE_BIT set, config_reg_4 = entry length - 1 (clocks) and
+ * config_reg_5 = {first entry [31:16], entries [15:0]}
+ */
+parameter PINC_DEPTH = 2048;
+parameter PINC_SLOPE_FRAC_BITS = 8;
+
+/**
+ * Hop table (stepped frequency / hopping). Entry is two words: PINC and
+ * {phase offset [31:16] (CODE_PHASE_BITS), dwell length - 1 [15:0] (clocks,
+ * HOP_MIN_DWELL minimum)}.
+ * With HOP_TABLE_BIT set, config_reg_5 = {first entry [31:16], entries [15:0]}
+ */
+parameter HOP_DEPTH = 512;
+parameter HOP_DWELL_BITS = 16;
+parameter HOP_MIN_DWELL = 2;
+
+/**
+ * Waveform sequencer table
+ */
+parameter SEQ_DEPTH = 64;           // Table entries
+parameter SEQ_ENTRY_WORDS = 8;      // Words per entry, power of two
+parameter SEQ_REPEAT_WORD = 5;      // Entry word holding the repeat count
+parameter SEQ_TABLE_BASE = 'h800;   // AXI address of entry 0
+
+/**
+ * Table loader, DMA MM2S stream. First word of each packet is a header:
+ * [31:28] table, [27:24] channel, [15:0] first word written.
+ * Following words are written to consecutive addresses until TLAST.
+ */
+parameter TABLE_SEQUENCER = 4'd0;   // Sequencer table, word address as in the AXI map
+parameter TABLE_CODE = 4'd1;        // Phase code table, one chip per word
+parameter TABLE_PINC = 4'd2;        // PINC table, word address = entry * 2 + {0: PINC, 1: slope}
+parameter TABLE_HOP = 4'd3;         // Hop table, word address = entry * 2 + {0: PINC, 1: phase/dwell}
+parameter TABLE_CHANNEL_ALL = 4'hF; // Header channel value selecting every channel
+
+/**
+ * Clock domain crossing, register bank (AXI clock) to sequencer and
+ * modulator (DDS clock), see dds_config_cdc
+ */
+parameter CDC_SYNC_STAGES = 2;      // Synchronizer flip-flops, 2 or more
+
 /* This value represents the maximum samples that will be retrieved through DMA */
 parameter MAX_DEBUG_PACKETS = 125000;
 
+/* Timestamp counter bits (DDS clocks). Captures start with a header
+ * carrying the capture timestamp, see dds_capture_combiner */
+parameter TIMESTAMP_BITS = 64;
+
+/**
+ * Performance counters, 32 bit, wrap around. DDS side counters are
+ * packed in perf_o[PERF_* * 32 +: 32] of dds_modulator
+ */
+parameter PERF_PULSES = 0;          // Pulses started
+parameter PERF_STALLS = 1;          // Clocks enabled with tready low (DDS backpressure)
+parameter PERF_CAPTURE_BEATS = 2;   // Capture beats sent to the DDS
+parameter PERF_TLASTS = 3;          // Captures ended (tlast)
+parameter PERF_COMMITS = 4;         // Staged configs latched
+parameter PERF_TRIGGERS = 5;        // Trigger edges seen in triggered mode
+parameter PERF_TRIGGERS_MISSED = 6; // Trigger edges while running or in holdoff
+parameter PERF_COUNTERS = 7;
+
 
 endpackage
\ No newline at end of file
@@ -0,0 +1,129 @@
+`timescale 1ns / 1ps
+/**
+ * @file dds_polyphase.sv
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Polyphase phase generator. Turns the modulator {resync, offset, PINC}
+ * stream into LANES phases per clock, one per DDS Compiler (SIN/COS LUT
+ * only), for a sample rate of LANES times the clock.
+ */
+
+/**
+ *  Lane k of clock n is output sample n*LANES + k. Its phase is the one a
+ *  single accumulator at the sample rate would have:
+ *
+ *      phase[n][k] = acc[n] + k * PINC + offset
+ *      acc[n + 1]  = acc[n] + LANES * PINC
+ *
+ *  acc[n] is 0 on a beat with resync set.
+ *
+ *  Prime beats (tvalid low, prime set) are taken as valid ones but give
+ *  no sample: the armed modulator sends them with resync set and PINC 0,
+ *  so the pipeline is flushed and the first valid beat starts from
+ *  acc = 0, LATENCY clocks after it comes in.
+ *
+ *  PINC and offset are per clock, so chirp steps and phase code chips are
+ *  LANES samples long. PINC is referred to the sample rate.
+ *
+ *  Runs while en_i is set, same as the DDS Compiler ACLKEN, so the
+ *  pipeline freezes with the LUTs. Phases are truncated to PHASE_OUT_BITS.
+ *
+ *  @param LANES: Samples per clock
+ *  @param PINC_BITS: Phase accumulator bits
+ *  @param PHASE_OUT_BITS: Phase bits to each LUT (DDS Compiler Phase_Width)
+ */
+module dds_polyphase #(parameter LANES = 1, parameter PINC_BITS = 30, parameter PHASE_OUT_BITS = 16)(
+    input clk_i,
+    input resetn_i,
+    input en_i,
+    /* Modulator stream: {6'b0, prime, resync, 2'b00, offset, 2'b00, pinc} */
+    input [71:0] s_axis_tdata,
+    input s_axis_tvalid,
+    input s_axis_tlast,
+    input s_axis_tuser,
+    /* Lane k phase in [k*PHASE_OUT_BITS +: PHASE_OUT_BITS] */
+    output [LANES*PHASE_OUT_BITS-1:0] m_axis_tdata,
+    output m_axis_tvalid,
+    output m_axis_tlast,
+    output m_axis_tuser
+    );
+
+    /* Clocks from input to output */
+    localparam LATENCY = 3;
+
+    logic [PINC_BITS-1:0] pinc;
+    logic [PINC_BITS-1:0] offset;
+    logic resync;
+    logic prime;
+    assign pinc = s_axis_tdata[PINC_BITS-1:0];
+    assign offset = s_axis_tdata[32 +: PINC_BITS];
+    assign resync = s_axis_tdata[64];
+    assign prime = s_axis_tdata[65];
+
+    /* Beat loaded into stage 1 */
+    logic load;
+    assign load = s_axis_tvalid | prime;
+
+    /* Stage 1: input registered */
+    logic [PINC_BITS-1:0] pinc_q, offset_q;
+    logic resync_q;
+    /* Stage 2: accumulator and lane steps */
+    logic [PINC_BITS-1:0] acc_reg, base_reg;
+    logic [PINC_BITS-1:0] lane_step [LANES];
+    /* Stage 3: lane phases */
+    logic [PHASE_OUT_BITS-1:0] phase_reg [LANES];
+    logic [LATENCY-1:0] tvalid_pipe, tlast_pipe, tuser_pipe;
+
+    logic [PINC_BITS-1:0] acc_start;
+    assign acc_start = resync_q ? '0 : acc_reg;
+
+    logic [PINC_BITS-1:0] lane_phase [LANES];
+    always_comb
+        for (int k = 0; k < LANES; k++)
+            lane_phase[k] = base_reg + lane_step[k];
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            pinc_q <= 0;
+            offset_q <= 0;
+            resync_q <= 0;
+            acc_reg <= 0;
+            base_reg <= 0;
+            for (int k = 0; k < LANES; k++) begin
+                lane_step[k] <= 0;
+                phase_reg[k] <= 0;
+            end
+            tvalid_pipe <= 0;
+            tlast_pipe <= 0;
+            tuser_pipe <= 0;
+        end
+        else if (en_i) begin
+            // Stage 1, config holds between valid and prime beats
+            if (load) begin
+                pinc_q <= pinc;
+                offset_q <= offset;
+            end
+            resync_q <= load & resync;
+            // Stage 2
+            base_reg <= acc_start;
+            acc_reg <= acc_start + PINC_BITS'(LANES) * pinc_q;
+            for (int k = 0; k < LANES; k++)
+                lane_step[k] <= PINC_BITS'(k) * pinc_q + offset_q;
+            // Stage 3
+            for (int k = 0; k < LANES; k++)
+                phase_reg[k] <= lane_phase[k][PINC_BITS-1 -: PHASE_OUT_BITS];
+            tvalid_pipe <= {tvalid_pipe[LATENCY-2:0], s_axis_tvalid};
+            tlast_pipe <= {tlast_pipe[LATENCY-2:0], s_axis_tlast};
+            tuser_pipe <= {tuser_pipe[LATENCY-2:0], s_axis_tuser};
+        end
+    end
+
+    for (genvar k = 0; k < LANES; k++)
+        assign m_axis_tdata[k*PHASE_OUT_BITS +: PHASE_OUT_BITS] = phase_reg[k];
+
+    assign m_axis_tvalid = tvalid_pipe[LATENCY-1];
+    assign m_axis_tlast = tlast_pipe[LATENCY-1];
+    assign m_axis_tuser = tuser_pipe[LATENCY-1];
+
+endmodule
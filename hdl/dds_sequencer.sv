@@ -0,0 +1,178 @@
+`timescale 1ns / 1ps
+/**
+ * @file dds_sequencer.sv
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Pulse to pulse waveform sequencer. Walks a BRAM table of register images,
+ * feeding them to the modulator staging inputs and committing one entry
+ * per period, with no CPU in the loop.
+ */
+
+/**
+ *  Table entry layout (SEQ_ENTRY_WORDS words):
+ *      word 0..4: config_reg_1..5 images
+ *      word 5: repeat count (periods the entry is played, 0 is played once)
+ *
+ *  When SEQ_EN_BIT is clear, registers pass through unchanged.
+ */
+module dds_sequencer
+    import dds_modulator_pkg::*;
+    (
+    input clk_i,
+    input resetn_i,
+    /* Table write port clock, table is read on clk_i */
+    input wr_clk_i,
+    /* Configuration inputs from registers */
+    input [31:0] config_reg_0,
+    input [31:0] config_reg_1,
+    input [31:0] config_reg_2,
+    input [31:0] config_reg_3,
+    input [31:0] config_reg_4,
+    input [31:0] config_reg_5,
+    /* Number of table entries to play */
+    input [31:0] seq_length_i,
+    /* Table write port, from AXI register bank (wr_clk_i) */
+    input table_wr_en_i,
+    input [$clog2(SEQ_DEPTH * SEQ_ENTRY_WORDS) - 1:0] table_wr_addr_i,
+    input [31:0] table_wr_data_i,
+    input [3:0] table_wr_strb_i,
+    /* Registers to modulator */
+    output [31:0] mod_reg_0,
+    output [31:0] mod_reg_1,
+    output [31:0] mod_reg_2,
+    output [31:0] mod_reg_3,
+    output [31:0] mod_reg_4,
+    output [31:0] mod_reg_5,
+    /* Staged entry latched by modulator */
+    input commit_done_i,
+    /* Entry being played */
+    output [$clog2(SEQ_DEPTH) - 1:0] seq_index_o
+    );
+
+    localparam INDEX_BITS = $clog2(SEQ_DEPTH);
+    localparam WORD_BITS = $clog2(SEQ_ENTRY_WORDS);
+
+    /* Sequencer FSM States */
+    typedef enum logic [1:0] {  SEQ_IDLE_S,
+                                SEQ_FETCH_S,
+                                SEQ_READY_S
+    } seq_state_e;
+
+    seq_state_e state_reg;
+
+    logic seq_en;
+    assign seq_en = config_reg_0[SEQ_EN_BIT];
+
+    /* Waveform table, simple dual port BRAM with byte write enables */
+    logic [31:0] table_mem [SEQ_DEPTH * SEQ_ENTRY_WORDS];
+    logic [INDEX_BITS + WORD_BITS - 1:0] rd_addr;
+    logic [31:0] rd_data;
+
+    always_ff @(posedge wr_clk_i)
+    begin
+        for (int b = 0; b < 4; b++)
+        begin
+            if (table_wr_en_i && table_wr_strb_i[b])
+                table_mem[table_wr_addr_i][8*b +: 8] <= table_wr_data_i[8*b +: 8];
+        end
+    end
+
+    always_ff @(posedge clk_i)
+    begin
+        rd_data <= table_mem[rd_addr];
+    end
+
+    /* Staged entry */
+    logic [31:0] entry_reg [SEQ_REPEAT_WORD + 1];
+    logic [INDEX_BITS - 1:0] index_reg;
+    logic [31:0] plays_reg;
+    /* Word being fetched, read data is one cycle behind */
+    logic [WORD_BITS:0] fetch_word;
+
+    assign rd_addr = {index_reg, fetch_word[WORD_BITS - 1:0]};
+
+    /* First entry was fetched, modulator can be enabled */
+    logic primed;
+
+    /* Modulator enable seen by the modulator, delayed until primed */
+    logic mod_en, mod_en_d;
+    assign mod_en = config_reg_0[ENABLE_BIT] & (~seq_en | primed);
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) mod_en_d <= 0;
+        else mod_en_d <= mod_en;
+    end
+
+    /**
+     * Staged entry is played once per commit. The first entry is already
+     * active when the modulator gets enabled, that counts as its first play.
+     */
+    logic entry_played;
+    assign entry_played = (state_reg == SEQ_READY_S) & mod_en & ((commit_done_i & mod_en_d) | ~mod_en_d);
+
+    logic [31:0] repeat_count;
+    assign repeat_count = entry_reg[SEQ_REPEAT_WORD];
+
+    logic [31:0] length;
+    assign length = (seq_length_i == 0) ? 1 : seq_length_i;
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0 || !seq_en || !config_reg_0[ENABLE_BIT]) begin
+            state_reg <= SEQ_IDLE_S;
+            index_reg <= 0;
+            plays_reg <= 0;
+            fetch_word <= 0;
+            primed <= 0;
+        end
+        else begin
+            case (state_reg)
+                SEQ_IDLE_S:
+                begin
+                    fetch_word <= 0;
+                    state_reg <= SEQ_FETCH_S;
+                end
+                SEQ_FETCH_S:
+                begin
+                    if (fetch_word != 0)
+                        entry_reg[fetch_word - 1] <= rd_data;
+                    if (fetch_word == SEQ_REPEAT_WORD + 1) begin
+                        state_reg <= SEQ_READY_S;
+                        primed <= 1;
+                    end
+                    else
+                        fetch_word <= fetch_word + 1;
+                end
+                SEQ_READY_S:
+                begin
+                    if (entry_played) begin
+                        if (plays_reg + 1 >= repeat_count) begin
+                            // Go to next entry, wrap at sequence end
+                            plays_reg <= 0;
+                            index_reg <= (index_reg + 1 >= length) ? 0 : index_reg + 1;
+                            fetch_word <= 0;
+                            state_reg <= SEQ_FETCH_S;
+                        end
+                        else
+                            plays_reg <= plays_reg + 1;
+                    end
+                end
+                default:
+                    state_reg <= SEQ_IDLE_S;
+            endcase
+        end
+    end
+
+    /* Next entry is committed while ready, modulator latches it at the period wrap */
+    assign mod_reg_0 = seq_en ? ((config_reg_0 & ~(32'b1 << ENABLE_BIT)) | (mod_en << ENABLE_BIT) |
+                                 ((state_reg == SEQ_READY_S) << COMMIT_BIT)) : config_reg_0;
+    assign mod_reg_1 = seq_en ? entry_reg[0] : config_reg_1;
+    assign mod_reg_2 = seq_en ? entry_reg[1] : config_reg_2;
+    assign mod_reg_3 = seq_en ? entry_reg[2] : config_reg_3;
+    assign mod_reg_4 = seq_en ? entry_reg[3] : config_reg_4;
+    assign mod_reg_5 = seq_en ? entry_reg[4] : config_reg_5;
+
+    assign seq_index_o = index_reg;
+
+endmodule
@@ -0,0 +1,119 @@
+`timescale 1ns / 1ps
+/**
+ * @file dds_table_loader.sv
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Table loader for DDS Modulator PL memories. Writes words streamed by the
+ * DMA MM2S channel, one per clock, instead of one AXI-Lite write each.
+ */
+
+/**
+ *  Packet format (see dds_modulator_pkg):
+ *      word 0: header {table[31:28], channel[27:24], 8'b0, address[15:0]}
+ *      word 1..n: data, written from address up. Last word has TLAST.
+ *
+ *  The stream is broadcast to every channel, packets for other channels
+ *  are consumed and ignored. Words past the end of the table are dropped.
+ *
+ *  The sequencer table write port is shared with the AXI-Lite register
+ *  bank. The loader has priority: AXI-Lite table writes during a load
+ *  are lost. Phase code, PINC and hop tables are only written from here.
+ *
+ *  @param CHANNEL: Generator channel index, matched against header
+ */
+module dds_table_loader
+    import dds_modulator_pkg::*;
+    #(parameter CHANNEL = 0)(
+    input clk_i,
+    input resetn_i,
+    /* AXI-Stream from DMA MM2S */
+    input [31:0] s_axis_table_tdata,
+    input s_axis_table_tvalid,
+    input s_axis_table_tlast,
+    output s_axis_table_tready,
+    /* Sequencer table writes from AXI-Lite register bank */
+    input axi_wr_en_i,
+    input [$clog2(SEQ_DEPTH * SEQ_ENTRY_WORDS) - 1:0] axi_wr_addr_i,
+    input [31:0] axi_wr_data_i,
+    input [3:0] axi_wr_strb_i,
+    /* Sequencer table write port */
+    output seq_wr_en_o,
+    output [$clog2(SEQ_DEPTH * SEQ_ENTRY_WORDS) - 1:0] seq_wr_addr_o,
+    output [31:0] seq_wr_data_o,
+    output [3:0] seq_wr_strb_o,
+    /* Phase code table write port */
+    output code_wr_en_o,
+    output [$clog2(CODE_DEPTH) - 1:0] code_wr_addr_o,
+    output [31:0] code_wr_data_o,
+    /* PINC table write port */
+    output pinc_wr_en_o,
+    output [$clog2(2 * PINC_DEPTH) - 1:0] pinc_wr_addr_o,
+    output [31:0] pinc_wr_data_o,
+    /* Hop table write port */
+    output hop_wr_en_o,
+    output [$clog2(2 * HOP_DEPTH) - 1:0] hop_wr_addr_o,
+    output [31:0] hop_wr_data_o
+    );
+
+    localparam SEQ_WORDS = SEQ_DEPTH * SEQ_ENTRY_WORDS;
+
+    /* Next word is data, header already received */
+    logic in_packet;
+    /* Header addressed this channel */
+    logic selected;
+    logic [3:0] table_reg;
+    logic [15:0] addr_reg;
+
+    /* Tables are BRAM, a word is written every clock */
+    assign s_axis_table_tready = 1'b1;
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            in_packet <= 0;
+            selected <= 0;
+            table_reg <= 0;
+            addr_reg <= 0;
+        end
+        else if (s_axis_table_tvalid)
+        begin
+            in_packet <= !s_axis_table_tlast;
+            if (!in_packet)
+            begin
+                selected <= (s_axis_table_tdata[27:24] == CHANNEL) || (s_axis_table_tdata[27:24] == TABLE_CHANNEL_ALL);
+                table_reg <= s_axis_table_tdata[31:28];
+                addr_reg <= s_axis_table_tdata[15:0];
+            end
+            else
+                addr_reg <= addr_reg + 1;
+        end
+    end
+
+    logic load_seq;
+    assign load_seq = s_axis_table_tvalid && in_packet && selected &&
+                      (table_reg == TABLE_SEQUENCER) && (addr_reg < SEQ_WORDS);
+
+    assign seq_wr_en_o = load_seq || axi_wr_en_i;
+    assign seq_wr_addr_o = load_seq ? addr_reg[$clog2(SEQ_WORDS) - 1:0] : axi_wr_addr_i;
+    assign seq_wr_data_o = load_seq ? s_axis_table_tdata : axi_wr_data_i;
+    assign seq_wr_strb_o = load_seq ? 4'hF : axi_wr_strb_i;
+
+    /* Code table is only written by the loader */
+    assign code_wr_en_o = s_axis_table_tvalid && in_packet && selected &&
+                          (table_reg == TABLE_CODE) && (addr_reg < CODE_DEPTH);
+    assign code_wr_addr_o = addr_reg[$clog2(CODE_DEPTH) - 1:0];
+    assign code_wr_data_o = s_axis_table_tdata;
+
+    /* PINC table, two words per entry */
+    assign pinc_wr_en_o = s_axis_table_tvalid && in_packet && selected &&
+                          (table_reg == TABLE_PINC) && (addr_reg < 2 * PINC_DEPTH);
+    assign pinc_wr_addr_o = addr_reg[$clog2(2 * PINC_DEPTH) - 1:0];
+    assign pinc_wr_data_o = s_axis_table_tdata;
+
+    /* Hop table, two words per entry */
+    assign hop_wr_en_o = s_axis_table_tvalid && in_packet && selected &&
+                         (table_reg == TABLE_HOP) && (addr_reg < 2 * HOP_DEPTH);
+    assign hop_wr_addr_o = addr_reg[$clog2(2 * HOP_DEPTH) - 1:0];
+    assign hop_wr_data_o = s_axis_table_tdata;
+
+endmodule
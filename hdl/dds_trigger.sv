@@ -0,0 +1,133 @@
+`timescale 1ns / 1ps
+/**
+ * @file dds_trigger.sv
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * External trigger input. Starts the modulator on a trigger edge instead of
+ * an ENABLE_BIT write, with a fixed latency from the trigger.
+ */
+
+/**
+ *  trigger_i is asynchronous (PMOD pin): it goes through CDC_SYNC_STAGES
+ *  flip-flops, then an edge detector (TRIG_EDGE_* in config_reg_0).
+ *  With SYNC = 0 trigger_i is already synchronous to clk_i, the
+ *  trigger_sync_o of another channel, so every channel sees the same
+ *  edge on the same clock.
+ *
+ *  Sits between dds_config_cdc and the sequencer. While TRIG_EN_BIT is set
+ *  an accepted edge sets ENABLE_BIT of config_reg_0_o, until:
+ *      - the end of the period (period_end_i), one PRI per trigger, or
+ *      - TRIG_EN_BIT is cleared, with TRIG_TRAIN_BIT set: the trigger
+ *        starts the configured train (or sequence).
+ *  In continuous modes there is no period end, the output runs until
+ *  TRIG_EN_BIT is cleared. ENABLE_BIT written over AXI still starts it.
+ *
+ *  An edge is accepted when the output is not running and the holdoff from
+ *  the last accepted edge (TRIG_HOLDOFF_BITS clocks) is over. Other edges
+ *  are missed. Edges are only looked at with TRIG_EN_BIT set.
+ *
+ *  Latency, counted from the clock edge that samples the trigger pin:
+ *  the edge is seen CDC_SYNC_STAGES clocks later, ENABLE_BIT is registered
+ *  and the modulator samples it on the next clock, START_LATENCY clock 1
+ *  (see mm2s_dds_modulator). With ARM_BIT set the first sample is
+ *      CDC_SYNC_STAGES + 1 + START_LATENCY
+ *  clocks from there, the pin itself adds up to one clock of jitter.
+ *  With SEQ_EN_BIT set the sequencer adds its first entry fetch.
+ *
+ *  One PRI per trigger does not work with the sequencer: ENABLE_BIT drops
+ *  at every period end, which sends it back to idle and entry 0, so each
+ *  trigger would replay the first entry. The driver refuses SEQ_EN_BIT
+ *  without TRIG_TRAIN_BIT (generator_ext_trigger_arm()).
+ */
+module dds_trigger
+    import dds_modulator_pkg::*;
+    #(parameter SYNC = 1)(
+    input clk_i,
+    input resetn_i,
+    /* Trigger, asynchronous with SYNC = 1 */
+    input trigger_i,
+    /* Synchronized trigger level, trigger_i of the other channels */
+    output trigger_sync_o,
+    /* config_reg_0 from dds_config_cdc, to the sequencer */
+    input [31:0] config_reg_0_i,
+    output [31:0] config_reg_0_o,
+    /* Last clock of an enabled period, from dds_modulator */
+    input period_end_i,
+    /* Edges seen and edges missed, one clock events */
+    output trig_received_o,
+    output trig_missed_o
+    );
+
+    logic trig_en, train, enable;
+    logic [1:0] edge_sel;
+    logic [TRIG_HOLDOFF_BITS-1:0] holdoff;
+    assign trig_en = config_reg_0_i[TRIG_EN_BIT];
+    assign train = config_reg_0_i[TRIG_TRAIN_BIT];
+    assign enable = config_reg_0_i[ENABLE_BIT];
+    assign edge_sel = config_reg_0_i[TRIG_EDGE_BIT +: 2];
+    assign holdoff = config_reg_0_i[TRIG_HOLDOFF_BIT +: TRIG_HOLDOFF_BITS];
+
+    /* Synchronizer and edge detector */
+    (* ASYNC_REG = "TRUE" *) logic [CDC_SYNC_STAGES-1:0] trigger_sync;
+    logic level, level_q;
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0)
+            trigger_sync <= 0;
+        else
+            trigger_sync <= {trigger_sync[CDC_SYNC_STAGES-2:0], trigger_i};
+    end
+
+    assign trigger_sync_o = trigger_sync[CDC_SYNC_STAGES-1];
+    assign level = SYNC ? trigger_sync[CDC_SYNC_STAGES-1] : trigger_i;
+
+    logic rising, falling, trig_edge;
+    assign rising = level & ~level_q;
+    assign falling = ~level & level_q;
+
+    always_comb
+    begin
+        case (edge_sel)
+            TRIG_EDGE_RISING: trig_edge = rising;
+            TRIG_EDGE_FALLING: trig_edge = falling;
+            default: trig_edge = rising | falling;
+        endcase
+    end
+
+    /* Triggered run and holdoff from the last accepted edge */
+    logic run_reg;
+    logic [TRIG_HOLDOFF_BITS-1:0] holdoff_reg;
+    logic received, accepted;
+    assign received = trig_en & trig_edge;
+    assign accepted = received & ~run_reg & ~enable & (holdoff_reg == 0);
+
+    always_ff @(posedge clk_i)
+    begin
+        if (resetn_i == 0) begin
+            level_q <= 0;
+            run_reg <= 0;
+            holdoff_reg <= 0;
+        end
+        else begin
+            level_q <= level;
+
+            if (!trig_en)
+                run_reg <= 0;
+            else if (accepted)
+                run_reg <= 1;
+            else if (period_end_i & ~train)
+                run_reg <= 0;
+
+            if (accepted)
+                holdoff_reg <= holdoff;
+            else if (holdoff_reg != 0)
+                holdoff_reg <= holdoff_reg - 1;
+        end
+    end
+
+    assign config_reg_0_o = config_reg_0_i | (run_reg << ENABLE_BIT);
+    assign trig_received_o = received;
+    assign trig_missed_o = received & ~accepted;
+
+endmodule
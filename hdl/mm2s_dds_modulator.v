@@ -7,10 +7,49 @@
  * Top Wrapper for modulator and register instances.
  */
 
-module mm2s_dds_modulator(
+/**
+ *  Two clock domains:
+ *      - S_AXI_CLK: register bank and table loader.
+ *      - DDS_CLK: sequencer and modulator, same clock as the DDS Compiler.
+ *  Config registers cross in dds_config_cdc. Tables are dual clock BRAMs,
+ *  written on S_AXI_CLK and read on DDS_CLK.
+ *
+ *  DDS_LANES samples per DDS_CLK: dds_polyphase turns the modulator stream
+ *  into one phase per lane, each lane drives a SIN/COS LUT only DDS Compiler.
+ *  MAX_DEBUG_PACKETS must be a multiple of DDS_LANES.
+ *
+ *  dds_en_o drives the DDS Compilers ACLKEN. With ARM_BIT set the pipeline
+ *  is primed while disabled, and the first sample after ENABLE_BIT reaches
+ *  the modulator comes out of the DDS Compilers
+ *      1 (modulator) + 3 (dds_polyphase) + DDS Compiler latency
+ *  DDS_CLK clocks later, from phase 0 in every start.
+ *
+ *  trigger_i starts the channel on a pin edge in triggered mode (TRIG_EN_BIT),
+ *  see dds_trigger. Channel 0 synchronizes the pin and drives the
+ *  trigger_i of the other channels (TRIGGER_SYNC = 0) from trigger_sync_o,
+ *  so every channel starts on the same DDS_CLK.
+ */
+
+module mm2s_dds_modulator #(
+    /* Channel index, selects table loader packets */
+    parameter CHANNEL = 0,
+    /* DDS_CLK frequency, read only in REG_8 */
+    parameter DDS_CLK_KHZ = 125000,
+    /* Samples per DDS_CLK, read only in REG_9 */
+    parameter DDS_LANES = 1,
+    /* trigger_i is an asynchronous pin, 0: synchronous to DDS_CLK */
+    parameter TRIGGER_SYNC = 1
+    )(
     /* AXI4-Lite Clock and reset signals */
+    (* X_INTERFACE_INFO = "xilinx.com:signal:clock:1.0 S_AXI_CLK CLK" *)
+    (* X_INTERFACE_PARAMETER = "ASSOCIATED_BUSIF S_AXI:s_axis_table, ASSOCIATED_RESET S_AXI_ARESETN" *)
     input wire          S_AXI_CLK,
     input wire          S_AXI_ARESETN,
+    /* DDS Clock and reset signals, sequencer and modulator */
+    (* X_INTERFACE_INFO = "xilinx.com:signal:clock:1.0 DDS_CLK CLK" *)
+    (* X_INTERFACE_PARAMETER = "ASSOCIATED_BUSIF m_axis_modulation, ASSOCIATED_RESET DDS_ARESETN" *)
+    input wire          DDS_CLK,
+    input wire          DDS_ARESETN,
 
     /* AXI4-lite slave signals */
     /* Write address signals */
@@ -38,11 +77,31 @@ module mm2s_dds_modulator(
 
     /* DDS Compiler Signals */
     output wire dds_en_o,
-    /* AXI4-Stream Master Signals */
-    output wire [71:0] m_axis_modulation_tdata,
+    /* AXI4-Stream Master Signals, lane k phase in tdata[16*k +: 16] */
+    output wire [16*DDS_LANES-1:0] m_axis_modulation_tdata,
     output wire m_axis_modulation_tvalid,
     output wire m_axis_modulation_tlast,
-    input wire m_axis_modulation_tready
+    /* First beat of a debug capture, lane 0 DDS Compiler TUSER */
+    output wire m_axis_modulation_tuser,
+    input wire m_axis_modulation_tready,
+
+    /* Multi-channel debug capture: channel 0 trigger is fanned out
+     * to every channel, so all of them are captured together (DDS_CLK) */
+    output wire capture_trig_o,
+    input wire capture_trig_i,
+    /* Capture start timestamp, header of the capture stream (DDS_CLK) */
+    output wire [63:0] capture_ts_o,
+
+    /* External trigger, PMOD pin on channel 0, trigger_sync_o of
+     * channel 0 on the others */
+    input wire trigger_i,
+    output wire trigger_sync_o,
+
+    /* AXI4-Stream Slave Signals, table loads from DMA MM2S */
+    input wire [31:0] s_axis_table_tdata,
+    input wire s_axis_table_tvalid,
+    input wire s_axis_table_tlast,
+    output wire s_axis_table_tready
 );
 
     wire [31:0] config_reg_0;
@@ -51,30 +110,247 @@ module mm2s_dds_modulator(
     wire [31:0] config_reg_3;
     wire [31:0] config_reg_4;
     wire [31:0] config_reg_5;
+    wire [31:0] config_reg_6;
+    wire commit_done;
+    wire dbg_tlast;
+    wire [31:0] seq_status;
+    /* Timestamps, DDS clock domain and register bank copies */
+    wire [63:0] dds_ts_now;
+    wire [63:0] dds_ts_pulse;
+    wire [63:0] dds_ts_commit;
+    wire [63:0] dds_ts_capture;
+    wire [63:0] ts_now;
+    wire [63:0] ts_pulse;
+    wire [63:0] ts_commit;
+    wire [63:0] ts_capture;
+    /* Performance counters (7 x 32 bit, PERF_* in dds_modulator_package.sv) */
+    wire [223:0] dds_perf;
+    wire [223:0] perf;
+
+    /* Registers in DDS clock domain */
+    wire [31:0] dds_reg_0;
+    wire [31:0] dds_reg_1;
+    wire [31:0] dds_reg_2;
+    wire [31:0] dds_reg_3;
+    wire [31:0] dds_reg_4;
+    wire [31:0] dds_reg_5;
+    wire [31:0] dds_reg_6;
+    wire dds_commit_done;
+    /* REG_0 with the triggered enable */
+    wire [31:0] trig_reg_0;
+    wire trig_received;
+    wire trig_missed;
+    wire period_end;
+
+    /* Registers after sequencer */
+    wire [31:0] mod_reg_0;
+    wire [31:0] mod_reg_1;
+    wire [31:0] mod_reg_2;
+    wire [31:0] mod_reg_3;
+    wire [31:0] mod_reg_4;
+    wire [31:0] mod_reg_5;
+
+    /* Sequencer table writes from AXI-Lite */
+    wire table_wr_en;
+    wire [8:0] table_wr_addr;
+    wire [31:0] table_wr_data;
+    wire [3:0] table_wr_strb;
+    /* Sequencer table write port, AXI-Lite or table loader */
+    wire seq_wr_en;
+    wire [8:0] seq_wr_addr;
+    wire [31:0] seq_wr_data;
+    wire [3:0] seq_wr_strb;
+    /* Phase code table write port, table loader */
+    wire code_wr_en;
+    wire [11:0] code_wr_addr;
+    wire [31:0] code_wr_data;
+    /* PINC table write port, table loader */
+    wire pinc_wr_en;
+    wire [11:0] pinc_wr_addr;
+    wire [31:0] pinc_wr_data;
+    /* Hop table write port, table loader */
+    wire hop_wr_en;
+    wire [9:0] hop_wr_addr;
+    wire [31:0] hop_wr_data;
+    wire [5:0] seq_index;
+    /* Modulator stream to polyphase phase generator */
+    wire [71:0] mod_tdata;
+    wire mod_tvalid;
+    wire mod_tlast;
+    wire mod_tuser;
+
+    dds_config_cdc config_cdc(
+        .axi_clk_i(S_AXI_CLK),
+        .axi_resetn_i(S_AXI_ARESETN),
+        .config_reg_0_i(config_reg_0),
+        .config_reg_1_i(config_reg_1),
+        .config_reg_2_i(config_reg_2),
+        .config_reg_3_i(config_reg_3),
+        .config_reg_4_i(config_reg_4),
+        .config_reg_5_i(config_reg_5),
+        .config_reg_6_i(config_reg_6),
+        .commit_done_o(commit_done),
+        .dbg_tlast_o(dbg_tlast),
+        .seq_status_o(seq_status),
+        .ts_now_o(ts_now),
+        .ts_pulse_o(ts_pulse),
+        .ts_commit_o(ts_commit),
+        .ts_capture_o(ts_capture),
+        .perf_o(perf),
+        .dds_clk_i(DDS_CLK),
+        .dds_resetn_i(DDS_ARESETN),
+        .config_reg_0_o(dds_reg_0),
+        .config_reg_1_o(dds_reg_1),
+        .config_reg_2_o(dds_reg_2),
+        .config_reg_3_o(dds_reg_3),
+        .config_reg_4_o(dds_reg_4),
+        .config_reg_5_o(dds_reg_5),
+        .config_reg_6_o(dds_reg_6),
+        .commit_done_i(dds_commit_done),
+        .dbg_tlast_i(mod_tlast),
+        .seq_status_i({26'b0, seq_index}),
+        .ts_now_i(dds_ts_now),
+        .ts_pulse_i(dds_ts_pulse),
+        .ts_commit_i(dds_ts_commit),
+        .ts_capture_i(dds_ts_capture),
+        .perf_i(dds_perf)
+    );
+
+    dds_trigger #(.SYNC(TRIGGER_SYNC)) trigger(
+        .clk_i(DDS_CLK),
+        .resetn_i(DDS_ARESETN),
+        .trigger_i(trigger_i),
+        .trigger_sync_o(trigger_sync_o),
+        .config_reg_0_i(dds_reg_0),
+        .config_reg_0_o(trig_reg_0),
+        .period_end_i(period_end),
+        .trig_received_o(trig_received),
+        .trig_missed_o(trig_missed)
+    );
+
+    dds_sequencer sequencer(
+        .clk_i(DDS_CLK),
+        .resetn_i(DDS_ARESETN),
+        .wr_clk_i(S_AXI_CLK),
+        .config_reg_0(trig_reg_0),
+        .config_reg_1(dds_reg_1),
+        .config_reg_2(dds_reg_2),
+        .config_reg_3(dds_reg_3),
+        .config_reg_4(dds_reg_4),
+        .config_reg_5(dds_reg_5),
+        .seq_length_i(dds_reg_6),
+        .table_wr_en_i(seq_wr_en),
+        .table_wr_addr_i(seq_wr_addr),
+        .table_wr_data_i(seq_wr_data),
+        .table_wr_strb_i(seq_wr_strb),
+        .mod_reg_0(mod_reg_0),
+        .mod_reg_1(mod_reg_1),
+        .mod_reg_2(mod_reg_2),
+        .mod_reg_3(mod_reg_3),
+        .mod_reg_4(mod_reg_4),
+        .mod_reg_5(mod_reg_5),
+        .commit_done_i(dds_commit_done),
+        .seq_index_o(seq_index)
+    );
 
-    dds_modulator modulator(
+    dds_table_loader #(.CHANNEL(CHANNEL)) table_loader(
         .clk_i(S_AXI_CLK),
         .resetn_i(S_AXI_ARESETN),
+        .s_axis_table_tdata(s_axis_table_tdata),
+        .s_axis_table_tvalid(s_axis_table_tvalid),
+        .s_axis_table_tlast(s_axis_table_tlast),
+        .s_axis_table_tready(s_axis_table_tready),
+        .axi_wr_en_i(table_wr_en),
+        .axi_wr_addr_i(table_wr_addr),
+        .axi_wr_data_i(table_wr_data),
+        .axi_wr_strb_i(table_wr_strb),
+        .seq_wr_en_o(seq_wr_en),
+        .seq_wr_addr_o(seq_wr_addr),
+        .seq_wr_data_o(seq_wr_data),
+        .seq_wr_strb_o(seq_wr_strb),
+        .code_wr_en_o(code_wr_en),
+        .code_wr_addr_o(code_wr_addr),
+        .code_wr_data_o(code_wr_data),
+        .pinc_wr_en_o(pinc_wr_en),
+        .pinc_wr_addr_o(pinc_wr_addr),
+        .pinc_wr_data_o(pinc_wr_data),
+        .hop_wr_en_o(hop_wr_en),
+        .hop_wr_addr_o(hop_wr_addr),
+        .hop_wr_data_o(hop_wr_data)
+    );
+
+    dds_modulator #(.DDS_LANES(DDS_LANES)) modulator(
+        .clk_i(DDS_CLK),
+        .resetn_i(DDS_ARESETN),
+        .wr_clk_i(S_AXI_CLK),
         .dds_en_o(dds_en_o),
-        .m_axis_modulation_tdata(m_axis_modulation_tdata),
-        .m_axis_modulation_tvalid(m_axis_modulation_tvalid),
-        .m_axis_modulation_tlast(m_axis_modulation_tlast),
+        .m_axis_modulation_tdata(mod_tdata),
+        .m_axis_modulation_tvalid(mod_tvalid),
+        .m_axis_modulation_tlast(mod_tlast),
+        .m_axis_modulation_tuser(mod_tuser),
         .m_axis_modulation_tready(m_axis_modulation_tready),
-        .config_reg_0(config_reg_0),
-        .config_reg_1(config_reg_1),
-        .config_reg_2(config_reg_2),
-        .config_reg_3(config_reg_3),
-        .config_reg_4(config_reg_4),
-        .config_reg_5(config_reg_5)
+        .config_reg_0(mod_reg_0),
+        .config_reg_1(mod_reg_1),
+        .config_reg_2(mod_reg_2),
+        .config_reg_3(mod_reg_3),
+        .config_reg_4(mod_reg_4),
+        .config_reg_5(mod_reg_5),
+        .commit_done_o(dds_commit_done),
+        .capture_trig_i(capture_trig_i),
+        .ts_now_o(dds_ts_now),
+        .ts_pulse_o(dds_ts_pulse),
+        .ts_commit_o(dds_ts_commit),
+        .ts_capture_o(dds_ts_capture),
+        .perf_o(dds_perf),
+        .trig_received_i(trig_received),
+        .trig_missed_i(trig_missed),
+        .period_end_o(period_end),
+        .code_wr_en_i(code_wr_en),
+        .code_wr_addr_i(code_wr_addr),
+        .code_wr_data_i(code_wr_data),
+        .pinc_wr_en_i(pinc_wr_en),
+        .pinc_wr_addr_i(pinc_wr_addr),
+        .pinc_wr_data_i(pinc_wr_data),
+        .hop_wr_en_i(hop_wr_en),
+        .hop_wr_addr_i(hop_wr_addr),
+        .hop_wr_data_i(hop_wr_data)
     );
 
-    axi_lite_mm2dds_mod_registers registers(
+    dds_polyphase #(.LANES(DDS_LANES)) polyphase(
+        .clk_i(DDS_CLK),
+        .resetn_i(DDS_ARESETN),
+        .en_i(dds_en_o),
+        .s_axis_tdata(mod_tdata),
+        .s_axis_tvalid(mod_tvalid),
+        .s_axis_tlast(mod_tlast),
+        .s_axis_tuser(mod_tuser),
+        .m_axis_tdata(m_axis_modulation_tdata),
+        .m_axis_tvalid(m_axis_modulation_tvalid),
+        .m_axis_tlast(m_axis_modulation_tlast),
+        .m_axis_tuser(m_axis_modulation_tuser)
+    );
+
+    assign capture_trig_o = dds_reg_0[1];   // DEBUG_BIT
+    assign capture_ts_o = dds_ts_capture;
+
+    axi_lite_mm2dds_mod_registers #(.DDS_CLK_KHZ(DDS_CLK_KHZ), .DDS_LANES(DDS_LANES)) registers(
         .config_reg_0_o(config_reg_0),
         .config_reg_1_o(config_reg_1),
         .config_reg_2_o(config_reg_2),
         .config_reg_3_o(config_reg_3),
         .config_reg_4_o(config_reg_4),
         .config_reg_5_o(config_reg_5),
+        .config_reg_6_o(config_reg_6),
+        .table_wr_en_o(table_wr_en),
+        .table_wr_addr_o(table_wr_addr),
+        .table_wr_data_o(table_wr_data),
+        .table_wr_strb_o(table_wr_strb),
+        .seq_status_i(seq_status),
+        .ts_now_i(ts_now),
+        .ts_pulse_i(ts_pulse),
+        .ts_commit_i(ts_commit),
+        .ts_capture_i(ts_capture),
+        .perf_i(perf),
         .S_AXI_CLK(S_AXI_CLK),
         .S_AXI_ARESETN(S_AXI_ARESETN),
         .S_AXI_AWREADY(S_AXI_AWREADY),
@@ -94,7 +370,8 @@ module mm2s_dds_modulator(
         .S_AXI_RDATA(S_AXI_RDATA),
         .S_AXI_RRESP(S_AXI_RRESP),
         .S_AXI_RVALID(S_AXI_RVALID),
-        .dbg_tlast(m_axis_modulation_tlast)
+        .dbg_tlast(dbg_tlast),
+        .commit_done(commit_done)
     );
 
 endmodule
\ No newline at end of file
@@ -0,0 +1,172 @@
+/**
+ * @file bus_count.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Counts AXI-Lite transactions issued by the generator driver for each
+ * configuration, against the mocked register bank.
+ * @date 2020-08-09
+ */
+
+#include <stdio.h>
+
+#include "generator.h"
+#include "presets.h"
+#include "phase_codes.h"
+#include "xil_io_mock.h"
+
+static Waveform_Generator_t wg;
+
+static void report(const char *name, int retval){
+    printf("%-38s %3s reads %2u writes %2u dma %3u  regs", name, retval < 0 ? "ERR" : "",
+           bus_counters.reads, bus_counters.writes, bus_counters.dma_words);
+    for (int i = 0; i < GENERATOR_NUM_REGS; i++){
+        printf(" %08x", mock_regs[i]);
+    }
+    printf("\n");
+    mock_reset_counters();
+}
+
+int main(){
+    int retval;
+
+    /* DDS clock reported by the bitstream (REG_8) */
+    mock_regs[REG_INDEX(REG_8_OFFSET)] = 125000;
+    /* One sample per DDS clock (REG_9) */
+    mock_regs[REG_INDEX(REG_9_OFFSET)] = 1;
+    generator_init(&wg, MOCK_BASEADDR, 0, 0);
+    report("generator_init", 0);
+
+    retval = set_continuous_mode_constant_freq(&wg, 5000);
+    report("set_continuous_mode_constant_freq", retval);
+    retval = set_continuous_mode_freq_mod(&wg, 1000, 5000, 150);
+    report("set_continuous_mode_freq_mod", retval);
+    retval = set_continuous_mode_phase_mod(&wg, 20000, 7, 35);
+    report("set_continuous_mode_phase_mod", retval);
+    retval = set_pulsed_mode_constant_freq(&wg, 150, 35, 3000);
+    report("set_pulsed_mode_constant_freq", retval);
+    retval = set_pulsed_mode_freq_mod(&wg, 120, 10, 4000, 5678);
+    report("set_pulsed_mode_freq_mod", retval);
+    retval = set_pulsed_mode_phase_mod(&wg, 150, 35, 3000, 7);
+    report("set_pulsed_mode_phase_mod", retval);
+    /* Same config again */
+    retval = set_pulsed_mode_phase_mod(&wg, 150, 35, 3000, 7);
+    report("set_pulsed_mode_phase_mod (again)", retval);
+    retval = generator_start(&wg);
+    report("generator_start", retval);
+    retval = generator_stop(&wg);
+    report("generator_stop", retval);
+
+    /* Live updates: core keeps running, configs are committed */
+    generator_set_live_update(&wg, 1);
+    generator_start(&wg);
+    mock_reset_counters();
+    retval = set_pulsed_mode_constant_freq(&wg, 150, 35, 3000);
+    report("live set_pulsed_mode_constant_freq", retval);
+    /* Hardware latched the commit at period wrap */
+    mock_regs[REG_INDEX(REG_0_OFFSET)] &= ~(1 << COMMIT_BIT);
+    retval = set_pulsed_mode_freq_mod(&wg, 120, 10, 4000, 5678);
+    report("live set_pulsed_mode_freq_mod", retval);
+    /* Refused config (low above high): nothing written, core keeps running */
+    retval = set_pulsed_mode_freq_mod(&wg, 120, 10, 5678, 4000);
+    report("live refused config", retval);
+    /* Commit never latched (lost CDC round): config is refused */
+    retval = set_pulsed_mode_constant_freq(&wg, 150, 35, 3000);
+    report("live commit lost", retval);
+    mock_regs[REG_INDEX(REG_0_OFFSET)] &= ~(1 << COMMIT_BIT);
+    generator_set_live_update(&wg, 0);
+
+    /* Sequencer: entries are composed detached and written to the table */
+    static Waveform_Generator_t entry;
+    generator_init_detached(&entry, &wg);
+    retval = set_pulsed_mode_constant_freq(&entry, 150, 35, 3000);
+    report("detached set_pulsed_mode_constant_freq", retval);
+    retval = generator_sequence_write_entry(&wg, 0, &entry, 3);
+    report("generator_sequence_write_entry", retval);
+    /* Same entry through the table loader: no AXI-Lite writes */
+    uint32_t words[SEQ_ENTRY_WORDS];
+    generator_sequence_pack_entry(&entry, 3, words);
+    retval = generator_load_table(&wg, TABLE_SEQUENCER, 1 * SEQ_ENTRY_WORDS, words, SEQ_ENTRY_WORDS);
+    report("generator_load_table (1 entry)", retval);
+    retval = generator_sequence_start(&wg, 2);
+    report("generator_sequence_start", retval);
+
+    /* Code table: chips are loaded by DMA, config is a single register set */
+    static uint32_t phases[CODE_MAX_CHIPS];
+    int chips = phase_code_p4(64, phases, CODE_MAX_CHIPS);
+    retval = generator_load_table(&wg, TABLE_CODE, 0, phases, chips);
+    report("generator_load_table (P4, 64 chips)", retval);
+    retval = set_pulsed_mode_code_mod(&wg, 150, 64, 3000, 0, chips);
+    report("set_pulsed_mode_code_mod", retval);
+    retval = set_continuous_mode_code_mod(&wg, 3000, 0, chips, 200);
+    report("set_continuous_mode_code_mod", retval);
+
+    /* PINC table: 4 entry frequency law, interpolated */
+    const uint32_t law_pinc[4] = {8589935, 17179869, 25769803, 34359738};
+    const int32_t law_slope[4] = {1099511, 1099511, 1099511, 0};
+    retval = generator_load_pinc_table(&wg, 0, law_pinc, law_slope, 4);
+    report("generator_load_pinc_table (4 entries)", retval);
+    retval = set_pulsed_mode_pinc_table(&wg, 150, 64, 0, 4, 2000);
+    report("set_pulsed_mode_pinc_table", retval);
+
+    /* Hop table: 8 dwells of 4 us, odd dwells shifted 90 degrees */
+    generator_hop_t hops[8];
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        hops[i].freq_khz = 1000 * (i + 1);
+        hops[i].dwell_clocks = 500;
+        hops[i].phase = (i & 1) ? 0x4000 : 0;
+    }
+    retval = generator_load_hop_table(&wg, 10, hops, 8);
+    report("generator_load_hop_table (8 entries)", retval);
+    retval = set_pulsed_mode_hop(&wg, 50, 32, 10, 8);
+    report("set_pulsed_mode_hop", retval);
+
+    /* Presets: image is composed once, recall skips validation and math */
+    uint32_t image[GENERATOR_IMAGE_REGS];
+    presets_init();
+    generator_init_detached(&entry, &wg);
+    set_pulsed_mode_freq_mod(&entry, 120, 10, 4000, 5678);
+    generator_get_image(&entry, image);
+    presets_save(0, "chirp", image);
+    generator_init_detached(&entry, &wg);
+    set_pulsed_mode_phase_mod(&entry, 150, 35, 3000, 7);
+    generator_get_image(&entry, image);
+    presets_save(1, "barker7", image);
+    mock_reset_counters();
+    retval = generator_apply_image(&wg, presets_get(0)->image);
+    report("recall preset 0 (chirp)", retval);
+    retval = generator_apply_image(&wg, presets_get(1)->image);
+    report("recall preset 1 (barker7)", retval);
+
+    /* External trigger: a single REG_0 write, holdoff is 16 bit */
+    retval = generator_ext_trigger_arm(&wg, TRIGGER_RISING, 1000, 0);
+    report("generator_ext_trigger_arm", retval);
+    retval = generator_ext_trigger_arm(&wg, TRIGGER_BOTH, 1000000, 1);
+    report("generator_ext_trigger_arm (1 ms holdoff)", retval);
+    /* Sequencer with a train per trigger only */
+    retval = generator_sequence_start(&wg, 2);
+    report("generator_sequence_start (one PRI)", retval);
+    generator_ext_trigger_disarm(&wg);
+    report("generator_ext_trigger_disarm", 0);
+    retval = generator_sequence_start(&wg, 2);
+    report("generator_sequence_start", retval);
+    retval = generator_ext_trigger_arm(&wg, TRIGGER_RISING, 1000, 0);
+    report("generator_ext_trigger_arm (sequence)", retval);
+    retval = generator_ext_trigger_arm(&wg, TRIGGER_RISING, 1000, 1);
+    report("generator_ext_trigger_arm (train)", retval);
+    /* Armed channel: the trigger may be running it, configs are committed */
+    generator_set_live_update(&wg, 1);
+    retval = set_pulsed_mode_constant_freq(&wg, 150, 35, 3000);
+    report("live config (train armed)", retval);
+    mock_regs[REG_INDEX(REG_0_OFFSET)] &= ~(1 << COMMIT_BIT);
+    generator_set_live_update(&wg, 0);
+    generator_ext_trigger_disarm(&wg);
+    report("generator_ext_trigger_disarm", 0);
+    /* Stop disarms too (STOP, lost connection) */
+    retval = generator_ext_trigger_arm(&wg, TRIGGER_RISING, 1000, 1);
+    report("generator_ext_trigger_arm (train)", retval);
+    retval = generator_stop(&wg);
+    report("generator_stop (armed)", retval);
+
+    return 0;
+}
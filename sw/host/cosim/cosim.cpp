@@ -0,0 +1,302 @@
+/**
+ * @file cosim.cpp
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Verilator co-simulation harness. Runs cosim_top with its two clocks
+ * (S_AXI_CLK at FCLK0, DDS_CLK at COSIM_DDS_CLK_KHZ) and turns register
+ * accesses and DMA transfers into transactions on its ports.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "verilated.h"
+#include "Vcosim_top.h"
+
+#include "cosim.h"
+
+#ifndef COSIM_DDS_CLK_KHZ
+#define COSIM_DDS_CLK_KHZ 125000
+#endif
+
+/* FCLK0, 125 MHz */
+#define AXI_HALF_PERIOD_PS 4000ULL
+#define DDS_HALF_PERIOD_PS (500000000ULL / COSIM_DDS_CLK_KHZ)
+/* Clocks in reset */
+#define RESET_CYCLES 16
+/* A transaction not answered in this many clocks is a hang */
+#define AXI_TIMEOUT_CYCLES 1000
+
+cosim_counters_t cosim_counters;
+
+static std::unique_ptr<VerilatedContext> context;
+static std::unique_ptr<Vcosim_top> top;
+
+static uint64_t now_ps;
+static uint64_t next_axi_ps;
+static uint64_t next_dds_ps;
+
+/* S2MM state */
+static uint32_t *capture_buffer;
+static uint32_t capture_max_words;
+static uint32_t capture_words;
+static bool capture_armed;
+static bool capture_done;
+
+/**
+ * @brief Capture beat, copied to the buffer while armed. Beat is
+ * little endian, word 0 is tdata[31:0].
+ */
+static void _capture_words(IData data, uint32_t *words, uint32_t n){
+    words[0] = data;
+}
+
+static void _capture_words(QData data, uint32_t *words, uint32_t n){
+    words[0] = (uint32_t) data;
+    words[1] = (uint32_t) (data >> 32);
+}
+
+template <std::size_t N>
+static void _capture_words(const VlWide<N> &data, uint32_t *words, uint32_t n){
+    for (uint32_t w = 0; w < n; w++){
+        words[w] = data[w];
+    }
+}
+
+static void _capture_beat(){
+    const uint32_t beat_words = sizeof(top->m_axis_capture_tdata) / sizeof(uint32_t);
+    uint32_t words[beat_words];
+
+    if (!capture_armed || capture_done || !top->m_axis_capture_tvalid){
+        return;
+    }
+
+    _capture_words(top->m_axis_capture_tdata, words, beat_words);
+    for (uint32_t w = 0; w < beat_words && capture_words < capture_max_words; w++){
+        capture_buffer[capture_words++] = words[w];
+    }
+    /* DMA stops on tlast or when the buffer is full */
+    if (top->m_axis_capture_tlast || capture_words >= capture_max_words){
+        capture_done = true;
+    }
+}
+
+/**
+ * @brief Advances to the next clock edge. Capture is sampled right before
+ * the DDS_CLK rising edge, with the outputs of the last one settled.
+ */
+static void _tick(){
+    uint64_t t = next_axi_ps < next_dds_ps ? next_axi_ps : next_dds_ps;
+
+    if (next_dds_ps == t && !top->DDS_CLK){
+        _capture_beat();
+    }
+    if (next_axi_ps == t){
+        top->S_AXI_CLK = !top->S_AXI_CLK;
+        next_axi_ps += AXI_HALF_PERIOD_PS;
+    }
+    if (next_dds_ps == t){
+        top->DDS_CLK = !top->DDS_CLK;
+        next_dds_ps += DDS_HALF_PERIOD_PS;
+        if (top->DDS_CLK){
+            cosim_counters.dds_cycles++;
+        }
+    }
+    now_ps = t;
+    cosim_counters.time_ns = now_ps / 1000;
+    top->eval();
+}
+
+/**
+ * @brief Runs up to the next S_AXI_CLK rising edge. Inputs changed before
+ * the call are seen by that edge.
+ */
+static void _axi_cycle(){
+    top->eval();
+    do {
+        _tick();
+    } while (!top->S_AXI_CLK);
+}
+
+void cosim_init(void){
+    context.reset(new VerilatedContext);
+    top.reset(new Vcosim_top{context.get()});
+
+    cosim_counters = (cosim_counters_t){0};
+    now_ps = 0;
+    next_axi_ps = AXI_HALF_PERIOD_PS;
+    next_dds_ps = DDS_HALF_PERIOD_PS;
+
+    top->S_AXI_CLK = 0;
+    top->DDS_CLK = 0;
+    top->S_AXI_ARESETN = 0;
+    top->DDS_ARESETN = 0;
+    top->S_AXI_AWVALID = 0;
+    top->S_AXI_WVALID = 0;
+    top->S_AXI_BREADY = 0;
+    top->S_AXI_ARVALID = 0;
+    top->S_AXI_RREADY = 0;
+    top->s_axis_table_tvalid = 0;
+    top->dds_stall_i = 0;
+    top->trigger_i = 0;
+    top->eval();
+
+    for (int i = 0; i < RESET_CYCLES; i++){
+        _axi_cycle();
+    }
+    top->S_AXI_ARESETN = 1;
+    top->DDS_ARESETN = 1;
+    for (int i = 0; i < RESET_CYCLES; i++){
+        _axi_cycle();
+    }
+}
+
+void cosim_final(void){
+    top->final();
+    top.reset();
+    context.reset();
+}
+
+static void _hang(const char *what, uint32_t offset){
+    fprintf(stderr, "cosim: %s at 0x%08x not answered\n", what, offset);
+    abort();
+}
+
+uint32_t cosim_read(uint32_t offset){
+    uint32_t data;
+    int cycles = 0;
+
+    top->S_AXI_ARADDR = offset;
+    top->S_AXI_ARVALID = 1;
+    top->S_AXI_RREADY = 1;
+
+    /* Address */
+    for (bool taken = false; !taken; ){
+        top->eval();
+        taken = top->S_AXI_ARREADY;
+        _axi_cycle();
+        if (++cycles > AXI_TIMEOUT_CYCLES) _hang("read", offset);
+    }
+    top->S_AXI_ARVALID = 0;
+
+    /* Data, address held until here for the decoder */
+    for (bool valid = false; !valid; ){
+        top->eval();
+        valid = top->S_AXI_RVALID;
+        data = top->S_AXI_RDATA;
+        if (valid && top->S_AXI_RRESP != 0){
+            cosim_counters.slverr++;
+        }
+        _axi_cycle();
+        if (++cycles > AXI_TIMEOUT_CYCLES) _hang("read", offset);
+    }
+    top->S_AXI_RREADY = 0;
+
+    cosim_counters.reads++;
+    return data;
+}
+
+void cosim_write(uint32_t offset, uint32_t value){
+    bool aw_taken = false, w_taken = false;
+    int cycles = 0;
+
+    top->S_AXI_AWADDR = offset;
+    top->S_AXI_AWVALID = 1;
+    top->S_AXI_WDATA = value;
+    top->S_AXI_WSTRB = 0xF;
+    top->S_AXI_WVALID = 1;
+    top->S_AXI_BREADY = 1;
+
+    /* Address and data, independent channels */
+    while (!aw_taken || !w_taken){
+        top->eval();
+        bool aw = top->S_AXI_AWVALID && top->S_AXI_AWREADY;
+        bool w = top->S_AXI_WVALID && top->S_AXI_WREADY;
+        _axi_cycle();
+        if (aw){
+            aw_taken = true;
+            top->S_AXI_AWVALID = 0;
+        }
+        if (w){
+            w_taken = true;
+            top->S_AXI_WVALID = 0;
+        }
+        if (++cycles > AXI_TIMEOUT_CYCLES) _hang("write", offset);
+    }
+
+    /* Response */
+    for (bool valid = false; !valid; ){
+        top->eval();
+        valid = top->S_AXI_BVALID;
+        if (valid && top->S_AXI_BRESP != 0){
+            cosim_counters.slverr++;
+        }
+        _axi_cycle();
+        if (++cycles > AXI_TIMEOUT_CYCLES) _hang("write", offset);
+    }
+    top->S_AXI_BREADY = 0;
+
+    cosim_counters.writes++;
+}
+
+void cosim_run_ns(uint64_t ns){
+    uint64_t end_ps = now_ps + ns * 1000;
+
+    while (now_ps < end_ps){
+        _tick();
+    }
+}
+
+void cosim_set_stall(int stall){
+    top->dds_stall_i = stall ? 1 : 0;
+}
+
+void cosim_set_trigger(int level){
+    top->trigger_i = level ? 1 : 0;
+}
+
+void cosim_table_stream(const uint32_t *words, uint32_t count){
+    uint32_t i = 0;
+    int idle = 0;
+
+    while (i < count){
+        top->s_axis_table_tdata = words[i];
+        top->s_axis_table_tlast = (i == count - 1);
+        top->s_axis_table_tvalid = 1;
+        top->eval();
+        bool taken = top->s_axis_table_tready;
+        _axi_cycle();
+        if (taken){
+            i++;
+            idle = 0;
+        }
+        else if (++idle > AXI_TIMEOUT_CYCLES){
+            _hang("table stream", i);
+        }
+    }
+    top->s_axis_table_tvalid = 0;
+    top->s_axis_table_tlast = 0;
+    cosim_counters.dma_words += count;
+}
+
+void cosim_capture_arm(uint32_t *buffer, uint32_t max_bytes){
+    capture_buffer = buffer;
+    capture_max_words = max_bytes / sizeof(uint32_t);
+    capture_words = 0;
+    capture_done = false;
+    capture_armed = true;
+}
+
+int cosim_capture_wait(uint64_t timeout_ns){
+    uint64_t end_ps = now_ps + timeout_ns * 1000;
+
+    while (capture_armed && !capture_done && now_ps < end_ps){
+        _tick();
+    }
+    return capture_armed && !capture_done;
+}
+
+uint32_t cosim_capture_bytes(void){
+    return capture_words * sizeof(uint32_t);
+}
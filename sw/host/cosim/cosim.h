@@ -0,0 +1,58 @@
+/* Verilator co-simulation of the generator, see cosim.cpp */
+#ifndef __COSIM
+#define __COSIM
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Register window of channel n: COSIM_BASEADDR + n * COSIM_CHANNEL_STRIDE */
+#define COSIM_BASEADDR 0x40000000
+#define COSIM_CHANNEL_STRIDE 0x10000
+
+typedef struct{
+    /* AXI-Lite transactions, and the ones answered with SLVERR */
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t slverr;
+    /* Words streamed to the table loader */
+    uint32_t dma_words;
+    /* Simulated time */
+    uint64_t dds_cycles;
+    uint64_t time_ns;
+}cosim_counters_t;
+
+extern cosim_counters_t cosim_counters;
+
+/* Builds the model and runs the reset sequence */
+void cosim_init(void);
+void cosim_final(void);
+
+/* AXI-Lite transactions, offset from COSIM_BASEADDR */
+uint32_t cosim_read(uint32_t offset);
+void cosim_write(uint32_t offset, uint32_t value);
+
+/* Free running simulation */
+void cosim_run_ns(uint64_t ns);
+/* DDS Compilers tready low while set */
+void cosim_set_stall(int stall);
+/* Trigger pin level (PMOD JA1) */
+void cosim_set_trigger(int level);
+
+/* DMA MM2S: streams a table load packet, returns when it was taken */
+void cosim_table_stream(const uint32_t *words, uint32_t count);
+
+/* DMA S2MM: arms a capture into buffer, beats are copied while the
+ * simulation runs. cosim_capture_wait() runs it until tlast, a full
+ * buffer or timeout_ns, returns 1 while the capture is still running */
+void cosim_capture_arm(uint32_t *buffer, uint32_t max_bytes);
+int cosim_capture_wait(uint64_t timeout_ns);
+uint32_t cosim_capture_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file cosim_test.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Regression of the generator driver against the Verilator model: the
+ * set_*_mode_* functions program the RTL and the capture is checked.
+ * Reports simulation throughput, exits non zero on failure.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "generator.h"
+#include "cosim.h"
+
+#define PI 3.14159265358979323846
+/* Full range LUT amplitude, 14 bit output */
+#define DDS_AMPLITUDE 8191
+
+static Waveform_Generator_t wg[GENERATOR_NUM_CHANNELS];
+static s32 i_samples[MAX_DEBUG_SAMPLES];
+static s32 q_samples[MAX_DEBUG_SAMPLES];
+static int failures;
+
+static void check(int ok, const char *name){
+    printf("%-44s %s\n", name, ok ? "ok" : "FAIL");
+    if (!ok){
+        failures++;
+    }
+}
+
+/**
+ * @brief Mean frequency of the valid capture samples, from the phase step
+ * between consecutive samples. Sine is negated, phase is atan2(-q, i).
+ */
+static double capture_freq_khz(Waveform_Generator_t *g, u32 n){
+    double acc = 0;
+
+    for (u32 k = 1; k < n; k++){
+        double step = atan2(-q_samples[k], i_samples[k]) - atan2(-q_samples[k-1], i_samples[k-1]);
+        if (step > PI) step -= 2 * PI;
+        if (step < -PI) step += 2 * PI;
+        acc += step;
+    }
+    return acc / (n - 1) * FS_KHZ(g) / (2 * PI);
+}
+
+static int capture_amplitude_ok(u32 n){
+    for (u32 k = 0; k < n; k++){
+        double a = sqrt((double) i_samples[k] * i_samples[k] + (double) q_samples[k] * q_samples[k]);
+        if (fabs(a - DDS_AMPLITUDE) > 2){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void test_continuous(void){
+    u32 freq_khz[GENERATOR_NUM_CHANNELS] = {5000, 12500};
+
+    for (int n = 0; n < GENERATOR_NUM_CHANNELS; n++){
+        set_continuous_mode_constant_freq(&wg[n], freq_khz[n]);
+        generator_start(&wg[n]);
+    }
+    cosim_run_ns(10000);
+
+    /* Channel 0 triggers the capture of every channel */
+    check(generator_trigger_debug(&wg[0]) == 0, "continuous: capture");
+    u32 n_samples = wg[0].valid_debug_samples;
+    check(n_samples == MAX_DEBUG_SAMPLES, "continuous: capture length");
+    check(wg[0].capture_timestamp != 0 &&
+          wg[0].capture_timestamp < generator_get_timestamp(&wg[0], TIMESTAMP_NOW),
+          "continuous: capture timestamp");
+
+    for (int n = 0; n < GENERATOR_NUM_CHANNELS; n++){
+        char name[64];
+        generator_get_i_samples(&wg[n], i_samples, n_samples);
+        generator_get_q_samples(&wg[n], q_samples, n_samples);
+        double f = capture_freq_khz(&wg[n], n_samples);
+        snprintf(name, sizeof(name), "continuous: ch%d amplitude", n);
+        check(capture_amplitude_ok(n_samples), name);
+        snprintf(name, sizeof(name), "continuous: ch%d %u kHz (%.1f)", n, freq_khz[n], f);
+        check(fabs(f - freq_khz[n]) < 1.0, name);
+    }
+}
+
+static void test_pulsed(void){
+    generator_perf_t before, after;
+
+    set_pulsed_mode_constant_freq(&wg[0], 100, 20, 5000);
+    generator_start(&wg[0]);
+    cosim_run_ns(200000);
+
+    generator_get_perf(&wg[0], &before);
+    cosim_run_ns(1000000);
+    generator_get_perf(&wg[0], &after);
+    check(after.pulses - before.pulses >= 9 && after.pulses - before.pulses <= 11,
+          "pulsed: 10 pulses per ms");
+    check(generator_get_timestamp(&wg[0], TIMESTAMP_PULSE) != 0, "pulsed: pulse timestamp");
+}
+
+static void test_live_update(void){
+    generator_perf_t before, after;
+
+    generator_get_perf(&wg[0], &before);
+    generator_set_live_update(&wg[0], 1);
+    set_pulsed_mode_constant_freq(&wg[0], 100, 30, 7000);
+    generator_set_live_update(&wg[0], 0);
+    /* Latched at the next period wrap */
+    cosim_run_ns(200000);
+    generator_get_perf(&wg[0], &after);
+    check(after.commits == before.commits + 1, "live update: commit latched");
+    check(cosim_counters.slverr == 0, "live update: no SLVERR");
+}
+
+static void test_stall(void){
+    generator_perf_t before, after;
+    uint64_t cycles;
+
+    set_continuous_mode_constant_freq(&wg[0], 5000);
+    generator_start(&wg[0]);
+    cosim_run_ns(10000);
+
+    generator_get_perf(&wg[0], &before);
+    cycles = cosim_counters.dds_cycles;
+    cosim_set_stall(1);
+    cosim_run_ns(10000);
+    cosim_set_stall(0);
+    cycles = cosim_counters.dds_cycles - cycles;
+    cosim_run_ns(1000);
+    generator_get_perf(&wg[0], &after);
+    check(after.stall_cycles - before.stall_cycles >= cycles - 1 &&
+          after.stall_cycles - before.stall_cycles <= cycles + 1,
+          "stall: stall cycles counted");
+}
+
+static void trigger_pulse(uint64_t high_ns, uint64_t low_ns){
+    cosim_set_trigger(1);
+    cosim_run_ns(high_ns);
+    cosim_set_trigger(0);
+    cosim_run_ns(low_ns);
+}
+
+static void test_trigger(void){
+    generator_perf_t before, after;
+
+    /* 100 us PRI, one per rising edge */
+    set_pulsed_mode_constant_freq(&wg[0], 100, 20, 5000);
+    check(generator_ext_trigger_arm(&wg[0], TRIGGER_RISING, 0, 0) == 0, "trigger: arm");
+    cosim_run_ns(10000);
+
+    generator_get_perf(&wg[0], &before);
+    for (int k = 0; k < 3; k++){
+        trigger_pulse(1000, 150000);
+    }
+    generator_get_perf(&wg[0], &after);
+    check(after.pulses - before.pulses == 3, "trigger: one PRI per trigger");
+    check(after.triggers - before.triggers == 3 && after.triggers_missed == before.triggers_missed,
+          "trigger: triggers counted");
+
+    /* Second edge lands in the PRI started by the first one */
+    before = after;
+    trigger_pulse(1000, 20000);
+    trigger_pulse(1000, 150000);
+    generator_get_perf(&wg[0], &after);
+    check(after.pulses - before.pulses == 1 && after.triggers - before.triggers == 2 &&
+          after.triggers_missed - before.triggers_missed == 1, "trigger: edge while running missed");
+
+    /* Disarmed, edges are not looked at */
+    generator_ext_trigger_disarm(&wg[0]);
+    before = after;
+    trigger_pulse(1000, 150000);
+    generator_get_perf(&wg[0], &after);
+    check(after.pulses == before.pulses && after.triggers == before.triggers, "trigger: disarmed");
+}
+
+int main(){
+    struct timespec t0, t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    cosim_init();
+
+    for (int n = 0; n < GENERATOR_NUM_CHANNELS; n++){
+        generator_init(&wg[n], COSIM_BASEADDR + n * COSIM_CHANNEL_STRIDE, n, 0);
+    }
+    check(FCLK_KHZ(&wg[0]) == COSIM_DDS_CLK_KHZ, "init: DDS clock (REG_8)");
+
+    test_continuous();
+    test_pulsed();
+    test_live_update();
+    test_stall();
+    test_trigger();
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    printf("simulated %.3f ms in %.3f s: %.2f ms/s, %.2f M DDS clocks/s, %u reads %u writes\n",
+           cosim_counters.time_ns * 1e-6, wall, cosim_counters.time_ns * 1e-6 / wall,
+           cosim_counters.dds_cycles * 1e-6 / wall, cosim_counters.reads, cosim_counters.writes);
+
+    cosim_final();
+    return failures ? 1 : 0;
+}
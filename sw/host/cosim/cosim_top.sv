@@ -0,0 +1,190 @@
+`timescale 1ns / 1ps
+/**
+ * @file cosim_top.sv
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Verilator co-simulation top: the generator part of bd/generator.bd.tcl
+ * (channels, DDS Compiler lanes and capture combiner) with a single
+ * AXI-Lite port and the DMA streams as top level ports.
+ */
+
+/**
+ *  Channel n registers at n * 0x10000, as in the block design address map.
+ *  The AXI-Lite port is a simple decoder: the harness runs one transaction
+ *  at a time and holds AWADDR/ARADDR until the response, so the address
+ *  also routes the write data and response channels.
+ *
+ *  The table stream is broadcast to every channel (tready from channel 0),
+ *  the capture stream is the combiner output, the clock crossing FIFO and
+ *  the DMA are left to the harness. dds_stall_i holds the DDS Compilers
+ *  s_axis_phase_tready low (DDS backpressure). trigger_i is the PMOD trigger
+ *  pin, channel 0 synchronizes it for every channel.
+ *
+ *  @param NUM_CHANNELS: Generator channels (GENERATOR_NUM_CHANNELS)
+ *  @param DDS_LANES: Samples per DDS clock
+ *  @param DDS_CLK_KHZ: DDS clock, reported in REG_8
+ *  @param DDS_LATENCY: DDS Compiler latency, clocks (dds_latency in bd/generator.bd.tcl)
+ */
+module cosim_top #(parameter NUM_CHANNELS = 2, parameter DDS_LANES = 1,
+                   parameter DDS_CLK_KHZ = 125000, parameter DDS_LATENCY = 6)(
+    input S_AXI_CLK,
+    input S_AXI_ARESETN,
+    input DDS_CLK,
+    input DDS_ARESETN,
+
+    /* AXI4-Lite slave */
+    output S_AXI_AWREADY,
+    input [31:0] S_AXI_AWADDR,
+    input S_AXI_AWVALID,
+    output S_AXI_WREADY,
+    input [31:0] S_AXI_WDATA,
+    input [3:0] S_AXI_WSTRB,
+    input S_AXI_WVALID,
+    input S_AXI_BREADY,
+    output [1:0] S_AXI_BRESP,
+    output S_AXI_BVALID,
+    output S_AXI_ARREADY,
+    input [31:0] S_AXI_ARADDR,
+    input S_AXI_ARVALID,
+    input S_AXI_RREADY,
+    output [31:0] S_AXI_RDATA,
+    output [1:0] S_AXI_RRESP,
+    output S_AXI_RVALID,
+
+    /* Table loads, DMA MM2S (S_AXI_CLK) */
+    input [31:0] s_axis_table_tdata,
+    input s_axis_table_tvalid,
+    input s_axis_table_tlast,
+    output s_axis_table_tready,
+
+    /* Debug capture, DMA S2MM (DDS_CLK) */
+    output [NUM_CHANNELS*DDS_LANES*32-1:0] m_axis_capture_tdata,
+    output m_axis_capture_tvalid,
+    output m_axis_capture_tlast,
+
+    input dds_stall_i,
+    input trigger_i
+    );
+
+    localparam SEL_BITS = 4;
+
+    logic [SEL_BITS-1:0] aw_sel, ar_sel;
+    assign aw_sel = S_AXI_AWADDR[16 +: SEL_BITS];
+    assign ar_sel = S_AXI_ARADDR[16 +: SEL_BITS];
+
+    logic [NUM_CHANNELS-1:0] awready, wready, bvalid, arready, rvalid;
+    logic [1:0] bresp [NUM_CHANNELS];
+    logic [1:0] rresp [NUM_CHANNELS];
+    logic [31:0] rdata [NUM_CHANNELS];
+
+    logic [NUM_CHANNELS-1:0] table_tready;
+    logic capture_trig;
+    logic [63:0] capture_ts;
+    logic trigger_sync;
+
+    logic [NUM_CHANNELS*DDS_LANES*32-1:0] capture_tdata;
+    logic [NUM_CHANNELS-1:0] capture_tvalid, capture_tlast, capture_tuser;
+
+    for (genvar n = 0; n < NUM_CHANNELS; n++) begin : channel
+        logic dds_en;
+        logic [16*DDS_LANES-1:0] phase_tdata;
+        logic phase_tvalid, phase_tlast, phase_tuser;
+        logic trig_o;
+        logic trig_sync_o;
+        logic [63:0] ts_o;
+        logic [DDS_LANES-1:0] lane_tvalid, lane_tlast, lane_tuser;
+
+        mm2s_dds_modulator #(.CHANNEL(n), .DDS_CLK_KHZ(DDS_CLK_KHZ), .DDS_LANES(DDS_LANES),
+                             .TRIGGER_SYNC(n == 0)) modulator(
+            .S_AXI_CLK,
+            .S_AXI_ARESETN,
+            .DDS_CLK,
+            .DDS_ARESETN,
+            .S_AXI_AWREADY(awready[n]),
+            .S_AXI_AWADDR,
+            .S_AXI_AWVALID(S_AXI_AWVALID && aw_sel == n),
+            .S_AXI_WREADY(wready[n]),
+            .S_AXI_WDATA,
+            .S_AXI_WSTRB,
+            .S_AXI_WVALID(S_AXI_WVALID && aw_sel == n),
+            .S_AXI_BREADY(S_AXI_BREADY && aw_sel == n),
+            .S_AXI_BRESP(bresp[n]),
+            .S_AXI_BVALID(bvalid[n]),
+            .S_AXI_ARREADY(arready[n]),
+            .S_AXI_ARADDR,
+            .S_AXI_ARVALID(S_AXI_ARVALID && ar_sel == n),
+            .S_AXI_RREADY(S_AXI_RREADY && ar_sel == n),
+            .S_AXI_RDATA(rdata[n]),
+            .S_AXI_RRESP(rresp[n]),
+            .S_AXI_RVALID(rvalid[n]),
+            .dds_en_o(dds_en),
+            .m_axis_modulation_tdata(phase_tdata),
+            .m_axis_modulation_tvalid(phase_tvalid),
+            .m_axis_modulation_tlast(phase_tlast),
+            .m_axis_modulation_tuser(phase_tuser),
+            .m_axis_modulation_tready(DDS_ARESETN & ~dds_stall_i),
+            .capture_trig_o(trig_o),
+            .capture_trig_i(capture_trig),
+            .capture_ts_o(ts_o),
+            .trigger_i(n == 0 ? trigger_i : trigger_sync),
+            .trigger_sync_o(trig_sync_o),
+            .s_axis_table_tdata,
+            .s_axis_table_tvalid,
+            .s_axis_table_tlast,
+            .s_axis_table_tready(table_tready[n])
+        );
+
+        for (genvar k = 0; k < DDS_LANES; k++) begin : lane
+            dds_lut_model #(.LATENCY(DDS_LATENCY)) dds(
+                .aclk(DDS_CLK),
+                .aclken(dds_en),
+                .aresetn(DDS_ARESETN),
+                .s_axis_phase_tdata(phase_tdata[16*k +: 16]),
+                .s_axis_phase_tvalid(phase_tvalid),
+                .s_axis_phase_tlast(phase_tlast),
+                .s_axis_phase_tuser(phase_tuser),
+                .m_axis_data_tdata(capture_tdata[(n*DDS_LANES + k)*32 +: 32]),
+                .m_axis_data_tvalid(lane_tvalid[k]),
+                .m_axis_data_tlast(lane_tlast[k]),
+                .m_axis_data_tuser(lane_tuser[k])
+            );
+        end
+
+        // Lanes run in lockstep, tvalid/tlast/tuser from lane 0
+        assign capture_tvalid[n] = lane_tvalid[0];
+        assign capture_tlast[n] = lane_tlast[0];
+        assign capture_tuser[n] = lane_tuser[0];
+
+        if (n == 0) begin : trig
+            assign capture_trig = trig_o;
+            assign capture_ts = ts_o;
+            assign trigger_sync = trig_sync_o;
+        end
+    end
+
+    assign S_AXI_AWREADY = awready[aw_sel];
+    assign S_AXI_WREADY = wready[aw_sel];
+    assign S_AXI_BVALID = bvalid[aw_sel];
+    assign S_AXI_BRESP = bresp[aw_sel];
+    assign S_AXI_ARREADY = arready[ar_sel];
+    assign S_AXI_RVALID = rvalid[ar_sel];
+    assign S_AXI_RDATA = rdata[ar_sel];
+    assign S_AXI_RRESP = rresp[ar_sel];
+
+    assign s_axis_table_tready = table_tready[0];
+
+    dds_capture_combiner #(.NUM_CHANNELS(NUM_CHANNELS), .DATA_BITS(32 * DDS_LANES)) combiner(
+        .clk_i(DDS_CLK),
+        .resetn_i(DDS_ARESETN),
+        .s_axis_tdata(capture_tdata),
+        .s_axis_tvalid(capture_tvalid),
+        .s_axis_tlast(capture_tlast),
+        .s_axis_tuser(capture_tuser),
+        .capture_ts_i(capture_ts),
+        .m_axis_tdata(m_axis_capture_tdata),
+        .m_axis_tvalid(m_axis_capture_tvalid),
+        .m_axis_tlast(m_axis_capture_tlast),
+        .m_axis_tready(1'b1)
+    );
+
+endmodule
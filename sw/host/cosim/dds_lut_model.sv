@@ -0,0 +1,84 @@
+`timescale 1ns / 1ps
+/**
+ * @file dds_lut_model.sv
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Simulation model of one DDS Compiler lane as configured in
+ * bd/generator.bd.tcl: SIN/COS LUT only, phase from the modulator.
+ */
+
+/**
+ *  Output is [Sine|Cosine], each OUTPUT_BITS wide sign extended to 16 bits,
+ *  sine negated (Negative_Sine). Full range amplitude, 2^(OUTPUT_BITS-1) - 1:
+ *
+ *      cosine[p] =  round(A * cos(2*pi*p / 2^PHASE_BITS))
+ *      sine[p]   = -round(A * sin(2*pi*p / 2^PHASE_BITS))
+ *
+ *  tvalid, tlast and tuser go through the same LATENCY clocks, the
+ *  pipeline runs while aclken is set.
+ *
+ *  @param PHASE_BITS: Phase_Width
+ *  @param OUTPUT_BITS: Output_Width
+ *  @param LATENCY: Clocks from phase to data
+ */
+module dds_lut_model #(parameter PHASE_BITS = 16, parameter OUTPUT_BITS = 14, parameter LATENCY = 6)(
+    input aclk,
+    input aclken,
+    input aresetn,
+    input [15:0] s_axis_phase_tdata,
+    input s_axis_phase_tvalid,
+    input s_axis_phase_tlast,
+    input s_axis_phase_tuser,
+    output [31:0] m_axis_data_tdata,
+    output m_axis_data_tvalid,
+    output m_axis_data_tlast,
+    output m_axis_data_tuser
+    );
+
+    localparam DEPTH = 1 << PHASE_BITS;
+    localparam real AMPLITUDE = (1 << (OUTPUT_BITS - 1)) - 1;
+    localparam real PI = 3.14159265358979323846;
+
+    logic [15:0] cos_lut [DEPTH];
+    logic [15:0] sin_lut [DEPTH];
+
+    function automatic logic [15:0] round_sample(input real value);
+        return 16'($rtoi(value >= 0.0 ? value + 0.5 : value - 0.5));
+    endfunction
+
+    initial
+        for (int p = 0; p < DEPTH; p++) begin
+            cos_lut[p] = round_sample(AMPLITUDE * $cos(2.0 * PI * p / DEPTH));
+            sin_lut[p] = -round_sample(AMPLITUDE * $sin(2.0 * PI * p / DEPTH));
+        end
+
+    logic [31:0] data_pipe [LATENCY];
+    logic [LATENCY-1:0] tvalid_pipe, tlast_pipe, tuser_pipe;
+    logic [PHASE_BITS-1:0] phase;
+    assign phase = s_axis_phase_tdata[PHASE_BITS-1:0];
+
+    always_ff @(posedge aclk)
+    begin
+        if (aresetn == 0) begin
+            for (int s = 0; s < LATENCY; s++)
+                data_pipe[s] <= 0;
+            tvalid_pipe <= 0;
+            tlast_pipe <= 0;
+            tuser_pipe <= 0;
+        end
+        else if (aclken) begin
+            data_pipe[0] <= {sin_lut[phase], cos_lut[phase]};
+            for (int s = 1; s < LATENCY; s++)
+                data_pipe[s] <= data_pipe[s-1];
+            tvalid_pipe <= LATENCY'({tvalid_pipe, s_axis_phase_tvalid});
+            tlast_pipe <= LATENCY'({tlast_pipe, s_axis_phase_tlast});
+            tuser_pipe <= LATENCY'({tuser_pipe, s_axis_phase_tuser});
+        end
+    end
+
+    assign m_axis_data_tdata = data_pipe[LATENCY-1];
+    assign m_axis_data_tvalid = tvalid_pipe[LATENCY-1];
+    assign m_axis_data_tlast = tlast_pipe[LATENCY-1];
+    assign m_axis_data_tuser = tuser_pipe[LATENCY-1];
+
+endmodule
@@ -0,0 +1,104 @@
+/**
+ * @file xil_io_cosim.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Xil_In32/Xil_Out32, AXI DMA and FreeRTOS shims on top of the Verilator
+ * model (cosim.cpp): register accesses become AXI-Lite transactions, DMA
+ * transfers drive the table and capture streams, task delays run the
+ * simulation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "xil_io.h"
+#include "xaxidma.h"
+#include "task.h"
+
+#include "cosim.h"
+
+/* Capture DMA polling, simulated time per XAxiDma_Busy() call */
+#define CAPTURE_POLL_NS 100000
+
+/**
+ * @brief Translates bus address to model offset.
+ * Aborts on accesses outside the generator channels.
+ */
+static uint32_t _offset(UINTPTR addr){
+    if (addr < COSIM_BASEADDR || addr >= COSIM_BASEADDR + 16 * COSIM_CHANNEL_STRIDE || (addr & 0x3)){
+        fprintf(stderr, "Bad bus access at 0x%08lx\n", (unsigned long) addr);
+        abort();
+    }
+    return addr - COSIM_BASEADDR;
+}
+
+u32 Xil_In32(UINTPTR addr){
+    return cosim_read(_offset(addr));
+}
+
+void Xil_Out32(UINTPTR addr, u32 value){
+    cosim_write(_offset(addr), value);
+}
+
+void Xil_DCacheFlushRange(UINTPTR addr, u32 len){
+}
+
+static XAxiDma_Config dma_config;
+
+XAxiDma_Config *XAxiDma_LookupConfig(u32 device_id){
+    dma_config.DeviceId = device_id;
+    return &dma_config;
+}
+
+int XAxiDma_CfgInitialize(XAxiDma *inst, XAxiDma_Config *cfg){
+    inst->RegBase = 0;
+    return XST_SUCCESS;
+}
+
+void XAxiDma_IntrDisable(XAxiDma *inst, u32 mask, int direction){
+}
+
+int XAxiDma_SimpleTransfer(XAxiDma *inst, UINTPTR buff, u32 len, int direction){
+    if (direction == XAXIDMA_DMA_TO_DEVICE){
+        cosim_table_stream((const uint32_t *) buff, len / sizeof(u32));
+    }
+    else {
+        cosim_capture_arm((uint32_t *) buff, len);
+    }
+    return XST_SUCCESS;
+}
+
+/* Table loads are done when SimpleTransfer returns. Captures run the
+ * simulation in CAPTURE_POLL_NS steps, until tlast or a full buffer.
+ * With no tlast it stays busy as the real DMA, the driver times out */
+int XAxiDma_Busy(XAxiDma *inst, int direction){
+    if (direction == XAXIDMA_DMA_TO_DEVICE){
+        return 0;
+    }
+    return cosim_capture_wait(CAPTURE_POLL_NS);
+}
+
+u32 XAxiDma_ReadReg(UINTPTR base, u32 offset){
+    if (base + offset == XAXIDMA_RX_OFFSET * XAXIDMA_DEVICE_TO_DMA + XAXIDMA_BUFFLEN_OFFSET){
+        return cosim_capture_bytes();
+    }
+    return 0;
+}
+
+/* Transfers never fail in the model */
+void XAxiDma_Reset(XAxiDma *inst){
+}
+
+int XAxiDma_ResetIsDone(XAxiDma *inst){
+    return 1;
+}
+
+/* One tick per ms, pdMS_TO_TICKS() */
+void vTaskDelay(TickType_t ticks){
+    cosim_run_ns((uint64_t) ticks * 1000000);
+}
+
+/* Simulated time, every bus access runs the model */
+TickType_t xTaskGetTickCount(void){
+    return (TickType_t) (cosim_counters.time_ns / 1000000);
+}
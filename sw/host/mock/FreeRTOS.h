@@ -0,0 +1,11 @@
+/* Host mock of FreeRTOS, only what the drivers use */
+#ifndef __MOCK_FREERTOS
+#define __MOCK_FREERTOS
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
+
+#endif
@@ -0,0 +1,10 @@
+/* Host mock of FreeRTOS tasks */
+#ifndef __MOCK_TASK
+#define __MOCK_TASK
+
+#include "FreeRTOS.h"
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+
+#endif
@@ -0,0 +1,33 @@
+/* Host mock of Xilinx AXI DMA driver, no transfers are performed */
+#ifndef __MOCK_XAXIDMA
+#define __MOCK_XAXIDMA
+
+#include "xil_io.h"
+
+#define XAXIDMA_IRQ_ALL_MASK 0x7000
+#define XAXIDMA_DMA_TO_DEVICE 0x00
+#define XAXIDMA_DEVICE_TO_DMA 0x01
+#define XAXIDMA_TX_OFFSET 0x00
+#define XAXIDMA_RX_OFFSET 0x30
+#define XAXIDMA_SR_OFFSET 0x04
+#define XAXIDMA_BUFFLEN_OFFSET 0x28
+#define XAXIDMA_ERR_ALL_MASK 0x00000770
+
+typedef struct{
+    UINTPTR RegBase;
+}XAxiDma;
+
+typedef struct{
+    u32 DeviceId;
+}XAxiDma_Config;
+
+XAxiDma_Config *XAxiDma_LookupConfig(u32 device_id);
+int XAxiDma_CfgInitialize(XAxiDma *inst, XAxiDma_Config *cfg);
+void XAxiDma_IntrDisable(XAxiDma *inst, u32 mask, int direction);
+int XAxiDma_SimpleTransfer(XAxiDma *inst, UINTPTR buff, u32 len, int direction);
+int XAxiDma_Busy(XAxiDma *inst, int direction);
+u32 XAxiDma_ReadReg(UINTPTR base, u32 offset);
+void XAxiDma_Reset(XAxiDma *inst);
+int XAxiDma_ResetIsDone(XAxiDma *inst);
+
+#endif
@@ -0,0 +1,11 @@
+/* Host mock of Xilinx register access, see xil_io_mock.c */
+#ifndef __MOCK_XIL_IO
+#define __MOCK_XIL_IO
+
+#include "xil_types.h"
+
+u32 Xil_In32(UINTPTR addr);
+void Xil_Out32(UINTPTR addr, u32 value);
+void Xil_DCacheFlushRange(UINTPTR addr, u32 len);
+
+#endif
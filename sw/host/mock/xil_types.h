@@ -0,0 +1,20 @@
+/* Host mock of Xilinx standalone BSP types */
+#ifndef __MOCK_XIL_TYPES
+#define __MOCK_XIL_TYPES
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef uintptr_t UINTPTR;
+
+#define TRUE 1
+#define FALSE 0
+#define XST_SUCCESS 0
+
+#endif
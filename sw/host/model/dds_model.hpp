@@ -0,0 +1,767 @@
+/**
+ * @file dds_model.hpp
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Bit exact, clock accurate model of one generator channel: dds_modulator,
+ * dds_polyphase and the DDS Compiler lanes (SIN/COS LUT only). Header only.
+ */
+
+/**
+ *  modulator: dds_modulator.sv. One step() is one clk_i rising edge, the
+ *      inputs are the values sampled by that edge. Outputs are the
+ *      registered ones (m_axis_modulation_*), commit_done() and tlast()
+ *      are the combinational outputs for the next step() inputs.
+ *      Timestamps and performance counters are not modelled.
+ *  polyphase: dds_polyphase.sv, LANES phases per clock.
+ *  sin_cos_lut: DDS Compiler as in bd/generator.bd.tcl, Phase_Width 16,
+ *      Output_Width 14, Negative_Sine, full range amplitude. Same table as
+ *      sw/host/cosim/dds_lut_model.sv.
+ *  generator: the three of them as wired in mm2s_dds_modulator.v, plus the
+ *      self clearing COMMIT/DEBUG bits of the register bank. Registers reach
+ *      the modulator on the next clock, the CDC delay is not modelled.
+ *      generate() and capture() run it in blocks: control path one clock
+ *      at a time, table lookups of the block in a single loop.
+ */
+#ifndef __DDS_MODEL
+#define __DDS_MODEL
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace dds_model {
+
+/* dds_modulator_package.sv */
+constexpr unsigned ENABLE_BIT = 0;
+constexpr unsigned DEBUG_BIT = 1;
+constexpr unsigned COMMIT_BIT = 2;
+constexpr unsigned ARM_BIT = 4;
+constexpr unsigned CODE_TABLE_BIT = 3;
+constexpr unsigned PINC_TABLE_BIT = 4;
+constexpr unsigned HOP_TABLE_BIT = 5;
+constexpr unsigned PERIOD_COUNTER_BITS = 16;
+constexpr unsigned PINC_BITS = 30;
+constexpr uint32_t PHASE_OFFSET_180 = 536870911;
+constexpr unsigned CODE_DEPTH = 4096;
+constexpr unsigned CODE_PHASE_BITS = 16;
+constexpr unsigned PINC_DEPTH = 2048;
+constexpr unsigned PINC_SLOPE_FRAC_BITS = 8;
+constexpr unsigned HOP_DEPTH = 512;
+constexpr unsigned HOP_DWELL_BITS = 16;
+constexpr unsigned MAX_DEBUG_PACKETS = 125000;
+
+/* DDS Compiler */
+constexpr unsigned PHASE_WIDTH = 16;
+constexpr unsigned OUTPUT_WIDTH = 14;
+/* Clocks from phase to data, dds_latency in bd/generator.bd.tcl. The
+ * Makefile passes it as BD_DDS_LATENCY */
+#ifndef BD_DDS_LATENCY
+#define BD_DDS_LATENCY 6
+#endif
+constexpr unsigned DDS_LATENCY = BD_DDS_LATENCY;
+/* dds_polyphase.sv */
+constexpr unsigned POLYPHASE_LATENCY = 3;
+constexpr unsigned MAX_LANES = 8;
+
+constexpr uint32_t PINC_MASK = (1u << PINC_BITS) - 1;
+constexpr uint32_t PERIOD_MASK = (1u << PERIOD_COUNTER_BITS) - 1;
+constexpr uint32_t CODE_ADDR_MASK = CODE_DEPTH - 1;
+
+/* Sign extends the low bits of a two's complement value */
+inline int64_t sign_extend(uint64_t value, unsigned bits){
+    uint64_t sign = 1ull << (bits - 1);
+    value &= (sign << 1) - 1;
+    return (int64_t) (value ^ sign) - (int64_t) sign;
+}
+
+struct modulator_inputs{
+    bool resetn = true;
+    /* config_reg_0..5 */
+    uint32_t reg[6] = {0};
+    bool tready = true;
+    bool capture_trig = false;
+};
+
+/* m_axis_modulation_tdata = {6'b0, prime, resync, 2'b00, offset, 2'b00, pinc} */
+struct modulator_beat{
+    uint32_t pinc = 0;
+    uint32_t offset = 0;
+    bool resync = false;
+    bool prime = false;
+    bool tvalid = false;
+    bool tlast = false;
+    bool tuser = false;
+};
+
+class modulator{
+public:
+    explicit modulator(unsigned lanes = 1) : debug_packets(MAX_DEBUG_PACKETS / lanes){
+        code_mem.assign(CODE_DEPTH, 0);
+        pinc_mem.assign(PINC_DEPTH, 0);
+        slope_mem.assign(PINC_DEPTH, 0);
+        hop_pinc_mem.assign(HOP_DEPTH, 0);
+        hop_dwell_mem.assign(HOP_DEPTH, 0);
+        reset();
+    }
+
+    /* Reset values of the registers with reset */
+    void reset(){
+        for (auto &r : active_reg) r = 0;
+        active_mode = MODE_NONE;
+        active_mc_start = active_mc_inc = active_mc_start_inc = 0;
+        active_mc_start_tc = false;
+        active_chip_last = 0;
+        period_counter_reg = 0;
+        mc_reg = mc_inc_reg = 0;
+        mc_tc_reg = false;
+        chip_counter_reg = table_addr_reg = 0;
+        pinc_interp_reg = 0;
+        pinc_interp_first = true;
+        packet_counter = 0;
+        capture_done = false;
+        out = modulator_beat();
+        tvalid_q = false;
+        dds_en_q = false;
+    }
+
+    /* Table write ports, table loader word layout */
+    void write_code(unsigned addr, uint32_t data){
+        code_mem[addr & CODE_ADDR_MASK] = data & 0xFFFF;
+    }
+    void write_pinc(unsigned word_addr, uint32_t data){
+        unsigned entry = (word_addr >> 1) & (PINC_DEPTH - 1);
+        if (word_addr & 1) slope_mem[entry] = (int32_t) data;
+        else pinc_mem[entry] = data & PINC_MASK;
+    }
+    void write_hop(unsigned word_addr, uint32_t data){
+        unsigned entry = (word_addr >> 1) & (HOP_DEPTH - 1);
+        if (word_addr & 1) hop_dwell_mem[entry] = data;
+        else hop_pinc_mem[entry] = data & PINC_MASK;
+    }
+
+    /* Registered AXI-Stream output, tvalid already gated by tready */
+    modulator_beat output(bool tready) const{
+        modulator_beat b = out;
+        b.tvalid = tvalid_q && tready;
+        return b;
+    }
+    bool dds_en() const{
+        return dds_en_q;
+    }
+
+    /* Combinational outputs for inputs in */
+    bool commit_done(const modulator_inputs &in) const{
+        return _decode(in).commit_done;
+    }
+    bool tlast(const modulator_inputs &in) const{
+        return _decode(in).tlast;
+    }
+
+    /* One clk_i rising edge */
+    void step(const modulator_inputs &in){
+        const comb c = _decode(in);
+        const uint32_t *r = in.reg;
+
+        /* Table reads, BRAM registers have no reset */
+        code_phase = code_mem[c.table_addr_d];
+        pinc_entry = pinc_mem[c.table_addr_d & (PINC_DEPTH - 1)];
+        pinc_slope_q = pinc_slope;
+        pinc_slope = slope_mem[c.table_addr_d & (PINC_DEPTH - 1)];
+        hop_pinc = hop_pinc_mem[c.table_addr_d & (HOP_DEPTH - 1)];
+        hop_dwell_word = hop_dwell_mem[c.table_addr_d & (HOP_DEPTH - 1)];
+
+        if (!in.resetn){
+            reset();
+            return;
+        }
+
+        /* Commit logic */
+        if (c.config_load){
+            bool freq_mod = ((r[1] >> 1) & 1) && ((r[1] >> 2) & 1);
+            bool ramp = freq_mod && !((r[1] >> PINC_TABLE_BIT) & 1) && !((r[1] >> HOP_TABLE_BIT) & 1);
+            bool tables = (r[1] >> CODE_TABLE_BIT) & 7;
+
+            for (int i = 1; i <= 5; i++) active_reg[i] = r[i];
+            active_mode = _decode_mode(r[1]);
+            active_mc_start = c.staged_mc_start;
+            active_mc_inc = ramp ? (r[5] & PINC_MASK) : 1;
+            active_mc_start_inc = c.staged_mc_start_inc;
+            active_mc_start_tc = c.staged_mc_start_tc;
+            active_chip_last = ((tables ? (r[5] & 0xFFFF) : (r[5] >> 28)) - 1) & 0xFFFF;
+        }
+
+        /* Period counter */
+        if (period_counter_reg == c.period_counter_stop || c.armed) period_counter_reg = 0;
+        else if (c.modulator_en && c.period_counter_en) period_counter_reg = (period_counter_reg + 1) & PERIOD_MASK;
+
+        /* Modulation counter */
+        if (c.config_load){
+            mc_reg = c.staged_mc_start;
+            mc_inc_reg = c.staged_mc_start_inc;
+            mc_tc_reg = c.staged_mc_start_tc;
+        }
+        else if (c.modulation_counter_en && !mc_tc_reg){
+            bool tc = mc_inc_reg >= c.modulation_counter_stop;
+            mc_reg = mc_inc_reg;
+            mc_inc_reg = (mc_inc_reg + c.active_mc_inc) & PINC_MASK;
+            mc_tc_reg = tc;
+        }
+        else {
+            mc_reg = active_mc_start;
+            mc_inc_reg = active_mc_start_inc;
+            mc_tc_reg = active_mc_start_tc;
+        }
+
+        /* Chip counter and table address */
+        chip_counter_reg = c.chip_counter_d;
+        table_addr_reg = c.table_addr_d;
+
+        /* PINC table interpolation */
+        if (c.pinc_interp_run)
+            pinc_interp_reg = pinc_interp_first ? c.pinc_slope : sign_extend(pinc_interp_reg + c.pinc_slope_q, INTERP_BITS);
+        else
+            pinc_interp_reg = 0;
+        pinc_interp_first = !c.pinc_interp_run;
+
+        /* Debug capture */
+        if (c.capture_run){
+            if (packet_counter == debug_packets - 1){
+                packet_counter = 0;
+                capture_done = true;
+            }
+            else packet_counter++;
+        }
+        else packet_counter = 0;
+        if (!c.dbg_en) capture_done = false;
+
+        /* Output registers, prime beat while armed */
+        out.pinc = (c.resync || c.armed) ? 0 : c.tdata_pinc;
+        out.offset = c.armed ? 0 : c.tdata_offset;
+        out.resync = c.resync || c.armed;
+        out.prime = c.armed;
+        out.tlast = c.tlast;
+        out.tuser = c.capture_start;
+        tvalid_q = c.tvalid && c.modulator_en;
+        dds_en_q = c.modulator_en || c.armed;
+    }
+
+private:
+    enum mode_e { MODE_NONE, MODE_CONT_NO_MOD, MODE_CONT_MOD_FREC, MODE_CONT_MOD_PHASE,
+                  MODE_PULS_NO_MOD, MODE_PULS_MOD_FREC, MODE_PULS_MOD_PHASE };
+
+    /* pinc_interp_reg width, PINC_BITS + PINC_SLOPE_FRAC_BITS + 1 */
+    static constexpr unsigned INTERP_BITS = PINC_BITS + PINC_SLOPE_FRAC_BITS + 1;
+
+    /* Combinational signals of one clock */
+    struct comb{
+        bool modulator_en, armed, dbg_en, config_load, commit_done;
+        bool modulation_counter_en, chip_counter_en, period_counter_en;
+        uint32_t modulation_counter_stop, period_counter_stop;
+        uint32_t tdata_pinc, tdata_offset;
+        bool tvalid, resync;
+        uint32_t staged_mc_start, staged_mc_start_inc;
+        bool staged_mc_start_tc;
+        uint32_t active_mc_inc;
+        uint32_t chip_counter_d, table_addr_d;
+        bool pinc_interp_run;
+        int64_t pinc_slope, pinc_slope_q;
+        bool capture_run, capture_start, tlast;
+    };
+
+    static mode_e _decode_mode(uint32_t reg_1){
+        switch (reg_1 & 7){
+            case 1: case 5: return MODE_CONT_NO_MOD;
+            case 7:         return MODE_CONT_MOD_FREC;
+            case 3:         return MODE_CONT_MOD_PHASE;
+            case 0: case 4: return MODE_PULS_NO_MOD;
+            case 6:         return MODE_PULS_MOD_FREC;
+            default:        return MODE_PULS_MOD_PHASE;
+        }
+    }
+
+    comb _decode(const modulator_inputs &in) const{
+        comb c{};
+        const uint32_t *r = in.reg;
+        const uint32_t a1 = active_reg[1], a2 = active_reg[2], a3 = active_reg[3],
+                       a4 = active_reg[4], a5 = active_reg[5];
+
+        c.modulator_en = (r[0] >> ENABLE_BIT) & 1;
+        c.armed = ((r[0] >> ARM_BIT) & 1) && !c.modulator_en;
+        c.dbg_en = ((r[0] >> DEBUG_BIT) & 1) || in.capture_trig;
+        bool commit_req = (r[0] >> COMMIT_BIT) & 1;
+
+        bool pulsed_mode = a1 & 1;   // Set in continuous modes, as in the RTL
+        bool code_table_en = (a1 >> CODE_TABLE_BIT) & 1;
+        bool pinc_table_en = (a1 >> PINC_TABLE_BIT) & 1;
+        bool hop_table_en = (a1 >> HOP_TABLE_BIT) & 1;
+        uint32_t period = a2 & PERIOD_MASK;
+        uint32_t tau = (a2 >> 16) & PERIOD_MASK;
+        uint32_t pinc = a3 & PINC_MASK;
+        uint32_t length = a4 & PINC_MASK;
+        uint32_t barker_sequence = a5 & 0x1FFF;
+
+        uint32_t code_offset = (code_phase << (PINC_BITS - CODE_PHASE_BITS)) & PINC_MASK;
+        uint32_t pinc_interp = (uint32_t) (pinc_interp_reg >> PINC_SLOPE_FRAC_BITS) & PINC_MASK;
+        uint32_t pinc_table_pinc = (pinc_entry + pinc_interp) & PINC_MASK;
+        uint32_t hop_dwell_length = hop_dwell_word & ((1u << HOP_DWELL_BITS) - 1);
+        uint32_t hop_offset = ((hop_dwell_word >> 16) << (PINC_BITS - CODE_PHASE_BITS)) & PINC_MASK;
+        uint32_t barker_offset = ((barker_sequence >> chip_counter_reg) & 1) ? 0 : PHASE_OFFSET_180;
+
+        /* State logic decoding */
+        uint32_t pulse_length = 0;
+        bool pulse_timeout_n;
+        c.tvalid = true;
+        /* pulse_timeout_n only depends on period_counter_reg and pulse_length */
+        auto timeout_n = [&](){ return pulsed_mode ? true : (period_counter_reg < pulse_length); };
+
+        switch (active_mode){
+            case MODE_CONT_NO_MOD:
+                c.tdata_pinc = pinc;
+                break;
+            case MODE_CONT_MOD_FREC:
+                c.modulation_counter_en = true;
+                if (pinc_table_en){
+                    c.modulation_counter_stop = length;
+                    c.chip_counter_en = true;
+                    c.tdata_pinc = pinc_table_pinc;
+                }
+                else if (hop_table_en){
+                    c.modulation_counter_stop = hop_dwell_length;
+                    c.chip_counter_en = true;
+                    c.tdata_pinc = hop_pinc;
+                    c.tdata_offset = hop_offset;
+                }
+                else {
+                    c.modulation_counter_stop = length;
+                    c.tdata_pinc = mc_reg;
+                }
+                break;
+            case MODE_CONT_MOD_PHASE:
+                c.modulation_counter_en = true;
+                c.modulation_counter_stop = length;
+                c.chip_counter_en = true;
+                c.tdata_offset = code_table_en ? code_offset : barker_offset;
+                c.tdata_pinc = pinc;
+                break;
+            case MODE_PULS_NO_MOD:
+                c.period_counter_en = true;
+                c.period_counter_stop = period;
+                pulse_length = tau;
+                c.tdata_pinc = pinc;
+                break;
+            case MODE_PULS_MOD_FREC:
+                c.period_counter_en = true;
+                c.period_counter_stop = period;
+                pulse_length = tau;
+                c.modulation_counter_en = timeout_n();
+                if (pinc_table_en){
+                    c.modulation_counter_stop = length;
+                    c.chip_counter_en = timeout_n();
+                    c.tdata_pinc = pinc_table_pinc;
+                }
+                else if (hop_table_en){
+                    c.modulation_counter_stop = hop_dwell_length;
+                    c.chip_counter_en = timeout_n();
+                    c.tdata_pinc = hop_pinc;
+                    c.tdata_offset = hop_offset;
+                }
+                else {
+                    c.modulation_counter_stop = length;
+                    c.tdata_pinc = mc_reg;
+                }
+                break;
+            case MODE_PULS_MOD_PHASE:
+                c.period_counter_en = true;
+                c.period_counter_stop = period;
+                pulse_length = tau;
+                c.chip_counter_en = timeout_n();
+                c.modulation_counter_en = timeout_n();
+                c.modulation_counter_stop = length;
+                c.tdata_offset = code_table_en ? code_offset : barker_offset;
+                c.tdata_pinc = pinc;
+                break;
+            default:
+                c.tvalid = false;
+                break;
+        }
+        pulse_timeout_n = timeout_n();
+
+        /* Commit logic */
+        bool period_wrap = c.period_counter_en && (period_counter_reg == c.period_counter_stop);
+        c.commit_done = commit_req && (!c.modulator_en || pulsed_mode || period_wrap);
+        c.config_load = !c.modulator_en || c.commit_done;
+
+        /* Staged config */
+        bool freq_mod = ((r[1] >> 1) & 1) && ((r[1] >> 2) & 1);
+        bool ramp = freq_mod && !((r[1] >> PINC_TABLE_BIT) & 1) && !((r[1] >> HOP_TABLE_BIT) & 1);
+        bool hop = freq_mod && !((r[1] >> PINC_TABLE_BIT) & 1) && ((r[1] >> HOP_TABLE_BIT) & 1);
+        c.staged_mc_start = ramp ? (r[3] & PINC_MASK) : 0;
+        c.staged_mc_start_inc = (c.staged_mc_start + (ramp ? (r[5] & PINC_MASK) : 1)) & PINC_MASK;
+        c.staged_mc_start_tc = !hop && (c.staged_mc_start >= (r[4] & PINC_MASK));
+        c.active_mc_inc = active_mc_inc;
+
+        /* Modulation and chip counters */
+        bool expired = c.modulator_en && c.modulation_counter_en && mc_tc_reg && !c.commit_done;
+        bool wrap = chip_counter_reg == active_chip_last;
+        uint32_t chip_counter_next = expired ? (wrap ? 0 : (chip_counter_reg + 1) & CODE_ADDR_MASK) : chip_counter_reg;
+        bool chip_counter_run = c.chip_counter_en && c.modulator_en && !c.commit_done;
+        c.chip_counter_d = chip_counter_run ? chip_counter_next : 0;
+
+        uint32_t table_start = (a5 >> 16) & CODE_ADDR_MASK;
+        uint32_t table_start_d = c.config_load ? ((r[5] >> 16) & CODE_ADDR_MASK) : table_start;
+        if (!chip_counter_run) c.table_addr_d = table_start_d;
+        else if (expired) c.table_addr_d = wrap ? table_start : (table_addr_reg + 1) & CODE_ADDR_MASK;
+        else c.table_addr_d = table_addr_reg;
+
+        c.pinc_interp_run = chip_counter_run && !expired;
+        c.pinc_slope = pinc_slope;
+        c.pinc_slope_q = pinc_slope_q;
+
+        c.resync = !pulse_timeout_n && c.modulator_en;
+
+        /* Debug capture */
+        c.capture_run = in.tready && c.modulator_en && c.dbg_en && !capture_done;
+        c.tlast = c.capture_run && packet_counter == debug_packets - 1;
+        c.capture_start = c.capture_run && packet_counter == 0;
+        return c;
+    }
+
+    const uint32_t debug_packets;
+
+    /* Tables */
+    std::vector<uint32_t> code_mem, pinc_mem, hop_pinc_mem, hop_dwell_mem;
+    std::vector<int32_t> slope_mem;
+    uint32_t code_phase = 0, pinc_entry = 0, hop_pinc = 0, hop_dwell_word = 0;
+    int32_t pinc_slope = 0, pinc_slope_q = 0;
+
+    /* Active config */
+    uint32_t active_reg[6];
+    mode_e active_mode;
+    uint32_t active_mc_start, active_mc_inc, active_mc_start_inc;
+    bool active_mc_start_tc;
+    uint32_t active_chip_last;
+
+    /* Counters */
+    uint32_t period_counter_reg;
+    uint32_t mc_reg, mc_inc_reg;
+    bool mc_tc_reg;
+    uint32_t chip_counter_reg, table_addr_reg;
+    int64_t pinc_interp_reg;
+    bool pinc_interp_first;
+    uint32_t packet_counter;
+    bool capture_done;
+
+    /* Output registers */
+    modulator_beat out;
+    bool tvalid_q;
+    bool dds_en_q;
+};
+
+/* Lane phases of one clock, PHASE_WIDTH bits each */
+struct phase_beat{
+    uint16_t phase[MAX_LANES] = {0};
+    bool tvalid = false;
+    bool tlast = false;
+    bool tuser = false;
+};
+
+class polyphase{
+public:
+    explicit polyphase(unsigned lanes = 1) : lanes(lanes){
+        reset();
+    }
+
+    void reset(){
+        pinc_q = offset_q = acc_reg = base_reg = 0;
+        resync_q = false;
+        for (unsigned k = 0; k < MAX_LANES; k++) lane_step[k] = 0;
+        out = phase_beat();
+        tvalid_pipe = tlast_pipe = tuser_pipe = 0;
+    }
+
+    const phase_beat &output() const{
+        return out;
+    }
+
+    void step(bool resetn, bool en, const modulator_beat &in){
+        if (!resetn){
+            reset();
+            return;
+        }
+        if (!en) return;
+
+        /* Stage 3 */
+        for (unsigned k = 0; k < lanes; k++)
+            out.phase[k] = ((base_reg + lane_step[k]) & PINC_MASK) >> (PINC_BITS - PHASE_WIDTH);
+        /* Stage 2 */
+        uint32_t acc_start = resync_q ? 0 : acc_reg;
+        base_reg = acc_start;
+        acc_reg = (acc_start + lanes * pinc_q) & PINC_MASK;
+        for (unsigned k = 0; k < lanes; k++)
+            lane_step[k] = (k * pinc_q + offset_q) & PINC_MASK;
+        /* Stage 1, prime beats load like valid ones */
+        bool load = in.tvalid || in.prime;
+        if (load){
+            pinc_q = in.pinc;
+            offset_q = in.offset;
+        }
+        resync_q = load && in.resync;
+
+        tvalid_pipe = (tvalid_pipe << 1) | in.tvalid;
+        tlast_pipe = (tlast_pipe << 1) | in.tlast;
+        tuser_pipe = (tuser_pipe << 1) | in.tuser;
+        out.tvalid = (tvalid_pipe >> (POLYPHASE_LATENCY - 1)) & 1;
+        out.tlast = (tlast_pipe >> (POLYPHASE_LATENCY - 1)) & 1;
+        out.tuser = (tuser_pipe >> (POLYPHASE_LATENCY - 1)) & 1;
+    }
+
+private:
+    const unsigned lanes;
+    uint32_t pinc_q, offset_q, acc_reg, base_reg;
+    bool resync_q;
+    uint32_t lane_step[MAX_LANES];
+    phase_beat out;
+    uint32_t tvalid_pipe, tlast_pipe, tuser_pipe;
+};
+
+/**
+ * DDS Compiler SIN/COS table. Sample is [Sine|Cosine], 16 bit each:
+ *     cosine[p] =  round(A * cos(2*pi*p / 2^PHASE_WIDTH))
+ *     sine[p]   = -round(A * sin(2*pi*p / 2^PHASE_WIDTH))
+ * A = 2^(OUTPUT_WIDTH-1) - 1, rounding half away from zero.
+ */
+class sin_cos_lut{
+public:
+    static const sin_cos_lut &get(){
+        static const sin_cos_lut lut;
+        return lut;
+    }
+
+    uint32_t operator[](uint16_t phase) const{
+        return table[phase];
+    }
+
+    static int16_t cosine(uint32_t sample){
+        return (int16_t) (sample & 0xFFFF);
+    }
+    static int16_t sine(uint32_t sample){
+        return (int16_t) (sample >> 16);
+    }
+
+    /* i = cosine, q = sine of each phase */
+    void lookup(const uint16_t *phase, size_t n, int16_t *i, int16_t *q) const{
+        const uint32_t *t = table.data();
+        for (size_t k = 0; k < n; k++){
+            uint32_t s = t[phase[k]];
+            i[k] = (int16_t) s;
+            q[k] = (int16_t) (s >> 16);
+        }
+    }
+
+private:
+    sin_cos_lut() : table(1u << PHASE_WIDTH){
+        const double pi = 3.14159265358979323846;
+        const double amplitude = (1 << (OUTPUT_WIDTH - 1)) - 1;
+        const double depth = 1u << PHASE_WIDTH;
+        for (uint32_t p = 0; p < table.size(); p++){
+            uint16_t c = (uint16_t) _round(amplitude * std::cos(2.0 * pi * p / depth));
+            uint16_t s = (uint16_t) -_round(amplitude * std::sin(2.0 * pi * p / depth));
+            table[p] = ((uint32_t) s << 16) | c;
+        }
+    }
+
+    static int32_t _round(double value){
+        return (int32_t) (value >= 0.0 ? value + 0.5 : value - 0.5);
+    }
+
+    std::vector<uint32_t> table;
+};
+
+/* One clock of DDS Compiler outputs, LANES samples */
+struct dds_beat{
+    uint32_t data[MAX_LANES] = {0};
+    bool tvalid = false;
+    bool tlast = false;
+    bool tuser = false;
+};
+
+class generator{
+public:
+    explicit generator(unsigned lanes = 1, unsigned dds_latency = DDS_LATENCY)
+        : lanes(lanes), mod(lanes), poly(lanes), dds_pipe(dds_latency){
+        reset();
+    }
+
+    unsigned num_lanes() const{
+        return lanes;
+    }
+
+    /* Clocks from the one ENABLE_BIT reaches the modulator to the first
+     * sample out of the DDS, armed start */
+    unsigned start_latency() const{
+        return 1 + POLYPHASE_LATENCY + dds_pipe.size();
+    }
+
+    /* DDS_ARESETN pulse, tables keep their contents */
+    void reset(){
+        in.resetn = false;
+        clock();
+        in.resetn = true;
+        for (auto &r : in.reg) r = 0;
+        for (auto &b : dds_pipe) b = phase_beat();
+        clocks = 0;
+    }
+
+    /* config_reg_0..5 as written by the driver (REG_0..REG_5) */
+    void write_reg(unsigned index, uint32_t value){
+        in.reg[index] = value;
+    }
+    uint32_t read_reg(unsigned index) const{
+        return in.reg[index];
+    }
+
+    void load_code(unsigned offset, const uint32_t *chips, size_t count){
+        for (size_t i = 0; i < count; i++) mod.write_code(offset + i, chips[i]);
+    }
+    void load_pinc(unsigned entry, const uint32_t *pinc, const int32_t *slope, size_t count){
+        for (size_t i = 0; i < count; i++){
+            mod.write_pinc(2 * (entry + i), pinc[i]);
+            mod.write_pinc(2 * (entry + i) + 1, (uint32_t) slope[i]);
+        }
+    }
+    void load_hop(unsigned entry, const uint32_t *pinc, const uint32_t *dwell_word, size_t count){
+        for (size_t i = 0; i < count; i++){
+            mod.write_hop(2 * (entry + i), pinc[i]);
+            mod.write_hop(2 * (entry + i) + 1, dwell_word[i]);
+        }
+    }
+
+    /* DDS backpressure, s_axis_phase_tready low */
+    void set_stall(bool stall){
+        in.tready = !stall;
+    }
+
+    /* One DDS clock. Returns the DDS output after the edge, LUT not applied */
+    const phase_beat &clock(){
+        bool en = mod.dds_en();
+        bool commit_done = mod.commit_done(in);
+        bool tlast = mod.tlast(in);
+
+        /* DDS Compiler pipeline, frozen with ACLKEN low */
+        if (!in.resetn){
+            for (auto &b : dds_pipe) b = phase_beat();
+            head = 0;
+        }
+        else if (en && !dds_pipe.empty()){
+            dds_pipe[head] = poly.output();
+            head = (head + 1) % dds_pipe.size();
+        }
+        poly.step(in.resetn, en, mod.output(in.tready));
+        mod.step(in);
+        clocks++;
+
+        /* Register bank clears COMMIT and DEBUG */
+        if (commit_done) in.reg[0] &= ~(1u << COMMIT_BIT);
+        if (tlast) in.reg[0] &= ~(1u << DEBUG_BIT);
+        return output();
+    }
+
+    /* DDS Compiler output beat, phases before the LUT */
+    const phase_beat &output() const{
+        return dds_pipe.empty() ? poly.output() : dds_pipe[head];
+    }
+
+    /* DDS output of the current beat */
+    dds_beat sample_output() const{
+        dds_beat b;
+        const phase_beat &p = output();
+        for (unsigned k = 0; k < lanes; k++) b.data[k] = sin_cos_lut::get()[p.phase[k]];
+        b.tvalid = p.tvalid;
+        b.tlast = p.tlast;
+        b.tuser = p.tuser;
+        return b;
+    }
+
+    /**
+     * Runs until n valid samples came out of the DDS or max_clocks elapsed.
+     * Returns the samples written to i (cosine) and q (sine).
+     */
+    size_t generate(size_t n, int16_t *i, int16_t *q, uint64_t max_clocks = UINT64_MAX){
+        return _run(n, i, q, max_clocks, false);
+    }
+
+    /**
+     * Debug capture as seen by the DMA: sets DEBUG_BIT and returns the
+     * samples from the TUSER beat on, up to n or TLAST.
+     */
+    size_t capture(size_t n, int16_t *i, int16_t *q, uint64_t max_clocks = UINT64_MAX){
+        in.reg[0] |= 1u << DEBUG_BIT;
+        return _run(n, i, q, max_clocks, true);
+    }
+
+    uint64_t clocks = 0;
+
+private:
+    size_t _run(size_t n, int16_t *i, int16_t *q, uint64_t max_clocks, bool capture){
+        const sin_cos_lut &lut = sin_cos_lut::get();
+        /* Phases are collected in blocks, then looked up at once */
+        constexpr size_t BLOCK = 4096;
+        uint16_t phases[BLOCK + MAX_LANES];
+        size_t done = 0, pending = 0;
+        bool started = !capture;
+
+        for (uint64_t c = 0; c < max_clocks && done + pending < n; c++){
+            const phase_beat &b = clock();
+            if (!b.tvalid) continue;
+            if (!started && !b.tuser) continue;
+            started = true;
+            for (unsigned k = 0; k < lanes && done + pending < n; k++) phases[pending++] = b.phase[k];
+            if (pending >= BLOCK){
+                lut.lookup(phases, pending, i + done, q + done);
+                done += pending;
+                pending = 0;
+            }
+            if (capture && b.tlast) break;
+        }
+        lut.lookup(phases, pending, i + done, q + done);
+        return done + pending;
+    }
+
+    const unsigned lanes;
+    modulator_inputs in;
+    modulator mod;
+    polyphase poly;
+    std::vector<phase_beat> dds_pipe;
+    size_t head = 0;
+};
+
+/**
+ * Finds where a capture starts in a reference stream: first offset
+ * (up to max_offset) where all n capture samples match.
+ * Returns -1 if there is none.
+ */
+inline long find_alignment(const int16_t *ref_i, const int16_t *ref_q, size_t ref_n,
+                           const int16_t *cap_i, const int16_t *cap_q, size_t cap_n,
+                           size_t max_offset){
+    for (size_t o = 0; o <= max_offset && o + cap_n <= ref_n; o++){
+        size_t k = 0;
+        while (k < cap_n && ref_i[o + k] == cap_i[k] && ref_q[o + k] == cap_q[k]) k++;
+        if (k == cap_n) return (long) o;
+    }
+    return -1;
+}
+
+/* First sample where two streams differ, -1 if they match */
+inline long first_mismatch(const int16_t *a_i, const int16_t *a_q,
+                           const int16_t *b_i, const int16_t *b_q, size_t n){
+    for (size_t k = 0; k < n; k++){
+        if (a_i[k] != b_i[k] || a_q[k] != b_q[k]) return (long) k;
+    }
+    return -1;
+}
+
+}
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file dds_model_py.cpp
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Python bindings of the golden model (dds_model.hpp), module dds_model.
+ * Samples are returned as (i, q) int16 numpy arrays, i is the cosine.
+ *
+ *     import dds_model
+ *     gen = dds_model.Generator(lanes=1)
+ *     gen.write_regs([0, reg_1, reg_2, reg_3, reg_4, reg_5])
+ *     gen.clock()
+ *     gen.write_reg(0, 1 << dds_model.ENABLE_BIT)
+ *     i, q = gen.generate(100000)
+ *     offset = dds_model.find_alignment(i, q, cap_i, cap_q, len(i) - len(cap_i))
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include "dds_model.hpp"
+
+namespace py = pybind11;
+using namespace dds_model;
+
+typedef py::array_t<int16_t, py::array::c_style | py::array::forcecast> samples_t;
+typedef py::array_t<uint32_t, py::array::c_style | py::array::forcecast> words_t;
+
+/* Runs fn(n, i, q) into new arrays, trimmed to the samples returned */
+template <typename F>
+static py::tuple _samples(size_t n, F fn){
+    samples_t i(n), q(n);
+    size_t got;
+    {
+        py::gil_scoped_release release;
+        got = fn(n, i.mutable_data(), q.mutable_data());
+    }
+    i.resize({(py::ssize_t) got});
+    q.resize({(py::ssize_t) got});
+    return py::make_tuple(i, q);
+}
+
+static void _check_pair(const samples_t &i, const samples_t &q){
+    if (i.ndim() != 1 || q.ndim() != 1 || i.shape(0) != q.shape(0))
+        throw std::invalid_argument("i and q must be 1-D arrays of the same length");
+}
+
+PYBIND11_MODULE(dds_model, m){
+    m.doc() = "Bit exact model of a generator channel: dds_modulator, dds_polyphase and DDS Compiler";
+
+    m.attr("ENABLE_BIT") = ENABLE_BIT;
+    m.attr("DEBUG_BIT") = DEBUG_BIT;
+    m.attr("COMMIT_BIT") = COMMIT_BIT;
+    m.attr("ARM_BIT") = ARM_BIT;
+    m.attr("PINC_BITS") = PINC_BITS;
+    m.attr("PHASE_WIDTH") = PHASE_WIDTH;
+    m.attr("OUTPUT_WIDTH") = OUTPUT_WIDTH;
+    m.attr("DDS_LATENCY") = DDS_LATENCY;
+    m.attr("MAX_DEBUG_PACKETS") = MAX_DEBUG_PACKETS;
+
+    py::class_<generator>(m, "Generator")
+        .def(py::init<unsigned, unsigned>(), py::arg("lanes") = 1, py::arg("dds_latency") = DDS_LATENCY)
+        .def_property_readonly("lanes", &generator::num_lanes)
+        .def_readonly("clocks", &generator::clocks)
+        .def_property_readonly("start_latency", &generator::start_latency,
+            "Clocks from ENABLE_BIT to the first sample, armed start")
+        .def("reset", &generator::reset, "DDS_ARESETN pulse, tables keep their contents")
+        .def("write_reg", &generator::write_reg, py::arg("index"), py::arg("value"))
+        .def("read_reg", &generator::read_reg, py::arg("index"))
+        .def("write_regs", [](generator &g, const std::vector<uint32_t> &regs){
+                if (regs.size() > 6) throw std::invalid_argument("REG_0 to REG_5");
+                for (size_t r = 0; r < regs.size(); r++) g.write_reg(r, regs[r]);
+            }, py::arg("regs"), "REG_0, REG_1, ... as written by the driver")
+        .def("load_code", [](generator &g, unsigned offset, words_t chips){
+                g.load_code(offset, chips.data(), chips.size());
+            }, py::arg("offset"), py::arg("chips"))
+        .def("load_pinc", [](generator &g, unsigned entry, words_t pinc,
+                             py::array_t<int32_t, py::array::c_style | py::array::forcecast> slope){
+                if (pinc.size() != slope.size()) throw std::invalid_argument("pinc and slope lengths differ");
+                g.load_pinc(entry, pinc.data(), slope.data(), pinc.size());
+            }, py::arg("entry"), py::arg("pinc"), py::arg("slope"))
+        .def("load_hop", [](generator &g, unsigned entry, words_t pinc, words_t dwell_word){
+                if (pinc.size() != dwell_word.size()) throw std::invalid_argument("pinc and dwell_word lengths differ");
+                g.load_hop(entry, pinc.data(), dwell_word.data(), pinc.size());
+            }, py::arg("entry"), py::arg("pinc"), py::arg("dwell_word"))
+        .def("set_stall", &generator::set_stall, py::arg("stall"))
+        .def("clock", [](generator &g, uint64_t clocks){
+                for (uint64_t c = 0; c < clocks; c++) g.clock();
+            }, py::arg("clocks") = 1)
+        .def("output", [](const generator &g){
+                dds_beat b = g.sample_output();
+                py::list i, q;
+                for (unsigned k = 0; k < g.num_lanes(); k++){
+                    i.append(sin_cos_lut::cosine(b.data[k]));
+                    q.append(sin_cos_lut::sine(b.data[k]));
+                }
+                return py::dict(py::arg("i") = i, py::arg("q") = q, py::arg("tvalid") = b.tvalid,
+                                py::arg("tlast") = b.tlast, py::arg("tuser") = b.tuser);
+            }, "DDS output beat of the last clock")
+        .def("generate", [](generator &g, size_t n, uint64_t max_clocks){
+                return _samples(n, [&](size_t n, int16_t *i, int16_t *q){ return g.generate(n, i, q, max_clocks); });
+            }, py::arg("n"), py::arg("max_clocks") = UINT64_MAX,
+            "Next n valid samples, (i, q)")
+        .def("capture", [](generator &g, size_t n, uint64_t max_clocks){
+                return _samples(n, [&](size_t n, int16_t *i, int16_t *q){ return g.capture(n, i, q, max_clocks); });
+            }, py::arg("n") = MAX_DEBUG_PACKETS, py::arg("max_clocks") = UINT64_MAX,
+            "Debug capture: sets DEBUG_BIT, samples from TUSER to TLAST, (i, q)");
+
+    m.def("sin_cos", [](uint16_t phase){
+            uint32_t s = sin_cos_lut::get()[phase];
+            return py::make_tuple(sin_cos_lut::cosine(s), sin_cos_lut::sine(s));
+        }, py::arg("phase"), "DDS Compiler output for a PHASE_WIDTH phase, (i, q)");
+
+    m.def("find_alignment", [](samples_t ref_i, samples_t ref_q, samples_t cap_i, samples_t cap_q, size_t max_offset){
+            _check_pair(ref_i, ref_q);
+            _check_pair(cap_i, cap_q);
+            return find_alignment(ref_i.data(), ref_q.data(), ref_i.shape(0),
+                                  cap_i.data(), cap_q.data(), cap_i.shape(0), max_offset);
+        }, py::arg("ref_i"), py::arg("ref_q"), py::arg("cap_i"), py::arg("cap_q"), py::arg("max_offset"),
+        "First offset of ref where the whole capture matches, -1 if none");
+
+    m.def("first_mismatch", [](samples_t a_i, samples_t a_q, samples_t b_i, samples_t b_q){
+            _check_pair(a_i, a_q);
+            _check_pair(b_i, b_q);
+            size_t n = std::min(a_i.shape(0), b_i.shape(0));
+            return first_mismatch(a_i.data(), a_q.data(), b_i.data(), b_q.data(), n);
+        }, py::arg("a_i"), py::arg("a_q"), py::arg("b_i"), py::arg("b_q"),
+        "First sample where two streams differ, -1 if they match");
+}
@@ -0,0 +1,323 @@
+/**
+ * @file model_check.cpp
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Checks of the golden model (dds_model.hpp).
+ *   model_check: configs composed by the driver (detached instances), waveform
+ *       checks, capture alignment and model throughput.
+ *   model_check <trace>: replays a tb/dds_modulator_tb.sv trace (+trace=<file>)
+ *       and compares the modulator outputs clock by clock.
+ * Exits non zero on failure.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "dds_model.hpp"
+
+extern "C" {
+#include "generator.h"
+}
+
+using namespace dds_model;
+
+static int failures;
+
+static void check(bool ok, const char *name){
+    printf("%-44s %s\n", name, ok ? "ok" : "FAIL");
+    if (!ok){
+        failures++;
+    }
+}
+
+/*
+ * Trace replay
+ */
+
+/* Parses a hex token, false if it has X/Z bits */
+static bool _hex(const char *token, uint64_t &value){
+    char *end;
+    if (strpbrk(token, "xXzZ")) return false;
+    value = strtoull(token, &end, 16);
+    return *end == '\0';
+}
+
+/* 72 bit tdata: [71:64] in the top two hex digits */
+static bool _tdata(const char *token, modulator_beat &b){
+    size_t len = strlen(token);
+    uint64_t low, high = 0;
+    if (len > 16){
+        char top[8] = {0};
+        memcpy(top, token, len - 16 < 7 ? len - 16 : 7);
+        if (!_hex(top, high)) return false;
+        token += len - 16;
+    }
+    if (!_hex(token, low)) return false;
+    b.pinc = low & PINC_MASK;
+    b.offset = (low >> 32) & PINC_MASK;
+    b.resync = high & 1;
+    b.prime = (high >> 1) & 1;
+    return true;
+}
+
+static int replay_trace(const char *filename){
+    FILE *f = fopen(filename, "r");
+    char line[512];
+    modulator mod;
+    unsigned long lines = 0, compared = 0, mismatches = 0;
+
+    if (!f){
+        fprintf(stderr, "Can't open %s\n", filename);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), f)){
+        /* resetn reg0..5 tready trig | tdata tvalid tlast tuser dds_en commit_done */
+        char tok[15][32];
+        uint64_t v[9], tvalid, tlast, tuser, dds_en, commit_done;
+        modulator_inputs in;
+        modulator_beat ref;
+        bool known = true;
+
+        if (sscanf(line, "%31s %31s %31s %31s %31s %31s %31s %31s %31s %31s %31s %31s %31s %31s %31s",
+                   tok[0], tok[1], tok[2], tok[3], tok[4], tok[5], tok[6], tok[7], tok[8],
+                   tok[9], tok[10], tok[11], tok[12], tok[13], tok[14]) != 15){
+            continue;
+        }
+        lines++;
+        for (int i = 0; i < 9; i++){
+            if (!_hex(tok[i], v[i])){
+                v[i] = 0;
+                known = false;
+            }
+        }
+        in.resetn = v[0];
+        for (int i = 0; i < 6; i++) in.reg[i] = v[1 + i];
+        in.tready = v[7];
+        in.capture_trig = v[8];
+
+        known &= _tdata(tok[9], ref) && _hex(tok[10], tvalid) && _hex(tok[11], tlast) &&
+                 _hex(tok[12], tuser) && _hex(tok[13], dds_en) && _hex(tok[14], commit_done);
+
+        /* Outputs before the edge, X until the first reset edge */
+        if (known){
+            modulator_beat b = mod.output(in.tready);
+            bool same = b.tvalid == (bool) tvalid && b.tlast == (bool) tlast && b.tuser == (bool) tuser &&
+                        mod.dds_en() == (bool) dds_en && mod.commit_done(in) == (bool) commit_done;
+            /* Payload is don't care on invalid beats, but for prime ones */
+            if (tvalid || b.prime || ref.prime){
+                same &= b.pinc == ref.pinc && b.offset == ref.offset && b.resync == ref.resync &&
+                        b.prime == ref.prime;
+            }
+            compared++;
+            if (!same && mismatches++ < 10){
+                printf("line %lu: model pinc %08x offset %08x resync %d tvalid %d tlast %d tuser %d en %d commit %d\n"
+                       "%*s trace pinc %08x offset %08x resync %d tvalid %d tlast %d tuser %d en %d commit %d\n",
+                       lines, b.pinc, b.offset, b.resync, b.tvalid, b.tlast, b.tuser, mod.dds_en(), mod.commit_done(in),
+                       (int) (strlen("line ") + 1), "", ref.pinc, ref.offset, ref.resync, (int) tvalid, (int) tlast,
+                       (int) tuser, (int) dds_en, (int) commit_done);
+            }
+        }
+        mod.step(in);
+    }
+    fclose(f);
+
+    printf("%lu clocks, %lu compared, %lu mismatches\n", lines, compared, mismatches);
+    return (compared == 0 || mismatches) ? 1 : 0;
+}
+
+/*
+ * Self test with driver configs
+ */
+
+static Waveform_Generator_t hw;
+
+/* Register image of a detached instance to the model. Written while
+ * disabled, the active config follows it, then enabled */
+static void apply(generator &gen, Waveform_Generator_t *entry){
+    uint32_t image[GENERATOR_IMAGE_REGS];
+
+    generator_get_image(entry, image);
+    gen.reset();
+    for (int i = 0; i < GENERATOR_IMAGE_REGS; i++){
+        gen.write_reg(1 + i, image[i]);
+    }
+    gen.clock();
+    gen.write_reg(0, 1u << ENABLE_BIT);
+}
+
+static double freq_khz(const int16_t *i, const int16_t *q, size_t n, double fs_khz){
+    const double pi = 3.14159265358979323846;
+    double acc = 0;
+
+    for (size_t k = 1; k < n; k++){
+        double step = atan2(-q[k], i[k]) - atan2(-q[k-1], i[k-1]);
+        if (step > pi) step -= 2 * pi;
+        if (step < -pi) step += 2 * pi;
+        acc += step;
+    }
+    return acc / (n - 1) * fs_khz / (2 * pi);
+}
+
+static void self_test(unsigned lanes){
+    char name[64];
+    Waveform_Generator_t entry;
+    generator gen(lanes);
+    const size_t n = 200000;
+    std::vector<int16_t> i(n), q(n), ci(n), cq(n);
+    double fs_khz;
+
+    hw.fclk_khz = 200000;
+    hw.dds_lanes = lanes;
+    fs_khz = (double) hw.fclk_khz * lanes;
+
+    /* Continuous tone: frequency and amplitude */
+    generator_init_detached(&entry, &hw);
+    set_continuous_mode_constant_freq(&entry, 5000);
+    apply(gen, &entry);
+    size_t got = gen.generate(n, i.data(), q.data());
+    bool amplitude = got == n;
+    for (size_t k = 0; k < got && amplitude; k++){
+        double a = std::sqrt((double) i[k] * i[k] + (double) q[k] * q[k]);
+        amplitude = std::fabs(a - ((1 << (OUTPUT_WIDTH - 1)) - 1)) <= 2;
+    }
+    snprintf(name, sizeof(name), "L%u continuous: amplitude", lanes);
+    check(amplitude, name);
+    double f = freq_khz(i.data(), q.data(), got, fs_khz);
+    snprintf(name, sizeof(name), "L%u continuous: 5000 kHz (%.1f)", lanes, f);
+    check(std::fabs(f - 5000) < 1.0, name);
+
+    /* Pulsed: outside the pulse the phase is held at 0 (resync) */
+    generator_init_detached(&entry, &hw);
+    set_pulsed_mode_constant_freq(&entry, 100, 20, 5000);
+    apply(gen, &entry);
+    got = gen.generate(n, i.data(), q.data());
+    /* Whole periods, 100 us */
+    got -= got % (size_t) (fs_khz / 10);
+    size_t idle = 0;
+    for (size_t k = 0; k < got; k++){
+        idle += (i[k] == (1 << (OUTPUT_WIDTH - 1)) - 1 && q[k] == 0);
+    }
+    double duty = 1.0 - (double) idle / got;
+    snprintf(name, sizeof(name), "L%u pulsed: duty (%.3f)", lanes, duty);
+    check(std::fabs(duty - 0.2) < 0.01, name);
+
+    /* Capture: TLAST after MAX_DEBUG_PACKETS samples, found in the
+     * reference stream of the same config */
+    generator_init_detached(&entry, &hw);
+    set_pulsed_mode_freq_mod(&entry, 100, 20, 1000, 20000);
+    apply(gen, &entry);
+    got = gen.generate(n, i.data(), q.data());
+    gen.generate(12345, ci.data(), cq.data());
+    size_t captured = gen.capture(MAX_DEBUG_PACKETS, ci.data(), cq.data());
+    snprintf(name, sizeof(name), "L%u capture: %zu samples", lanes, captured);
+    check(captured == MAX_DEBUG_PACKETS, name);
+    /* Period is 100 us, look for the first 10000 samples in 1.5 periods */
+    long offset = find_alignment(i.data(), q.data(), got, ci.data(), cq.data(), 10000, (size_t) (fs_khz * 0.15));
+    snprintf(name, sizeof(name), "L%u capture: aligned to reference (%ld)", lanes, offset);
+    check(offset >= 0, name);
+}
+
+/* Armed start: no samples while armed, the first one start_latency()
+ * clocks after the enable, from phase 0 and the same on every start,
+ * even after a stop in the middle of a pulse */
+static void armed_start(unsigned lanes){
+    char name[64];
+    Waveform_Generator_t entry;
+    uint32_t image[GENERATOR_IMAGE_REGS];
+    generator gen(lanes);
+    const size_t n = 4096;
+    std::vector<int16_t> i[2], q[2];
+    bool gated = true, latency = true;
+
+    hw.fclk_khz = 200000;
+    hw.dds_lanes = lanes;
+    generator_init_detached(&entry, &hw);
+    set_pulsed_mode_freq_mod(&entry, 100, 20, 1000, 20000);
+    generator_get_image(&entry, image);
+    gen.reset();
+    for (int r = 0; r < GENERATOR_IMAGE_REGS; r++){
+        gen.write_reg(1 + r, image[r]);
+    }
+    gen.clock();
+
+    /* Not armed, stopped in the middle of a pulse */
+    gen.write_reg(0, 1u << ENABLE_BIT);
+    for (int c = 0; c < 3000; c++){
+        gen.clock();
+    }
+    gen.write_reg(0, 0);
+    gen.clock();
+
+    for (int start = 0; start < 2; start++){
+        /* The last run drains on the first clocks, then no samples */
+        gen.write_reg(0, 1u << ARM_BIT);
+        for (unsigned c = 0; c < 64; c++){
+            gated &= !gen.clock().tvalid || c < gen.start_latency();
+        }
+        gen.write_reg(0, (1u << ARM_BIT) | (1u << ENABLE_BIT));
+        unsigned clocks = 1;
+        while (!gen.clock().tvalid && clocks <= gen.start_latency()){
+            clocks++;
+        }
+        latency &= clocks == gen.start_latency();
+
+        i[start].resize(n);
+        q[start].resize(n);
+        dds_beat b = gen.sample_output();
+        for (unsigned k = 0; k < lanes; k++){
+            i[start][k] = sin_cos_lut::cosine(b.data[k]);
+            q[start][k] = sin_cos_lut::sine(b.data[k]);
+        }
+        gen.generate(n - lanes, i[start].data() + lanes, q[start].data() + lanes);
+        /* Stopped in the middle of the pulse, back to armed */
+        gen.write_reg(0, 1u << ARM_BIT);
+    }
+
+    snprintf(name, sizeof(name), "L%u armed: no samples while armed", lanes);
+    check(gated, name);
+    snprintf(name, sizeof(name), "L%u armed: start latency %u clocks", lanes, gen.start_latency());
+    check(latency, name);
+    snprintf(name, sizeof(name), "L%u armed: first sample at phase 0", lanes);
+    check(i[0][0] == (1 << (OUTPUT_WIDTH - 1)) - 1 && q[0][0] == 0, name);
+    snprintf(name, sizeof(name), "L%u armed: same samples on every start", lanes);
+    check(first_mismatch(i[0].data(), q[0].data(), i[1].data(), q[1].data(), n) < 0, name);
+}
+
+static void throughput(unsigned lanes){
+    Waveform_Generator_t entry;
+    generator gen(lanes);
+    const size_t n = 20000000;
+    std::vector<int16_t> i(n), q(n);
+
+    hw.fclk_khz = 200000;
+    hw.dds_lanes = lanes;
+    generator_init_detached(&entry, &hw);
+    set_continuous_mode_freq_mod(&entry, 1000, 20000, 100);
+    apply(gen, &entry);
+
+    auto t0 = std::chrono::steady_clock::now();
+    size_t got = gen.generate(n, i.data(), q.data());
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - t0;
+    printf("L%u: %zu samples in %.3f s: %.1f M samples/s, %.2f ms of waveform per second\n",
+           lanes, got, wall.count(), got * 1e-6 / wall.count(),
+           got / (hw.fclk_khz * lanes * 1e3) * 1e3 / wall.count());
+}
+
+int main(int argc, char **argv){
+    if (argc > 1){
+        return replay_trace(argv[1]);
+    }
+
+    self_test(1);
+    self_test(4);
+    armed_start(1);
+    armed_start(4);
+    throughput(1);
+    throughput(4);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+#ifndef __XIL_IO_MOCK
+#define __XIL_IO_MOCK
+
+#include "xil_types.h"
+
+/* Mapped register window, covers the generator AXI-Lite slave */
+#define MOCK_BASEADDR 0x40000000
+#define MOCK_NUM_REGS 1024
+
+typedef struct{
+    u32 reads;
+    u32 writes;
+    /* Words moved by DMA MM2S table loads */
+    u32 dma_words;
+}bus_counters_t;
+
+extern bus_counters_t bus_counters;
+extern u32 mock_regs[MOCK_NUM_REGS];
+
+void mock_reset_counters();
+
+#endif
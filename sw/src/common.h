@@ -8,8 +8,17 @@
 #ifndef __COMMON
 #define __COMMON
 
+#include <stdint.h>
+
+#include "log.h"
+
 #define THREAD_STACKSIZE 1024
 
-void print_info(const char *format, ...);
+/* Console output goes through the asynchronous logger (log.h):
+ * only a ring write on the caller, UART is written by drain task */
+#define print_info(format, ...) log_info(format, ##__VA_ARGS__)
+
+/* Kernel context switch counter, traceTASK_SWITCHED_IN() hook */
+#include "kernel_hooks.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**
+ * @file demodulator_app.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Radar Demodulator sub-app. Hosted alongside the generator sub-app.
+ * @date 2020-08-09
+ */
+
+#include "common.h"
+#include "demodulator_app.h"
+#include "lwipopts.h"
+#include "netif/xadapter.h"
+
+#include "messages.pb.h"
+
+extern void send_ack(int sock, Ack_msg_Retval retval);
+
+/**
+ * @brief Initialize demodulator sub-app structure.
+ * No task is created: messages are handled on the connection loop
+ * through demodulator_app_handle_message(), routed apart from the
+ * generator ones. Receive-side processing is not implemented yet.
+ * 
+ * @param app Demodulator sub-app instance pointer.
+ * @param first_message App creation message. Initial coniguration is received here.
+ * @param net_sock Connected socket where responses are written.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+int demodulator_app_init (demodulator_app_t *app, Base_msg *first_message, int net_sock){
+
+    *app = (demodulator_app_t){0};
+
+    /* Apply first configuration */
+    app->config = first_message->config.demodulator;
+
+    /* Socket is already accepted in main app */
+    app->net_sock = net_sock;
+
+    return 0;
+}
+
+/**
+ * @brief Demodulator sub-app message handler.
+ * Runs on the connection loop for every message routed to the demodulator.
+ * 
+ * @param app Demodulator sub-app instance pointer.
+ * @param message Received protobuf message.
+ * @return int DEMODULATOR_APP_EXIT when the sub-app is released,
+ * DEMODULATOR_APP_RUNNING otherwise.
+ */
+int demodulator_app_handle_message(demodulator_app_t *app, Base_msg *message){
+
+    switch (message->which_message)
+    {
+    case Base_msg_config_tag:
+        app->config = message->config.demodulator;
+        send_ack(app->net_sock, Ack_msg_Retval_ACK);
+        break;
+
+    case Base_msg_control_tag:
+        switch (message->control.command)
+        {
+        case Control_msg_Command_START:
+            app->enabled = 1;
+            send_ack(app->net_sock, Ack_msg_Retval_ACK);
+            break;
+
+        case Control_msg_Command_STOP:
+            app->enabled = 0;
+            send_ack(app->net_sock, Ack_msg_Retval_ACK);
+            break;
+
+        case Control_msg_Command_BROKEN_CONN:
+            print_info("%s: Exiting sub-app. \r\n",__FUNCTION__);
+            app->enabled = 0;
+            return DEMODULATOR_APP_EXIT;
+
+        default:
+            send_ack(app->net_sock, Ack_msg_Retval_BAD_COMMAND);
+            break;
+        }
+        break;
+
+    default:
+        log_warn("%s: Unknown message received \r\n",__FUNCTION__);
+        send_ack(app->net_sock, Ack_msg_Retval_INVALID_MSG);
+        break;
+    }
+
+    return DEMODULATOR_APP_RUNNING;
+}
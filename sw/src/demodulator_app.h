@@ -0,0 +1,25 @@
+#ifndef __DEMODULATOR_APP
+#define __DEMODULATOR_APP
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "messages.pb.h"
+
+/* demodulator_app_handle_message() return values */
+#define DEMODULATOR_APP_RUNNING 0
+#define DEMODULATOR_APP_EXIT 1
+
+typedef struct{
+    Demodulator_config_msg config;
+    uint8_t enabled;
+
+    /* Connected socket, responses are written here */
+    /* Socket is accepted in main_app */
+    int net_sock;
+}demodulator_app_t;
+
+int demodulator_app_init (demodulator_app_t *app, Base_msg *first_message, int net_sock);
+
+int demodulator_app_handle_message(demodulator_app_t *app, Base_msg *message);
+
+#endif
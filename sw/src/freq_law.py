@@ -0,0 +1,103 @@
+"""Computes generator PINC tables from a frequency law description.
+
+A law is a function of time giving the instantaneous frequency. It is
+sampled at the start of every table entry. With interpolation each entry
+also gets the slope to the next sample, so the generator sweeps linearly
+between entries instead of holding them.
+
+Usage:
+    python3 freq_law.py tangent --f0 1000 --f1 5000 --length-us 32 --entries 256 --interp
+    python3 freq_law.py points --points law.csv --length-us 32 --entries 128 -o table.json
+
+The JSON output is loaded with Generator.load_freq_law().
+"""
+import argparse
+import csv
+import json
+import math
+
+# Must match generator.h
+# DDS clock: dds_clk_mhz in bd/generator.bd.tcl, the firmware reads it from REG_8
+FCLK_HZ = 200000000
+# Samples per DDS clock: dds_lanes in bd/generator.bd.tcl, REG_9
+DDS_LANES = 1
+PINC_BITS = 30
+PINC_SLOPE_FRAC_BITS = 8
+PINC_TABLE_MAX_ENTRIES = 2048
+MAX_LANE_FREQ_KHZ = 20000
+
+def pinc(freq_khz, fclk_hz = FCLK_HZ, lanes = DDS_LANES):
+    """PINC is referred to the sample rate, fclk_hz * lanes."""
+    if freq_khz < 0 or freq_khz > MAX_LANE_FREQ_KHZ * lanes:
+        raise ValueError("Frequency out of range: {} kHz".format(freq_khz))
+    return int(round(freq_khz * 1000 * (1 << PINC_BITS) / (fclk_hz * lanes)))
+
+def linear(f0, f1):
+    """Linear FM, f0 to f1 kHz. t is normalized to the law length (0 to 1)."""
+    return lambda t: f0 + (f1 - f0) * t
+
+def tangent(f0, f1, beta = 1.2):
+    """Tangent FM: sweeps slower at the band edges, lowering range sidelobes.
+    beta (0 to pi/2) sets how non-linear the law is."""
+    fc = (f0 + f1) / 2
+    return lambda t: fc + (f1 - f0) / 2 * math.tan(beta * (2 * t - 1)) / math.tan(beta)
+
+def points(filename):
+    """Piecewise linear law from a CSV of (t, f_khz) rows, t normalized 0 to 1."""
+    with open(filename) as f:
+        pts = sorted((float(t), float(fk)) for t, fk in csv.reader(f))
+    def law(t):
+        for (t0, f0), (t1, f1) in zip(pts, pts[1:]):
+            if t <= t1:
+                return f0 + (f1 - f0) * (t - t0) / (t1 - t0) if t1 > t0 else f1
+        return pts[-1][1]
+    return law
+
+def compute_table(law, length_us, entries, interp = True, fclk_hz = FCLK_HZ, lanes = DDS_LANES):
+    """Samples law over length_us in entries steps. Entry length and slope
+    are in DDS clocks, whatever the lanes.
+    Returns (pinc, slope, entry_clocks) as used by Freq_law_Mod and Freq_law_table_msg."""
+    if entries < 1 or entries > PINC_TABLE_MAX_ENTRIES:
+        raise ValueError("Entries must be 1 to {}".format(PINC_TABLE_MAX_ENTRIES))
+    entry_clocks = int(length_us * fclk_hz / 1e6) // entries
+    if entry_clocks < 1:
+        raise ValueError("Law too short for {} entries".format(entries))
+    length_clocks = entry_clocks * entries
+    # One more sample: end of the last entry, interpolation target
+    samples = [pinc(law(k * entry_clocks / length_clocks), fclk_hz, lanes) for k in range(entries + 1)]
+    if interp:
+        slope = [int(round((samples[k + 1] - samples[k]) * (1 << PINC_SLOPE_FRAC_BITS) / entry_clocks))
+                 for k in range(entries)]
+    else:
+        slope = [0] * entries
+    return samples[:entries], slope, entry_clocks
+
+def main():
+    parser = argparse.ArgumentParser(description = "Generator PINC table from a frequency law")
+    parser.add_argument("law", choices = ["linear", "tangent", "points"])
+    parser.add_argument("--f0", type = float, help = "Start frequency, kHz")
+    parser.add_argument("--f1", type = float, help = "End frequency, kHz")
+    parser.add_argument("--beta", type = float, default = 1.2, help = "Tangent law shape")
+    parser.add_argument("--points", help = "CSV file, rows: t (0 to 1), f_khz")
+    parser.add_argument("--length-us", type = float, required = True)
+    parser.add_argument("--entries", type = int, required = True)
+    parser.add_argument("--interp", action = "store_true", help = "Interpolate between entries")
+    parser.add_argument("--fclk-mhz", type = float, default = FCLK_HZ / 1e6, help = "DDS clock, MHz")
+    parser.add_argument("--lanes", type = int, default = DDS_LANES, help = "Samples per DDS clock")
+    parser.add_argument("-o", "--output", default = "freq_law.json")
+    args = parser.parse_args()
+
+    if args.law == "linear":
+        law = linear(args.f0, args.f1)
+    elif args.law == "tangent":
+        law = tangent(args.f0, args.f1, args.beta)
+    else:
+        law = points(args.points)
+
+    table, slope, entry_clocks = compute_table(law, args.length_us, args.entries, args.interp, args.fclk_mhz * 1e6, args.lanes)
+    with open(args.output, "w+") as f:
+        json.dump({"pinc": table, "slope": slope, "entry_clocks": entry_clocks}, f)
+    print("{} entries of {} clocks written to {}".format(len(table), entry_clocks, args.output))
+
+if __name__ == "__main__":
+    main()
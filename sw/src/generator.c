@@ -1,61 +1,80 @@
+#include <stddef.h>
+
 #include "generator.h"
+#include "trace.h"
 #include "FreeRTOS.h"
 #include "task.h"
 
 /* Buffer to store debug samples */
-static u32 debug_samples[MAX_DEBUG_SAMPLES];
+static u32 debug_samples[CAPTURE_BUFFER_BYTES / sizeof(u32)];
+/* Table loader packet: header word and data */
+static u32 table_load_buffer[TABLE_LOAD_MAX_WORDS + 1];
+
+/* Config state of Waveform_Generator_t, debug_enabled to dirty */
+#define CONFIG_STATE_START offsetof(Waveform_Generator_t, debug_enabled)
+#define CONFIG_STATE_SIZE (offsetof(Waveform_Generator_t, dirty) + sizeof(uint32_t) - CONFIG_STATE_START)
+/* Config state before the config being composed. Configs are only
+ * applied from the connection loop, one at a time */
+static uint8_t config_backup[CONFIG_STATE_SIZE];
 
 /**
  * @brief Reads a specific addres.
  * Wrapper of xilinx function, abstraction to read from generator registers
  * 
- * @param r Register address
+ * @param g Waveform Generator instance
+ * @param offset Register offset
  * @return uint32_t Register value
  */
-static uint32_t _readReg(uint32_t r)
+static uint32_t _readReg(Waveform_Generator_t * g, uint32_t offset)
 {
-    return Xil_In32(r);
+    return Xil_In32(g->address + offset);
 }
 
 /**
  * @brief Writes to a specific addres.
  * Wrapper of xilinx function, abstraction to write from generator registers
  * 
- * @param addr Register Addres
+ * @param g Waveform Generator instance
+ * @param offset Register offset
  * @param data Data to be written
  */
-static void _writeReg(uint32_t addr, uint32_t data)
+static void _writeReg(Waveform_Generator_t * g, uint32_t offset, uint32_t data)
 {
-    Xil_Out32(addr, data);
+    TRACE_BEGIN(WRITE_REG);
+    Xil_Out32(g->address + offset, data);
+    TRACE_END(WRITE_REG);
 }
 
 /**
- * @brief Read a specific bit value form the specified address.
+ * @brief Sets a register value in the shadow copy.
+ * Register is marked dirty only if its value changed.
  * 
- * @param addr Register Address
- * @param bit bit number (0 to 31)
- * @return uint32_t 0 if FALSE 1 if TRUE
+ * @param g Waveform Generator instance
+ * @param offset Register offset
+ * @param data Register value
  */
-static uint32_t _readBit(uint32_t addr, uint32_t bit)
+static void _setReg(Waveform_Generator_t * g, uint32_t offset, uint32_t data)
 {
-    /* Read entire reg */
-    uint32_t temp = _readReg(addr);
-    // Enmascaro el bit solicitado
-    temp &= 1 << bit;
-    // Devuelvo el valor
-    return (temp ? 1 : 0);
+    uint32_t index = REG_INDEX(offset);
+
+    if (g->shadow[index] != data)
+    {
+        g->shadow[index] = data;
+        g->dirty |= 1U << index;
+    }
 }
+
 /**
- * @brief 
+ * @brief Sets a specific bit value in the shadow copy.
  * 
- * @param addr Writes a specific bit value form the specified address.
+ * @param g Waveform Generator instance
+ * @param offset Register offset
  * @param bit bit number (0 to 31)
  * @param value Bit value (True/False, 1/0)
  */
-static void _writeBit(uint32_t addr, uint32_t bit, uint32_t value)
+static void _setBit(Waveform_Generator_t * g, uint32_t offset, uint32_t bit, uint32_t value)
 {   
-    /* Read current register value */
-    uint32_t reg = _readReg(addr);
+    uint32_t reg = g->shadow[REG_INDEX(offset)];
 
     /* Change actual bit */
     if (value)
@@ -67,48 +86,278 @@ static void _writeBit(uint32_t addr, uint32_t bit, uint32_t value)
         reg = reg & ~(1 << bit);
     }
 
-    /* Rewrite modified value */
-    _writeReg(addr,reg);
+    _setReg(g, offset, reg);
+}
+
+/**
+ * @brief Writes dirty shadow registers to hardware.
+ * REG_0 (enable) is written last, so the core never starts
+ * with half a configuration.
+ * 
+ * @param g Waveform Generator instance
+ */
+static void _flush(Waveform_Generator_t * g)
+{
+    for (int index = GENERATOR_NUM_REGS - 1; index >= 0; index--)
+    {
+        if (!g->detached && (g->dirty & (1U << index)))
+        {
+            _writeReg(g, index << 2, g->shadow[index]);
+        }
+    }
+    g->dirty = 0;
+}
+
+/**
+ * @brief Waits until hardware latched the last committed configuration.
+ * Staging registers can't change before that. Takes one period of the
+ * config running when it was written at most, plus the CDC round trip:
+ * past COMMIT_MARGIN_US more the commit is lost (bitstream mismatch).
+ * 
+ * @param g Waveform Generator instance
+ * @return int -1 on ERROR (timeout, commit still pending), 0 on SUCCESS
+ */
+static int _wait_commit(Waveform_Generator_t * g)
+{
+    TickType_t timeout = pdMS_TO_TICKS((g->commit_period_us + COMMIT_MARGIN_US + 999) / 1000) + 1;
+    TickType_t start = xTaskGetTickCount();
+
+    if (!g->commit_pending)
+    {
+        return 0;
+    }
+
+    while (_readReg(g, REG_0_OFFSET) & (1 << COMMIT_BIT))
+    {
+        if (xTaskGetTickCount() - start > timeout)
+        {
+            return -1;
+        }
+    }
+    g->commit_pending = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Starts a configuration. Saves the config state: nothing reaches
+ * hardware until _end_config() accepts it.
+ * 
+ * @param g Waveform Generator instance
+ */
+static void _begin_config(Waveform_Generator_t * g)
+{
+    memcpy(config_backup, (uint8_t *) g + CONFIG_STATE_START, CONFIG_STATE_SIZE);
+
+    /* Register configs leave sequencer mode */
+    _setBit(g, REG_0_OFFSET, SEQ_EN_BIT, FALSE);
+}
+
+/**
+ * @brief Ends a configuration, writing it to hardware.
+ * Core is stopped (and disarmed) first unless live updates are enabled.
+ * While the core is running or armed on the trigger staged registers are
+ * committed: hardware latches them at the next period start, or at once
+ * while idle. The trigger raises ENABLE_BIT behind the driver's back, a
+ * plain write could be latched half way or never (train running). Commit
+ * bit is self clearing, so it is not kept in the shadow copy. A refused
+ * config is dropped: shadow copy and attributes go back to the state saved
+ * by _begin_config(), the core is not touched.
+ * 
+ * @param g Waveform Generator instance
+ * @param retval Config validation result, < 0 drops the config
+ * @return int -1 on ERROR (config refused, or last commit never latched:
+ * nothing written), 0 on SUCCESS
+ */
+static int _end_config(Waveform_Generator_t * g, int retval)
+{
+    if (retval < 0)
+    {
+        memcpy((uint8_t *) g + CONFIG_STATE_START, config_backup, CONFIG_STATE_SIZE);
+        return -1;
+    }
+
+    if (!g->live_update)
+    {
+        generator_stop(g);
+    }
+
+    if ((g->enabled || g->triggered) && g->dirty)
+    {
+        if (_wait_commit(g) < 0)
+        {
+            memcpy((uint8_t *) g + CONFIG_STATE_START, config_backup, CONFIG_STATE_SIZE);
+            return -1;
+        }
+        _flush(g);
+        _writeReg(g, REG_0_OFFSET, g->shadow[REG_INDEX(REG_0_OFFSET)] | (1 << COMMIT_BIT));
+        g->commit_pending = 1;
+        /* Latched at the wrap of the config running now */
+        g->commit_period_us = g->running_period_us;
+    }
+    else
+    {
+        _flush(g);
+    }
+
+    g->running_period_us = (g->mode == PULSED) ? g->period_us : 0;
+
+    return 0;
 }
 
-void generator_init(Waveform_Generator_t * g, uint32_t hw_address, uint32_t axi_dma_device_id){
+void generator_init(Waveform_Generator_t * g, uint32_t hw_address, uint32_t channel, uint32_t axi_dma_device_id){
     /* Set everything to NULL */
     memset(g,0,sizeof(Waveform_Generator_t));
     // TODO: Validate address received is on Zynq valid addresses
     g->address = hw_address;
+    g->channel = channel;
     g->axi_dma_device_id = axi_dma_device_id;
+    /* Conversions to clocks depend on the DDS clock the bitstream was built with */
+    g->fclk_khz = _readReg(g, REG_8_OFFSET);
+    g->dds_lanes = _readReg(g, REG_9_OFFSET);
+    /* Bitstreams without DDS clock register */
+    if (g->fclk_khz == 0)
+    {
+        g->fclk_khz = DEFAULT_FCLK_KHZ;
+    }
+    /* Bitstreams without polyphase DDS */
+    if (g->dds_lanes == 0)
+    {
+        g->dds_lanes = 1;
+    }
+    /* Stopped channels stay primed for a fixed latency start */
+    g->shadow[REG_INDEX(REG_0_OFFSET)] = 1 << ARM_BIT;
+    /* Hardware state is unknown: write every register once */
+    g->dirty = (1U << GENERATOR_NUM_REGS) - 1;
+    _flush(g);
 }
 
-int generator_enable_debug(Waveform_Generator_t * wg){
+/**
+ * @brief Initializes the DMA driver instance, once.
+ * 
+ * @param g Waveform generator instance
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int _dma_init(Waveform_Generator_t * g){
 
 	int Status;
-    /* Init DMA */
-    wg->axi_dma_cfg_ptr = XAxiDma_LookupConfig(wg->axi_dma_device_id);
-    if (!wg->axi_dma_cfg_ptr) {
+
+    if (g->dma_ready)
+    {
+        return 0;
+    }
+
+    g->axi_dma_cfg_ptr = XAxiDma_LookupConfig(g->axi_dma_device_id);
+    if (!g->axi_dma_cfg_ptr) {
 		return -1;
     }
 
-    Status = XAxiDma_CfgInitialize(&wg->axi_dma_inst, wg->axi_dma_cfg_ptr);
+    Status = XAxiDma_CfgInitialize(&g->axi_dma_inst, g->axi_dma_cfg_ptr);
 	if (Status != SUCCESS) {
 		return -1;
 	}
 
-    /* Init Debug Vector */
-	memset(debug_samples,0,MAX_DEBUG_BYTES);
-	
     /* Not working with interrupts yet. Not neccessary */
-    XAxiDma_IntrDisable(&wg->axi_dma_inst, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DEVICE_TO_DMA);
+    XAxiDma_IntrDisable(&g->axi_dma_inst, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DEVICE_TO_DMA);
+    XAxiDma_IntrDisable(&g->axi_dma_inst, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DMA_TO_DEVICE);
+
+    g->dma_ready = 1;
+    return 0;
+}
+
+/**
+ * @brief Resets the DMA after an error halted it or a transfer got stuck.
+ * Both channels are reset, the other one is idle: captures and table
+ * loads run from the same task.
+ * 
+ * @param g Waveform generator instance
+ */
+static void _dma_reset(Waveform_Generator_t * g){
+
+    XAxiDma_Reset(&g->axi_dma_inst);
+    for (int polls = 0; polls < DMA_RESET_POLLS && !XAxiDma_ResetIsDone(&g->axi_dma_inst); polls++)
+    {
+    }
+
+    XAxiDma_IntrDisable(&g->axi_dma_inst, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DEVICE_TO_DMA);
+    XAxiDma_IntrDisable(&g->axi_dma_inst, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DMA_TO_DEVICE);
+}
+
+int generator_enable_debug(Waveform_Generator_t * wg){
+
+    /* Init DMA */
+    if (_dma_init(wg) < 0) {
+		return -1;
+    }
+
+    /* Init Debug Vector */
+	memset(debug_samples,0,CAPTURE_BUFFER_BYTES);
     
     wg->debug_enabled = 1;
 
     return 0;
 }
 
+void generator_init_detached(Waveform_Generator_t * g, const Waveform_Generator_t * hw){
+    memset(g,0,sizeof(Waveform_Generator_t));
+    g->detached = 1;
+    g->fclk_khz = hw->fclk_khz;
+    g->dds_lanes = hw->dds_lanes;
+}
+
+void generator_arm(Waveform_Generator_t * g, uint8_t arm){
+    _setBit(g, REG_0_OFFSET, ARM_BIT, arm);
+    _flush(g);
+}
+
+int generator_ext_trigger_arm(Waveform_Generator_t * g, generator_trigger_edge_t edge, uint32_t holdoff_ns, uint8_t train){
+
+    uint64_t holdoff_clocks = (uint64_t) holdoff_ns * FCLK_KHZ(g) / 1000000;
+    uint32_t reg;
+
+    if (holdoff_clocks > TRIG_MAX_HOLDOFF_CLOCKS)
+    {
+        return -1;
+    }
+
+    /* ENABLE_BIT drops after every PRI, the sequencer would restart from
+     * entry 0 on each trigger */
+    if (!train && (g->shadow[REG_INDEX(REG_0_OFFSET)] & (1 << SEQ_EN_BIT)))
+    {
+        return -1;
+    }
+
+    /* Trigger only starts a stopped core */
+    g->enabled = 0;
+    g->triggered = 1;
+
+    reg = g->shadow[REG_INDEX(REG_0_OFFSET)] & ~(TRIG_EDGE_MASK | TRIG_HOLDOFF_MASK | (1 << ENABLE_BIT));
+    reg |= ((uint32_t) edge << TRIG_EDGE_BIT) | ((uint32_t) holdoff_clocks << TRIG_HOLDOFF_BIT);
+    _setReg(g, REG_0_OFFSET, reg);
+    _setBit(g, REG_0_OFFSET, TRIG_TRAIN_BIT, train);
+    _setBit(g, REG_0_OFFSET, TRIG_EN_BIT, TRUE);
+    _flush(g);
+
+    return 0;
+}
+
+void generator_ext_trigger_disarm(Waveform_Generator_t * g){
+    g->triggered = 0;
+
+    _setReg(g, REG_0_OFFSET, g->shadow[REG_INDEX(REG_0_OFFSET)] & ~TRIG_CONFIG_MASK);
+    _flush(g);
+}
+
+void generator_set_live_update(Waveform_Generator_t * g, uint8_t enable){
+    g->live_update = enable;
+}
+
 int generator_start(Waveform_Generator_t * g){
 
     g->enabled = 1;
 
-    _writeBit(g->address + REG_0_OFFSET, ENABLE_BIT, TRUE);
+    _setBit(g, REG_0_OFFSET, ENABLE_BIT, TRUE);
+    _flush(g);
 
     return 0;
 }
@@ -116,8 +365,11 @@ int generator_start(Waveform_Generator_t * g){
 int generator_stop(Waveform_Generator_t * g){
 
     g->enabled = 0;
+    g->triggered = 0;
 
-    _writeBit(g->address + REG_0_OFFSET, ENABLE_BIT, FALSE);
+    /* One REG_0 write: enable and trigger drop together */
+    _setReg(g, REG_0_OFFSET, g->shadow[REG_INDEX(REG_0_OFFSET)] & ~(TRIG_CONFIG_MASK | (1 << ENABLE_BIT)));
+    _flush(g);
 
     return 0;
 }
@@ -125,27 +377,54 @@ int generator_stop(Waveform_Generator_t * g){
 int generator_trigger_debug(Waveform_Generator_t * wg){
 	
     int retval = 0;
+    uint8_t running = 0;
+    TickType_t start;
+    u32 status;
 
-    if (wg->enabled)
+    /* Channels not running are zero in the capture, tlast comes from
+     * any running one */
+    for (uint32_t channel = 0; channel < GENERATOR_NUM_CHANNELS; channel++)
+    {
+        running |= wg[channel].enabled | wg[channel].triggered;
+    }
+
+    if (running)
     {    
-        Xil_DCacheFlushRange((UINTPTR)debug_samples, MAX_DEBUG_BYTES);
+        u32 header_words = CAPTURE_HEADER_WORDS(wg);
 
-        /* Enable generator debug */
-        _writeBit(wg->address + REG_0_OFFSET, DEBUG_BIT, TRUE);
+        Xil_DCacheFlushRange((UINTPTR)debug_samples, CAPTURE_BUFFER_BYTES);
 
-        /* Start DMA transfer */
-        int Status = XAxiDma_SimpleTransfer(&wg->axi_dma_inst,(UINTPTR) debug_samples, MAX_DEBUG_BYTES, XAXIDMA_DEVICE_TO_DMA);
+        /* Start DMA transfer. Hardware only streams the capture itself,
+         * so the DMA is armed before the trigger */
+        int Status = XAxiDma_SimpleTransfer(&wg->axi_dma_inst,(UINTPTR) debug_samples, CAPTURE_BYTES + header_words * sizeof(u32), XAXIDMA_DEVICE_TO_DMA);
 
         if (Status != XST_SUCCESS) {
             retval = -1;
         }
+        else
+        {
+            /* Enable generator debug. Hardware clears the bit after
+             * the last sample, so it is never kept in the shadow copy */
+            _writeReg(wg, REG_0_OFFSET, wg->shadow[REG_INDEX(REG_0_OFFSET)] | (1 << DEBUG_BIT));
+        }
         
         /* Some debugging of DMA Registers */
         //    u32 stat = XAxiDma_ReadReg(wg->axi_dma_inst.RegBase + (XAXIDMA_RX_OFFSET * XAXIDMA_DEVICE_TO_DMA), XAXIDMA_SR_OFFSET);
 
-        /* Wait and poll for DMA transfer end */
+        /* Wait and poll for DMA transfer end. A capture that loses its
+         * tlast beat never ends the transfer: the poll is bounded and the
+         * DMA is reset, as are DMA errors */
+        start = xTaskGetTickCount();
         while (retval == 0 && (XAxiDma_Busy(&wg->axi_dma_inst, XAXIDMA_DEVICE_TO_DMA)))
         {
+            status = XAxiDma_ReadReg(wg->axi_dma_inst.RegBase + XAXIDMA_RX_OFFSET, XAXIDMA_SR_OFFSET);
+            if ((status & XAXIDMA_ERR_ALL_MASK) ||
+                xTaskGetTickCount() - start > pdMS_TO_TICKS(CAPTURE_TIMEOUT_MS))
+            {
+                _dma_reset(wg);
+                retval = -1;
+                break;
+            }
             /* Wait 10 ms*/
             vTaskDelay(pdMS_TO_TICKS( 10 ));
         } 
@@ -155,13 +434,30 @@ int generator_trigger_debug(Waveform_Generator_t * wg){
         //    u32 curdes = XAxiDma_ReadReg(wg->axi_dma_inst.RegBase + (XAXIDMA_RX_OFFSET * XAXIDMA_DEVICE_TO_DMA), XAXIDMA_CDESC_OFFSET);
         //    u32 destAdd = XAxiDma_ReadReg(wg->axi_dma_inst.RegBase + (XAXIDMA_RX_OFFSET * XAXIDMA_DEVICE_TO_DMA), XAXIDMA_DESTADDR_OFFSET);
         
+        if (retval < 0)
+        {
+            wg->valid_debug_samples = 0;
+            return retval;
+        }
+
         /* Read how many bytes were transfered by DMA*/
         u32 buffLen = XAxiDma_ReadReg(wg->axi_dma_inst.RegBase + (XAXIDMA_RX_OFFSET * XAXIDMA_DEVICE_TO_DMA), XAXIDMA_BUFFLEN_OFFSET);
-        /* Transform number of bytes, to number of 32bit samples */
-        wg->valid_debug_samples = buffLen / sizeof(u32);
+        /* Transform number of bytes, to number of 32bit samples per channel */
+        if (buffLen > header_words * sizeof(u32))
+        {
+            wg->valid_debug_samples = (buffLen - header_words * sizeof(u32)) / (sizeof(u32) * GENERATOR_NUM_CHANNELS);
+        }
+        else
+        {
+            wg->valid_debug_samples = 0;
+        }
         if (wg->valid_debug_samples == 0){
             retval = -1;
         }
+        else
+        {
+            wg->capture_timestamp = ((uint64_t) debug_samples[1] << 32) | debug_samples[0];
+        }
     }
     else
     {
@@ -179,7 +475,7 @@ int generator_trigger_debug(Waveform_Generator_t * wg){
  */
 int _set_continuous(Waveform_Generator_t * g){
     g->mode = CONTINUOUS;
-    _writeBit(g->address + REG_1_OFFSET, MODE_BIT, CONTINUOUS_MODE);
+    _setBit(g, REG_1_OFFSET, MODE_BIT, CONTINUOUS_MODE);
     return 0;
 }
 
@@ -198,10 +494,11 @@ int _set_pulsed(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_len
     if(period_us <= MAX_PERIOD_US &&
        period_us >= MIN_PERIOD_US &&
        pulse_length_us >= MIN_PULSE_LENGTH_US &&
-       pulse_length_us < period_us)
+       pulse_length_us < period_us &&
+       US_TO_CLOCKS(g, period_us) <= PERIOD_MASK)
     {
         g->mode = PULSED;
-        _writeBit(g->address + REG_1_OFFSET, MODE_BIT, PULSED_MODE);
+        _setBit(g, REG_1_OFFSET, MODE_BIT, PULSED_MODE);
 
         g->period_us = period_us;
         g->pulse_length_us = pulse_length_us;    
@@ -209,8 +506,8 @@ int _set_pulsed(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_len
         /* Align bits as required */
         /* Pulse length in high nibbles */
         /* Period in low nibbles */
-        uint32_t pulse_data = (((g->pulse_length_us * FCLK_MHZ) & PERIOD_MASK) << 16) | (((g->period_us * FCLK_MHZ) & PERIOD_MASK));
-        _writeReg(g->address + REG_2_OFFSET, pulse_data);
+        uint32_t pulse_data = ((US_TO_CLOCKS(g, g->pulse_length_us) & PERIOD_MASK) << 16) | (US_TO_CLOCKS(g, g->period_us) & PERIOD_MASK);
+        _setReg(g, REG_2_OFFSET, pulse_data);
     
     }
     else
@@ -240,7 +537,10 @@ int _set_pulsed(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_len
  */
 int _disable_modulation(Waveform_Generator_t * g){
     g->modulation_en = FALSE;
-    _writeBit(g->address + REG_1_OFFSET, MODULATION_EN_BIT, FALSE);
+    _setBit(g, REG_1_OFFSET, MODULATION_EN_BIT, FALSE);
+    _setBit(g, REG_1_OFFSET, CODE_TABLE_BIT, FALSE);
+    _setBit(g, REG_1_OFFSET, PINC_TABLE_BIT, FALSE);
+    _setBit(g, REG_1_OFFSET, HOP_TABLE_BIT, FALSE);
     return 0;
 }
 
@@ -252,7 +552,7 @@ int _disable_modulation(Waveform_Generator_t * g){
  */
 int _enable_modulation(Waveform_Generator_t * g){
     g->modulation_en = TRUE;
-    _writeBit(g->address + REG_1_OFFSET, MODULATION_EN_BIT, TRUE);
+    _setBit(g, REG_1_OFFSET, MODULATION_EN_BIT, TRUE);
     return 0;
 }
 
@@ -267,13 +567,12 @@ int _set_constant_freq(Waveform_Generator_t * g, uint32_t freq_khz){
     uint32_t pinc_val;
     int retval = 0;
 
-    if (freq_khz <= MAX_FREQ_KHZ) {
+    if (freq_khz <= MAX_FREQ_KHZ(g)) {
         /* We received a valid frequency value */
         g->cont_freq_khz = freq_khz;
         /* Translate frequency val to pinc val */
-        pinc_val = (g->cont_freq_khz * ((1U << PINC_BITS) / FCLK_KHZ)) & PINC_MASK;
-        /* Write to Hw  */
-        _writeReg(g->address + REG_3_OFFSET, pinc_val);
+        pinc_val = (g->cont_freq_khz * ((1U << PINC_BITS) / FS_KHZ(g))) & PINC_MASK;
+        _setReg(g, REG_3_OFFSET, pinc_val);
     }
     else {
         retval = -1;
@@ -299,23 +598,26 @@ int _set_frequency_modulation(Waveform_Generator_t * g, uint32_t low_freq_khz, u
 
     /* Check wrong settings */
     if (length_us <= MAX_PERIOD_US &&
-        low_freq_khz <= MAX_FREQ_KHZ &&
-        high_freq_khz <= MAX_FREQ_KHZ &&
+        US_TO_CLOCKS(g, length_us) != 0 &&
+        low_freq_khz <= MAX_FREQ_KHZ(g) &&
+        high_freq_khz <= MAX_FREQ_KHZ(g) &&
         low_freq_khz <= high_freq_khz)
     {
         g->period_us = length_us;
         
         /* Translate frequency val to pinc val */
-        uint32_t pinc_low_val = (g->low_freq_khz * ((1U << PINC_BITS) / FCLK_KHZ));
-        uint32_t pinc_high_val = (g->high_freq_khz * ((1U << PINC_BITS) / FCLK_KHZ)) & PINC_MASK;
-        uint32_t delta_pinc_val = ((pinc_high_val - pinc_low_val) / (g->period_us * FCLK_MHZ)) & PINC_MASK;
+        uint32_t pinc_low_val = (g->low_freq_khz * ((1U << PINC_BITS) / FS_KHZ(g)));
+        uint32_t pinc_high_val = (g->high_freq_khz * ((1U << PINC_BITS) / FS_KHZ(g))) & PINC_MASK;
+        uint32_t delta_pinc_val = ((pinc_high_val - pinc_low_val) / US_TO_CLOCKS(g, g->period_us)) & PINC_MASK;
         g->delta_pinc = delta_pinc_val;
 
-        /* Write to Hw  */
-        _writeBit(g->address + REG_1_OFFSET, MODULATION_TYPE_BIT, g->modulation_mode);
-        _writeReg(g->address + REG_3_OFFSET, pinc_low_val);
-        _writeReg(g->address + REG_4_OFFSET, pinc_high_val);
-        _writeReg(g->address + REG_5_OFFSET, g->delta_pinc);
+        _setBit(g, REG_1_OFFSET, MODULATION_TYPE_BIT, g->modulation_mode);
+        _setBit(g, REG_1_OFFSET, CODE_TABLE_BIT, FALSE);
+        _setBit(g, REG_1_OFFSET, PINC_TABLE_BIT, FALSE);
+        _setBit(g, REG_1_OFFSET, HOP_TABLE_BIT, FALSE);
+        _setReg(g, REG_3_OFFSET, pinc_low_val);
+        _setReg(g, REG_4_OFFSET, pinc_high_val);
+        _setReg(g, REG_5_OFFSET, g->delta_pinc);
     }
     else {
         retval = -1;
@@ -336,8 +638,6 @@ int _set_frequency_modulation(Waveform_Generator_t * g, uint32_t low_freq_khz, u
  */
 int _set_phase_modulation(Waveform_Generator_t * g, uint32_t freq_khz, uint8_t barker_seq, uint32_t subpulse_length_us){
     int retval = 0;
-    generator_stop(g);
-
     
     uint32_t barker_bits = 0;
     switch (barker_seq){
@@ -352,7 +652,7 @@ int _set_phase_modulation(Waveform_Generator_t * g, uint32_t freq_khz, uint8_t b
     }
 
     if (retval == 0 &&
-        freq_khz <= MAX_FREQ_KHZ &&
+        freq_khz <= MAX_FREQ_KHZ(g) &&
         subpulse_length_us >= MIN_BARKER_SUBPULSE_LENGTH_US &&
         (subpulse_length_us * barker_seq) <= MAX_PULSE_LENGTH_US) {
         
@@ -360,22 +660,24 @@ int _set_phase_modulation(Waveform_Generator_t * g, uint32_t freq_khz, uint8_t b
         g->barker_subpulse_length_us = subpulse_length_us;
         
         /* Translate subpulse length to register value */
-        uint32_t barker_subpulse_length_reg_val = ((subpulse_length_us * FCLK_MHZ) - 1) & PINC_MASK;
+        uint32_t barker_subpulse_length_reg_val = (US_TO_CLOCKS(g, subpulse_length_us) - 1) & PINC_MASK;
         
         g->cont_freq_khz = freq_khz;
 
         /* Translate frequency val to pinc val */
-        uint32_t pinc_val = (g->cont_freq_khz * ((1U << PINC_BITS) / FCLK_KHZ)) & PINC_MASK;
+        uint32_t pinc_val = (g->cont_freq_khz * ((1U << PINC_BITS) / FS_KHZ(g))) & PINC_MASK;
         
         /* Construct Config_reg_5 value */
         g->barker_seq_num = barker_seq;
         uint32_t barker_reg_val = (barker_seq << 28) | barker_bits; //TODO: Fix magic numbers
 
-        /* Write to Hw  */
-        _writeBit(g->address + REG_1_OFFSET, MODULATION_TYPE_BIT, PHASE_MOD);
-        _writeReg(g->address + REG_4_OFFSET, barker_subpulse_length_reg_val);
-        _writeReg(g->address + REG_5_OFFSET, barker_reg_val);
-        _writeReg(g->address + REG_3_OFFSET, pinc_val);
+        _setBit(g, REG_1_OFFSET, MODULATION_TYPE_BIT, PHASE_MOD);
+        _setBit(g, REG_1_OFFSET, CODE_TABLE_BIT, FALSE);
+        _setBit(g, REG_1_OFFSET, PINC_TABLE_BIT, FALSE);
+        _setBit(g, REG_1_OFFSET, HOP_TABLE_BIT, FALSE);
+        _setReg(g, REG_4_OFFSET, barker_subpulse_length_reg_val);
+        _setReg(g, REG_5_OFFSET, barker_reg_val);
+        _setReg(g, REG_3_OFFSET, pinc_val);
     }
     else {
         retval = -1;
@@ -384,75 +686,495 @@ int _set_phase_modulation(Waveform_Generator_t * g, uint32_t freq_khz, uint8_t b
     return retval;
 }
 
+/**
+ * @brief Sets code table phase modulation parameters.
+ * Each chip phase is read from the code table, chips are played in a loop.
+ * 
+ * @param g Waveform generator instance
+ * @param freq_khz Constant frequency value in kilohertz
+ * @param code_offset First chip in the code table
+ * @param code_length Number of chips
+ * @param chip_clocks Chip length in clock periods
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int _set_code_modulation(Waveform_Generator_t * g, uint32_t freq_khz, uint32_t code_offset, uint32_t code_length, uint32_t chip_clocks){
+    int retval = 0;
+
+    if (freq_khz <= MAX_FREQ_KHZ(g) &&
+        code_length >= 1 &&
+        code_offset < CODE_MAX_CHIPS &&
+        code_length <= CODE_MAX_CHIPS - code_offset &&
+        chip_clocks >= MIN_CODE_CHIP_CLOCKS &&
+        chip_clocks <= US_TO_CLOCKS(g, MAX_PULSE_LENGTH_US)) {
+
+        g->modulation_mode = PHASE_MOD;
+        g->cont_freq_khz = freq_khz;
+        g->code_offset = code_offset;
+        g->code_length = code_length;
+        g->code_chip_clocks = chip_clocks;
+
+        /* Translate frequency val to pinc val */
+        uint32_t pinc_val = (g->cont_freq_khz * ((1U << PINC_BITS) / FS_KHZ(g))) & PINC_MASK;
+
+        _setBit(g, REG_1_OFFSET, MODULATION_TYPE_BIT, PHASE_MOD);
+        _setBit(g, REG_1_OFFSET, CODE_TABLE_BIT, TRUE);
+        _setBit(g, REG_1_OFFSET, PINC_TABLE_BIT, FALSE);
+        _setBit(g, REG_1_OFFSET, HOP_TABLE_BIT, FALSE);
+        _setReg(g, REG_4_OFFSET, chip_clocks - 1);
+        _setReg(g, REG_5_OFFSET, (code_offset << CODE_START_SHIFT) | code_length);
+        _setReg(g, REG_3_OFFSET, pinc_val);
+    }
+    else {
+        retval = -1;
+    }
+
+    return retval;
+}
+
+/**
+ * @brief Sets PINC table frequency modulation parameters.
+ * Table entries are played in a loop, each one for entry_clocks.
+ * 
+ * @param g Waveform generator instance
+ * @param table_offset First entry in the PINC table
+ * @param entries Number of entries
+ * @param entry_clocks Entry length in clock periods
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int _set_pinc_table_modulation(Waveform_Generator_t * g, uint32_t table_offset, uint32_t entries, uint32_t entry_clocks){
+    int retval = 0;
+
+    if (entries >= 1 &&
+        table_offset < PINC_TABLE_MAX_ENTRIES &&
+        entries <= PINC_TABLE_MAX_ENTRIES - table_offset &&
+        entry_clocks >= 1 &&
+        entry_clocks <= US_TO_CLOCKS(g, MAX_PULSE_LENGTH_US)) {
+
+        g->modulation_mode = FREQ_MOD;
+        g->pinc_table_offset = table_offset;
+        g->pinc_table_entries = entries;
+        g->pinc_entry_clocks = entry_clocks;
+
+        _setBit(g, REG_1_OFFSET, MODULATION_TYPE_BIT, FREQ_MOD);
+        _setBit(g, REG_1_OFFSET, CODE_TABLE_BIT, FALSE);
+        _setBit(g, REG_1_OFFSET, PINC_TABLE_BIT, TRUE);
+        _setBit(g, REG_1_OFFSET, HOP_TABLE_BIT, FALSE);
+        _setReg(g, REG_4_OFFSET, entry_clocks - 1);
+        _setReg(g, REG_5_OFFSET, (table_offset << CODE_START_SHIFT) | entries);
+    }
+    else {
+        retval = -1;
+    }
+
+    return retval;
+}
+
+/**
+ * @brief Sets hop table frequency modulation parameters.
+ * Table entries are played in a loop, each one for its dwell length.
+ * 
+ * @param g Waveform generator instance
+ * @param table_offset First entry in the hop table
+ * @param entries Number of entries
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int _set_hop_modulation(Waveform_Generator_t * g, uint32_t table_offset, uint32_t entries){
+    int retval = 0;
+
+    if (entries >= 1 &&
+        table_offset < HOP_TABLE_MAX_ENTRIES &&
+        entries <= HOP_TABLE_MAX_ENTRIES - table_offset) {
+
+        g->modulation_mode = FREQ_MOD;
+        g->hop_table_offset = table_offset;
+        g->hop_table_entries = entries;
+
+        _setBit(g, REG_1_OFFSET, MODULATION_TYPE_BIT, FREQ_MOD);
+        _setBit(g, REG_1_OFFSET, CODE_TABLE_BIT, FALSE);
+        _setBit(g, REG_1_OFFSET, PINC_TABLE_BIT, FALSE);
+        _setBit(g, REG_1_OFFSET, HOP_TABLE_BIT, TRUE);
+        _setReg(g, REG_5_OFFSET, (table_offset << CODE_START_SHIFT) | entries);
+    }
+    else {
+        retval = -1;
+    }
+
+    return retval;
+}
+
 int set_continuous_mode_constant_freq(Waveform_Generator_t * g, uint32_t freq_khz)
 {
-   generator_stop(g);
+   int retval = 0;
+   _begin_config(g);
    _set_continuous(g);
    _disable_modulation(g);
-   return(_set_constant_freq(g,freq_khz));
+   retval = _set_constant_freq(g,freq_khz);
+   return _end_config(g, retval);
 }
 
 int set_continuous_mode_freq_mod(Waveform_Generator_t * g, uint32_t low_freq_khz, uint32_t high_freq_khz, uint32_t length_us){
-    generator_stop(g);
+    int retval = 0;
+    _begin_config(g);
     _set_continuous(g);
     _enable_modulation(g);
-    return(_set_frequency_modulation(g,low_freq_khz,high_freq_khz,length_us));
+    retval = _set_frequency_modulation(g,low_freq_khz,high_freq_khz,length_us);
+    return _end_config(g, retval);
 }
 
 int set_continuous_mode_phase_mod(Waveform_Generator_t * g, uint32_t freq_khz, uint8_t barker_seq_num, uint32_t barker_seq_length_us){
     int retval = 0;
-    generator_stop(g);
+    _begin_config(g);
     _set_continuous(g);
     _enable_modulation(g);
     retval = _set_phase_modulation(g, freq_khz, barker_seq_num, barker_seq_length_us/barker_seq_num); 
-    return retval;
+    return _end_config(g, retval);
 }
 
 int set_pulsed_mode_constant_freq(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t freq_khz){
     int retval = 0;
-    generator_stop(g);
+    _begin_config(g);
     _disable_modulation(g);
     retval = _set_pulsed(g, period_us, pulse_length_us);
-    if (retval < 0){
-        return(retval);
-    }
-    else{
+    if (retval == 0){
         retval = _set_constant_freq(g,freq_khz);
     }
-    return(retval);
+    return _end_config(g, retval);
 }
 
 int set_pulsed_mode_freq_mod(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t low_freq_khz, uint32_t high_freq_khz){
     int retval = 0;
-    generator_stop(g);
+    _begin_config(g);
     _enable_modulation(g);
 
     retval = _set_pulsed(g, period_us, pulse_length_us);
-    if (retval < 0)
-    {
-        return retval;
-    }
-    else
+    if (retval == 0)
     {
         retval = _set_frequency_modulation(g, low_freq_khz, high_freq_khz, g->pulse_length_us);
     }
-    return(retval);
+    return _end_config(g, retval);
 }
 
 int set_pulsed_mode_phase_mod(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t freq_khz, uint8_t barker_seq_num){
     int retval = 0;
-    generator_stop(g);
+    _begin_config(g);
     _enable_modulation(g);
     retval = _set_pulsed(g, period_us, pulse_length_us);
-    if (retval < 0)
+    if (retval == 0)
+    {
+        retval = _set_phase_modulation(g, freq_khz, barker_seq_num, pulse_length_us/barker_seq_num);
+    }
+    return _end_config(g, retval);
+}
+
+int set_continuous_mode_code_mod(Waveform_Generator_t * g, uint32_t freq_khz, uint32_t code_offset, uint32_t code_length, uint32_t chip_length_ns){
+    int retval = 0;
+    _begin_config(g);
+    _set_continuous(g);
+    _enable_modulation(g);
+    retval = _set_code_modulation(g, freq_khz, code_offset, code_length, NS_TO_CLOCKS(g, chip_length_ns));
+    return _end_config(g, retval);
+}
+
+int set_pulsed_mode_code_mod(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t freq_khz, uint32_t code_offset, uint32_t code_length){
+    int retval = 0;
+    _begin_config(g);
+    _enable_modulation(g);
+    retval = _set_pulsed(g, period_us, pulse_length_us);
+    if (retval == 0 && code_length > 0)
     {
-        return retval;
+        /* Whole pulse split between chips */
+        retval = _set_code_modulation(g, freq_khz, code_offset, code_length, US_TO_CLOCKS(g, pulse_length_us) / code_length);
     }
     else
     {
-        retval = _set_phase_modulation(g, freq_khz, barker_seq_num, pulse_length_us/barker_seq_num);
-    }  
-    return retval;
+        retval = -1;
+    }
+    return _end_config(g, retval);
+}
+
+int set_continuous_mode_pinc_table(Waveform_Generator_t * g, uint32_t table_offset, uint32_t entries, uint32_t entry_clocks){
+    int retval = 0;
+    _begin_config(g);
+    _set_continuous(g);
+    _enable_modulation(g);
+    retval = _set_pinc_table_modulation(g, table_offset, entries, entry_clocks);
+    return _end_config(g, retval);
+}
+
+int set_pulsed_mode_pinc_table(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t table_offset, uint32_t entries, uint32_t entry_clocks){
+    int retval = 0;
+    _begin_config(g);
+    _enable_modulation(g);
+    retval = _set_pulsed(g, period_us, pulse_length_us);
+    if (retval == 0)
+    {
+        retval = _set_pinc_table_modulation(g, table_offset, entries, entry_clocks);
+    }
+    return _end_config(g, retval);
+}
+
+int set_continuous_mode_hop(Waveform_Generator_t * g, uint32_t table_offset, uint32_t entries){
+    int retval = 0;
+    _begin_config(g);
+    _set_continuous(g);
+    _enable_modulation(g);
+    retval = _set_hop_modulation(g, table_offset, entries);
+    return _end_config(g, retval);
+}
+
+int set_pulsed_mode_hop(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t table_offset, uint32_t entries){
+    int retval = 0;
+    _begin_config(g);
+    _enable_modulation(g);
+    retval = _set_pulsed(g, period_us, pulse_length_us);
+    if (retval == 0)
+    {
+        retval = _set_hop_modulation(g, table_offset, entries);
+    }
+    return _end_config(g, retval);
+}
+
+void generator_get_image(Waveform_Generator_t * g, uint32_t * image){
+    memcpy(image, &g->shadow[REG_INDEX(REG_1_OFFSET)], GENERATOR_IMAGE_REGS * sizeof(uint32_t));
+}
+
+int generator_apply_image(Waveform_Generator_t * g, const uint32_t * image){
+    uint32_t reg_1 = image[0];
+    uint32_t period_clocks = image[REG_INDEX(REG_2_OFFSET) - REG_INDEX(REG_1_OFFSET)] & PERIOD_MASK;
+
+    _begin_config(g);
+    for (uint32_t i = 0; i < GENERATOR_IMAGE_REGS; i++)
+    {
+        _setReg(g, REG_1_OFFSET + i * sizeof(uint32_t), image[i]);
+    }
+
+    /* Keep driver attributes consistent with the image */
+    g->mode = (reg_1 & (1 << MODE_BIT)) ? CONTINUOUS : PULSED;
+    g->modulation_en = (reg_1 >> MODULATION_EN_BIT) & 1;
+    g->modulation_mode = (reg_1 >> MODULATION_TYPE_BIT) & 1;
+    /* Rounded up, bounds the commit wait */
+    g->period_us = (period_clocks * 1000 + FCLK_KHZ(g) - 1) / FCLK_KHZ(g);
+
+    return _end_config(g, 0);
+}
+
+int generator_sequence_pack_entry(Waveform_Generator_t * entry, uint32_t repeat, uint32_t * words){
+
+    /* Entries are latched at period wrap, pulsed mode only */
+    if (entry->mode != PULSED)
+    {
+        return -1;
+    }
+
+    memset(words, 0, SEQ_ENTRY_WORDS * sizeof(uint32_t));
+    memcpy(words, &entry->shadow[REG_INDEX(REG_1_OFFSET)], SEQ_REPEAT_WORD * sizeof(uint32_t));
+    words[SEQ_REPEAT_WORD] = repeat;
+
+    return 0;
+}
+
+int generator_sequence_write_entry(Waveform_Generator_t * g, uint32_t index, Waveform_Generator_t * entry, uint32_t repeat){
+    uint32_t entry_offset;
+    uint32_t words[SEQ_ENTRY_WORDS];
+
+    if (index >= SEQ_MAX_ENTRIES || generator_sequence_pack_entry(entry, repeat, words) < 0)
+    {
+        return -1;
+    }
+
+    entry_offset = SEQ_TABLE_OFFSET + index * SEQ_ENTRY_WORDS * sizeof(uint32_t);
+
+    /* Table is not shadowed, entries are written once */
+    for (uint32_t word = 0; word <= SEQ_REPEAT_WORD; word++)
+    {
+        _writeReg(g, entry_offset + word * sizeof(uint32_t), words[word]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Gets a table size.
+ * 
+ * @param table Table loader destination
+ * @return uint32_t Table size in words, 0 if table doesn't exist
+ */
+static uint32_t _table_words(generator_table_t table){
+    switch (table)
+    {
+    case TABLE_SEQUENCER:
+        return SEQ_MAX_ENTRIES * SEQ_ENTRY_WORDS;
+    case TABLE_CODE:
+        return CODE_MAX_CHIPS;
+    case TABLE_PINC:
+        return PINC_TABLE_MAX_ENTRIES * PINC_TABLE_ENTRY_WORDS;
+    case TABLE_HOP:
+        return HOP_TABLE_MAX_ENTRIES * HOP_TABLE_ENTRY_WORDS;
+    default:
+        return 0;
+    }
+}
+
+int generator_load_table(Waveform_Generator_t * g, generator_table_t table, uint32_t offset, const uint32_t * words, uint32_t count){
+
+    uint32_t bytes = (count + 1) * sizeof(u32);
+    TickType_t start;
+    u32 status;
+
+    if (g->detached || count == 0 || count > TABLE_LOAD_MAX_WORDS ||
+        offset + count > _table_words(table) || _dma_init(g) < 0)
+    {
+        return -1;
+    }
+
+    table_load_buffer[0] = ((uint32_t) table << TABLE_LOAD_TABLE_SHIFT) |
+                           (g->channel << TABLE_LOAD_CHANNEL_SHIFT) |
+                           (offset & TABLE_LOAD_ADDR_MASK);
+    memcpy(&table_load_buffer[1], words, count * sizeof(u32));
+
+    /* DMA reads from memory, data must be out of cache */
+    Xil_DCacheFlushRange((UINTPTR)table_load_buffer, bytes);
+
+    if (XAxiDma_SimpleTransfer(&g->axi_dma_inst, (UINTPTR) table_load_buffer, bytes, XAXIDMA_DMA_TO_DEVICE) != XST_SUCCESS)
+    {
+        return -1;
+    }
+
+    /* A full load takes a few microseconds: poll, don't sleep. A DMA
+     * error (bad header, loader not taking TLAST) halts the channel with
+     * Busy set, so the poll is bounded and the DMA is reset */
+    start = xTaskGetTickCount();
+    do
+    {
+        status = XAxiDma_ReadReg(g->axi_dma_inst.RegBase + XAXIDMA_TX_OFFSET, XAXIDMA_SR_OFFSET);
+        if ((status & XAXIDMA_ERR_ALL_MASK) ||
+            xTaskGetTickCount() - start > pdMS_TO_TICKS(TABLE_LOAD_TIMEOUT_MS))
+        {
+            _dma_reset(g);
+            return -1;
+        }
+    } while (XAxiDma_Busy(&g->axi_dma_inst, XAXIDMA_DMA_TO_DEVICE));
+
+    return 0;
+}
+
+int generator_load_pinc_table(Waveform_Generator_t * g, uint32_t first_entry, const uint32_t * pinc, const int32_t * slope, uint32_t count){
+
+    static uint32_t words[TABLE_LOAD_MAX_WORDS];
+
+    if (first_entry >= PINC_TABLE_MAX_ENTRIES || count == 0 ||
+        count > TABLE_LOAD_MAX_WORDS / PINC_TABLE_ENTRY_WORDS)
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (pinc[i] > PINC_MASK)
+        {
+            return -1;
+        }
+        words[i * PINC_TABLE_ENTRY_WORDS] = pinc[i];
+        words[i * PINC_TABLE_ENTRY_WORDS + 1] = (uint32_t) slope[i];
+    }
+
+    return generator_load_table(g, TABLE_PINC, first_entry * PINC_TABLE_ENTRY_WORDS, words, count * PINC_TABLE_ENTRY_WORDS);
+}
+
+int generator_load_hop_table(Waveform_Generator_t * g, uint32_t first_entry, const generator_hop_t * hops, uint32_t count){
+
+    static uint32_t words[HOP_TABLE_MAX_ENTRIES * HOP_TABLE_ENTRY_WORDS];
+
+    if (first_entry >= HOP_TABLE_MAX_ENTRIES || count == 0 ||
+        count > HOP_TABLE_MAX_ENTRIES - first_entry)
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (hops[i].freq_khz > MAX_FREQ_KHZ(g) ||
+            hops[i].dwell_clocks < HOP_MIN_DWELL_CLOCKS || hops[i].dwell_clocks > HOP_MAX_DWELL_CLOCKS)
+        {
+            return -1;
+        }
+        /* Translate frequency val to pinc val */
+        words[i * HOP_TABLE_ENTRY_WORDS] = (hops[i].freq_khz * ((1U << PINC_BITS) / FS_KHZ(g))) & PINC_MASK;
+        words[i * HOP_TABLE_ENTRY_WORDS + 1] = ((uint32_t) hops[i].phase << HOP_PHASE_SHIFT) | (hops[i].dwell_clocks - 1);
+    }
+
+    return generator_load_table(g, TABLE_HOP, first_entry * HOP_TABLE_ENTRY_WORDS, words, count * HOP_TABLE_ENTRY_WORDS);
+}
+
+uint64_t generator_get_timestamp(Waveform_Generator_t * g, generator_timestamp_t which){
+
+    uint32_t offset = REG_10_OFFSET + which * 2 * sizeof(u32);
+    uint64_t low;
+
+    if (g->detached)
+    {
+        return 0;
+    }
+
+    /* Low word first, it latches the high word */
+    low = _readReg(g, offset);
+    return ((uint64_t) _readReg(g, offset + sizeof(u32)) << 32) | low;
+}
+
+int generator_get_perf(Waveform_Generator_t * g, generator_perf_t * perf){
+
+    if (g->detached)
+    {
+        return -1;
+    }
+
+    perf->pulses = _readReg(g, REG_18_OFFSET);
+    perf->stall_cycles = _readReg(g, REG_19_OFFSET);
+    perf->capture_beats = _readReg(g, REG_20_OFFSET);
+    perf->tlasts = _readReg(g, REG_21_OFFSET);
+    perf->commits = _readReg(g, REG_22_OFFSET);
+    perf->config_writes = _readReg(g, REG_23_OFFSET);
+    perf->triggers = _readReg(g, REG_24_OFFSET);
+    perf->triggers_missed = _readReg(g, REG_25_OFFSET);
+
+    return 0;
+}
+
+int generator_sequence_start(Waveform_Generator_t * g, uint32_t length){
+
+    uint32_t reg_0 = g->shadow[REG_INDEX(REG_0_OFFSET)];
+
+    if (length == 0 || length > SEQ_MAX_ENTRIES)
+    {
+        return -1;
+    }
+
+    /* Not with one PRI per trigger, see generator_ext_trigger_arm() */
+    if ((reg_0 & (1 << TRIG_EN_BIT)) && !(reg_0 & (1 << TRIG_TRAIN_BIT)))
+    {
+        return -1;
+    }
+
+    generator_stop(g);
+    _setReg(g, REG_6_OFFSET, length);
+    _setBit(g, REG_0_OFFSET, SEQ_EN_BIT, TRUE);
+    /* Entries run any period, commits wait for the longest */
+    g->running_period_us = MAX_PERIOD_US;
+    /* Hardware holds the modulator until the first entry is fetched */
+    return generator_start(g);
+}
+
+/**
+ * @brief Capture word holding a channel sample. Beats carry dds_lanes
+ * samples of every channel after the header, see CAPTURE_BYTES.
+ * 
+ * @param wg Waveform Generator instance
+ * @param sample Sample index in the channel
+ * @return u32 Word index in debug vector
+ */
+static u32 _capture_word(Waveform_Generator_t *wg, u32 sample){
+    u32 lanes = wg->dds_lanes;
+    return CAPTURE_HEADER_WORDS(wg) + (sample / lanes) * GENERATOR_NUM_CHANNELS * lanes + wg->channel * lanes + sample % lanes;
 }
 
 /**
@@ -471,7 +1193,7 @@ void generator_get_i_samples(Waveform_Generator_t *wg, s32 *i_samples, u32 num_s
 	s16 *samples = (s16*) debug_samples;
 
     for (u32 i = 0; i < num_samples ; i++){
-        i_samples[i] = (s32) (samples[i*2]);
+        i_samples[i] = (s32) (samples[_capture_word(wg, i) * 2]);
     }   
 }
 
@@ -493,6 +1215,6 @@ void generator_get_q_samples(Waveform_Generator_t *wg, s32 *q_samples, u32 num_s
     samples++;
 
     for (u32 i = 0; i < num_samples ; i++){
-        q_samples[i] = (s32) (samples[i*2]);
+        q_samples[i] = (s32) (samples[_capture_word(wg, i) * 2]);
     }   
 }
@@ -1,3 +1,6 @@
+#ifndef __GENERATOR
+#define __GENERATOR
+
 #include <xil_io.h>
 #include "xaxidma.h"
 
@@ -10,16 +13,78 @@
 #define REG_3_OFFSET 0xc
 #define REG_4_OFFSET 0x10
 #define REG_5_OFFSET 0x14
+#define REG_6_OFFSET 0x18
+#define REG_7_OFFSET 0x1c
+#define REG_8_OFFSET 0x20
+#define REG_9_OFFSET 0x24
+/* Timestamps, DDS clocks since reset: low word at REG_10/12/14/16,
+ * reading it latches the high word at the next register */
+#define REG_10_OFFSET 0x28
+#define REG_11_OFFSET 0x2c
+#define REG_12_OFFSET 0x30
+#define REG_13_OFFSET 0x34
+#define REG_14_OFFSET 0x38
+#define REG_15_OFFSET 0x3c
+#define REG_16_OFFSET 0x40
+#define REG_17_OFFSET 0x44
+/* Performance counters, 32 bit, wrap around */
+#define REG_18_OFFSET 0x48
+#define REG_19_OFFSET 0x4c
+#define REG_20_OFFSET 0x50
+#define REG_21_OFFSET 0x54
+#define REG_22_OFFSET 0x58
+#define REG_23_OFFSET 0x5c
+/* External trigger counters, 32 bit, wrap around */
+#define REG_24_OFFSET 0x60
+#define REG_25_OFFSET 0x64
+
+/* Shadowed registers: REG_0 to REG_6. REG_7 to REG_25 are read only */
+#define GENERATOR_NUM_REGS 7
+/* Register offset to shadow index */
+#define REG_INDEX(offset) ((offset) >> 2)
+/* Configuration image: REG_1 to REG_5 */
+#define GENERATOR_IMAGE_REGS 5
+
 
+/* Channels in the block design (num_channels in bd/generator.bd.tcl) */
+#define GENERATOR_NUM_CHANNELS 2
 
-#define FCLK_MHZ    125U
-#define FCLK_KHZ    (FCLK_MHZ * 1000)
-#define FCLK        (FCLK_KHZ * 1000)
+/* DDS clock of a generator instance, kHz in REG_8 (dds_clk_mhz in
+ * bd/generator.bd.tcl). Read at init, channels share it */
+#define FCLK_KHZ(g)     ((g)->fclk_khz)
+/* Bitstreams without REG_8 run the DDS on FCLK0 */
+#define DEFAULT_FCLK_KHZ 125000
+/* Times to DDS clocks, rounded down. In kHz: MMCM clocks are not whole MHz */
+#define US_TO_CLOCKS(g, us) ((uint32_t) (((uint64_t) (us) * FCLK_KHZ(g)) / 1000))
+#define NS_TO_CLOCKS(g, ns) ((uint32_t) (((uint64_t) (ns) * FCLK_KHZ(g)) / 1000000))
+/* Sample rate: dds_lanes samples per DDS clock, REG_9 (dds_lanes in
+ * bd/generator.bd.tcl). PINC is referred to it, times count DDS clocks */
+#define FS_KHZ(g)       ((g)->fclk_khz * (g)->dds_lanes)
 
 
 /* Reg 0 defines */
 #define ENABLE_BIT 0
 #define DEBUG_BIT 1
+#define COMMIT_BIT 2
+/* Commit round trip on top of the period it waits for (CDC handshakes),
+ * a commit not latched by then is lost */
+#define COMMIT_MARGIN_US 1000
+#define SEQ_EN_BIT 3
+/* While stopped keep the DDS pipeline primed: start with fixed latency and phase */
+#define ARM_BIT 4
+/* Triggered mode: edges of the trigger pin (PMOD JA1) start the output */
+#define TRIG_EN_BIT 5
+/* Trigger edge, 2 bits (generator_trigger_edge_t) */
+#define TRIG_EDGE_BIT 6
+#define TRIG_EDGE_MASK (3U << TRIG_EDGE_BIT)
+/* A trigger starts the train instead of one PRI */
+#define TRIG_TRAIN_BIT 8
+/* DDS clocks with edges ignored after a trigger, 16 bits */
+#define TRIG_HOLDOFF_BIT 16
+#define TRIG_HOLDOFF_MASK (0xFFFFU << TRIG_HOLDOFF_BIT)
+#define TRIG_MAX_HOLDOFF_CLOCKS 0xFFFF
+/* Every trigger field, cleared on disarm */
+#define TRIG_CONFIG_MASK ((1U << TRIG_EN_BIT) | TRIG_EDGE_MASK | (1U << TRIG_TRAIN_BIT) | TRIG_HOLDOFF_MASK)
 /* Reg 1 defines */
 #define MODE_BIT 0
 #define MODULATION_EN_BIT 1
@@ -28,9 +93,15 @@
 #define MODULATION_TYPE_BIT 2
 #define FREQ_MOD 1
 #define PHASE_MOD 0
+/* Phase modulation from the code table instead of Barker bits */
+#define CODE_TABLE_BIT 3
+/* Frequency modulation from the PINC table instead of linear ramp */
+#define PINC_TABLE_BIT 4
+/* Frequency hopping from the hop table */
+#define HOP_TABLE_BIT 5
 
 /* Reg 2 defines */
-#define PERIOD_COUNTER_BITS 15
+#define PERIOD_COUNTER_BITS 16
 #define PERIOD_MASK ((1U << (PERIOD_COUNTER_BITS)) - 1)
 #define MAX_PERIOD_US 250
 #define MAX_PULSE_LENGTH_US 200
@@ -41,7 +112,8 @@
 /* Reg 3 defines */
 #define PINC_BITS 30
 #define PINC_MASK ((1U << (PINC_BITS)) - 1)
-#define MAX_FREQ_KHZ 20000
+#define MAX_LANE_FREQ_KHZ 20000
+#define MAX_FREQ_KHZ(g) (MAX_LANE_FREQ_KHZ * (g)->dds_lanes)
 
 /* Reg 5 defines */
 #define BARKER_2 2;
@@ -51,10 +123,69 @@
 #define BARKER_7 114;
 #define BARKER_11 1810;
 #define BARKER_13 7989;
+/* Reg 5 with code table: first chip in high half, chips in low half */
+#define CODE_START_SHIFT 16
+#define CODE_MAX_CHIPS 4096
+/* Chip phase, fraction of a turn: 1 << CODE_PHASE_BITS is 360° */
+#define CODE_PHASE_BITS 16
+/* Shortest chip, in clocks */
+#define MIN_CODE_CHIP_CLOCKS 1
+/* Reg 5 with PINC table: first entry in high half, entries in low half
+ * (CODE_START_SHIFT). Reg 4: entry length in clocks - 1 */
+#define PINC_TABLE_MAX_ENTRIES 2048
+/* Table words per entry: PINC and slope */
+#define PINC_TABLE_ENTRY_WORDS 2
+/* Slope: signed PINC change per clock, fixed point */
+#define PINC_SLOPE_FRAC_BITS 8
+/* Reg 5 with hop table: first entry in high half, entries in low half
+ * (CODE_START_SHIFT) */
+#define HOP_TABLE_MAX_ENTRIES 512
+/* Table words per entry: PINC and {phase, dwell length - 1} */
+#define HOP_TABLE_ENTRY_WORDS 2
+#define HOP_PHASE_SHIFT 16
+#define HOP_MIN_DWELL_CLOCKS 2
+#define HOP_MAX_DWELL_CLOCKS (1U << 16)
+
+/* Reg 6 (sequence length) and sequencer table defines */
+#define SEQ_TABLE_OFFSET 0x800
+#define SEQ_MAX_ENTRIES 64
+#define SEQ_ENTRY_WORDS 8
+/* Entry words 0 to 4 hold REG_1 to REG_5 images */
+#define SEQ_REPEAT_WORD 5
+
+/* Table loader defines (DMA MM2S stream, see dds_modulator_package.sv).
+ * Header word: table, channel and first word address */
+#define TABLE_LOAD_TABLE_SHIFT 28
+#define TABLE_LOAD_CHANNEL_SHIFT 24
+#define TABLE_LOAD_ADDR_MASK 0xFFFF
+/* Largest load, words. Loader takes one word per clock */
+#define TABLE_LOAD_MAX_WORDS 4096
+/* A load still busy by then is stuck, the DMA is reset */
+#define TABLE_LOAD_TIMEOUT_MS 2
+/* DMA soft reset takes a few clocks */
+#define DMA_RESET_POLLS 1000
 
 /* Debug defines */
 #define MAX_DEBUG_SAMPLES 125000
+/* A capture takes MAX_DEBUG_SAMPLES / dds_lanes clocks with the channel
+ * enabled (1 ms at 125 MHz), triggered channels take many PRIs. A capture
+ * still busy by then lost its tlast beat, the DMA is reset */
+#define CAPTURE_TIMEOUT_MS 1000
 #define MAX_DEBUG_BYTES MAX_DEBUG_SAMPLES * sizeof(u32)
+/* All channels are captured together, sample k of channel n
+ * is word k * GENERATOR_NUM_CHANNELS + n (one lane). With
+ * dds_lanes L, beats carry L samples of each channel: word
+ * (k / L) * GENERATOR_NUM_CHANNELS * L + n * L + k % L.
+ * Must fit the DMA 20 bit transfer length */
+#define CAPTURE_BYTES (MAX_DEBUG_BYTES * GENERATOR_NUM_CHANNELS)
+/* Captures start with a header, capture start timestamp in words 0
+ * (low) and 1 (high), zero padded to a whole beat. Samples follow it */
+#define CAPTURE_HEADER_WORDS(g) \
+    (GENERATOR_NUM_CHANNELS * (g)->dds_lanes < 2 ? 2 : GENERATOR_NUM_CHANNELS * (g)->dds_lanes)
+/* Largest dds_lanes the capture buffer has header room for */
+#define DDS_MAX_LANES 8
+#define CAPTURE_HEADER_MAX_WORDS (GENERATOR_NUM_CHANNELS * DDS_MAX_LANES)
+#define CAPTURE_BUFFER_BYTES (CAPTURE_BYTES + CAPTURE_HEADER_MAX_WORDS * sizeof(u32))
 
 typedef enum mode{
     CONTINUOUS,
@@ -67,10 +198,91 @@ typedef enum mode{
     // PULS_MOD_PHASE
 }generator_mode_t;
 
+/* PL memories written by the table loader */
+typedef enum table{
+    /* Word address: entry * SEQ_ENTRY_WORDS + word */
+    TABLE_SEQUENCER = 0,
+    /* Chip address, one chip phase per word */
+    TABLE_CODE = 1,
+    /* Word address: entry * PINC_TABLE_ENTRY_WORDS + {0: PINC, 1: slope} */
+    TABLE_PINC = 2,
+    /* Word address: entry * HOP_TABLE_ENTRY_WORDS + {0: PINC, 1: phase and dwell} */
+    TABLE_HOP = 3
+}generator_table_t;
+
+/* Hardware timestamps (REG_10 to REG_17) */
+typedef enum timestamp{
+    /* Free running counter */
+    TIMESTAMP_NOW = 0,
+    /* Last pulse start */
+    TIMESTAMP_PULSE = 1,
+    /* Last commit latched */
+    TIMESTAMP_COMMIT = 2,
+    /* Last debug capture start */
+    TIMESTAMP_CAPTURE = 3
+}generator_timestamp_t;
+
+typedef enum trigger_edge{
+    TRIGGER_RISING = 0,
+    TRIGGER_FALLING = 1,
+    TRIGGER_BOTH = 2
+}generator_trigger_edge_t;
+
+/* Performance counters snapshot (REG_18 to REG_25). Counters wrap
+ * around, rates come from the difference of two snapshots */
+typedef struct perf{
+    /* Pulses started */
+    uint32_t pulses;
+    /* DDS clocks enabled with tready low (DDS backpressure) */
+    uint32_t stall_cycles;
+    /* Capture beats sent to the DDS */
+    uint32_t capture_beats;
+    /* Captures ended (tlast) */
+    uint32_t tlasts;
+    /* Staged configs latched */
+    uint32_t commits;
+    /* REG_0 to REG_6 writes */
+    uint32_t config_writes;
+    /* Trigger edges seen in triggered mode */
+    uint32_t triggers;
+    /* Trigger edges while running or in holdoff, no start */
+    uint32_t triggers_missed;
+}generator_perf_t;
+
+/* Hop table entry */
+typedef struct hop{
+    uint32_t freq_khz;
+    /* Dwell length, HOP_MIN_DWELL_CLOCKS to HOP_MAX_DWELL_CLOCKS */
+    uint32_t dwell_clocks;
+    /* Phase offset, fraction of a turn: 1 << CODE_PHASE_BITS is 360° */
+    uint16_t phase;
+}generator_hop_t;
+
 typedef struct Waveform_Generator
 {
     uint32_t address;
+    /* Channel index, lane in debug captures */
+    uint32_t channel;
+    /* DDS clock, kHz */
+    uint32_t fclk_khz;
+    /* Samples per DDS clock */
+    uint32_t dds_lanes;
     uint8_t enabled;
+    /* Started by the trigger pin, see generator_ext_trigger_arm() */
+    uint8_t triggered;
+    /* Configs applied while enabled do not stop the core */
+    uint8_t live_update;
+    /* Commit written, not yet confirmed latched by hw */
+    uint8_t commit_pending;
+    /* Period of the config latched in hw, 0 in continuous mode */
+    uint32_t running_period_us;
+    /* Period the pending commit waits for, see COMMIT_MARGIN_US */
+    uint32_t commit_period_us;
+    /* Not mapped to hardware, configs only compose the shadow copy */
+    uint8_t detached;
+
+    /* Config state, debug_enabled to dirty: restored as a block when a
+     * config is refused (CONFIG_STATE_* in generator.c) */
     uint8_t debug_enabled;  //TODO: Ver si hace falta
     generator_mode_t mode;
     uint8_t modulation_en;
@@ -89,15 +301,35 @@ typedef struct Waveform_Generator
     /* Phase mode attributes */
     uint32_t barker_subpulse_length_us;
     uint8_t barker_seq_num;
+    /* Code table attributes */
+    uint32_t code_offset;
+    uint32_t code_length;
+    uint32_t code_chip_clocks;
+    /* PINC table attributes */
+    uint32_t pinc_table_offset;
+    uint32_t pinc_table_entries;
+    uint32_t pinc_entry_clocks;
+    /* Hop table attributes */
+    uint32_t hop_table_offset;
+    uint32_t hop_table_entries;
 
     uint8_t bad_config;
 
+    /* Shadow copy of config registers, configs are composed here */
+    uint32_t shadow[GENERATOR_NUM_REGS];
+    /* Bit n set: shadow[n] not yet written to hardware */
+    uint32_t dirty;
+
     /* Debug attributes */
     u32 axi_dma_device_id;
     XAxiDma axi_dma_inst;
     XAxiDma_Config *axi_dma_cfg_ptr;
+    /* DMA driver initialized, shared by debug and table loads */
+    uint8_t dma_ready;
     u32 *debug_samples_ptr;
     u32 valid_debug_samples;
+    /* Capture start timestamp, from the capture header */
+    uint64_t capture_timestamp;
 
 }Waveform_Generator_t;
 
@@ -106,9 +338,21 @@ typedef struct Waveform_Generator
  * 
  * @param g Waveform Generator instance
  * @param address Hardware address of memory mapped AXI waveform generator
+ * @param channel Channel index (0 to GENERATOR_NUM_CHANNELS - 1)
  * @param axi_dma_device_id Hardware address of memory mapped AXI-DMA IP Core for samples debugging
  */
-void generator_init(Waveform_Generator_t * g, uint32_t hw_address, uint32_t axi_dma_device_id);
+void generator_init(Waveform_Generator_t * g, uint32_t hw_address, uint32_t channel, uint32_t axi_dma_device_id);
+
+/**
+ * @brief Initializes a generator instance not mapped to hardware.
+ * Configurations are validated and composed in its shadow copy only,
+ * used to build sequencer table entries.
+ * 
+ * @param g Waveform Generator instance
+ * @param hw Generator instance of the hardware the image is for,
+ * clock and lanes are taken from it
+ */
+void generator_init_detached(Waveform_Generator_t * g, const Waveform_Generator_t * hw);
 
 /**
  * @brief Enables debug. Important: Debug mode will be disabled
@@ -129,12 +373,71 @@ int generator_start(Waveform_Generator_t * g);
 
 
 /**
- * @brief Enables and starts operation of the waveform generator
+ * @brief Stops operation of the waveform generator. A channel armed on the
+ * trigger is disarmed too, or the next edge would start it again.
  * 
  * @param g Waveform Generator instance
  */
 int generator_stop(Waveform_Generator_t * g);
 
+/**
+ * @brief Arms or disarms the waveform generator.
+ * Armed and stopped, the DDS keeps running with its phase held at 0 and
+ * no samples out, so generator_start() gives the first sample after a
+ * fixed number of DDS clocks and always with the same phase. Channels are
+ * armed by generator_init().
+ * 
+ * @param g Waveform Generator instance
+ * @param arm 1 to arm, 0 to freeze the DDS while stopped
+ */
+void generator_arm(Waveform_Generator_t * g, uint8_t arm);
+
+/**
+ * @brief Stops the waveform generator and leaves starting it to the trigger
+ * pin (PMOD JA1). Each accepted edge starts one PRI, or the configured
+ * train (sequencer too) with train set, a fixed number of DDS clocks after
+ * the edge: CDC_SYNC_STAGES + 1 + start latency, see generator_arm().
+ * Edges while running or within holdoff_ns of the last accepted one are
+ * missed, both are counted in generator_perf_t. Continuous modes run from
+ * the first trigger until disarmed. generator_start() still starts it.
+ * A sequence needs train set: the enable drops after each PRI, which sends
+ * the sequencer back to its first entry.
+ * 
+ * @param g Waveform Generator instance
+ * @param edge Trigger edge
+ * @param holdoff_ns Edges ignored after a trigger, up to
+ * TRIG_MAX_HOLDOFF_CLOCKS DDS clocks
+ * @param train 1: a trigger starts the train, 0: one PRI per trigger
+ * @return int -1 on ERROR (holdoff too long, or a sequence without train),
+ * 0 on SUCCESS
+ */
+int generator_ext_trigger_arm(Waveform_Generator_t * g, generator_trigger_edge_t edge, uint32_t holdoff_ns, uint8_t train);
+
+/**
+ * @brief Leaves triggered mode, a running PRI or train is stopped. Edge,
+ * train and holdoff are cleared with TRIG_EN_BIT.
+ * 
+ * @param g Waveform Generator instance
+ */
+void generator_ext_trigger_disarm(Waveform_Generator_t * g);
+
+/**
+ * @brief Enables or disables live updates.
+ * With live updates a configuration applied while the core is running,
+ * or armed on the trigger, does not stop it: staged registers are
+ * committed and take effect at the next period start (right away in
+ * continuous mode or between triggered PRIs). A configuration
+ * that returns -1 is dropped either way: nothing is written and the core
+ * keeps running the previous one.
+ * 
+ * @param g Waveform Generator instance
+ * @param enable 1 to enable, 0 to stop (and disarm, see generator_stop())
+ * the core on every configuration.
+ * Configurations return -1 if the last commit is not latched within its
+ * period plus COMMIT_MARGIN_US.
+ */
+void generator_set_live_update(Waveform_Generator_t * g, uint8_t enable);
+
 /**
  * @brief Sets Waveform Generator to continuous mode and configures constant frequency operation.
  * No modulation will be applied in this mode
@@ -213,15 +516,234 @@ int set_pulsed_mode_freq_mod(Waveform_Generator_t * g, uint32_t period_us, uint3
  */
 int set_pulsed_mode_phase_mod(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t freq_khz, uint8_t barker_seq_num);
 
+/**
+ * @brief Sets Waveform Generator to continuous mode and configures phase modulation
+ * from the code table: chips code_offset to code_offset + code_length - 1 are played
+ * in a loop. Table must be loaded with generator_load_table(), TABLE_CODE.
+ * After configuration the core will remain disabled.
+ * 
+ * @param g Waveform Generator instance
+ * @param freq_khz Frequency in kHz
+ * @param code_offset First chip in the code table
+ * @param code_length Number of chips
+ * @param chip_length_ns Chip length in nanoseconds, rounded down to clock periods
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int set_continuous_mode_code_mod(Waveform_Generator_t * g, uint32_t freq_khz, uint32_t code_offset, uint32_t code_length, uint32_t chip_length_ns);
+
+/**
+ * @brief Sets Waveform Generator to pulsed mode and configures phase modulation
+ * from the code table. The pulse is split evenly between the chips, clocks
+ * left over at the end of the pulse replay the first chip.
+ * After configuration the core will remain disabled.
+ * 
+ * @param g Waveform Generator instance
+ * @param period_us Period in microseconds (In RADAR terms, Pulse Repetition Interval)
+ * @param pulse_length_us Pulse length in microseconds
+ * @param freq_khz Frequency in kHz
+ * @param code_offset First chip in the code table
+ * @param code_length Number of chips
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int set_pulsed_mode_code_mod(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t freq_khz, uint32_t code_offset, uint32_t code_length);
+
+/**
+ * @brief Sets Waveform Generator to continuous mode and configures frequency
+ * modulation from the PINC table: entries table_offset to table_offset +
+ * entries - 1 are played in a loop. Table must be loaded with
+ * generator_load_pinc_table().
+ * After configuration the core will remain disabled.
+ * 
+ * @param g Waveform Generator instance
+ * @param table_offset First entry in the PINC table
+ * @param entries Number of entries
+ * @param entry_clocks Entry length in clock periods
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int set_continuous_mode_pinc_table(Waveform_Generator_t * g, uint32_t table_offset, uint32_t entries, uint32_t entry_clocks);
+
+/**
+ * @brief Sets Waveform Generator to pulsed mode and configures frequency
+ * modulation from the PINC table. The frequency law restarts every pulse,
+ * it wraps to its first entry if it is shorter than the pulse.
+ * After configuration the core will remain disabled.
+ * 
+ * @param g Waveform Generator instance
+ * @param period_us Period in microseconds (In RADAR terms, Pulse Repetition Interval)
+ * @param pulse_length_us Pulse length in microseconds
+ * @param table_offset First entry in the PINC table
+ * @param entries Number of entries
+ * @param entry_clocks Entry length in clock periods
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int set_pulsed_mode_pinc_table(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t table_offset, uint32_t entries, uint32_t entry_clocks);
+
+/**
+ * @brief Loads PINC table entries. Each entry PINC is played for the
+ * configured entry length, its slope (PINC change per clock, with
+ * PINC_SLOPE_FRAC_BITS fractional bits) is added every clock: 0 holds
+ * the entry, (next PINC - PINC) / entry_clocks interpolates linearly.
+ * Table must not be written while it is being played.
+ * 
+ * @param g Waveform Generator instance
+ * @param first_entry First entry written
+ * @param pinc Entries PINC
+ * @param slope Entries slope
+ * @param count Number of entries
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int generator_load_pinc_table(Waveform_Generator_t * g, uint32_t first_entry, const uint32_t * pinc, const int32_t * slope, uint32_t count);
+
+/**
+ * @brief Sets Waveform Generator to continuous mode and configures frequency
+ * hopping from the hop table: entries table_offset to table_offset +
+ * entries - 1 are played in a loop, each for its own dwell length. Table
+ * must be loaded with generator_load_hop_table().
+ * After configuration the core will remain disabled.
+ * 
+ * @param g Waveform Generator instance
+ * @param table_offset First entry in the hop table
+ * @param entries Number of entries
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int set_continuous_mode_hop(Waveform_Generator_t * g, uint32_t table_offset, uint32_t entries);
+
+/**
+ * @brief Sets Waveform Generator to pulsed mode and configures frequency
+ * hopping from the hop table. The hop pattern restarts every pulse, it
+ * wraps to its first dwell if it is shorter than the pulse.
+ * After configuration the core will remain disabled.
+ * 
+ * @param g Waveform Generator instance
+ * @param period_us Period in microseconds (In RADAR terms, Pulse Repetition Interval)
+ * @param pulse_length_us Pulse length in microseconds
+ * @param table_offset First entry in the hop table
+ * @param entries Number of entries
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int set_pulsed_mode_hop(Waveform_Generator_t * g, uint32_t period_us, uint32_t pulse_length_us, uint32_t table_offset, uint32_t entries);
+
+/**
+ * @brief Loads hop table entries.
+ * Table must not be written while it is being played.
+ * 
+ * @param g Waveform Generator instance
+ * @param first_entry First entry written
+ * @param hops Entries
+ * @param count Number of entries
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int generator_load_hop_table(Waveform_Generator_t * g, uint32_t first_entry, const generator_hop_t * hops, uint32_t count);
+
+/**
+ * @brief Copies the configuration register image (REG_1 to REG_5)
+ * composed in the shadow copy. Detached generators can be used to
+ * build images without touching hardware.
+ * 
+ * @param g Waveform Generator instance
+ * @param image Destination, GENERATOR_IMAGE_REGS words
+ */
+void generator_get_image(Waveform_Generator_t * g, uint32_t * image);
+
+/**
+ * @brief Applies a configuration register image previously built with
+ * generator_get_image(). Image is not validated again: only registers
+ * that differ from the current configuration are written.
+ * 
+ * @param g Waveform Generator instance
+ * @param image Source, GENERATOR_IMAGE_REGS words
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int generator_apply_image(Waveform_Generator_t * g, const uint32_t * image);
+
+/**
+ * @brief Writes a sequencer table entry.
+ * Entry is the register image of a detached generator, configured in pulsed mode.
+ * Table must not be written while the sequencer is running.
+ * 
+ * @param g Waveform Generator instance
+ * @param index Table entry index (0 to SEQ_MAX_ENTRIES - 1)
+ * @param entry Detached generator holding the entry configuration
+ * @param repeat Periods the entry is played (0 is played once)
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int generator_sequence_write_entry(Waveform_Generator_t * g, uint32_t index, Waveform_Generator_t * entry, uint32_t repeat);
+
+/**
+ * @brief Packs a sequencer table entry, to be written with generator_load_table().
+ * 
+ * @param entry Detached generator holding the entry configuration, in pulsed mode
+ * @param repeat Periods the entry is played (0 is played once)
+ * @param words Destination, SEQ_ENTRY_WORDS words
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int generator_sequence_pack_entry(Waveform_Generator_t * entry, uint32_t repeat, uint32_t * words);
+
+/**
+ * @brief Loads a block of words into a PL table through the DMA MM2S
+ * channel, instead of one AXI-Lite write per word. Blocks until the
+ * transfer is done, TABLE_LOAD_TIMEOUT_MS at most. On DMA errors or
+ * timeout the DMA is reset and the table is left partly written.
+ * Table must not be written while it is being played.
+ * 
+ * @param g Waveform Generator instance
+ * @param table Destination table
+ * @param offset First word address in the table
+ * @param words Source words
+ * @param count Number of words (1 to TABLE_LOAD_MAX_WORDS)
+ * @return int -1 on ERROR, 0 on SUCCESS
+ */
+int generator_load_table(Waveform_Generator_t * g, generator_table_t table, uint32_t offset, const uint32_t * words, uint32_t count);
+
+/**
+ * @brief Starts the sequencer. Table entries 0 to length - 1 are played
+ * in order, one per period, and the sequence wraps around.
+ * Any later configuration returns the generator to register mode.
+ * 
+ * @param g Waveform Generator instance
+ * @param length Number of table entries to play
+ * @return int -1 on ERROR (bad length, or armed for one PRI per trigger),
+ * 0 on SUCCESS
+ */
+int generator_sequence_start(Waveform_Generator_t * g, uint32_t length);
+
 /**
  * @brief Triggers debug samples transfer form PL to PS.
  * Debug enable bit will return to 0 when all samples are transferd
+ * Channel 0 trigger captures every channel, so it must be called on
+ * channel 0 instance, with any channel running (enabled or triggered).
+ * Samples of each channel are then read with its own instance.
  * 
- * @param wg Waveform Generator instance
- * @return int -1 on ERROR, 0 on SUCCESS
+ * @param wg Waveform Generator instances, GENERATOR_NUM_CHANNELS from
+ * channel 0. Capture results are kept in channel 0 instance
+ * @return int -1 on ERROR (no channel running, DMA error or no tlast
+ * within CAPTURE_TIMEOUT_MS: the DMA is reset), 0 on SUCCESS
  */
 int generator_trigger_debug(Waveform_Generator_t * wg);
 
+/**
+ * @brief Reads a hardware timestamp, DDS clocks since reset. Channels
+ * share the DDS clock reset, so timestamps of every channel compare.
+ * Capture timestamp of the last capture is also in capture_timestamp.
+ * 
+ * @param g Waveform Generator instance
+ * @param which Timestamp to read
+ * @return uint64_t Timestamp, 0 on detached instances
+ */
+uint64_t generator_get_timestamp(Waveform_Generator_t * g, generator_timestamp_t which);
+
+/**
+ * @brief Takes a snapshot of the performance counters. DDS side counters
+ * are a few clocks old, see dds_config_cdc.sv.
+ * 
+ * @param g Waveform Generator instance
+ * @param perf Destination snapshot
+ * @return int -1 on ERROR (detached instance), 0 on SUCCESS
+ */
+int generator_get_perf(Waveform_Generator_t * g, generator_perf_t * perf);
+
 
 void generator_get_i_samples(Waveform_Generator_t *wg, s32 *i_samples, u32 num_samples);
 void generator_get_q_samples(Waveform_Generator_t *wg, s32 *q_samples, u32 num_samples);
+
+#endif
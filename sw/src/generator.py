@@ -1,4 +1,5 @@
 import socket
+import json
 import messages_pb2
 import matplotlib
 import matplotlib.pyplot as plt
@@ -18,6 +19,7 @@ class Generator:
         self.base_msg = messages_pb2.Base_msg()
         self.config = messages_pb2.Generator_Config_msg()
         self.control = messages_pb2.Base_msg()
+        self.channel = 0
 
         self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
         self.sock.settimeout(3)
@@ -34,6 +36,15 @@ class Generator:
     def enable_debug(self, val = True):
         self.config.debug_enabled = val
 
+    def enable_live_update(self, val = True):
+        self.config.live_update = val
+
+    def set_channel(self, channel):
+        """Selects the channel later configs and commands apply to."""
+        self.channel = channel
+        self.config.channel = channel
+        self.control.control.channel = channel
+
     def __send_config__(self):
         serial = self.__serialize_config__()
         self.sock.send(serial)
@@ -85,13 +96,169 @@ class Generator:
         self.config.phase_mod.barker_seq_num = barker_seq_num
         self.__send_config__()
 
+    def set_continuous_mode_code_mod(self, freq_khz, code, order, chip_length_ns, table_offset = 0):
+        """code: messages_pb2.Code_Mod.FRANK, P3, P4, MLS or TABLE (loaded with upload_code)."""
+        self.config.mode = self.config.CONTINUOUS
+        self.config.code_mod.freq_khz = freq_khz
+        self.config.code_mod.code = code
+        self.config.code_mod.order = order
+        self.config.code_mod.table_offset = table_offset
+        self.config.code_mod.chip_length_ns = chip_length_ns
+        self.__send_config__()
+
+    def set_pulsed_mode_code_mod(self, period_us, pulse_length_us, freq_khz, code, order, table_offset = 0):
+        """The pulse is split evenly between the code chips."""
+        self.config.mode = self.config.PULSED
+        self.config.period_us = period_us
+        self.config.pulse_length_us = pulse_length_us
+        self.config.code_mod.freq_khz = freq_khz
+        self.config.code_mod.code = code
+        self.config.code_mod.order = order
+        self.config.code_mod.table_offset = table_offset
+        self.config.code_mod.chip_length_ns = 0
+        self.__send_config__()
+
+    def upload_code(self, phases, offset = 0, chunk_size = 128):
+        """Loads chip phases to the code table, from chip offset.
+        Phases are fractions of a turn, 65536 = 360 degrees."""
+        for first in range(0, len(phases), chunk_size):
+            msg = messages_pb2.Base_msg()
+            msg.config.code_table.offset = offset + first
+            msg.config.code_table.channel = self.channel
+            msg.config.code_table.phases.extend(phases[first:first + chunk_size])
+            self.sock.send(msg.SerializeToString())
+            input = self.sock.recv(100)
+            retmsg = messages_pb2.Base_msg()
+            retmsg.ParseFromString(input)
+            if retmsg.ack.retval == messages_pb2.Ack_msg.BAD_CONFIG:
+                raise AckError("Bad Code Table")
+
+    def set_continuous_mode_freq_law(self, entries, entry_clocks, table_offset = 0):
+        """Frequency law from the PINC table, played in a loop (see freq_law.py)."""
+        self.config.mode = self.config.CONTINUOUS
+        self.config.freq_law_mod.table_offset = table_offset
+        self.config.freq_law_mod.entries = entries
+        self.config.freq_law_mod.entry_clocks = entry_clocks
+        self.__send_config__()
+
+    def set_pulsed_mode_freq_law(self, period_us, pulse_length_us, entries, entry_clocks, table_offset = 0):
+        """Frequency law from the PINC table, restarted every pulse (see freq_law.py)."""
+        self.config.mode = self.config.PULSED
+        self.config.period_us = period_us
+        self.config.pulse_length_us = pulse_length_us
+        self.config.freq_law_mod.table_offset = table_offset
+        self.config.freq_law_mod.entries = entries
+        self.config.freq_law_mod.entry_clocks = entry_clocks
+        self.__send_config__()
+
+    def upload_freq_law(self, pinc, slope, offset = 0, chunk_size = 64):
+        """Loads PINC table entries, from entry offset."""
+        for first in range(0, len(pinc), chunk_size):
+            msg = messages_pb2.Base_msg()
+            msg.config.freq_law_table.offset = offset + first
+            msg.config.freq_law_table.channel = self.channel
+            msg.config.freq_law_table.pinc.extend(pinc[first:first + chunk_size])
+            msg.config.freq_law_table.slope.extend(slope[first:first + chunk_size])
+            self.sock.send(msg.SerializeToString())
+            input = self.sock.recv(100)
+            retmsg = messages_pb2.Base_msg()
+            retmsg.ParseFromString(input)
+            if retmsg.ack.retval == messages_pb2.Ack_msg.BAD_CONFIG:
+                raise AckError("Bad PINC Table")
+
+    def load_freq_law(self, filename, offset = 0):
+        """Uploads a table written by freq_law.py. Returns (entries, entry_clocks)."""
+        with open(filename) as f:
+            table = json.load(f)
+        self.upload_freq_law(table["pinc"], table["slope"], offset)
+        return len(table["pinc"]), table["entry_clocks"]
+
+    def set_continuous_mode_hop(self, entries, table_offset = 0):
+        """Frequency hopping from the hop table, played in a loop."""
+        self.config.mode = self.config.CONTINUOUS
+        self.config.hop_mod.table_offset = table_offset
+        self.config.hop_mod.entries = entries
+        self.__send_config__()
+
+    def set_pulsed_mode_hop(self, period_us, pulse_length_us, entries, table_offset = 0):
+        """Frequency hopping from the hop table, restarted every pulse."""
+        self.config.mode = self.config.PULSED
+        self.config.period_us = period_us
+        self.config.pulse_length_us = pulse_length_us
+        self.config.hop_mod.table_offset = table_offset
+        self.config.hop_mod.entries = entries
+        self.__send_config__()
+
+    def upload_hops(self, hops, offset = 0, chunk_size = 32):
+        """Loads hop table entries, from entry offset.
+        hops: list of (freq_khz, dwell_ns, phase) tuples, phase 65536 = 360 degrees."""
+        for first in range(0, len(hops), chunk_size):
+            msg = messages_pb2.Base_msg()
+            msg.config.hop_table.offset = offset + first
+            msg.config.hop_table.channel = self.channel
+            for freq_khz, dwell_ns, phase in hops[first:first + chunk_size]:
+                hop = msg.config.hop_table.hops.add()
+                hop.freq_khz = freq_khz
+                hop.dwell_ns = dwell_ns
+                hop.phase = phase
+            self.sock.send(msg.SerializeToString())
+            input = self.sock.recv(100)
+            retmsg = messages_pb2.Base_msg()
+            retmsg.ParseFromString(input)
+            if retmsg.ack.retval == messages_pb2.Ack_msg.BAD_CONFIG:
+                raise AckError("Bad Hop Table")
+
+    def load_sequence(self, entries, chunk_size = 8):
+        """Loads and starts a pulse to pulse sequence.
+        entries: list of (Generator_Config_msg, repeat) tuples, pulsed mode only."""
+        for first in range(0, len(entries), chunk_size):
+            msg = messages_pb2.Base_msg()
+            msg.config.sequence.first_index = first
+            msg.config.sequence.channel = self.channel
+            for config, repeat in entries[first:first + chunk_size]:
+                entry = msg.config.sequence.entries.add()
+                entry.config.CopyFrom(config)
+                entry.repeat = repeat
+            # Sequence starts with the last chunk
+            if first + chunk_size >= len(entries):
+                msg.config.sequence.length = len(entries)
+            self.sock.send(msg.SerializeToString())
+            input = self.sock.recv(100)
+            retmsg = messages_pb2.Base_msg()
+            retmsg.ParseFromString(input)
+            if retmsg.ack.retval == messages_pb2.Ack_msg.BAD_CONFIG:
+                raise AckError("Bad Sequence")
+
+    def __send_preset__(self, msg):
+        self.sock.send(msg.SerializeToString())
+        input = self.sock.recv(100)
+        retmsg = messages_pb2.Base_msg()
+        retmsg.ParseFromString(input)
+        if retmsg.ack.retval == messages_pb2.Ack_msg.BAD_CONFIG:
+            raise AckError("Bad Preset")
+
+    def save_preset(self, id, name, config = None):
+        """Saves config (last sent config by default) as preset id."""
+        msg = messages_pb2.Base_msg()
+        msg.config.save_preset.id = id
+        msg.config.save_preset.name = name
+        msg.config.save_preset.config.CopyFrom(self.config if config is None else config)
+        self.__send_preset__(msg)
+
+    def recall_preset(self, id):
+        msg = messages_pb2.Base_msg()
+        msg.config.recall_preset.id = id
+        msg.config.recall_preset.channel = self.channel
+        self.__send_preset__(msg)
+
     def __serialize_config__(self):
         self.base_msg.config.generator.CopyFrom(self.config)
         self.serial = self.base_msg.SerializeToString()
         return self.serial
 
-    def start(self):
+    def start(self, all_channels = False):
         self.control.control.command = self.control.control.START
+        self.control.control.all_channels = all_channels
         serial = self.control.SerializeToString()
         self.sock.send(serial)
         input = self.sock.recv(100)
@@ -104,8 +271,9 @@ class Generator:
         elif retmsg.ack.retval == messages_pb2.Ack_msg.BAD_COMMAND:
             raise AckError("Bad Command")
         
-    def stop(self):
+    def stop(self, all_channels = False):
         self.control.control.command = self.control.control.STOP
+        self.control.control.all_channels = all_channels
         serial = self.control.SerializeToString()
         self.sock.send(serial)
         input = self.sock.recv(100)
@@ -117,7 +285,16 @@ class Generator:
             raise AckError("Stop Error")
 
     def trigger_debug(self):
-        self.control.control.command = self.control.control.TRIG_DBG
+        """Captures every channel, receives samples of the selected one."""
+        self.__debug_command__(self.control.control.TRIG_DBG)
+
+    def get_debug(self, channel):
+        """Receives samples of channel from the last capture."""
+        self.set_channel(channel)
+        self.__debug_command__(self.control.control.GET_DBG)
+
+    def __debug_command__(self, command):
+        self.control.control.command = command
         serial = self.control.SerializeToString()
         self.sock.send(serial)
         # self.sock.settimeout(0)
@@ -143,6 +320,64 @@ class Generator:
         #     return True
         # else:
 
+    def get_stats(self):
+        self.control.control.command = self.control.control.GET_STATS
+        serial = self.control.SerializeToString()
+        self.sock.send(serial)
+        input = self.sock.recv(1000)
+        stats = messages_pb2.Stats_msg()
+        try:
+            stats.ParseFromString(input)
+        except:
+            raise AckError("Stats Error")
+        return stats
+
+    def set_log_level(self, level):
+        self.control.control.command = self.control.control.SET_LOG_LEVEL
+        self.control.control.log_level = level
+        serial = self.control.SerializeToString()
+        self.sock.send(serial)
+        input = self.sock.recv(100)
+        retmsg = messages_pb2.Base_msg()
+        retmsg.ParseFromString(input)
+        if retmsg.ack.retval != messages_pb2.Ack_msg.ACK:
+            raise AckError("Log Level Error")
+
+    def dump_trace(self):
+        self.control.control.command = self.control.control.TRACE_DUMP
+        serial = self.control.SerializeToString()
+        self.sock.send(serial)
+        fragments = []
+        while True:
+            try:
+                chunk = self.sock.recv(20000)
+                fragments.append(chunk)
+            except:
+                break
+        input = b''.join(fragments)
+        trace = messages_pb2.Trace_msg()
+        try:
+            trace.ParseFromString(input)
+        except:
+            raise AckError("Trace Error")
+        return trace
+
+    def save_trace(self, filename = "trace.json"):
+        # Chrome trace event format, open with chrome://tracing or Perfetto
+        trace = self.dump_trace()
+        phases = {messages_pb2.Trace_event.BEGIN: "B",
+                  messages_pb2.Trace_event.END: "E",
+                  messages_pb2.Trace_event.INSTANT: "i"}
+        events = []
+        for event in trace.events:
+            events.append({"name": messages_pb2.Trace_event.Stage.Name(event.stage),
+                           "ph": phases[event.phase],
+                           "ts": event.timestamp * 1e6 / trace.timer_freq_hz,
+                           "pid": 0,
+                           "tid": event.core})
+        with open(filename,"w+") as f:
+            json.dump({"traceEvents": events}, f)
+
     def dump_samples(self):
         with open("dump.txt","w+") as f: 
             for i in range(self.num_samples):
@@ -8,53 +8,422 @@
 
 #include "common.h"
 #include "generator_app.h"
+#include "trace.h"
+#include "presets.h"
+#include "phase_codes.h"
 #include "FreeRTOS.h"
 #include "lwipopts.h"
 #include "netif/xadapter.h"
 
 #include "messages.pb.h"
 
-void generator_app_thread(void *p);
-
-extern void send_ack(xQueueHandle queue, Ack_msg_Retval retval);
+extern void send_ack_ts(int sock, Ack_msg_Retval retval, uint64_t timestamp, uint64_t commit_timestamp, uint64_t pulse_timestamp);
 
 /* Protobuf message for generator debug samples */
 Debug_msg debug_samples_msg;
 
 /**
- * @brief Initialize generator sub-app structure and create task
+ * @brief Initialize generator sub-app structure.
+ * No task is created: messages are handled on the connection loop
+ * through generator_app_handle_message().
  * 
  * @param app Generator sub-app instance pointer.
  * @param first_message App creation message. Initial coniguration is received here.
- * @param net_in_queue Input protobuf message queue handle.
- * @param main_queue Main application protobuf message queue handle.
- * @param net_out_queue Output protobuf message queue handle.
+ * @param net_sock Connected socket where responses are written.
+ * @return int -1 if the first configuration is not valid (sub-app is
+ * created anyway), 0 on SUCCESS
  */
-void generator_app_init (generator_app_t *app, Base_msg *first_message, xQueueHandle net_in_queue, xQueueHandle main_queue, xQueueHandle net_out_queue){
+int generator_app_init (generator_app_t *app, Base_msg *first_message, int net_sock){
 
 	*app = (generator_app_t){0};
 
-    Waveform_Generator_t *wg = &app->wg;
+    const uint32_t addresses[GENERATOR_NUM_CHANNELS] = MY_GENERATOR_ADDRESSES;
+
+    /* Init waveform generator instances */
+    for (uint32_t channel = 0; channel < GENERATOR_NUM_CHANNELS; channel++){
+        generator_init(&app->wg[channel], addresses[channel], channel, DEBUG_DMA_ID); //TODO: Error handling
+    }
 
-    /* Init waveform generator instance */
-    generator_init(wg, MY_GENERATOR_ADDRESS, DEBUG_DMA_ID); //TODO: Error handling
+    /* Init debug, capture DMA is shared by all channels */
+    generator_enable_debug(&app->wg[0]);
 
-    /* Init debug */
-    generator_enable_debug(wg);
+    /* Socket is already accepted in main app */
+    app->net_sock = net_sock;
 
     /* Apply first configuration */
-    generator_app_decode_config(app,first_message);
-
-    /* Init queue handles - Queues are already created in main app*/
-    app->net_in_queue = net_in_queue;
-    app->main_app_queue = main_queue;
-    app->net_out_queue = net_out_queue;
-
-    /* Launch task */
-	sys_thread_new("generator_app", generator_app_thread,
-		(void*)app,
-		THREAD_STACKSIZE,
-		DEFAULT_THREAD_PRIO);
+    return generator_app_decode_config(app,first_message);
+}
+
+/**
+ * @brief Gets a channel generator instance.
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param channel Channel index.
+ * @return Waveform_Generator_t* NULL if channel doesn't exist.
+ */
+static Waveform_Generator_t *generator_app_channel(generator_app_t *app, uint32_t channel){
+
+    if (channel >= GENERATOR_NUM_CHANNELS){
+        return NULL;
+    }
+    app->ack_channel = channel;
+    return &app->wg[channel];
+}
+
+/**
+ * @brief Sends an ack with the hardware timestamps of the channel the
+ * message addressed (channel 0 if none).
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param retval Protobuf Ack message to send.
+ */
+static void generator_app_send_ack(generator_app_t *app, Ack_msg_Retval retval){
+
+    Waveform_Generator_t *wg = &app->wg[app->ack_channel];
+
+    send_ack_ts(app->net_sock, retval,
+                generator_get_timestamp(wg, TIMESTAMP_NOW),
+                generator_get_timestamp(wg, TIMESTAMP_COMMIT),
+                generator_get_timestamp(wg, TIMESTAMP_PULSE));
+}
+
+/**
+ * @brief Generates the chip phases of a code modulation.
+ * 
+ * @param code Protobuf code modulation.
+ * @param phases Destination, CODE_MAX_CHIPS words.
+ * @return int Number of chips, -1 on ERROR. 0 for TABLE codes, already loaded.
+ */
+static int generator_app_generate_code(Code_Mod *code, uint32_t *phases){
+
+    /* Chips left in the table from the first one */
+    uint32_t max_chips = (code->table_offset < CODE_MAX_CHIPS) ? CODE_MAX_CHIPS - code->table_offset : 0;
+
+    switch (code->code){
+        case Code_Mod_Code_FRANK:
+            return phase_code_frank(code->order, phases, max_chips);
+        case Code_Mod_Code_P3:
+            return phase_code_p3(code->order, phases, max_chips);
+        case Code_Mod_Code_P4:
+            return phase_code_p4(code->order, phases, max_chips);
+        case Code_Mod_Code_MLS:
+            return phase_code_mls(code->order, phases, max_chips);
+        case Code_Mod_Code_TABLE:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Applies a code modulation. Generated codes are loaded to the
+ * channel code table; detached instances (sequence entries, presets)
+ * only compose registers and play the table as it is.
+ * 
+ * @param wg Waveform generator instance, mapped or detached.
+ * @param config Protobuf generator configuration.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int generator_app_apply_code_mod(Waveform_Generator_t *wg, Generator_Config_msg *config){
+
+    static uint32_t phases[CODE_MAX_CHIPS];
+    Code_Mod *code = &config->code_mod;
+    int chips = generator_app_generate_code(code, phases);
+    uint32_t length = (chips == 0) ? code->order : (uint32_t) chips;
+    int retval;
+
+    if (chips < 0){
+        return -1;
+    }
+
+    /* Core is stopped here, unless it is a live update */
+    if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
+    {
+        retval = set_continuous_mode_code_mod(wg, code->freq_khz, code->table_offset,
+                                              length, code->chip_length_ns);
+    }
+    else
+    {
+        retval = set_pulsed_mode_code_mod(wg, config->period_us, config->pulse_length_us,
+                                          code->freq_khz, code->table_offset, length);
+    }
+
+    if (retval == 0 && chips > 0 && !wg->detached)
+    {
+        retval = generator_load_table(wg, TABLE_CODE, code->table_offset, phases, chips);
+    }
+
+    return retval;
+}
+
+/**
+ * @brief Applies a generator configuration message to a generator instance.
+ * 
+ * @param wg Waveform generator instance, mapped or detached.
+ * @param config Protobuf generator configuration.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int generator_app_apply_config(Waveform_Generator_t *wg, Generator_Config_msg *config){
+
+    int retval = 0;
+
+    /* Decode modulation */
+    switch (config->which_modulation_config){
+        case Generator_Config_msg_const_freq_tag:
+            /* Decode continuous or pulsed */
+            if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
+            {
+                retval = set_continuous_mode_constant_freq(wg,
+                                                           config->const_freq.freq_khz);
+            }
+            else
+            {
+                retval = set_pulsed_mode_constant_freq(wg,config->period_us,
+                                              config->pulse_length_us,
+                                              config->const_freq.freq_khz);
+            }
+            break;
+        case Generator_Config_msg_freq_mod_tag:
+            /* Decode continuous or pulsed */
+        	if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
+					{
+						retval = set_continuous_mode_freq_mod(wg,
+                                                 config->freq_mod.low_freq_khz,
+                                                 config->freq_mod.high_freq_khz,
+                                                 config->freq_mod.length_us);
+					}
+					else
+					{
+						retval = set_pulsed_mode_freq_mod(wg,
+                                             config->period_us,
+                                             config->pulse_length_us,
+                                             config->freq_mod.low_freq_khz,
+                                             config->freq_mod.high_freq_khz);
+					}
+            break;
+        case Generator_Config_msg_phase_mod_tag:
+            /* Decode continuous or pulsed */
+            if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
+					{
+						retval = set_continuous_mode_phase_mod(wg,
+                                                config->phase_mod.freq_khz,
+                                                config->phase_mod.barker_seq_num,
+                                                config->phase_mod.barker_subpulse_length_us*config->phase_mod.barker_seq_num);
+					}
+					else
+					{
+						retval = set_pulsed_mode_phase_mod(wg,
+                                              config->period_us,
+                                              config->pulse_length_us,
+                                              config->phase_mod.freq_khz,
+                                              config->phase_mod.barker_seq_num);
+					}
+            break;
+        case Generator_Config_msg_code_mod_tag:
+            retval = generator_app_apply_code_mod(wg, config);
+            break;
+        case Generator_Config_msg_freq_law_mod_tag:
+            /* Decode continuous or pulsed */
+            if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
+            {
+                retval = set_continuous_mode_pinc_table(wg,
+                                                        config->freq_law_mod.table_offset,
+                                                        config->freq_law_mod.entries,
+                                                        config->freq_law_mod.entry_clocks);
+            }
+            else
+            {
+                retval = set_pulsed_mode_pinc_table(wg,
+                                                    config->period_us,
+                                                    config->pulse_length_us,
+                                                    config->freq_law_mod.table_offset,
+                                                    config->freq_law_mod.entries,
+                                                    config->freq_law_mod.entry_clocks);
+            }
+            break;
+        case Generator_Config_msg_hop_mod_tag:
+            /* Decode continuous or pulsed */
+            if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
+            {
+                retval = set_continuous_mode_hop(wg,
+                                                 config->hop_mod.table_offset,
+                                                 config->hop_mod.entries);
+            }
+            else
+            {
+                retval = set_pulsed_mode_hop(wg,
+                                             config->period_us,
+                                             config->pulse_length_us,
+                                             config->hop_mod.table_offset,
+                                             config->hop_mod.entries);
+            }
+            break;
+    }
+
+    return retval;
+}
+
+/**
+ * @brief Writes sequence entries to the sequencer table and starts it.
+ * Each entry is composed in a detached generator, its register image
+ * is packed and the whole chunk is loaded to the table in one DMA transfer.
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param sequence Protobuf sequence message.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int generator_app_decode_sequence(generator_app_t *app, Sequence_msg *sequence){
+
+    /* Scratch instance, only its shadow copy is used */
+    static Waveform_Generator_t entry;
+    /* Packed entries of this chunk */
+    static uint32_t table[SEQ_MAX_ENTRIES * SEQ_ENTRY_WORDS];
+    Waveform_Generator_t *wg = generator_app_channel(app, sequence->channel);
+
+    if (wg == NULL || sequence->first_index + sequence->entries_count > SEQ_MAX_ENTRIES){
+        return -1;
+    }
+
+    for (pb_size_t i = 0; i < sequence->entries_count; i++)
+    {
+        generator_init_detached(&entry, wg);
+
+        if (!sequence->entries[i].has_config ||
+            generator_app_apply_config(&entry, &sequence->entries[i].config) < 0 ||
+            generator_sequence_pack_entry(&entry, sequence->entries[i].repeat,
+                                          &table[i * SEQ_ENTRY_WORDS]) < 0)
+        {
+            return -1;
+        }
+    }
+
+    if (sequence->entries_count != 0 &&
+        generator_load_table(wg, TABLE_SEQUENCER, sequence->first_index * SEQ_ENTRY_WORDS,
+                             table, sequence->entries_count * SEQ_ENTRY_WORDS) < 0)
+    {
+        return -1;
+    }
+
+    /* Length is only sent with the last chunk of entries */
+    if (sequence->length != 0)
+    {
+        return generator_sequence_start(wg, sequence->length);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Loads a block of chip phases to a channel code table.
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param code_table Protobuf code table message.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int generator_app_load_code_table(generator_app_t *app, Code_table_msg *code_table){
+
+    Waveform_Generator_t *wg = generator_app_channel(app, code_table->channel);
+
+    if (wg == NULL){
+        return -1;
+    }
+
+    return generator_load_table(wg, TABLE_CODE, code_table->offset,
+                                code_table->phases, code_table->phases_count);
+}
+
+/**
+ * @brief Loads a block of entries to a channel PINC table.
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param law_table Protobuf PINC table message.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int generator_app_load_freq_law_table(generator_app_t *app, Freq_law_table_msg *law_table){
+
+    Waveform_Generator_t *wg = generator_app_channel(app, law_table->channel);
+
+    if (wg == NULL || law_table->pinc_count != law_table->slope_count){
+        return -1;
+    }
+
+    return generator_load_pinc_table(wg, law_table->offset, law_table->pinc,
+                                     law_table->slope, law_table->pinc_count);
+}
+
+/**
+ * @brief Loads a block of entries to a channel hop table.
+ * Dwell lengths are rounded down to clock periods.
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param hop_table Protobuf hop table message.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int generator_app_load_hop_table(generator_app_t *app, Hop_table_msg *hop_table){
+
+    /* Runs on the connection loop, kept off its stack */
+    static generator_hop_t hops[sizeof(hop_table->hops) / sizeof(hop_table->hops[0])];
+    Waveform_Generator_t *wg = generator_app_channel(app, hop_table->channel);
+
+    if (wg == NULL){
+        return -1;
+    }
+
+    for (pb_size_t i = 0; i < hop_table->hops_count; i++)
+    {
+        if (hop_table->hops[i].phase > UINT16_MAX){
+            return -1;
+        }
+        hops[i].freq_khz = hop_table->hops[i].freq_khz;
+        hops[i].dwell_clocks = NS_TO_CLOCKS(wg, hop_table->hops[i].dwell_ns);
+        hops[i].phase = hop_table->hops[i].phase;
+    }
+
+    return generator_load_hop_table(wg, hop_table->offset, hops, hop_table->hops_count);
+}
+
+/**
+ * @brief Validates a configuration and saves its register image as preset.
+ * Running generator is not modified.
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param save Protobuf save preset message.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int generator_app_save_preset(generator_app_t *app, Save_preset_msg *save){
+
+    /* Scratch instance, only its shadow copy is used */
+    static Waveform_Generator_t preset_wg;
+    uint32_t image[GENERATOR_IMAGE_REGS];
+
+    /* Channels share the DDS clock */
+    generator_init_detached(&preset_wg, &app->wg[0]);
+
+    if (!save->has_config || generator_app_apply_config(&preset_wg, &save->config) < 0){
+        return -1;
+    }
+
+    generator_get_image(&preset_wg, image);
+    return presets_save(save->id, save->name, image);
+}
+
+/**
+ * @brief Applies a saved preset to the generator.
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param recall Protobuf recall preset message.
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int generator_app_recall_preset(generator_app_t *app, Recall_preset_msg *recall){
+
+    const preset_t *preset = presets_get(recall->id);
+    Waveform_Generator_t *wg = generator_app_channel(app, recall->channel);
+
+    if (preset == NULL || wg == NULL){
+        return -1;
+    }
+
+    return generator_apply_image(wg, preset->image);
 }
 
 /**
@@ -67,8 +436,11 @@ void generator_app_init (generator_app_t *app, Base_msg *first_message, xQueueHa
 int generator_app_decode_config(generator_app_t *app, Base_msg *config_message){
 
     Generator_Config_msg *config;
+    Waveform_Generator_t *wg;
     int retval = 0;
 
+    TRACE_BEGIN(DECODE_CONFIG);
+
     /* Is the received message a configuration ?
     *  Is the received message a generator configuration ?
     *  */
@@ -76,66 +448,48 @@ int generator_app_decode_config(generator_app_t *app, Base_msg *config_message){
         config_message->config.which_config == Config_msg_generator_tag){
         
         config = &(config_message->config.generator);
+        wg = generator_app_channel(app, config->channel);
 
-        /* Decode modulation */
-        switch (config->which_modulation_config){
-            case Generator_Config_msg_const_freq_tag:
-                /* Decode continuous or pulsed */
-                if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
-                {
-                    retval = set_continuous_mode_constant_freq(&app->wg,
-                                                               config->const_freq.freq_khz);
-                }
-                else
-                {
-                    retval = set_pulsed_mode_constant_freq(&app->wg,config->period_us,
-                                                  config->pulse_length_us,
-                                                  config->const_freq.freq_khz);
-                }
-                break;
-            case Generator_Config_msg_freq_mod_tag:
-                /* Decode continuous or pulsed */
-            	if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
-					{
-						retval = set_continuous_mode_freq_mod(&app->wg,
-                                                     config->freq_mod.low_freq_khz,
-                                                     config->freq_mod.high_freq_khz,
-                                                     config->freq_mod.length_us);
-					}
-					else
-					{
-						retval = set_pulsed_mode_freq_mod(&app->wg,
-                                                 config->period_us,
-                                                 config->pulse_length_us,
-                                                 config->freq_mod.low_freq_khz,
-                                                 config->freq_mod.high_freq_khz);
-					}
-                break;
-            case Generator_Config_msg_phase_mod_tag:
-                /* Decode continuous or pulsed */
-                if (config->mode == Generator_Config_msg_Mode_CONTINUOUS)
-					{
-						retval = set_continuous_mode_phase_mod(&app->wg,
-                                                    config->phase_mod.freq_khz,
-                                                    config->phase_mod.barker_seq_num,
-                                                    config->phase_mod.barker_subpulse_length_us*config->phase_mod.barker_seq_num);
-					}
-					else
-					{
-						retval = set_pulsed_mode_phase_mod(&app->wg,
-                                                  config->period_us,
-                                                  config->pulse_length_us,
-                                                  config->phase_mod.freq_khz,
-                                                  config->phase_mod.barker_seq_num);
-					}
-                break;
+        if (wg == NULL){
+            retval = -1;
         }
+        else{
+            /* Apply without stopping if requested */
+            generator_set_live_update(wg, config->live_update);
 
+            /* Decode modulation */
+            retval = generator_app_apply_config(wg, config);
+        }
+    }
+    else if (config_message->which_message == Base_msg_config_tag &&
+             config_message->config.which_config == Config_msg_sequence_tag){
+        retval = generator_app_decode_sequence(app, &config_message->config.sequence);
+    }
+    else if (config_message->which_message == Base_msg_config_tag &&
+             config_message->config.which_config == Config_msg_save_preset_tag){
+        retval = generator_app_save_preset(app, &config_message->config.save_preset);
+    }
+    else if (config_message->which_message == Base_msg_config_tag &&
+             config_message->config.which_config == Config_msg_recall_preset_tag){
+        retval = generator_app_recall_preset(app, &config_message->config.recall_preset);
+    }
+    else if (config_message->which_message == Base_msg_config_tag &&
+             config_message->config.which_config == Config_msg_code_table_tag){
+        retval = generator_app_load_code_table(app, &config_message->config.code_table);
+    }
+    else if (config_message->which_message == Base_msg_config_tag &&
+             config_message->config.which_config == Config_msg_freq_law_table_tag){
+        retval = generator_app_load_freq_law_table(app, &config_message->config.freq_law_table);
+    }
+    else if (config_message->which_message == Base_msg_config_tag &&
+             config_message->config.which_config == Config_msg_hop_table_tag){
+        retval = generator_app_load_hop_table(app, &config_message->config.hop_table);
     }
     else{
         retval = -1;
     }
     
+    TRACE_END(DECODE_CONFIG);
     return retval;
 }
 
@@ -148,6 +502,7 @@ int generator_app_decode_config(generator_app_t *app, Base_msg *config_message){
 void generator_app_decode_control(generator_app_t *app, Base_msg *config_message){
     
     Control_msg *control;
+    Waveform_Generator_t *wg;
     
     int valid_message = 0;
     int debug_error = 0;
@@ -156,34 +511,52 @@ void generator_app_decode_control(generator_app_t *app, Base_msg *config_message
     /* Is the received message a control message? */
     if (config_message->which_message == Base_msg_control_tag){
         control = &(config_message->control);
+        wg = generator_app_channel(app, control->channel);
 
         switch (control->command)
         {
         case Control_msg_Command_START:
-            generator_start(&app->wg);
-            valid_message = 1;
+            valid_message = (wg != NULL || control->all_channels);
+            for (uint32_t channel = 0; valid_message && channel < GENERATOR_NUM_CHANNELS; channel++){
+                if (control->all_channels || channel == control->channel){
+                    generator_start(&app->wg[channel]);
+                }
+            }
             break;
         
         case Control_msg_Command_STOP:
-            generator_stop(&app->wg);
-            valid_message = 1;
+            valid_message = (wg != NULL || control->all_channels);
+            for (uint32_t channel = 0; valid_message && channel < GENERATOR_NUM_CHANNELS; channel++){
+                if (control->all_channels || channel == control->channel){
+                    generator_stop(&app->wg[channel]);
+                }
+            }
             break;
         
         case Control_msg_Command_TRIG_DBG:
-            valid_message = 1;
+            valid_message = (wg != NULL);
             /* Trigger debug samples transfer  */
-            /* This gets samples form PL to PS */
-            if (generator_trigger_debug(&app->wg) < 0 ){
-                debug_error  = 1;
+            /* This gets samples form PL to PS, every channel at once */
+            if (valid_message){
+                app->debug_captured = (generator_trigger_debug(app->wg) == 0);
+                debug_error = !app->debug_captured;
             }
-            else{
-                /* Successful DMA transfer */
-                /* Build protobuf message  */
-                generator_get_i_samples(&app->wg, debug_samples_msg.i_samples, app->wg.valid_debug_samples);
-                generator_get_q_samples(&app->wg, debug_samples_msg.q_samples, app->wg.valid_debug_samples);
-                debug_samples_msg.num_samples = app->wg.valid_debug_samples;
+            /* Fall through: requested channel samples are sent */
+
+        case Control_msg_Command_GET_DBG:
+            valid_message = (wg != NULL);
+            if (valid_message && app->debug_captured){
+                /* Build protobuf message from last capture */
+                generator_get_i_samples(wg, debug_samples_msg.i_samples, app->wg[0].valid_debug_samples);
+                generator_get_q_samples(wg, debug_samples_msg.q_samples, app->wg[0].valid_debug_samples);
+                debug_samples_msg.num_samples = app->wg[0].valid_debug_samples;
+                debug_samples_msg.channel = control->channel;
+                debug_samples_msg.timestamp = app->wg[0].capture_timestamp;
                 debug_is_valid = 1;
             }
+            else{
+                debug_error = 1;
+            }
             break;
         
         default:
@@ -199,83 +572,106 @@ void generator_app_decode_control(generator_app_t *app, Base_msg *config_message
     
     /* Check message errors */
     if (!valid_message){
-        send_ack(app->net_out_queue, Ack_msg_Retval_BAD_COMMAND);
+        generator_app_send_ack(app, Ack_msg_Retval_BAD_COMMAND);
         
     }
     else{
         /* DMA debug transfer was successful. Inform that debug samples are valid */
         if(debug_is_valid){
-            send_ack(app->net_out_queue, Ack_msg_Retval_DEBUG_IS_VALID);
+            generator_app_send_ack(app, Ack_msg_Retval_DEBUG_IS_VALID);
         }
         else if (debug_error)
         {
-            send_ack(app->net_out_queue, Ack_msg_Retval_DEBUG_ERROR);
+            generator_app_send_ack(app, Ack_msg_Retval_DEBUG_ERROR);
         }
         else{
-            send_ack(app->net_out_queue, Ack_msg_Retval_ACK);
+            generator_app_send_ack(app, Ack_msg_Retval_ACK);
         }
     }
 }
 
 /**
- * @brief Generator sub-app thread.
- * Waits for configuration and control messages.
+ * @brief Fills the stats message with the performance counters of
+ * every channel.
  * 
- * @param p Generator sub-app instance pointer-
+ * @param app Generator sub-app instance pointer.
+ * @param stats Stats message, perf entries are appended.
  */
-void generator_app_thread(void *p){
+void generator_app_collect_perf(generator_app_t *app, Stats_msg *stats){
 
-    generator_app_t *app = (generator_app_t*) p;
+    generator_perf_t perf;
 
-    Base_msg received_message = Base_msg_init_zero;
+    for (uint32_t channel = 0; channel < GENERATOR_NUM_CHANNELS; channel++){
+        if (stats->perf_count >= GENERATOR_APP_MAX_PERF ||
+            generator_get_perf(&app->wg[channel], &perf) < 0){
+            continue;
+        }
+        stats->perf[stats->perf_count++] = (Generator_perf){
+            .channel = channel,
+            .pulses = perf.pulses,
+            .stall_cycles = perf.stall_cycles,
+            .capture_beats = perf.capture_beats,
+            .tlasts = perf.tlasts,
+            .commits = perf.commits,
+            .config_writes = perf.config_writes,
+            .triggers = perf.triggers,
+            .triggers_missed = perf.triggers_missed,
+        };
+    }
+}
 
-    int exit = 0;
+/**
+ * @brief Generator sub-app message handler.
+ * Runs on the connection loop for every message routed to the generator.
+ * 
+ * @param app Generator sub-app instance pointer.
+ * @param message Received protobuf message.
+ * @return int GENERATOR_APP_EXIT when the sub-app is released (generator stopped),
+ * GENERATOR_APP_RUNNING otherwise.
+ */
+int generator_app_handle_message(generator_app_t *app, Base_msg *message){
 
-    while (!exit){
-        /* Block until new incoming message */
-	    xQueueReceive(app->net_in_queue,(void *) &received_message,portMAX_DELAY);
+    int exit = 0;
 
-        /* Parse received messages */
-        switch (received_message.which_message)
-        {
-        case Base_msg_config_tag:
-            /* Is my config ? */
-            if (received_message.config.which_config == Config_msg_generator_tag){
-                /* Decode and set configuration */
-                if (generator_app_decode_config(app, &received_message) < 0){
-                    send_ack(app->net_out_queue, Ack_msg_Retval_BAD_CONFIG);
-                }
-                else {
-                    send_ack(app->net_out_queue, Ack_msg_Retval_ACK);
-                }
-                
-            }
-            else{
-                exit = 1;
-                /* Received demodulator config, send message to main_app and exit thread */
-				xQueueSend(app->main_app_queue, &received_message, portMAX_DELAY);
-            }      
-            break;
-        
-        case Base_msg_control_tag:
-        	/* Broken conn?*/
-        	if (received_message.control.command == Control_msg_Command_BROKEN_CONN){
-                exit = 1;
-            }
-            else{
-                generator_app_decode_control(app, &received_message);
-            }
-            break;
+    /* Acks carry the timestamps of the channel the message addresses */
+    app->ack_channel = 0;
 
-        default:
-            print_info("%s: Unknown message received \r\n",__FUNCTION__);
-            send_ack(app->net_out_queue, Ack_msg_Retval_INVALID_MSG);
-            break;
+    /* Parse received messages */
+    switch (message->which_message)
+    {
+    case Base_msg_config_tag:
+        /* Decode and set configuration */
+        if (generator_app_decode_config(app, message) < 0){
+            generator_app_send_ack(app, Ack_msg_Retval_BAD_CONFIG);
+        }
+        else {
+            generator_app_send_ack(app, Ack_msg_Retval_ACK);
         }
+        break;
+    
+    case Base_msg_control_tag:
+        /* Broken conn?*/
+        if (message->control.command == Control_msg_Command_BROKEN_CONN){
+            exit = 1;
+        }
+        else{
+            generator_app_decode_control(app, message);
+        }
+        break;
 
+    default:
+        log_warn("%s: Unknown message received \r\n",__FUNCTION__);
+        generator_app_send_ack(app, Ack_msg_Retval_INVALID_MSG);
+        break;
     }
-    
-    print_info("%s: Exiting task. \r\n",__FUNCTION__);
-    generator_stop(&app->wg);   
-    vTaskDelete(NULL);
+
+    if (exit){
+        print_info("%s: Exiting sub-app. \r\n",__FUNCTION__);
+        for (uint32_t channel = 0; channel < GENERATOR_NUM_CHANNELS; channel++){
+            generator_stop(&app->wg[channel]);
+        }
+        return GENERATOR_APP_EXIT;
+    }
+
+    return GENERATOR_APP_RUNNING;
 }
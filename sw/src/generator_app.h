@@ -2,31 +2,42 @@
 #define __GENERATOR_APP
 
 #include "FreeRTOS.h"
-#include "queue.h"
 #include "generator.h"
 #include "messages.pb.h"
 
 //#include "main_app.h"
 
-#define MY_GENERATOR_ADDRESS XPAR_MM2S_DDS_MODULATOR_BASEADDR
+/* One entry per channel, GENERATOR_NUM_CHANNELS entries */
+#define MY_GENERATOR_ADDRESSES {XPAR_MM2S_DDS_MODULATOR_0_BASEADDR, XPAR_MM2S_DDS_MODULATOR_1_BASEADDR}
 #define DEBUG_DMA_ID XPAR_AXI_DMA_0_DEVICE_ID
 
+/* generator_app_handle_message() return values */
+#define GENERATOR_APP_RUNNING 0
+#define GENERATOR_APP_EXIT 1
+
+/* Must match Stats_msg.perf max_count in messages.options */
+#define GENERATOR_APP_MAX_PERF 2
+
 typedef struct{
-    Waveform_Generator_t wg;
-    Base_msg incoming_message;
-    
-    /* Queue for incoming network messages*/
-    xQueueHandle net_in_queue;
-    /* Queue for main app communication */
-    xQueueHandle main_app_queue;
-    /* Network output data queue */
-    /* This queue is initialized in main_app*/
-    xQueueHandle net_out_queue;
+    /* Channel 0 instance owns the capture DMA */
+    Waveform_Generator_t wg[GENERATOR_NUM_CHANNELS];
+    /* Samples of every channel from last TRIG_DBG are valid */
+    uint8_t debug_captured;
+    /* Channel of the last message, its timestamps go in the ack */
+    uint32_t ack_channel;
+
+    /* Connected socket, responses are written here */
+    /* Socket is accepted in main_app */
+    int net_sock;
 }generator_app_t;
 
-void generator_app_init (generator_app_t *app, Base_msg *first_message, xQueueHandle net_in_queue, xQueueHandle main_queue, xQueueHandle net_out_queue);
+int generator_app_init (generator_app_t *app, Base_msg *first_message, int net_sock);
+
+int generator_app_handle_message(generator_app_t *app, Base_msg *message);
 
 int generator_app_decode_config(generator_app_t *app, Base_msg *config_message);
 void generator_app_decode_control(generator_app_t *app, Base_msg *config_message);
 
+void generator_app_collect_perf(generator_app_t *app, Stats_msg *stats);
+
 #endif
@@ -0,0 +1,23 @@
+/**
+ * @file kernel_hooks.h
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * FreeRTOS trace hooks. The generated FreeRTOSConfig.h is not kept in this
+ * tree, so the BSP force-includes this file in every kernel source, ahead of
+ * FreeRTOS.h and its empty defaults. In the BSP settings (freertos10_xilinx,
+ * extra_compiler_flags):
+ *     -include <workspace>/<app>/src/kernel_hooks.h
+ * @date 2020-08-09
+ */
+#ifndef __KERNEL_HOOKS
+#define __KERNEL_HOOKS
+
+#include <stdint.h>
+
+/* Context switch counter, defined in main.c */
+extern volatile uint32_t context_switches;
+
+/* Runs in the scheduler with interrupts masked, a single increment */
+#define traceTASK_SWITCHED_IN() context_switches++
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @file log.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Asynchronous logger. Multi-producer lock-free ring (per record sequence
+ * numbers), single consumer drain task.
+ * @date 2020-08-09
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "common.h"
+#include "log.h"
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+
+typedef struct{
+    /* Record is ready to read when sequence == position + 1,
+     * and free to write when sequence == position */
+    volatile uint32_t sequence;
+    uint8_t level;
+    uint8_t nargs;
+    const char *format;
+    uint32_t args[LOG_MAX_ARGS];
+}log_record_t;
+
+static log_record_t log_ring[LOG_RING_SIZE];
+
+/* Next position to write, shared by producers */
+static uint32_t write_position;
+/* Next position to read, owned by drain task */
+static uint32_t read_position;
+
+static volatile uint32_t log_overflows;
+static volatile log_level_t log_level = LOG_LEVEL_INFO;
+
+static const char *level_names[] = {"E", "W", "I", "D"};
+
+void log_drain_thread(void *p);
+
+int log_init(void){
+
+    for (uint32_t i = 0; i < LOG_RING_SIZE; i++){
+        log_ring[i].sequence = i;
+    }
+    write_position = 0;
+    read_position = 0;
+    log_overflows = 0;
+
+    if (pdPASS != xTaskCreate(log_drain_thread, "log_drain",
+                              THREAD_STACKSIZE,
+                              NULL,
+                              tskIDLE_PRIORITY + 1,
+                              NULL)){
+        return -1;
+    }
+    return 0;
+}
+
+void log_set_level(log_level_t level){
+    log_level = level;
+}
+
+uint32_t log_get_overflows(void){
+    return log_overflows;
+}
+
+void log_write(log_level_t level, const char *format, uint32_t nargs, ...){
+
+    log_record_t *record;
+    uint32_t position;
+    uint32_t sequence;
+    int32_t diff;
+    va_list args;
+
+    if (level > log_level){
+        return;
+    }
+
+    /* Claim a free record */
+    position = __atomic_load_n(&write_position, __ATOMIC_RELAXED);
+    while (1){
+        record = &log_ring[position & LOG_RING_MASK];
+        sequence = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+        diff = (int32_t)(sequence - position);
+
+        if (diff == 0){
+            /* Record is free, try to take it */
+            if (__atomic_compare_exchange_n(&write_position, &position, position + 1,
+                                            1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+                break;
+            }
+        }
+        else if (diff < 0){
+            /* Ring is full, drop record */
+            __atomic_fetch_add(&log_overflows, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        else{
+            /* Another producer took it, retry */
+            position = __atomic_load_n(&write_position, __ATOMIC_RELAXED);
+        }
+    }
+
+    /* Fill record, arguments are formatted later */
+    record->level = level;
+    record->format = format;
+    record->nargs = (nargs > LOG_MAX_ARGS) ? LOG_MAX_ARGS : nargs;
+    va_start(args, nargs);
+    for (uint32_t i = 0; i < record->nargs; i++){
+        record->args[i] = va_arg(args, uint32_t);
+    }
+    va_end(args);
+
+    /* Publish record to drain task */
+    __atomic_store_n(&record->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Drain task. Formats records on UART, out of the hot paths.
+ * 
+ * @param p Unused
+ */
+void log_drain_thread(void *p){
+
+    log_record_t *record;
+    uint32_t *a;
+    uint32_t reported_overflows = 0;
+    uint32_t overflows;
+
+    while (1){
+        record = &log_ring[read_position & LOG_RING_MASK];
+
+        if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) == read_position + 1){
+            a = record->args;
+            printf("[%s] ", level_names[record->level]);
+            printf(record->format, a[0], a[1], a[2], a[3], a[4], a[5]);
+
+            /* Release record for next lap */
+            __atomic_store_n(&record->sequence, read_position + LOG_RING_SIZE, __ATOMIC_RELEASE);
+            read_position++;
+        }
+        else{
+            overflows = log_overflows;
+            if (overflows != reported_overflows){
+                printf("[W] log: %lu records dropped\r\n", (unsigned long)(overflows - reported_overflows));
+                reported_overflows = overflows;
+            }
+            vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+        }
+    }
+}
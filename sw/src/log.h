@@ -0,0 +1,75 @@
+/**
+ * @file log.h
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Asynchronous logger. Records are written to a lock-free ring and
+ * formatted later on UART by a low priority drain task.
+ * @date 2020-08-09
+ */
+#ifndef __LOG
+#define __LOG
+
+#include <stdint.h>
+
+/* Ring size in records, must be a power of 2 */
+#define LOG_RING_SIZE 64
+/* Maximum arguments per record */
+#define LOG_MAX_ARGS 6
+/* Drain task polling period */
+#define LOG_DRAIN_PERIOD_MS 20
+
+typedef enum{
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG
+}log_level_t;
+
+/* Counts variadic arguments (0 to LOG_MAX_ARGS) */
+#define LOG_NARGS(...) _LOG_NARGS(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define _LOG_NARGS(_0, _1, _2, _3, _4, _5, _6, N, ...) N
+
+/**
+ * Logging macros. Format is deferred: format string and %s arguments
+ * must point to static storage (literals, __FUNCTION__), other
+ * arguments are stored as 32 bit words.
+ */
+#define log_error(format, ...) log_write(LOG_LEVEL_ERROR, format, LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define log_warn(format, ...) log_write(LOG_LEVEL_WARN, format, LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define log_info(format, ...) log_write(LOG_LEVEL_INFO, format, LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define log_debug(format, ...) log_write(LOG_LEVEL_DEBUG, format, LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+/**
+ * @brief Initializes ring and creates drain task.
+ * Must be called before any log is written.
+ * 
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+int log_init(void);
+
+/**
+ * @brief Sets runtime log level. Records above this level are discarded
+ * without touching the ring.
+ * 
+ * @param level New log level
+ */
+void log_set_level(log_level_t level);
+
+/**
+ * @brief Writes a record to the ring. Never blocks: if ring is full
+ * the record is dropped and overflow counter incremented.
+ * 
+ * @param level Record level
+ * @param format printf-like format string (static storage)
+ * @param nargs Number of arguments following
+ */
+void log_write(log_level_t level, const char *format, uint32_t nargs, ...);
+
+/**
+ * @brief Returns number of records dropped because ring was full.
+ * 
+ * @return uint32_t Dropped records
+ */
+uint32_t log_get_overflows(void);
+
+#endif
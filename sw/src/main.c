@@ -28,29 +28,13 @@ struct netif *echo_netif;
 /* Main App control structure */
 main_app_t main_app;
 
-static SemaphoreHandle_t mutex_uart_printf;
-
-/**
- * @brief Thread safe printf
- */
-void print_info(const char *format, ...){    
-    
-    va_list args;
-    va_start(args, format);
-
-    /* Take and give mutex for printing */
-    if (pdTRUE == xSemaphoreTake( mutex_uart_printf, portMAX_DELAY)){
-        vprintf(format,args);
-        xSemaphoreGive( mutex_uart_printf );
-    }
-    va_end(args);
-}
+/* Updated by traceTASK_SWITCHED_IN() kernel hook, see kernel_hooks.h */
+volatile uint32_t context_switches = 0;
 
 /* IP data printing helper func */
 void print_ip(char *msg, ip_addr_t *ip)
 {
-	print_info(msg);
-	print_info("%d.%d.%d.%d\n\r", ip4_addr1(ip), ip4_addr2(ip),
+	print_info("%s%d.%d.%d.%d\n\r", msg, ip4_addr1(ip), ip4_addr2(ip),
 			ip4_addr3(ip), ip4_addr4(ip));
 }
 
@@ -66,9 +50,9 @@ void print_ip_settings(ip_addr_t *ip, ip_addr_t *mask, ip_addr_t *gw)
 
 int main()
 {   
-    /* Printf Mutex Init */
-    mutex_uart_printf = xSemaphoreCreateMutex();
-    configASSERT( mutex_uart_printf );
+    /* Asynchronous logger Init */
+    int log_status = log_init();
+    configASSERT( log_status == 0 );
 
     print_info("Application Init \r\n");
 
@@ -20,6 +20,9 @@
 #include "common.h"
 #include "main_app.h"
 #include "generator_app.h"
+#include "stats.h"
+#include "trace.h"
+#include "presets.h"
 
 #include "pb_common.h"
 #include "pb_encode.h"
@@ -35,9 +38,17 @@ u16_t app_port = 7;
 extern Debug_msg debug_samples_msg;
 /* Buffer for network output stream (Protobuf encoded messages) */
 uint8_t out_buffer[Debug_msg_size];
+/* Protobuf message for runtime statistics */
+static Stats_msg stats_msg;
+/* Protobuf message for tracepoints dump */
+static Trace_msg trace_msg;
 
-void incoming_data_thread(void *p);
-void output_data_thread(void *p);
+/* Generator sub-application */
+static generator_app_t generator_app;
+/* Demodulator sub-application */
+static demodulator_app_t demodulator_app;
+
+void connection_thread(void *p);
 
 void print_app_header()
 {
@@ -47,23 +58,265 @@ void print_app_header()
     print_info("-----------------------------------\n");
 }
 
+/**
+ * @brief Encodes a protobuf message and writes it to socket.
+ * 
+ * @param sock Connected socket.
+ * @param fields Protobuf message descriptor.
+ * @param message Protobuf message to send.
+ */
+static void send_message(int sock, const pb_msgdesc_t *fields, const void *message){
+
+	int nwrote;
+	pb_ostream_t output_stream;
+	int message_length;
+
+	/* Build nano-pb output stream for encoded messages as bytes */
+	output_stream = pb_ostream_from_buffer(out_buffer, sizeof(out_buffer));
+
+	/* Encode message */
+	TRACE_BEGIN(PB_ENCODE);
+	if (!pb_encode(&output_stream, fields, message) || output_stream.bytes_written == 0){
+		TRACE_END(PB_ENCODE);
+		print_info("%s: Could not encode message to serialize", __FUNCTION__);
+		return;
+	}
+	TRACE_END(PB_ENCODE);
+	message_length = output_stream.bytes_written;
+
+	/* Out Message is encoded as bytes, send it through socket */
+	TRACE_BEGIN(SOCKET_WRITE);
+	nwrote = write(sock, out_buffer, message_length);
+	TRACE_END(SOCKET_WRITE);
+	if (nwrote < 0) {
+		print_info("%s: Error sending output message. Bytes to write = %d, Bytes written = %d\r\n",
+				__FUNCTION__, message_length, nwrote);
+	}
+}
+
 /**
  * @brief Helper function for ack messages sending.
+ * Called from the connection loop, message is written to socket
+ * right away.
  * 
- * @param queue Message queue handle.
+ * @param sock Connected socket.
  * @param retval Protobuf Ack message to send.
  */
-void send_ack(xQueueHandle queue, Ack_msg_Retval retval){
-	Base_msg ack_message = Base_msg_init_zero;
+void send_ack(int sock, Ack_msg_Retval retval){
+	send_ack_ts(sock, retval, 0, 0, 0);
+}
 
-	ack_message.which_message = Base_msg_ack_tag;
-	ack_message.ack.retval = retval;
-	xQueueSend(queue, &ack_message, portMAX_DELAY);
+/**
+ * @brief Sends an ack with hardware timestamps, see send_ack().
+ * 
+ * @param sock Connected socket.
+ * @param retval Protobuf Ack message to send.
+ * @param timestamp Hardware timestamp when answering.
+ * @param commit_timestamp Last commit latched.
+ * @param pulse_timestamp Last pulse start.
+ */
+void send_ack_ts(int sock, Ack_msg_Retval retval, uint64_t timestamp, uint64_t commit_timestamp, uint64_t pulse_timestamp){
+	/* Only called from the connection loop, kept off its stack */
+	static Base_msg ack_message;
+
+	ack_message = (Base_msg) Base_msg_init_zero;
+
+	TRACE_BEGIN(SEND_ACK);
+
+	/* Debug samples are sent instead of the ack */
+	if (retval == Ack_msg_Retval_DEBUG_IS_VALID){
+		send_message(sock, Debug_msg_fields, &debug_samples_msg);
+	}
+	else{
+		ack_message.which_message = Base_msg_ack_tag;
+		ack_message.ack.retval = retval;
+		ack_message.ack.timestamp = timestamp;
+		ack_message.ack.commit_timestamp = commit_timestamp;
+		ack_message.ack.pulse_timestamp = pulse_timestamp;
+		send_message(sock, Base_msg_fields, &ack_message);
+	}
+
+	TRACE_END(SEND_ACK);
+}
+
+/**
+ * @brief Routes a configuration message to its sub-app.
+ * Sub-apps are created by their first configuration.
+ * 
+ * @param app Main application control struct pointer.
+ * @param message Received protobuf configuration message.
+ */
+static void main_app_route_config(main_app_t *app, Base_msg *message){
+
+	if (message->config.which_config == Config_msg_generator_tag ||
+		message->config.which_config == Config_msg_sequence_tag ||
+		message->config.which_config == Config_msg_save_preset_tag ||
+		message->config.which_config == Config_msg_recall_preset_tag ||
+		message->config.which_config == Config_msg_code_table_tag ||
+		message->config.which_config == Config_msg_freq_law_table_tag ||
+		message->config.which_config == Config_msg_hop_table_tag){
+		if (app->generator_running){
+			generator_app_handle_message(&generator_app, message);
+		}
+		else{
+			print_info("%s: Creating generator app \r\n",__FUNCTION__);
+			/* Channels are initialized even if the first config is refused */
+			app->generator_running = 1;
+			if (generator_app_init(&generator_app, message, app->accepted_sock) < 0){
+				send_ack(app->accepted_sock, Ack_msg_Retval_BAD_CONFIG);
+				return;
+			}
+			/* Return ack */
+			send_ack(app->accepted_sock, Ack_msg_Retval_ACK);
+		}
+	}
+	else if (message->config.which_config == Config_msg_demodulator_tag){
+		if (app->demodulator_running){
+			demodulator_app_handle_message(&demodulator_app, message);
+		}
+		else{
+			print_info("%s: Creating demodulator app \r\n",__FUNCTION__);
+			if (demodulator_app_init(&demodulator_app, message, app->accepted_sock) < 0){
+				send_ack(app->accepted_sock, Ack_msg_Retval_BAD_CONFIG);
+				return;
+			}
+			app->demodulator_running = 1;
+			send_ack(app->accepted_sock, Ack_msg_Retval_ACK);
+		}
+	}
+	else{
+		log_warn("%s: Received bad config \r\n",__FUNCTION__);
+		send_ack(app->accepted_sock, Ack_msg_Retval_BAD_CONFIG);
+	}
+}
+
+/**
+ * @brief Collects runtime statistics and sends them.
+ * Stats message is sent instead of an ack.
+ * 
+ * @param app Main application control struct pointer.
+ */
+static void main_app_send_stats(main_app_t *app){
+
+	stats_msg = (Stats_msg) Stats_msg_init_zero;
+	stats_collect(&stats_msg);
+	stats_msg.command_switches = app->command_switches;
+	stats_msg.max_command_switches = app->max_command_switches;
+	stats_msg.log_overflows = log_get_overflows();
+	/* Hardware counters, read from the generator registers */
+	if (app->generator_running){
+		generator_app_collect_perf(&generator_app, &stats_msg);
+	}
+
+	send_message(app->accepted_sock, Stats_msg_fields, &stats_msg);
+}
+
+/**
+ * @brief Dumps and empties the tracepoint rings.
+ * Trace message is sent instead of an ack.
+ * 
+ * @param app Main application control struct pointer.
+ */
+static void main_app_send_trace(main_app_t *app){
+
+	trace_dump(&trace_msg);
+	send_message(app->accepted_sock, Trace_msg_fields, &trace_msg);
+}
+
+/**
+ * @brief Routes a control message to the sub-app in its target field.
+ * 
+ * @param app Main application control struct pointer.
+ * @param message Received protobuf control message.
+ */
+static void main_app_route_control(main_app_t *app, Base_msg *message){
+
+	/* Connection is down: release every running sub-app */
+	if (message->control.command == Control_msg_Command_BROKEN_CONN){
+		if (app->generator_running &&
+			generator_app_handle_message(&generator_app, message) == GENERATOR_APP_EXIT){
+			app->generator_running = 0;
+		}
+		if (app->demodulator_running &&
+			demodulator_app_handle_message(&demodulator_app, message) == DEMODULATOR_APP_EXIT){
+			app->demodulator_running = 0;
+		}
+		return;
+	}
+
+	/* Statistics are system wide, no sub-app needed */
+	if (message->control.command == Control_msg_Command_GET_STATS){
+		main_app_send_stats(app);
+		return;
+	}
+
+	/* Tracepoints are system wide, no sub-app needed */
+	if (message->control.command == Control_msg_Command_TRACE_DUMP){
+		main_app_send_trace(app);
+		return;
+	}
+
+	/* Log level is system wide, no sub-app needed */
+	if (message->control.command == Control_msg_Command_SET_LOG_LEVEL){
+		/* Enums are open in proto3, any value can come from the wire */
+		if ((uint32_t) message->control.log_level > LOG_LEVEL_DEBUG){
+			send_ack(app->accepted_sock, Ack_msg_Retval_BAD_COMMAND);
+			return;
+		}
+		log_set_level((log_level_t) message->control.log_level);
+		send_ack(app->accepted_sock, Ack_msg_Retval_ACK);
+		return;
+	}
+
+	switch (message->control.target){
+		case Control_msg_Target_GENERATOR:
+			if (app->generator_running){
+				generator_app_handle_message(&generator_app, message);
+				return;
+			}
+			break;
+		case Control_msg_Target_DEMODULATOR:
+			if (app->demodulator_running){
+				demodulator_app_handle_message(&demodulator_app, message);
+				return;
+			}
+			break;
+		default:
+			send_ack(app->accepted_sock, Ack_msg_Retval_BAD_COMMAND);
+			return;
+	}
+
+	log_warn("%s: Received command when no config applied \r\n",__FUNCTION__);
+	/* Return ack */
+	send_ack(app->accepted_sock, Ack_msg_Retval_NO_CONFIG);
+}
+
+/**
+ * @brief Dispatch received message to its sub-app handler.
+ * Configs are routed by config type, commands by target,
+ * so generator and demodulator run at the same time.
+ * 
+ * @param app Main application control struct pointer.
+ * @param message Received protobuf message.
+ */
+static void main_app_dispatch(main_app_t *app, Base_msg *message){
+
+	switch (message->which_message){
+		case Base_msg_config_tag:
+			main_app_route_config(app, message);
+			break;
+		case Base_msg_control_tag:
+			main_app_route_control(app, message);
+			break;
+		default:
+			log_warn("%s: Unknown message received \r\n",__FUNCTION__);
+			break;
+	}
 }
 
 /**
  * @brief Main application thread.
- * Accepts socket connection, and spawns Generator and Demodulator sub-apps.
+ * Accepts socket connection and launches the connection loop.
  * 
  * @param p Main application control struct pointer.
  */
@@ -72,12 +325,6 @@ void main_app_thread(void *p)
 	int error = 0;
 	main_app_t *app = (main_app_t*) p;
 
-	/* Generator sub-application */
-	static generator_app_t generator_app;
-
-	/* Protobuf messages vars */
-	Base_msg received_message = Base_msg_init_zero;
-
 	/* Socket related vars */
 	int sock;
 	int size;
@@ -86,6 +333,9 @@ void main_app_thread(void *p)
 	/* Init sockaddr struct */
 	memset(&address, 0, sizeof(address));
 
+	/* Connection loop notifies this task when connection is closed */
+	app->main_task = xTaskGetCurrentTaskHandle();
+
 	/* Create socket */
 	if ((sock = lwip_socket(AF_INET, SOCK_STREAM, 0)) < 0)
 		error = -1;
@@ -107,226 +357,106 @@ void main_app_thread(void *p)
 		 * Only one simultaneous connection allowed */
 		if ((app->accepted_sock = lwip_accept(sock, (struct sockaddr *)&remote, (socklen_t *)&size)) > 0) {
 
-			/* Create Data reception task */
-			if(NULL == sys_thread_new("incoming_data_thread",
-									  incoming_data_thread,
+			/* Create connection event loop task */
+			if(NULL == sys_thread_new("connection_thread",
+									  connection_thread,
 									  (void*)app,
 									  THREAD_STACKSIZE,
 									  DEFAULT_THREAD_PRIO)){
-				print_info("%s: Error creating incoming_data_thread\r\n",__FUNCTION__);
-				error = -1;
-				continue;
-			}
-			
-			/* Create Data output task */
-			if(NULL == sys_thread_new("output_data_thread",
-									  output_data_thread,
-									  (void*)app,
-									  THREAD_STACKSIZE,
-									  DEFAULT_THREAD_PRIO)){
-				print_info("%s: Error creating output_data_thread\r\n",__FUNCTION__);
+				log_error("%s: Error creating connection_thread\r\n",__FUNCTION__);
 				error = -1;
 				continue;
 			}
 
 			print_info("%s: New connection \r\n",__FUNCTION__);
-			while(1){
-				/* Connection is up, wait for incoming messages */
-				xQueueReceive(app->main_queue,(void *) &received_message,portMAX_DELAY);
-				
-				/* If new config arrived */
-				if (received_message.which_message == Base_msg_config_tag){
-					
-					/* Create app and launch task */
-					if (received_message.config.which_config == Config_msg_generator_tag){
-						print_info("%s: Creating generator app \r\n",__FUNCTION__);
-						generator_app_init(&generator_app, &received_message, app->generator_queue, app->main_queue, app->output_data_queue);
-						app->current_mode = GENERATOR;
-						/* Return ack */
-						send_ack(app->output_data_queue, Ack_msg_Retval_ACK);
-					}
-					else if (received_message.config.which_config == Config_msg_demodulator_tag){
-						print_info("Creating demodulator app \r\n");
-						app->current_mode = DEMODULATOR;
-					}
-					else{
-						print_info("%s: Received bad config \r\n",__FUNCTION__);
-						send_ack(app->output_data_queue, Ack_msg_Retval_BAD_CONFIG);
-					}
-					
-				}
-				else if (received_message.which_message == Base_msg_control_tag){
-					if (received_message.control.command == Control_msg_Command_BROKEN_CONN){
-						print_info("%s: Connection is down, waiting new connect. \r\n",__FUNCTION__);
-						break;
-					}
-					print_info("%s: Received command when no config applied \r\n",__FUNCTION__);
-					/* Return ack */
-					send_ack(app->output_data_queue, Ack_msg_Retval_NO_CONFIG);
-				}
-				else{
-					print_info("%s: Unknown message received \r\n",__FUNCTION__);
-				}	
-			}
 
-			/* Out of main loop, BROKEN_CONN Command received */
-			/* Other apps are deleted, we're back to MAIN app */
-			app->current_mode = MAIN;
+			/* Block until connection loop ends */
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			print_info("%s: Connection is down, waiting new connect. \r\n",__FUNCTION__);
 		}
 	}
 
-	print_info("ERROR %s: Deleting main app\r\n",__FUNCTION__);
+	log_error("%s: Deleting main app\r\n",__FUNCTION__);
 	vTaskDelete(NULL);
 }
 
 /**
- * @brief Data reception task.
+ * @brief Connection event loop.
  * Receives messages from socket, decodes protobuf messages and
- * sends them to corresponding sub-app.
+ * runs the corresponding sub-app handler. Responses are encoded and
+ * written from this same task, so a command costs no queue hops.
  * 
  * @param p Main application control struct pointer
  */
-void incoming_data_thread(void *p){
+void connection_thread(void *p){
 
 	main_app_t *app = (main_app_t*) p;
 
 	/* Socket related vars */
 	int sock = app->accepted_sock;
 	int n;
-	char recv_buf[RECV_BUF_SIZE];
+	/* Only one connection at a time: buffers are kept off the task stack,
+	 * handlers, pb_encode and lwIP run on it (see stack_high_water_mark
+	 * of connection_thread in GET_STATS) */
+	static char recv_buf[RECV_BUF_SIZE];
 
 	/* Protobuf messages vars */
-	Base_msg incoming_msg = Base_msg_init_zero;
+	static Base_msg incoming_msg;
 	pb_istream_t input_stream;
-	Base_msg output_msg = Base_msg_init_zero;
+	bool decoded;
+
+	uint32_t switches_start;
+
+	incoming_msg = (Base_msg) Base_msg_init_zero;
 
 	while(1){
 		if ((n = read(sock, recv_buf, RECV_BUF_SIZE)) < 0) {
 			print_info("%s: Error reading from socket %d, closing socket\r\n", __FUNCTION__, sock);
 			break;
 		}
+		/* Command arrival */
+		TRACE_INSTANT(SOCKET_READ);
+
+		switches_start = context_switches;
 
 		/* Build nano-pb input stream from received bytes (n) */		
 		input_stream = pb_istream_from_buffer((pb_byte_t*)recv_buf, n);
 
-		/* Dispatch received message to sub-app, if valid */
-		if (pb_decode(&input_stream, Base_msg_fields, &incoming_msg) && n != 0){
-			switch (app->current_mode){
-				case MAIN:
-					xQueueSend(app->main_queue, &incoming_msg, portMAX_DELAY);
-					break;
-				case GENERATOR:
-					xQueueSend(app->generator_queue, &incoming_msg, portMAX_DELAY);
-					break;
-				case DEMODULATOR:
-					xQueueSend(app->demodulator_queue, &incoming_msg, portMAX_DELAY);
-					break;
-				default:
-					xQueueSend(app->main_queue, &incoming_msg, portMAX_DELAY);
-					break;
-			}
+		/* Run sub-app handler, if valid */
+		TRACE_BEGIN(PB_DECODE);
+		decoded = pb_decode(&input_stream, Base_msg_fields, &incoming_msg);
+		TRACE_END(PB_DECODE);
+		if (decoded && n != 0){
+			TRACE_BEGIN(DISPATCH);
+			main_app_dispatch(app, &incoming_msg);
+			TRACE_END(DISPATCH);
 		}
 		/* Handle invalid message */
 		else if (n != 0)
 		{
+			log_warn("%s: No valid message received\r\n", __FUNCTION__);
 			/* Return invalid message */
-			output_msg.which_message = Base_msg_ack_tag;	
-			output_msg.ack.retval = Ack_msg_Retval_INVALID_MSG;
-			print_info("%s: No valid message received\r\n", __FUNCTION__);
+			send_ack(sock, Ack_msg_Retval_INVALID_MSG);
+		}
 
-			xQueueSend(app->output_data_queue, &output_msg, portMAX_DELAY);
+		/* Context switches while serving this command */
+		app->command_switches = context_switches - switches_start;
+		if (app->command_switches > app->max_command_switches){
+			app->max_command_switches = app->command_switches;
 		}
 	}
 
-	/* Socket read returned error:           */
-	/* Notify apps that connection is closed */
-	output_msg.which_message = Base_msg_control_tag;
-	output_msg.control.command = Control_msg_Command_BROKEN_CONN;
-	/* Send to output_data_thread */
-	xQueueSend(app->output_data_queue, &output_msg, portMAX_DELAY);
-	/* Send to Main app */
-	xQueueSend(app->main_queue, &output_msg, portMAX_DELAY);
-	/* Send to Current sub-app */
-	if(app->current_mode == GENERATOR){
-		xQueueSend(app->generator_queue, &output_msg, portMAX_DELAY);
-	}
-	else if (app->current_mode == DEMODULATOR) {
-		xQueueSend(app->demodulator_queue, &output_msg, portMAX_DELAY);
-	}
+	/* Socket read returned error:               */
+	/* Notify running sub-apps connection closed */
+	incoming_msg = (Base_msg) Base_msg_init_zero;
+	incoming_msg.which_message = Base_msg_control_tag;
+	incoming_msg.control.command = Control_msg_Command_BROKEN_CONN;
+	main_app_dispatch(app, &incoming_msg);
 
 	/* Close connection */
 	close(sock);
-	/* Nothing to do until new connection, delete task */
-	vTaskDelete(NULL);
-}
-
-/**
- * @brief Data output task.
- * Writes encoded protobuf outgoing messages to socket.
- * 
- * @param p Main application control struct pointer
- */
-void output_data_thread(void *p){
-
-	main_app_t *app = (main_app_t*) p;
-
-	/* Socket related vars */
-	int sock = app->accepted_sock;
-	int nwrote;
-
-	/* Protobuf messages vars */
-	Base_msg output_msg = Base_msg_init_zero;
-	pb_ostream_t output_stream;
-	int message_length;
-
-	int status;
-
-	while(1){
-		
-		/* Wait for messages to send */
-		xQueueReceive(app->output_data_queue,(void *) &output_msg, portMAX_DELAY);
-
-		/* Build nano-pb output stream for encoded messages as bytes */
-		output_stream = pb_ostream_from_buffer(out_buffer, sizeof(out_buffer));
-
-		/* Encode message */
-		status = pb_encode(&output_stream, Base_msg_fields, &output_msg);
-		message_length = output_stream.bytes_written;
-
-		/* Send to network if encoded OK*/
-		if(status & (message_length != 0)){
-			
-			/* Check if connection is broken */
-			if (output_msg.which_message == Base_msg_control_tag && output_msg.control.command == Control_msg_Command_BROKEN_CONN){
-				break;
-			}
-
-			/* Check if we've to send debug samples */
-			if (output_msg.which_message == Base_msg_ack_tag && output_msg.ack.retval == Ack_msg_Retval_DEBUG_IS_VALID)
-			{
-				/* Build again output stream with debug message - This overwrites output stream */
-				status = pb_encode(&output_stream, Debug_msg_fields, &debug_samples_msg);
-				message_length = output_stream.bytes_written;
-				if (!status)
-				{
-					print_info("%s: Could not encode debug message to serialize", __FUNCTION__);
-					continue;
-				}			
-			}
-
-			/* Out Message is encoded as bytes, send it through socket */
-			if ((nwrote = write(sock, out_buffer, message_length)) < 0) {
-				print_info("%s: Error sending output message. Bytes to write = %d, Bytes written = %d\r\n",
-						__FUNCTION__, message_length, nwrote);
-			}
-		}
-		else{
-			print_info("%s: Could not encode message to serialize", __FUNCTION__);
-		}
-		
-	}
-
-	/* BROKEN_CONN message received */
+	/* Wake main app to accept a new connection */
+	xTaskNotifyGive(app->main_task);
 	/* Nothing to do until new connection, delete task */
 	vTaskDelete(NULL);
 }
@@ -341,33 +471,14 @@ int main_app_init(main_app_t *app){
 
 	*app = (main_app_t){0};
 
-	/* Queues */
-	/* Main app input protobuf messages queue*/
-	if (!(app->main_queue = xQueueCreate(MAX_QUEUED_MESSAGES, sizeof(Base_msg)) )){
-		return -1;
-	}
-	
-	/* Generator sub-app input protobuf messages queue*/
-	if (!(app->generator_queue = xQueueCreate(MAX_QUEUED_MESSAGES, sizeof(Base_msg)) )){
-		return -1;
-	}
-
-	/* Demodulator sub-app input protobuf messages queue*/
-	if (!(app->demodulator_queue = xQueueCreate(MAX_QUEUED_MESSAGES, sizeof(Base_msg)) )){
-		return -1;
-	}
-
-	/* Main app output protobuf messages queue*/
-	if (!(app->output_data_queue = xQueueCreate(MAX_QUEUED_MESSAGES, sizeof(Base_msg)) )){
-		return -1;
-	}
+	/* Load saved generator presets, store starts empty on failure */
+	presets_init();
 
-	/* Application starts in MAIN mode,
+	/* Application starts with no sub-app running,
 	 * Generator and Demodulator sub-apps
 	 * are created later depending on 
 	 * commands received
 	 * */
-	app->current_mode = MAIN;
 
 	/* Create main application task */
 	if (NULL == (sys_thread_new("main_app", main_app_thread, app,
@@ -12,29 +12,27 @@
 #include "task.h"
 
 #include "generator_app.h"
+#include "demodulator_app.h"
 
 #define THREAD_STACKSIZE 1024
-#define MAX_QUEUED_MESSAGES 5
 
 typedef struct{
    int accepted_sock;
 
-   enum{
-      MAIN,
-      GENERATOR,
-      DEMODULATOR
-   } current_mode;
+   /* Sub-apps hosted concurrently, created by their first config */
+   uint8_t generator_running;
+   uint8_t demodulator_running;
 
-   /* Application queues */
-   xQueueHandle main_queue;
-   xQueueHandle generator_queue;
-   xQueueHandle demodulator_queue;
+   /* Main app task, notified by the connection loop when connection closes */
+   TaskHandle_t main_task;
 
-   /* Network output data queue */
-   xQueueHandle output_data_queue;
+   /* Context switches counted while serving the last command, and worst case */
+   uint32_t command_switches;
+   uint32_t max_command_switches;
 }main_app_t;
 
-void send_ack(xQueueHandle queue, Ack_msg_Retval retval);
+void send_ack(int sock, Ack_msg_Retval retval);
+void send_ack_ts(int sock, Ack_msg_Retval retval, uint64_t timestamp, uint64_t commit_timestamp, uint64_t pulse_timestamp);
 
 void main_app_thread(void *p);
 
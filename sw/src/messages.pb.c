@@ -30,12 +30,60 @@ PB_BIND(Freq_Mod, Freq_Mod, AUTO)
 PB_BIND(Phase_Mod, Phase_Mod, AUTO)
 
 
+PB_BIND(Code_Mod, Code_Mod, AUTO)
+
+
+PB_BIND(Freq_law_Mod, Freq_law_Mod, AUTO)
+
+
+PB_BIND(Hop_Mod, Hop_Mod, AUTO)
+
+
 PB_BIND(Demodulator_config_msg, Demodulator_config_msg, AUTO)
 
 
 PB_BIND(Debug_msg, Debug_msg, 8)
 
 
+PB_BIND(Task_stats, Task_stats, AUTO)
+
+
+PB_BIND(Generator_perf, Generator_perf, AUTO)
+
+
+PB_BIND(Stats_msg, Stats_msg, 2)
+
+
+PB_BIND(Trace_event, Trace_event, AUTO)
+
+
+PB_BIND(Trace_msg, Trace_msg, 2)
+
+
+PB_BIND(Sequence_entry, Sequence_entry, AUTO)
+
+
+PB_BIND(Sequence_msg, Sequence_msg, 2)
+
+
+PB_BIND(Save_preset_msg, Save_preset_msg, AUTO)
+
+
+PB_BIND(Recall_preset_msg, Recall_preset_msg, AUTO)
+
+
+PB_BIND(Code_table_msg, Code_table_msg, 2)
+
+
+PB_BIND(Freq_law_table_msg, Freq_law_table_msg, 2)
+
+
+PB_BIND(Hop, Hop, AUTO)
+
+
+PB_BIND(Hop_table_msg, Hop_table_msg, 2)
+
+
 
 
 
@@ -18,9 +18,25 @@ typedef enum _Control_msg_Command {
     Control_msg_Command_START = 0,
     Control_msg_Command_STOP = 1,
     Control_msg_Command_TRIG_DBG = 2,
-    Control_msg_Command_BROKEN_CONN = 3
+    Control_msg_Command_BROKEN_CONN = 3,
+    Control_msg_Command_GET_STATS = 4,
+    Control_msg_Command_SET_LOG_LEVEL = 5,
+    Control_msg_Command_TRACE_DUMP = 6,
+    Control_msg_Command_GET_DBG = 7
 } Control_msg_Command;
 
+typedef enum _Control_msg_Target {
+    Control_msg_Target_GENERATOR = 0,
+    Control_msg_Target_DEMODULATOR = 1
+} Control_msg_Target;
+
+typedef enum _Control_msg_Log_level {
+    Control_msg_Log_level_LOG_ERROR = 0,
+    Control_msg_Log_level_LOG_WARN = 1,
+    Control_msg_Log_level_LOG_INFO = 2,
+    Control_msg_Log_level_LOG_DEBUG = 3
+} Control_msg_Log_level;
+
 typedef enum _Ack_msg_Retval {
     Ack_msg_Retval_ACK = 0,
     Ack_msg_Retval_INVALID_MSG = 1,
@@ -36,6 +52,31 @@ typedef enum _Generator_Config_msg_Mode {
     Generator_Config_msg_Mode_PULSED = 1
 } Generator_Config_msg_Mode;
 
+typedef enum _Code_Mod_Code {
+    Code_Mod_Code_FRANK = 0,
+    Code_Mod_Code_P3 = 1,
+    Code_Mod_Code_P4 = 2,
+    Code_Mod_Code_MLS = 3,
+    Code_Mod_Code_TABLE = 4
+} Code_Mod_Code;
+
+typedef enum _Trace_event_Stage {
+    Trace_event_Stage_SOCKET_READ = 0,
+    Trace_event_Stage_PB_DECODE = 1,
+    Trace_event_Stage_DISPATCH = 2,
+    Trace_event_Stage_DECODE_CONFIG = 3,
+    Trace_event_Stage_WRITE_REG = 4,
+    Trace_event_Stage_SEND_ACK = 5,
+    Trace_event_Stage_PB_ENCODE = 6,
+    Trace_event_Stage_SOCKET_WRITE = 7
+} Trace_event_Stage;
+
+typedef enum _Trace_event_Phase {
+    Trace_event_Phase_BEGIN = 0,
+    Trace_event_Phase_END = 1,
+    Trace_event_Phase_INSTANT = 2
+} Trace_event_Phase;
+
 /* Struct definitions */
 typedef struct _Demodulator_config_msg {
     char dummy_field;
@@ -43,20 +84,77 @@ typedef struct _Demodulator_config_msg {
 
 typedef struct _Ack_msg {
     Ack_msg_Retval retval;
+    uint64_t timestamp;
+    uint64_t commit_timestamp;
+    uint64_t pulse_timestamp;
 } Ack_msg;
 
+typedef struct _Code_Mod {
+    uint32_t freq_khz;
+    Code_Mod_Code code;
+    uint32_t order;
+    uint32_t table_offset;
+    uint32_t chip_length_ns;
+} Code_Mod;
+
+typedef struct _Code_table_msg {
+    uint32_t offset;
+    pb_size_t phases_count;
+    uint32_t phases[128];
+    uint32_t channel;
+} Code_table_msg;
+
+typedef struct _Freq_law_Mod {
+    uint32_t table_offset;
+    uint32_t entries;
+    uint32_t entry_clocks;
+} Freq_law_Mod;
+
+typedef struct _Freq_law_table_msg {
+    uint32_t offset;
+    pb_size_t pinc_count;
+    uint32_t pinc[64];
+    pb_size_t slope_count;
+    int32_t slope[64];
+    uint32_t channel;
+} Freq_law_table_msg;
+
+typedef struct _Hop_Mod {
+    uint32_t table_offset;
+    uint32_t entries;
+} Hop_Mod;
+
+typedef struct _Hop {
+    uint32_t freq_khz;
+    uint32_t dwell_ns;
+    uint32_t phase;
+} Hop;
+
+typedef struct _Hop_table_msg {
+    uint32_t offset;
+    pb_size_t hops_count;
+    Hop hops[32];
+    uint32_t channel;
+} Hop_table_msg;
+
 typedef struct _Const_Freq {
     uint32_t freq_khz;
 } Const_Freq;
 
 typedef struct _Control_msg {
     Control_msg_Command command;
+    Control_msg_Target target;
+    Control_msg_Log_level log_level;
+    uint32_t channel;
+    bool all_channels;
 } Control_msg;
 
 typedef struct _Debug_msg {
     int32_t i_samples[125000];
     int32_t q_samples[125000];
     uint32_t num_samples;
+    uint32_t channel;
+    uint64_t timestamp;
 } Debug_msg;
 
 typedef struct _Freq_Mod {
@@ -71,6 +169,38 @@ typedef struct _Phase_Mod {
     uint32_t barker_subpulse_length_us;
 } Phase_Mod;
 
+typedef struct _Recall_preset_msg {
+    uint32_t id;
+    uint32_t channel;
+} Recall_preset_msg;
+
+typedef struct _Trace_event {
+    uint64_t timestamp;
+    Trace_event_Stage stage;
+    Trace_event_Phase phase;
+    uint32_t core;
+} Trace_event;
+
+typedef struct _Task_stats {
+    char name[16];
+    uint32_t run_time_percent;
+    uint32_t run_time_counter;
+    uint32_t stack_high_water_mark;
+    uint32_t priority;
+} Task_stats;
+
+typedef struct _Generator_perf {
+    uint32_t channel;
+    uint32_t pulses;
+    uint32_t stall_cycles;
+    uint32_t capture_beats;
+    uint32_t tlasts;
+    uint32_t commits;
+    uint32_t config_writes;
+    uint32_t triggers;
+    uint32_t triggers_missed;
+} Generator_perf;
+
 typedef struct _Generator_Config_msg {
     bool debug_enabled;
     Generator_Config_msg_Mode mode;
@@ -79,16 +209,67 @@ typedef struct _Generator_Config_msg {
         Const_Freq const_freq;
         Freq_Mod freq_mod;
         Phase_Mod phase_mod;
+        Code_Mod code_mod;
+        Freq_law_Mod freq_law_mod;
+        Hop_Mod hop_mod;
     };
     uint32_t period_us;
     uint32_t pulse_length_us;
+    bool live_update;
+    uint32_t channel;
 } Generator_Config_msg;
 
+typedef struct _Stats_msg {
+    pb_size_t tasks_count;
+    Task_stats tasks[16];
+    uint32_t total_run_time;
+    uint32_t free_heap;
+    uint32_t min_free_heap;
+    uint32_t command_switches;
+    uint32_t max_command_switches;
+    uint32_t log_overflows;
+    pb_size_t perf_count;
+    Generator_perf perf[2];
+} Stats_msg;
+
+typedef struct _Trace_msg {
+    pb_size_t events_count;
+    Trace_event events[512];
+    uint32_t timer_freq_hz;
+} Trace_msg;
+
+typedef struct _Sequence_entry {
+    bool has_config;
+    Generator_Config_msg config;
+    uint32_t repeat;
+} Sequence_entry;
+
+typedef struct _Sequence_msg {
+    uint32_t first_index;
+    pb_size_t entries_count;
+    Sequence_entry entries[8];
+    uint32_t length;
+    uint32_t channel;
+} Sequence_msg;
+
+typedef struct _Save_preset_msg {
+    uint32_t id;
+    char name[16];
+    bool has_config;
+    Generator_Config_msg config;
+} Save_preset_msg;
+
 typedef struct _Config_msg {
     pb_size_t which_config;
     union {
         Generator_Config_msg generator;
         Demodulator_config_msg demodulator;
+        Sequence_msg sequence;
+        Save_preset_msg save_preset;
+        Recall_preset_msg recall_preset;
+        Code_table_msg code_table;
+        Freq_law_table_msg freq_law_table;
+        Hop_table_msg hop_table;
     };
 } Config_msg;
 
@@ -104,8 +285,16 @@ typedef struct _Base_msg {
 
 /* Helper constants for enums */
 #define _Control_msg_Command_MIN Control_msg_Command_START
-#define _Control_msg_Command_MAX Control_msg_Command_BROKEN_CONN
-#define _Control_msg_Command_ARRAYSIZE ((Control_msg_Command)(Control_msg_Command_BROKEN_CONN+1))
+#define _Control_msg_Command_MAX Control_msg_Command_GET_DBG
+#define _Control_msg_Command_ARRAYSIZE ((Control_msg_Command)(Control_msg_Command_GET_DBG+1))
+
+#define _Control_msg_Target_MIN Control_msg_Target_GENERATOR
+#define _Control_msg_Target_MAX Control_msg_Target_DEMODULATOR
+#define _Control_msg_Target_ARRAYSIZE ((Control_msg_Target)(Control_msg_Target_DEMODULATOR+1))
+
+#define _Control_msg_Log_level_MIN Control_msg_Log_level_LOG_ERROR
+#define _Control_msg_Log_level_MAX Control_msg_Log_level_LOG_DEBUG
+#define _Control_msg_Log_level_ARRAYSIZE ((Control_msg_Log_level)(Control_msg_Log_level_LOG_DEBUG+1))
 
 #define _Ack_msg_Retval_MIN Ack_msg_Retval_ACK
 #define _Ack_msg_Retval_MAX Ack_msg_Retval_DEBUG_IS_VALID
@@ -115,41 +304,137 @@ typedef struct _Base_msg {
 #define _Generator_Config_msg_Mode_MAX Generator_Config_msg_Mode_PULSED
 #define _Generator_Config_msg_Mode_ARRAYSIZE ((Generator_Config_msg_Mode)(Generator_Config_msg_Mode_PULSED+1))
 
+#define _Code_Mod_Code_MIN Code_Mod_Code_FRANK
+#define _Code_Mod_Code_MAX Code_Mod_Code_TABLE
+#define _Code_Mod_Code_ARRAYSIZE ((Code_Mod_Code)(Code_Mod_Code_TABLE+1))
+
+#define _Trace_event_Stage_MIN Trace_event_Stage_SOCKET_READ
+#define _Trace_event_Stage_MAX Trace_event_Stage_SOCKET_WRITE
+#define _Trace_event_Stage_ARRAYSIZE ((Trace_event_Stage)(Trace_event_Stage_SOCKET_WRITE+1))
+
+#define _Trace_event_Phase_MIN Trace_event_Phase_BEGIN
+#define _Trace_event_Phase_MAX Trace_event_Phase_INSTANT
+#define _Trace_event_Phase_ARRAYSIZE ((Trace_event_Phase)(Trace_event_Phase_INSTANT+1))
+
 
 /* Initializer values for message structs */
 #define Base_msg_init_default                    {0, {Control_msg_init_default}}
-#define Control_msg_init_default                 {_Control_msg_Command_MIN}
+#define Control_msg_init_default                 {_Control_msg_Command_MIN, _Control_msg_Target_MIN, _Control_msg_Log_level_MIN, 0, 0}
 #define Config_msg_init_default                  {0, {Generator_Config_msg_init_default}}
-#define Ack_msg_init_default                     {_Ack_msg_Retval_MIN}
-#define Generator_Config_msg_init_default        {0, _Generator_Config_msg_Mode_MIN, 0, {Const_Freq_init_default}, 0, 0}
+#define Ack_msg_init_default                     {_Ack_msg_Retval_MIN, 0, 0, 0}
+#define Generator_Config_msg_init_default        {0, _Generator_Config_msg_Mode_MIN, 0, {Const_Freq_init_default}, 0, 0, 0, 0}
 #define Const_Freq_init_default                  {0}
 #define Freq_Mod_init_default                    {0, 0, 0}
 #define Phase_Mod_init_default                   {0, 0, 0}
+#define Code_Mod_init_default                    {0, _Code_Mod_Code_MIN, 0, 0, 0}
+#define Freq_law_Mod_init_default                {0, 0, 0}
+#define Hop_Mod_init_default                     {0, 0}
 #define Demodulator_config_msg_init_default      {0}
+#define Task_stats_init_default                  {"", 0, 0, 0, 0}
+#define Generator_perf_init_default              {0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define Stats_msg_init_default                   {0, {Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default, Task_stats_init_default}, 0, 0, 0, 0, 0, 0, 0, {Generator_perf_init_default, Generator_perf_init_default}}
+#define Trace_event_init_default                 {0, _Trace_event_Stage_MIN, _Trace_event_Phase_MIN, 0}
+#define Trace_msg_init_default                   {0, {0}, 0}
+#define Sequence_entry_init_default              {false, Generator_Config_msg_init_default, 0}
+#define Sequence_msg_init_default                {0, 0, {Sequence_entry_init_default, Sequence_entry_init_default, Sequence_entry_init_default, Sequence_entry_init_default, Sequence_entry_init_default, Sequence_entry_init_default, Sequence_entry_init_default, Sequence_entry_init_default}, 0, 0}
+#define Save_preset_msg_init_default             {0, "", false, Generator_Config_msg_init_default}
+#define Recall_preset_msg_init_default           {0, 0}
+#define Code_table_msg_init_default              {0, 0, {0}, 0}
+#define Freq_law_table_msg_init_default          {0, 0, {0}, 0, {0}, 0}
+#define Hop_init_default                         {0, 0, 0}
+#define Hop_table_msg_init_default               {0, 0, {Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default, Hop_init_default}, 0}
 
 #define Base_msg_init_zero                       {0, {Control_msg_init_zero}}
-#define Control_msg_init_zero                    {_Control_msg_Command_MIN}
+#define Control_msg_init_zero                    {_Control_msg_Command_MIN, _Control_msg_Target_MIN, _Control_msg_Log_level_MIN, 0, 0}
 #define Config_msg_init_zero                     {0, {Generator_Config_msg_init_zero}}
-#define Ack_msg_init_zero                        {_Ack_msg_Retval_MIN}
-#define Generator_Config_msg_init_zero           {0, _Generator_Config_msg_Mode_MIN, 0, {Const_Freq_init_zero}, 0, 0}
+#define Ack_msg_init_zero                        {_Ack_msg_Retval_MIN, 0, 0, 0}
+#define Generator_Config_msg_init_zero           {0, _Generator_Config_msg_Mode_MIN, 0, {Const_Freq_init_zero}, 0, 0, 0, 0}
 #define Const_Freq_init_zero                     {0}
 #define Freq_Mod_init_zero                       {0, 0, 0}
 #define Phase_Mod_init_zero                      {0, 0, 0}
+#define Code_Mod_init_zero                       {0, _Code_Mod_Code_MIN, 0, 0, 0}
+#define Freq_law_Mod_init_zero                   {0, 0, 0}
+#define Hop_Mod_init_zero                        {0, 0}
 #define Demodulator_config_msg_init_zero         {0}
+#define Task_stats_init_zero                     {"", 0, 0, 0, 0}
+#define Generator_perf_init_zero                 {0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define Stats_msg_init_zero                      {0, {Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero, Task_stats_init_zero}, 0, 0, 0, 0, 0, 0, 0, {Generator_perf_init_zero, Generator_perf_init_zero}}
+#define Trace_event_init_zero                    {0, _Trace_event_Stage_MIN, _Trace_event_Phase_MIN, 0}
+#define Trace_msg_init_zero                      {0, {0}, 0}
+#define Sequence_entry_init_zero                 {false, Generator_Config_msg_init_zero, 0}
+#define Sequence_msg_init_zero                   {0, 0, {Sequence_entry_init_zero, Sequence_entry_init_zero, Sequence_entry_init_zero, Sequence_entry_init_zero, Sequence_entry_init_zero, Sequence_entry_init_zero, Sequence_entry_init_zero, Sequence_entry_init_zero}, 0, 0}
+#define Save_preset_msg_init_zero                {0, "", false, Generator_Config_msg_init_zero}
+#define Recall_preset_msg_init_zero              {0, 0}
+#define Code_table_msg_init_zero                 {0, 0, {0}, 0}
+#define Freq_law_table_msg_init_zero             {0, 0, {0}, 0, {0}, 0}
+#define Hop_init_zero                            {0, 0, 0}
+#define Hop_table_msg_init_zero                  {0, 0, {Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero, Hop_init_zero}, 0}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define Ack_msg_retval_tag                       1
+#define Ack_msg_timestamp_tag                    2
+#define Ack_msg_commit_timestamp_tag             3
+#define Ack_msg_pulse_timestamp_tag              4
 #define Const_Freq_freq_khz_tag                  1
 #define Control_msg_command_tag                  1
+#define Control_msg_target_tag                   2
+#define Control_msg_log_level_tag                3
+#define Control_msg_channel_tag                  4
+#define Control_msg_all_channels_tag             5
 #define Debug_msg_i_samples_tag                  1
 #define Debug_msg_q_samples_tag                  2
 #define Debug_msg_num_samples_tag                3
+#define Debug_msg_channel_tag                    4
+#define Debug_msg_timestamp_tag                  5
+#define Code_Mod_freq_khz_tag                    1
+#define Code_Mod_code_tag                        2
+#define Code_Mod_order_tag                       3
+#define Code_Mod_table_offset_tag                4
+#define Code_Mod_chip_length_ns_tag              5
+#define Code_table_msg_offset_tag                1
+#define Code_table_msg_phases_tag                2
+#define Code_table_msg_channel_tag               3
+#define Freq_law_Mod_table_offset_tag            1
+#define Freq_law_Mod_entries_tag                 2
+#define Freq_law_Mod_entry_clocks_tag            3
+#define Freq_law_table_msg_offset_tag            1
+#define Freq_law_table_msg_pinc_tag              2
+#define Freq_law_table_msg_slope_tag             3
+#define Freq_law_table_msg_channel_tag           4
+#define Hop_Mod_table_offset_tag                 1
+#define Hop_Mod_entries_tag                      2
+#define Hop_freq_khz_tag                         1
+#define Hop_dwell_ns_tag                         2
+#define Hop_phase_tag                            3
+#define Hop_table_msg_offset_tag                 1
+#define Hop_table_msg_hops_tag                   2
+#define Hop_table_msg_channel_tag                3
 #define Freq_Mod_low_freq_khz_tag                1
 #define Freq_Mod_high_freq_khz_tag               2
 #define Freq_Mod_length_us_tag                   3
 #define Phase_Mod_freq_khz_tag                   1
 #define Phase_Mod_barker_seq_num_tag             2
 #define Phase_Mod_barker_subpulse_length_us_tag  3
+#define Recall_preset_msg_id_tag                 1
+#define Recall_preset_msg_channel_tag            2
+#define Trace_event_timestamp_tag                1
+#define Trace_event_stage_tag                    2
+#define Trace_event_phase_tag                    3
+#define Trace_event_core_tag                     4
+#define Task_stats_name_tag                      1
+#define Task_stats_run_time_percent_tag          2
+#define Task_stats_run_time_counter_tag          3
+#define Task_stats_stack_high_water_mark_tag     4
+#define Task_stats_priority_tag                  5
+#define Generator_perf_channel_tag               1
+#define Generator_perf_pulses_tag                2
+#define Generator_perf_stall_cycles_tag          3
+#define Generator_perf_capture_beats_tag         4
+#define Generator_perf_tlasts_tag                5
+#define Generator_perf_commits_tag               6
+#define Generator_perf_config_writes_tag         7
+#define Generator_perf_triggers_tag              8
+#define Generator_perf_triggers_missed_tag       9
 #define Generator_Config_msg_debug_enabled_tag   1
 #define Generator_Config_msg_mode_tag            2
 #define Generator_Config_msg_const_freq_tag      3
@@ -157,11 +442,41 @@ typedef struct _Base_msg {
 #define Generator_Config_msg_phase_mod_tag       5
 #define Generator_Config_msg_period_us_tag       6
 #define Generator_Config_msg_pulse_length_us_tag 7
+#define Generator_Config_msg_live_update_tag     8
+#define Generator_Config_msg_channel_tag         9
+#define Generator_Config_msg_code_mod_tag        10
+#define Generator_Config_msg_freq_law_mod_tag    11
+#define Generator_Config_msg_hop_mod_tag         12
 #define Config_msg_generator_tag                 1
 #define Config_msg_demodulator_tag               2
+#define Config_msg_sequence_tag                  3
+#define Config_msg_save_preset_tag               4
+#define Config_msg_recall_preset_tag             5
+#define Config_msg_code_table_tag                6
+#define Config_msg_freq_law_table_tag            7
+#define Config_msg_hop_table_tag                 8
 #define Base_msg_control_tag                     1
 #define Base_msg_config_tag                      2
 #define Base_msg_ack_tag                         3
+#define Stats_msg_tasks_tag                      1
+#define Stats_msg_total_run_time_tag             2
+#define Stats_msg_free_heap_tag                  3
+#define Stats_msg_min_free_heap_tag              4
+#define Stats_msg_command_switches_tag           5
+#define Stats_msg_max_command_switches_tag       6
+#define Stats_msg_log_overflows_tag              7
+#define Stats_msg_perf_tag                       8
+#define Trace_msg_events_tag                     1
+#define Trace_msg_timer_freq_hz_tag              2
+#define Sequence_entry_config_tag                1
+#define Sequence_entry_repeat_tag                2
+#define Sequence_msg_first_index_tag             1
+#define Sequence_msg_entries_tag                 2
+#define Sequence_msg_length_tag                  3
+#define Sequence_msg_channel_tag                 4
+#define Save_preset_msg_id_tag                   1
+#define Save_preset_msg_name_tag                 2
+#define Save_preset_msg_config_tag               3
 
 /* Struct field encoding specification for nanopb */
 #define Base_msg_FIELDLIST(X, a) \
@@ -175,20 +490,39 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (message,ack,ack),   3)
 #define Base_msg_message_ack_MSGTYPE Ack_msg
 
 #define Control_msg_FIELDLIST(X, a) \
-X(a, STATIC,   SINGULAR, UENUM,    command,           1)
+X(a, STATIC,   SINGULAR, UENUM,    command,           1) \
+X(a, STATIC,   SINGULAR, UENUM,    target,            2) \
+X(a, STATIC,   SINGULAR, UENUM,    log_level,         3) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           4) \
+X(a, STATIC,   SINGULAR, BOOL,     all_channels,      5)
 #define Control_msg_CALLBACK NULL
 #define Control_msg_DEFAULT NULL
 
 #define Config_msg_FIELDLIST(X, a) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (config,generator,generator),   1) \
-X(a, STATIC,   ONEOF,    MESSAGE,  (config,demodulator,demodulator),   2)
+X(a, STATIC,   ONEOF,    MESSAGE,  (config,demodulator,demodulator),   2) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (config,sequence,sequence),   3) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (config,save_preset,save_preset),   4) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (config,recall_preset,recall_preset),   5) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (config,code_table,code_table),   6) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (config,freq_law_table,freq_law_table),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (config,hop_table,hop_table),   8)
 #define Config_msg_CALLBACK NULL
 #define Config_msg_DEFAULT NULL
 #define Config_msg_config_generator_MSGTYPE Generator_Config_msg
 #define Config_msg_config_demodulator_MSGTYPE Demodulator_config_msg
+#define Config_msg_config_sequence_MSGTYPE Sequence_msg
+#define Config_msg_config_save_preset_MSGTYPE Save_preset_msg
+#define Config_msg_config_recall_preset_MSGTYPE Recall_preset_msg
+#define Config_msg_config_code_table_MSGTYPE Code_table_msg
+#define Config_msg_config_freq_law_table_MSGTYPE Freq_law_table_msg
+#define Config_msg_config_hop_table_MSGTYPE Hop_table_msg
 
 #define Ack_msg_FIELDLIST(X, a) \
-X(a, STATIC,   SINGULAR, UENUM,    retval,            1)
+X(a, STATIC,   SINGULAR, UENUM,    retval,            1) \
+X(a, STATIC,   SINGULAR, UINT64,   timestamp,         2) \
+X(a, STATIC,   SINGULAR, UINT64,   commit_timestamp,   3) \
+X(a, STATIC,   SINGULAR, UINT64,   pulse_timestamp,   4)
 #define Ack_msg_CALLBACK NULL
 #define Ack_msg_DEFAULT NULL
 
@@ -199,12 +533,20 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (modulation_config,const_freq,const_freq),
 X(a, STATIC,   ONEOF,    MESSAGE,  (modulation_config,freq_mod,freq_mod),   4) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (modulation_config,phase_mod,phase_mod),   5) \
 X(a, STATIC,   SINGULAR, UINT32,   period_us,         6) \
-X(a, STATIC,   SINGULAR, UINT32,   pulse_length_us,   7)
+X(a, STATIC,   SINGULAR, UINT32,   pulse_length_us,   7) \
+X(a, STATIC,   SINGULAR, BOOL,     live_update,       8) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           9) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (modulation_config,code_mod,code_mod),  10) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (modulation_config,freq_law_mod,freq_law_mod),  11) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (modulation_config,hop_mod,hop_mod),  12)
 #define Generator_Config_msg_CALLBACK NULL
 #define Generator_Config_msg_DEFAULT NULL
 #define Generator_Config_msg_modulation_config_const_freq_MSGTYPE Const_Freq
 #define Generator_Config_msg_modulation_config_freq_mod_MSGTYPE Freq_Mod
 #define Generator_Config_msg_modulation_config_phase_mod_MSGTYPE Phase_Mod
+#define Generator_Config_msg_modulation_config_code_mod_MSGTYPE Code_Mod
+#define Generator_Config_msg_modulation_config_freq_law_mod_MSGTYPE Freq_law_Mod
+#define Generator_Config_msg_modulation_config_hop_mod_MSGTYPE Hop_Mod
 
 #define Const_Freq_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   freq_khz,          1)
@@ -225,6 +567,28 @@ X(a, STATIC,   SINGULAR, UINT32,   barker_subpulse_length_us,   3)
 #define Phase_Mod_CALLBACK NULL
 #define Phase_Mod_DEFAULT NULL
 
+#define Code_Mod_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   freq_khz,          1) \
+X(a, STATIC,   SINGULAR, UENUM,    code,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   order,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   table_offset,      4) \
+X(a, STATIC,   SINGULAR, UINT32,   chip_length_ns,    5)
+#define Code_Mod_CALLBACK NULL
+#define Code_Mod_DEFAULT NULL
+
+#define Freq_law_Mod_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   table_offset,      1) \
+X(a, STATIC,   SINGULAR, UINT32,   entries,           2) \
+X(a, STATIC,   SINGULAR, UINT32,   entry_clocks,      3)
+#define Freq_law_Mod_CALLBACK NULL
+#define Freq_law_Mod_DEFAULT NULL
+
+#define Hop_Mod_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   table_offset,      1) \
+X(a, STATIC,   SINGULAR, UINT32,   entries,           2)
+#define Hop_Mod_CALLBACK NULL
+#define Hop_Mod_DEFAULT NULL
+
 #define Demodulator_config_msg_FIELDLIST(X, a) \
 
 #define Demodulator_config_msg_CALLBACK NULL
@@ -233,10 +597,123 @@ X(a, STATIC,   SINGULAR, UINT32,   barker_subpulse_length_us,   3)
 #define Debug_msg_FIELDLIST(X, a) \
 X(a, STATIC,   FIXARRAY, SINT32,   i_samples,         1) \
 X(a, STATIC,   FIXARRAY, SINT32,   q_samples,         2) \
-X(a, STATIC,   SINGULAR, UINT32,   num_samples,       3)
+X(a, STATIC,   SINGULAR, UINT32,   num_samples,       3) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           4) \
+X(a, STATIC,   SINGULAR, UINT64,   timestamp,         5)
 #define Debug_msg_CALLBACK NULL
 #define Debug_msg_DEFAULT NULL
 
+#define Task_stats_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   run_time_percent,   2) \
+X(a, STATIC,   SINGULAR, UINT32,   run_time_counter,   3) \
+X(a, STATIC,   SINGULAR, UINT32,   stack_high_water_mark,   4) \
+X(a, STATIC,   SINGULAR, UINT32,   priority,          5)
+#define Task_stats_CALLBACK NULL
+#define Task_stats_DEFAULT NULL
+
+#define Generator_perf_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   pulses,            2) \
+X(a, STATIC,   SINGULAR, UINT32,   stall_cycles,      3) \
+X(a, STATIC,   SINGULAR, UINT32,   capture_beats,     4) \
+X(a, STATIC,   SINGULAR, UINT32,   tlasts,            5) \
+X(a, STATIC,   SINGULAR, UINT32,   commits,           6) \
+X(a, STATIC,   SINGULAR, UINT32,   config_writes,     7) \
+X(a, STATIC,   SINGULAR, UINT32,   triggers,          8) \
+X(a, STATIC,   SINGULAR, UINT32,   triggers_missed,   9)
+#define Generator_perf_CALLBACK NULL
+#define Generator_perf_DEFAULT NULL
+
+#define Stats_msg_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  tasks,             1) \
+X(a, STATIC,   SINGULAR, UINT32,   total_run_time,    2) \
+X(a, STATIC,   SINGULAR, UINT32,   free_heap,         3) \
+X(a, STATIC,   SINGULAR, UINT32,   min_free_heap,     4) \
+X(a, STATIC,   SINGULAR, UINT32,   command_switches,   5) \
+X(a, STATIC,   SINGULAR, UINT32,   max_command_switches,   6) \
+X(a, STATIC,   SINGULAR, UINT32,   log_overflows,     7) \
+X(a, STATIC,   REPEATED, MESSAGE,  perf,              8)
+#define Stats_msg_CALLBACK NULL
+#define Stats_msg_DEFAULT NULL
+#define Stats_msg_tasks_MSGTYPE Task_stats
+#define Stats_msg_perf_MSGTYPE Generator_perf
+
+#define Trace_event_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT64,   timestamp,         1) \
+X(a, STATIC,   SINGULAR, UENUM,    stage,             2) \
+X(a, STATIC,   SINGULAR, UENUM,    phase,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   core,              4)
+#define Trace_event_CALLBACK NULL
+#define Trace_event_DEFAULT NULL
+
+#define Trace_msg_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  events,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   timer_freq_hz,     2)
+#define Trace_msg_CALLBACK NULL
+#define Trace_msg_DEFAULT NULL
+#define Trace_msg_events_MSGTYPE Trace_event
+
+#define Sequence_entry_FIELDLIST(X, a) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  config,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   repeat,            2)
+#define Sequence_entry_CALLBACK NULL
+#define Sequence_entry_DEFAULT NULL
+#define Sequence_entry_config_MSGTYPE Generator_Config_msg
+
+#define Sequence_msg_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   first_index,       1) \
+X(a, STATIC,   REPEATED, MESSAGE,  entries,           2) \
+X(a, STATIC,   SINGULAR, UINT32,   length,            3) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           4)
+#define Sequence_msg_CALLBACK NULL
+#define Sequence_msg_DEFAULT NULL
+#define Sequence_msg_entries_MSGTYPE Sequence_entry
+
+#define Save_preset_msg_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   id,                1) \
+X(a, STATIC,   SINGULAR, STRING,   name,              2) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  config,            3)
+#define Save_preset_msg_CALLBACK NULL
+#define Save_preset_msg_DEFAULT NULL
+#define Save_preset_msg_config_MSGTYPE Generator_Config_msg
+
+#define Recall_preset_msg_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   id,                1) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           2)
+#define Recall_preset_msg_CALLBACK NULL
+#define Recall_preset_msg_DEFAULT NULL
+
+#define Code_table_msg_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   REPEATED, UINT32,   phases,            2) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           3)
+#define Code_table_msg_CALLBACK NULL
+#define Code_table_msg_DEFAULT NULL
+
+#define Freq_law_table_msg_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   REPEATED, UINT32,   pinc,              2) \
+X(a, STATIC,   REPEATED, SINT32,   slope,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           4)
+#define Freq_law_table_msg_CALLBACK NULL
+#define Freq_law_table_msg_DEFAULT NULL
+
+#define Hop_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   freq_khz,          1) \
+X(a, STATIC,   SINGULAR, UINT32,   dwell_ns,          2) \
+X(a, STATIC,   SINGULAR, UINT32,   phase,             3)
+#define Hop_CALLBACK NULL
+#define Hop_DEFAULT NULL
+
+#define Hop_table_msg_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   REPEATED, MESSAGE,  hops,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           3)
+#define Hop_table_msg_CALLBACK NULL
+#define Hop_table_msg_DEFAULT NULL
+#define Hop_table_msg_hops_MSGTYPE Hop
+
 extern const pb_msgdesc_t Base_msg_msg;
 extern const pb_msgdesc_t Control_msg_msg;
 extern const pb_msgdesc_t Config_msg_msg;
@@ -245,8 +722,24 @@ extern const pb_msgdesc_t Generator_Config_msg_msg;
 extern const pb_msgdesc_t Const_Freq_msg;
 extern const pb_msgdesc_t Freq_Mod_msg;
 extern const pb_msgdesc_t Phase_Mod_msg;
+extern const pb_msgdesc_t Code_Mod_msg;
+extern const pb_msgdesc_t Freq_law_Mod_msg;
+extern const pb_msgdesc_t Hop_Mod_msg;
 extern const pb_msgdesc_t Demodulator_config_msg_msg;
 extern const pb_msgdesc_t Debug_msg_msg;
+extern const pb_msgdesc_t Task_stats_msg;
+extern const pb_msgdesc_t Generator_perf_msg;
+extern const pb_msgdesc_t Stats_msg_msg;
+extern const pb_msgdesc_t Trace_event_msg;
+extern const pb_msgdesc_t Trace_msg_msg;
+extern const pb_msgdesc_t Sequence_entry_msg;
+extern const pb_msgdesc_t Sequence_msg_msg;
+extern const pb_msgdesc_t Save_preset_msg_msg;
+extern const pb_msgdesc_t Recall_preset_msg_msg;
+extern const pb_msgdesc_t Code_table_msg_msg;
+extern const pb_msgdesc_t Freq_law_table_msg_msg;
+extern const pb_msgdesc_t Hop_msg;
+extern const pb_msgdesc_t Hop_table_msg_msg;
 
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
 #define Base_msg_fields &Base_msg_msg
@@ -257,20 +750,52 @@ extern const pb_msgdesc_t Debug_msg_msg;
 #define Const_Freq_fields &Const_Freq_msg
 #define Freq_Mod_fields &Freq_Mod_msg
 #define Phase_Mod_fields &Phase_Mod_msg
+#define Code_Mod_fields &Code_Mod_msg
+#define Freq_law_Mod_fields &Freq_law_Mod_msg
+#define Hop_Mod_fields &Hop_Mod_msg
 #define Demodulator_config_msg_fields &Demodulator_config_msg_msg
 #define Debug_msg_fields &Debug_msg_msg
+#define Task_stats_fields &Task_stats_msg
+#define Generator_perf_fields &Generator_perf_msg
+#define Stats_msg_fields &Stats_msg_msg
+#define Trace_event_fields &Trace_event_msg
+#define Trace_msg_fields &Trace_msg_msg
+#define Sequence_entry_fields &Sequence_entry_msg
+#define Sequence_msg_fields &Sequence_msg_msg
+#define Save_preset_msg_fields &Save_preset_msg_msg
+#define Recall_preset_msg_fields &Recall_preset_msg_msg
+#define Code_table_msg_fields &Code_table_msg_msg
+#define Freq_law_table_msg_fields &Freq_law_table_msg_msg
+#define Hop_fields &Hop_msg
+#define Hop_table_msg_fields &Hop_table_msg_msg
 
 /* Maximum encoded size of messages (where known) */
-#define Base_msg_size                            40
-#define Control_msg_size                         2
-#define Config_msg_size                          38
-#define Ack_msg_size                             2
-#define Generator_Config_msg_size                36
+#define Base_msg_size                            664
+#define Control_msg_size                         14
+#define Config_msg_size                          661
+#define Ack_msg_size                             35
+#define Generator_Config_msg_size                52
 #define Const_Freq_size                          6
 #define Freq_Mod_size                            18
 #define Phase_Mod_size                           18
+#define Code_Mod_size                            26
+#define Freq_law_Mod_size                        18
+#define Hop_Mod_size                             12
 #define Demodulator_config_msg_size              0
-#define Debug_msg_size                           1500006
+#define Debug_msg_size                           1500023
+#define Task_stats_size                          41
+#define Generator_perf_size                      54
+#define Stats_msg_size                           836
+#define Trace_event_size                         21
+#define Trace_msg_size                           11782
+#define Sequence_entry_size                      60
+#define Sequence_msg_size                        514
+#define Save_preset_msg_size                     77
+#define Recall_preset_msg_size                   12
+#define Code_table_msg_size                      655
+#define Freq_law_table_msg_size                  658
+#define Hop_size                                 18
+#define Hop_table_msg_size                       652
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -1,13 +1,11 @@
+# -*- coding: utf-8 -*-
 # Generated by the protocol buffer compiler.  DO NOT EDIT!
 # source: generator/sw/src/messages.proto
-
-import sys
-_b=sys.version_info[0]<3 and (lambda x:x) or (lambda x:x.encode('latin1'))
+"""Generated protocol buffer code."""
+from google.protobuf.internal import builder as _builder
 from google.protobuf import descriptor as _descriptor
-from google.protobuf import message as _message
-from google.protobuf import reflection as _reflection
+from google.protobuf import descriptor_pool as _descriptor_pool
 from google.protobuf import symbol_database as _symbol_database
-from google.protobuf import descriptor_pb2
 # @@protoc_insertion_point(imports)
 
 _sym_db = _symbol_database.Default()
@@ -15,648 +13,79 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor.FileDescriptor(
-  name='generator/sw/src/messages.proto',
-  package='',
-  syntax='proto3',
-  serialized_pb=_b('\n\x1fgenerator/sw/src/messages.proto\"n\n\x08\x42\x61se_msg\x12\x1f\n\x07\x63ontrol\x18\x01 \x01(\x0b\x32\x0c.Control_msgH\x00\x12\x1d\n\x06\x63onfig\x18\x02 \x01(\x0b\x32\x0b.Config_msgH\x00\x12\x17\n\x03\x61\x63k\x18\x03 \x01(\x0b\x32\x08.Ack_msgH\x00\x42\t\n\x07message\"s\n\x0b\x43ontrol_msg\x12%\n\x07\x63ommand\x18\x01 \x01(\x0e\x32\x14.Control_msg.Command\"=\n\x07\x43ommand\x12\t\n\x05START\x10\x00\x12\x08\n\x04STOP\x10\x01\x12\x0c\n\x08TRIG_DBG\x10\x02\x12\x0f\n\x0b\x42ROKEN_CONN\x10\x03\"r\n\nConfig_msg\x12*\n\tgenerator\x18\x01 \x01(\x0b\x32\x15.Generator_Config_msgH\x00\x12.\n\x0b\x64\x65modulator\x18\x02 \x01(\x0b\x32\x17.Demodulator_config_msgH\x00\x42\x08\n\x06\x63onfig\"\xa3\x01\n\x07\x41\x63k_msg\x12\x1f\n\x06retval\x18\x01 \x01(\x0e\x32\x0f.Ack_msg.Retval\"w\n\x06Retval\x12\x07\n\x03\x41\x43K\x10\x00\x12\x0f\n\x0bINVALID_MSG\x10\x01\x12\x0e\n\nBAD_CONFIG\x10\x02\x12\r\n\tNO_CONFIG\x10\x03\x12\x0f\n\x0b\x42\x41\x44_COMMAND\x10\x04\x12\x0f\n\x0b\x44\x45\x42UG_ERROR\x10\x05\x12\x12\n\x0e\x44\x45\x42UG_IS_VALID\x10\x06\"\x9f\x02\n\x14Generator_Config_msg\x12\x15\n\rdebug_enabled\x18\x01 \x01(\x08\x12(\n\x04mode\x18\x02 \x01(\x0e\x32\x1a.Generator_Config_msg.Mode\x12!\n\nconst_freq\x18\x03 \x01(\x0b\x32\x0b.Const_FreqH\x00\x12\x1d\n\x08\x66req_mod\x18\x04 \x01(\x0b\x32\t.Freq_ModH\x00\x12\x1f\n\tphase_mod\x18\x05 \x01(\x0b\x32\n.Phase_ModH\x00\x12\x11\n\tperiod_us\x18\x06 \x01(\r\x12\x17\n\x0fpulse_length_us\x18\x07 \x01(\r\"\"\n\x04Mode\x12\x0e\n\nCONTINUOUS\x10\x00\x12\n\n\x06PULSED\x10\x01\x42\x13\n\x11modulation_config\"\x1e\n\nConst_Freq\x12\x10\n\x08\x66req_khz\x18\x01 \x01(\r\"J\n\x08\x46req_Mod\x12\x14\n\x0clow_freq_khz\x18\x01 \x01(\r\x12\x15\n\rhigh_freq_khz\x18\x02 \x01(\r\x12\x11\n\tlength_us\x18\x03 \x01(\r\"X\n\tPhase_Mod\x12\x10\n\x08\x66req_khz\x18\x01 \x01(\r\x12\x16\n\x0e\x62\x61rker_seq_num\x18\x02 \x01(\r\x12!\n\x19\x62\x61rker_subpulse_length_us\x18\x03 \x01(\r\"\x18\n\x16\x44\x65modulator_config_msg\"F\n\tDebug_msg\x12\x11\n\ti_samples\x18\x01 \x03(\x11\x12\x11\n\tq_samples\x18\x02 \x03(\x11\x12\x13\n\x0bnum_samples\x18\x03 \x01(\rb\x06proto3')
-)
-_sym_db.RegisterFileDescriptor(DESCRIPTOR)
-
-
-
-_CONTROL_MSG_COMMAND = _descriptor.EnumDescriptor(
-  name='Command',
-  full_name='Control_msg.Command',
-  filename=None,
-  file=DESCRIPTOR,
-  values=[
-    _descriptor.EnumValueDescriptor(
-      name='START', index=0, number=0,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='STOP', index=1, number=1,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='TRIG_DBG', index=2, number=2,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='BROKEN_CONN', index=3, number=3,
-      options=None,
-      type=None),
-  ],
-  containing_type=None,
-  options=None,
-  serialized_start=201,
-  serialized_end=262,
-)
-_sym_db.RegisterEnumDescriptor(_CONTROL_MSG_COMMAND)
-
-_ACK_MSG_RETVAL = _descriptor.EnumDescriptor(
-  name='Retval',
-  full_name='Ack_msg.Retval',
-  filename=None,
-  file=DESCRIPTOR,
-  values=[
-    _descriptor.EnumValueDescriptor(
-      name='ACK', index=0, number=0,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='INVALID_MSG', index=1, number=1,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='BAD_CONFIG', index=2, number=2,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='NO_CONFIG', index=3, number=3,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='BAD_COMMAND', index=4, number=4,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='DEBUG_ERROR', index=5, number=5,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='DEBUG_IS_VALID', index=6, number=6,
-      options=None,
-      type=None),
-  ],
-  containing_type=None,
-  options=None,
-  serialized_start=425,
-  serialized_end=544,
-)
-_sym_db.RegisterEnumDescriptor(_ACK_MSG_RETVAL)
-
-_GENERATOR_CONFIG_MSG_MODE = _descriptor.EnumDescriptor(
-  name='Mode',
-  full_name='Generator_Config_msg.Mode',
-  filename=None,
-  file=DESCRIPTOR,
-  values=[
-    _descriptor.EnumValueDescriptor(
-      name='CONTINUOUS', index=0, number=0,
-      options=None,
-      type=None),
-    _descriptor.EnumValueDescriptor(
-      name='PULSED', index=1, number=1,
-      options=None,
-      type=None),
-  ],
-  containing_type=None,
-  options=None,
-  serialized_start=779,
-  serialized_end=813,
-)
-_sym_db.RegisterEnumDescriptor(_GENERATOR_CONFIG_MSG_MODE)
-
-
-_BASE_MSG = _descriptor.Descriptor(
-  name='Base_msg',
-  full_name='Base_msg',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='control', full_name='Base_msg.control', index=0,
-      number=1, type=11, cpp_type=10, label=1,
-      has_default_value=False, default_value=None,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='config', full_name='Base_msg.config', index=1,
-      number=2, type=11, cpp_type=10, label=1,
-      has_default_value=False, default_value=None,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='ack', full_name='Base_msg.ack', index=2,
-      number=3, type=11, cpp_type=10, label=1,
-      has_default_value=False, default_value=None,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-    _descriptor.OneofDescriptor(
-      name='message', full_name='Base_msg.message',
-      index=0, containing_type=None, fields=[]),
-  ],
-  serialized_start=35,
-  serialized_end=145,
-)
-
-
-_CONTROL_MSG = _descriptor.Descriptor(
-  name='Control_msg',
-  full_name='Control_msg',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='command', full_name='Control_msg.command', index=0,
-      number=1, type=14, cpp_type=8, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-    _CONTROL_MSG_COMMAND,
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-  ],
-  serialized_start=147,
-  serialized_end=262,
-)
-
-
-_CONFIG_MSG = _descriptor.Descriptor(
-  name='Config_msg',
-  full_name='Config_msg',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='generator', full_name='Config_msg.generator', index=0,
-      number=1, type=11, cpp_type=10, label=1,
-      has_default_value=False, default_value=None,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='demodulator', full_name='Config_msg.demodulator', index=1,
-      number=2, type=11, cpp_type=10, label=1,
-      has_default_value=False, default_value=None,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-    _descriptor.OneofDescriptor(
-      name='config', full_name='Config_msg.config',
-      index=0, containing_type=None, fields=[]),
-  ],
-  serialized_start=264,
-  serialized_end=378,
-)
-
-
-_ACK_MSG = _descriptor.Descriptor(
-  name='Ack_msg',
-  full_name='Ack_msg',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='retval', full_name='Ack_msg.retval', index=0,
-      number=1, type=14, cpp_type=8, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-    _ACK_MSG_RETVAL,
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-  ],
-  serialized_start=381,
-  serialized_end=544,
-)
-
-
-_GENERATOR_CONFIG_MSG = _descriptor.Descriptor(
-  name='Generator_Config_msg',
-  full_name='Generator_Config_msg',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='debug_enabled', full_name='Generator_Config_msg.debug_enabled', index=0,
-      number=1, type=8, cpp_type=7, label=1,
-      has_default_value=False, default_value=False,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='mode', full_name='Generator_Config_msg.mode', index=1,
-      number=2, type=14, cpp_type=8, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='const_freq', full_name='Generator_Config_msg.const_freq', index=2,
-      number=3, type=11, cpp_type=10, label=1,
-      has_default_value=False, default_value=None,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='freq_mod', full_name='Generator_Config_msg.freq_mod', index=3,
-      number=4, type=11, cpp_type=10, label=1,
-      has_default_value=False, default_value=None,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='phase_mod', full_name='Generator_Config_msg.phase_mod', index=4,
-      number=5, type=11, cpp_type=10, label=1,
-      has_default_value=False, default_value=None,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='period_us', full_name='Generator_Config_msg.period_us', index=5,
-      number=6, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='pulse_length_us', full_name='Generator_Config_msg.pulse_length_us', index=6,
-      number=7, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-    _GENERATOR_CONFIG_MSG_MODE,
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-    _descriptor.OneofDescriptor(
-      name='modulation_config', full_name='Generator_Config_msg.modulation_config',
-      index=0, containing_type=None, fields=[]),
-  ],
-  serialized_start=547,
-  serialized_end=834,
-)
-
-
-_CONST_FREQ = _descriptor.Descriptor(
-  name='Const_Freq',
-  full_name='Const_Freq',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='freq_khz', full_name='Const_Freq.freq_khz', index=0,
-      number=1, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-  ],
-  serialized_start=836,
-  serialized_end=866,
-)
-
-
-_FREQ_MOD = _descriptor.Descriptor(
-  name='Freq_Mod',
-  full_name='Freq_Mod',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='low_freq_khz', full_name='Freq_Mod.low_freq_khz', index=0,
-      number=1, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='high_freq_khz', full_name='Freq_Mod.high_freq_khz', index=1,
-      number=2, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='length_us', full_name='Freq_Mod.length_us', index=2,
-      number=3, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-  ],
-  serialized_start=868,
-  serialized_end=942,
-)
-
-
-_PHASE_MOD = _descriptor.Descriptor(
-  name='Phase_Mod',
-  full_name='Phase_Mod',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='freq_khz', full_name='Phase_Mod.freq_khz', index=0,
-      number=1, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='barker_seq_num', full_name='Phase_Mod.barker_seq_num', index=1,
-      number=2, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='barker_subpulse_length_us', full_name='Phase_Mod.barker_subpulse_length_us', index=2,
-      number=3, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-  ],
-  serialized_start=944,
-  serialized_end=1032,
-)
-
-
-_DEMODULATOR_CONFIG_MSG = _descriptor.Descriptor(
-  name='Demodulator_config_msg',
-  full_name='Demodulator_config_msg',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-  ],
-  serialized_start=1034,
-  serialized_end=1058,
-)
-
-
-_DEBUG_MSG = _descriptor.Descriptor(
-  name='Debug_msg',
-  full_name='Debug_msg',
-  filename=None,
-  file=DESCRIPTOR,
-  containing_type=None,
-  fields=[
-    _descriptor.FieldDescriptor(
-      name='i_samples', full_name='Debug_msg.i_samples', index=0,
-      number=1, type=17, cpp_type=1, label=3,
-      has_default_value=False, default_value=[],
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='q_samples', full_name='Debug_msg.q_samples', index=1,
-      number=2, type=17, cpp_type=1, label=3,
-      has_default_value=False, default_value=[],
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-    _descriptor.FieldDescriptor(
-      name='num_samples', full_name='Debug_msg.num_samples', index=2,
-      number=3, type=13, cpp_type=3, label=1,
-      has_default_value=False, default_value=0,
-      message_type=None, enum_type=None, containing_type=None,
-      is_extension=False, extension_scope=None,
-      options=None),
-  ],
-  extensions=[
-  ],
-  nested_types=[],
-  enum_types=[
-  ],
-  options=None,
-  is_extendable=False,
-  syntax='proto3',
-  extension_ranges=[],
-  oneofs=[
-  ],
-  serialized_start=1060,
-  serialized_end=1130,
-)
-
-_BASE_MSG.fields_by_name['control'].message_type = _CONTROL_MSG
-_BASE_MSG.fields_by_name['config'].message_type = _CONFIG_MSG
-_BASE_MSG.fields_by_name['ack'].message_type = _ACK_MSG
-_BASE_MSG.oneofs_by_name['message'].fields.append(
-  _BASE_MSG.fields_by_name['control'])
-_BASE_MSG.fields_by_name['control'].containing_oneof = _BASE_MSG.oneofs_by_name['message']
-_BASE_MSG.oneofs_by_name['message'].fields.append(
-  _BASE_MSG.fields_by_name['config'])
-_BASE_MSG.fields_by_name['config'].containing_oneof = _BASE_MSG.oneofs_by_name['message']
-_BASE_MSG.oneofs_by_name['message'].fields.append(
-  _BASE_MSG.fields_by_name['ack'])
-_BASE_MSG.fields_by_name['ack'].containing_oneof = _BASE_MSG.oneofs_by_name['message']
-_CONTROL_MSG.fields_by_name['command'].enum_type = _CONTROL_MSG_COMMAND
-_CONTROL_MSG_COMMAND.containing_type = _CONTROL_MSG
-_CONFIG_MSG.fields_by_name['generator'].message_type = _GENERATOR_CONFIG_MSG
-_CONFIG_MSG.fields_by_name['demodulator'].message_type = _DEMODULATOR_CONFIG_MSG
-_CONFIG_MSG.oneofs_by_name['config'].fields.append(
-  _CONFIG_MSG.fields_by_name['generator'])
-_CONFIG_MSG.fields_by_name['generator'].containing_oneof = _CONFIG_MSG.oneofs_by_name['config']
-_CONFIG_MSG.oneofs_by_name['config'].fields.append(
-  _CONFIG_MSG.fields_by_name['demodulator'])
-_CONFIG_MSG.fields_by_name['demodulator'].containing_oneof = _CONFIG_MSG.oneofs_by_name['config']
-_ACK_MSG.fields_by_name['retval'].enum_type = _ACK_MSG_RETVAL
-_ACK_MSG_RETVAL.containing_type = _ACK_MSG
-_GENERATOR_CONFIG_MSG.fields_by_name['mode'].enum_type = _GENERATOR_CONFIG_MSG_MODE
-_GENERATOR_CONFIG_MSG.fields_by_name['const_freq'].message_type = _CONST_FREQ
-_GENERATOR_CONFIG_MSG.fields_by_name['freq_mod'].message_type = _FREQ_MOD
-_GENERATOR_CONFIG_MSG.fields_by_name['phase_mod'].message_type = _PHASE_MOD
-_GENERATOR_CONFIG_MSG_MODE.containing_type = _GENERATOR_CONFIG_MSG
-_GENERATOR_CONFIG_MSG.oneofs_by_name['modulation_config'].fields.append(
-  _GENERATOR_CONFIG_MSG.fields_by_name['const_freq'])
-_GENERATOR_CONFIG_MSG.fields_by_name['const_freq'].containing_oneof = _GENERATOR_CONFIG_MSG.oneofs_by_name['modulation_config']
-_GENERATOR_CONFIG_MSG.oneofs_by_name['modulation_config'].fields.append(
-  _GENERATOR_CONFIG_MSG.fields_by_name['freq_mod'])
-_GENERATOR_CONFIG_MSG.fields_by_name['freq_mod'].containing_oneof = _GENERATOR_CONFIG_MSG.oneofs_by_name['modulation_config']
-_GENERATOR_CONFIG_MSG.oneofs_by_name['modulation_config'].fields.append(
-  _GENERATOR_CONFIG_MSG.fields_by_name['phase_mod'])
-_GENERATOR_CONFIG_MSG.fields_by_name['phase_mod'].containing_oneof = _GENERATOR_CONFIG_MSG.oneofs_by_name['modulation_config']
-DESCRIPTOR.message_types_by_name['Base_msg'] = _BASE_MSG
-DESCRIPTOR.message_types_by_name['Control_msg'] = _CONTROL_MSG
-DESCRIPTOR.message_types_by_name['Config_msg'] = _CONFIG_MSG
-DESCRIPTOR.message_types_by_name['Ack_msg'] = _ACK_MSG
-DESCRIPTOR.message_types_by_name['Generator_Config_msg'] = _GENERATOR_CONFIG_MSG
-DESCRIPTOR.message_types_by_name['Const_Freq'] = _CONST_FREQ
-DESCRIPTOR.message_types_by_name['Freq_Mod'] = _FREQ_MOD
-DESCRIPTOR.message_types_by_name['Phase_Mod'] = _PHASE_MOD
-DESCRIPTOR.message_types_by_name['Demodulator_config_msg'] = _DEMODULATOR_CONFIG_MSG
-DESCRIPTOR.message_types_by_name['Debug_msg'] = _DEBUG_MSG
-
-Base_msg = _reflection.GeneratedProtocolMessageType('Base_msg', (_message.Message,), dict(
-  DESCRIPTOR = _BASE_MSG,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Base_msg)
-  ))
-_sym_db.RegisterMessage(Base_msg)
-
-Control_msg = _reflection.GeneratedProtocolMessageType('Control_msg', (_message.Message,), dict(
-  DESCRIPTOR = _CONTROL_MSG,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Control_msg)
-  ))
-_sym_db.RegisterMessage(Control_msg)
-
-Config_msg = _reflection.GeneratedProtocolMessageType('Config_msg', (_message.Message,), dict(
-  DESCRIPTOR = _CONFIG_MSG,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Config_msg)
-  ))
-_sym_db.RegisterMessage(Config_msg)
-
-Ack_msg = _reflection.GeneratedProtocolMessageType('Ack_msg', (_message.Message,), dict(
-  DESCRIPTOR = _ACK_MSG,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Ack_msg)
-  ))
-_sym_db.RegisterMessage(Ack_msg)
-
-Generator_Config_msg = _reflection.GeneratedProtocolMessageType('Generator_Config_msg', (_message.Message,), dict(
-  DESCRIPTOR = _GENERATOR_CONFIG_MSG,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Generator_Config_msg)
-  ))
-_sym_db.RegisterMessage(Generator_Config_msg)
-
-Const_Freq = _reflection.GeneratedProtocolMessageType('Const_Freq', (_message.Message,), dict(
-  DESCRIPTOR = _CONST_FREQ,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Const_Freq)
-  ))
-_sym_db.RegisterMessage(Const_Freq)
-
-Freq_Mod = _reflection.GeneratedProtocolMessageType('Freq_Mod', (_message.Message,), dict(
-  DESCRIPTOR = _FREQ_MOD,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Freq_Mod)
-  ))
-_sym_db.RegisterMessage(Freq_Mod)
-
-Phase_Mod = _reflection.GeneratedProtocolMessageType('Phase_Mod', (_message.Message,), dict(
-  DESCRIPTOR = _PHASE_MOD,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Phase_Mod)
-  ))
-_sym_db.RegisterMessage(Phase_Mod)
-
-Demodulator_config_msg = _reflection.GeneratedProtocolMessageType('Demodulator_config_msg', (_message.Message,), dict(
-  DESCRIPTOR = _DEMODULATOR_CONFIG_MSG,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Demodulator_config_msg)
-  ))
-_sym_db.RegisterMessage(Demodulator_config_msg)
-
-Debug_msg = _reflection.GeneratedProtocolMessageType('Debug_msg', (_message.Message,), dict(
-  DESCRIPTOR = _DEBUG_MSG,
-  __module__ = 'generator.sw.src.messages_pb2'
-  # @@protoc_insertion_point(class_scope:Debug_msg)
-  ))
-_sym_db.RegisterMessage(Debug_msg)
-
-
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x1fgenerator/sw/src/messages.proto\"n\n\x08\x42\x61se_msg\x12\x1f\n\x07\x63ontrol\x18\x01 \x01(\x0b\x32\x0c.Control_msgH\x00\x12\x1d\n\x06\x63onfig\x18\x02 \x01(\x0b\x32\x0b.Config_msgH\x00\x12\x17\n\x03\x61\x63k\x18\x03 \x01(\x0b\x32\x08.Ack_msgH\x00\x42\t\n\x07message\"\x9a\x03\n\x0b\x43ontrol_msg\x12%\n\x07\x63ommand\x18\x01 \x01(\x0e\x32\x14.Control_msg.Command\x12#\n\x06target\x18\x02 \x01(\x0e\x32\x13.Control_msg.Target\x12)\n\tlog_level\x18\x03 \x01(\x0e\x32\x16.Control_msg.Log_level\x12\x0f\n\x07\x63hannel\x18\x04 \x01(\r\x12\x14\n\x0c\x61ll_channels\x18\x05 \x01(\x08\"|\n\x07\x43ommand\x12\t\n\x05START\x10\x00\x12\x08\n\x04STOP\x10\x01\x12\x0c\n\x08TRIG_DBG\x10\x02\x12\x0f\n\x0b\x42ROKEN_CONN\x10\x03\x12\r\n\tGET_STATS\x10\x04\x12\x11\n\rSET_LOG_LEVEL\x10\x05\x12\x0e\n\nTRACE_DUMP\x10\x06\x12\x0b\n\x07GET_DBG\x10\x07\"(\n\x06Target\x12\r\n\tGENERATOR\x10\x00\x12\x0f\n\x0b\x44\x45MODULATOR\x10\x01\"E\n\tLog_level\x12\r\n\tLOG_ERROR\x10\x00\x12\x0c\n\x08LOG_WARN\x10\x01\x12\x0c\n\x08LOG_INFO\x10\x02\x12\r\n\tLOG_DEBUG\x10\x03\"\xe6\x02\n\nConfig_msg\x12*\n\tgenerator\x18\x01 \x01(\x0b\x32\x15.Generator_Config_msgH\x00\x12.\n\x0b\x64\x65modulator\x18\x02 \x01(\x0b\x32\x17.Demodulator_config_msgH\x00\x12!\n\x08sequence\x18\x03 \x01(\x0b\x32\r.Sequence_msgH\x00\x12\'\n\x0bsave_preset\x18\x04 \x01(\x0b\x32\x10.Save_preset_msgH\x00\x12+\n\rrecall_preset\x18\x05 \x01(\x0b\x32\x12.Recall_preset_msgH\x00\x12%\n\ncode_table\x18\x06 \x01(\x0b\x32\x0f.Code_table_msgH\x00\x12-\n\x0e\x66req_law_table\x18\x07 \x01(\x0b\x32\x13.Freq_law_table_msgH\x00\x12#\n\thop_table\x18\x08 \x01(\x0b\x32\x0e.Hop_table_msgH\x00\x42\x08\n\x06\x63onfig\"\xe9\x01\n\x07\x41\x63k_msg\x12\x1f\n\x06retval\x18\x01 \x01(\x0e\x32\x0f.Ack_msg.Retval\x12\x11\n\ttimestamp\x18\x02 \x01(\x04\x12\x18\n\x10\x63ommit_timestamp\x18\x03 \x01(\x04\x12\x17\n\x0fpulse_timestamp\x18\x04 \x01(\x04\"w\n\x06Retval\x12\x07\n\x03\x41\x43K\x10\x00\x12\x0f\n\x0bINVALID_MSG\x10\x01\x12\x0e\n\nBAD_CONFIG\x10\x02\x12\r\n\tNO_CONFIG\x10\x03\x12\x0f\n\x0b\x42\x41\x44_COMMAND\x10\x04\x12\x0f\n\x0b\x44\x45\x42UG_ERROR\x10\x05\x12\x12\n\x0e\x44\x45\x42UG_IS_VALID\x10\x06\"\xa8\x03\n\x14Generator_Config_msg\x12\x15\n\rdebug_enabled\x18\x01 \x01(\x08\x12(\n\x04mode\x18\x02 \x01(\x0e\x32\x1a.Generator_Config_msg.Mode\x12!\n\nconst_freq\x18\x03 \x01(\x0b\x32\x0b.Const_FreqH\x00\x12\x1d\n\x08\x66req_mod\x18\x04 \x01(\x0b\x32\t.Freq_ModH\x00\x12\x1f\n\tphase_mod\x18\x05 \x01(\x0b\x32\n.Phase_ModH\x00\x12\x1d\n\x08\x63ode_mod\x18\n \x01(\x0b\x32\t.Code_ModH\x00\x12%\n\x0c\x66req_law_mod\x18\x0b \x01(\x0b\x32\r.Freq_law_ModH\x00\x12\x1b\n\x07hop_mod\x18\x0c \x01(\x0b\x32\x08.Hop_ModH\x00\x12\x11\n\tperiod_us\x18\x06 \x01(\r\x12\x17\n\x0fpulse_length_us\x18\x07 \x01(\r\x12\x13\n\x0blive_update\x18\x08 \x01(\x08\x12\x0f\n\x07\x63hannel\x18\t \x01(\r\"\"\n\x04Mode\x12\x0e\n\nCONTINUOUS\x10\x00\x12\n\n\x06PULSED\x10\x01\x42\x13\n\x11modulation_config\"\x1e\n\nConst_Freq\x12\x10\n\x08\x66req_khz\x18\x01 \x01(\r\"J\n\x08\x46req_Mod\x12\x14\n\x0clow_freq_khz\x18\x01 \x01(\r\x12\x15\n\rhigh_freq_khz\x18\x02 \x01(\r\x12\x11\n\tlength_us\x18\x03 \x01(\r\"X\n\tPhase_Mod\x12\x10\n\x08\x66req_khz\x18\x01 \x01(\r\x12\x16\n\x0e\x62\x61rker_seq_num\x18\x02 \x01(\r\x12!\n\x19\x62\x61rker_subpulse_length_us\x18\x03 \x01(\r\"\xae\x01\n\x08\x43ode_Mod\x12\x10\n\x08\x66req_khz\x18\x01 \x01(\r\x12\x1c\n\x04\x63ode\x18\x02 \x01(\x0e\x32\x0e.Code_Mod.Code\x12\r\n\x05order\x18\x03 \x01(\r\x12\x14\n\x0ctable_offset\x18\x04 \x01(\r\x12\x16\n\x0e\x63hip_length_ns\x18\x05 \x01(\r\"5\n\x04\x43ode\x12\t\n\x05\x46RANK\x10\x00\x12\x06\n\x02P3\x10\x01\x12\x06\n\x02P4\x10\x02\x12\x07\n\x03MLS\x10\x03\x12\t\n\x05TABLE\x10\x04\"\x18\n\x16\x44\x65modulator_config_msg\"j\n\tDebug_msg\x12\x11\n\ti_samples\x18\x01 \x03(\x11\x12\x11\n\tq_samples\x18\x02 \x03(\x11\x12\x13\n\x0bnum_samples\x18\x03 \x01(\r\x12\x0f\n\x07\x63hannel\x18\x04 \x01(\r\x12\x11\n\ttimestamp\x18\x05 \x01(\x04\"\x7f\n\nTask_stats\x12\x0c\n\x04name\x18\x01 \x01(\t\x12\x18\n\x10run_time_percent\x18\x02 \x01(\r\x12\x18\n\x10run_time_counter\x18\x03 \x01(\r\x12\x1d\n\x15stack_high_water_mark\x18\x04 \x01(\r\x12\x10\n\x08priority\x18\x05 \x01(\r\"\xc1\x01\n\x0eGenerator_perf\x12\x0f\n\x07\x63hannel\x18\x01 \x01(\r\x12\x0e\n\x06pulses\x18\x02 \x01(\r\x12\x14\n\x0cstall_cycles\x18\x03 \x01(\r\x12\x15\n\rcapture_beats\x18\x04 \x01(\r\x12\x0e\n\x06tlasts\x18\x05 \x01(\r\x12\x0f\n\x07\x63ommits\x18\x06 \x01(\r\x12\x15\n\rconfig_writes\x18\x07 \x01(\r\x12\x10\n\x08triggers\x18\x08 \x01(\r\x12\x17\n\x0ftriggers_missed\x18\t \x01(\r\"\xd7\x01\n\tStats_msg\x12\x1a\n\x05tasks\x18\x01 \x03(\x0b\x32\x0b.Task_stats\x12\x16\n\x0etotal_run_time\x18\x02 \x01(\r\x12\x11\n\tfree_heap\x18\x03 \x01(\r\x12\x15\n\rmin_free_heap\x18\x04 \x01(\r\x12\x18\n\x10\x63ommand_switches\x18\x05 \x01(\r\x12\x1c\n\x14max_command_switches\x18\x06 \x01(\r\x12\x15\n\rlog_overflows\x18\x07 \x01(\r\x12\x1d\n\x04perf\x18\x08 \x03(\x0b\x32\x0f.Generator_perf\"\xa7\x02\n\x0bTrace_event\x12\x11\n\ttimestamp\x18\x01 \x01(\x04\x12!\n\x05stage\x18\x02 \x01(\x0e\x32\x12.Trace_event.Stage\x12!\n\x05phase\x18\x03 \x01(\x0e\x32\x12.Trace_event.Phase\x12\x0c\n\x04\x63ore\x18\x04 \x01(\r\"\x86\x01\n\x05Stage\x12\x0f\n\x0bSOCKET_READ\x10\x00\x12\r\n\tPB_DECODE\x10\x01\x12\x0c\n\x08\x44ISPATCH\x10\x02\x12\x11\n\rDECODE_CONFIG\x10\x03\x12\r\n\tWRITE_REG\x10\x04\x12\x0c\n\x08SEND_ACK\x10\x05\x12\r\n\tPB_ENCODE\x10\x06\x12\x10\n\x0cSOCKET_WRITE\x10\x07\"(\n\x05Phase\x12\t\n\x05\x42\x45GIN\x10\x00\x12\x07\n\x03\x45ND\x10\x01\x12\x0b\n\x07INSTANT\x10\x02\"@\n\tTrace_msg\x12\x1c\n\x06\x65vents\x18\x01 \x03(\x0b\x32\x0c.Trace_event\x12\x15\n\rtimer_freq_hz\x18\x02 \x01(\r\"G\n\x0eSequence_entry\x12%\n\x06\x63onfig\x18\x01 \x01(\x0b\x32\x15.Generator_Config_msg\x12\x0e\n\x06repeat\x18\x02 \x01(\r\"f\n\x0cSequence_msg\x12\x13\n\x0b\x66irst_index\x18\x01 \x01(\r\x12 \n\x07\x65ntries\x18\x02 \x03(\x0b\x32\x0f.Sequence_entry\x12\x0e\n\x06length\x18\x03 \x01(\r\x12\x0f\n\x07\x63hannel\x18\x04 \x01(\r\"R\n\x0fSave_preset_msg\x12\n\n\x02id\x18\x01 \x01(\r\x12\x0c\n\x04name\x18\x02 \x01(\t\x12%\n\x06\x63onfig\x18\x03 \x01(\x0b\x32\x15.Generator_Config_msg\"0\n\x11Recall_preset_msg\x12\n\n\x02id\x18\x01 \x01(\r\x12\x0f\n\x07\x63hannel\x18\x02 \x01(\r\"K\n\x0c\x46req_law_Mod\x12\x14\n\x0ctable_offset\x18\x01 \x01(\r\x12\x0f\n\x07\x65ntries\x18\x02 \x01(\r\x12\x14\n\x0c\x65ntry_clocks\x18\x03 \x01(\r\"0\n\x07Hop_Mod\x12\x14\n\x0ctable_offset\x18\x01 \x01(\r\x12\x0f\n\x07\x65ntries\x18\x02 \x01(\r\"A\n\x0e\x43ode_table_msg\x12\x0e\n\x06offset\x18\x01 \x01(\r\x12\x0e\n\x06phases\x18\x02 \x03(\r\x12\x0f\n\x07\x63hannel\x18\x03 \x01(\r\"R\n\x12\x46req_law_table_msg\x12\x0e\n\x06offset\x18\x01 \x01(\r\x12\x0c\n\x04pinc\x18\x02 \x03(\r\x12\r\n\x05slope\x18\x03 \x03(\x11\x12\x0f\n\x07\x63hannel\x18\x04 \x01(\r\"8\n\x03Hop\x12\x10\n\x08\x66req_khz\x18\x01 \x01(\r\x12\x10\n\x08\x64well_ns\x18\x02 \x01(\r\x12\r\n\x05phase\x18\x03 \x01(\r\"D\n\rHop_table_msg\x12\x0e\n\x06offset\x18\x01 \x01(\r\x12\x12\n\x04hops\x18\x02 \x03(\x0b\x32\x04.Hop\x12\x0f\n\x07\x63hannel\x18\x03 \x01(\rb\x06proto3')
+
+_builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, globals())
+_builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'generator.sw.src.messages_pb2', globals())
+if _descriptor._USE_C_DESCRIPTORS == False:
+
+  DESCRIPTOR._options = None
+  _BASE_MSG._serialized_start=35
+  _BASE_MSG._serialized_end=145
+  _CONTROL_MSG._serialized_start=148
+  _CONTROL_MSG._serialized_end=558
+  _CONTROL_MSG_COMMAND._serialized_start=321
+  _CONTROL_MSG_COMMAND._serialized_end=445
+  _CONTROL_MSG_TARGET._serialized_start=447
+  _CONTROL_MSG_TARGET._serialized_end=487
+  _CONTROL_MSG_LOG_LEVEL._serialized_start=489
+  _CONTROL_MSG_LOG_LEVEL._serialized_end=558
+  _CONFIG_MSG._serialized_start=561
+  _CONFIG_MSG._serialized_end=919
+  _ACK_MSG._serialized_start=922
+  _ACK_MSG._serialized_end=1155
+  _ACK_MSG_RETVAL._serialized_start=1036
+  _ACK_MSG_RETVAL._serialized_end=1155
+  _GENERATOR_CONFIG_MSG._serialized_start=1158
+  _GENERATOR_CONFIG_MSG._serialized_end=1582
+  _GENERATOR_CONFIG_MSG_MODE._serialized_start=1527
+  _GENERATOR_CONFIG_MSG_MODE._serialized_end=1561
+  _CONST_FREQ._serialized_start=1584
+  _CONST_FREQ._serialized_end=1614
+  _FREQ_MOD._serialized_start=1616
+  _FREQ_MOD._serialized_end=1690
+  _PHASE_MOD._serialized_start=1692
+  _PHASE_MOD._serialized_end=1780
+  _CODE_MOD._serialized_start=1783
+  _CODE_MOD._serialized_end=1957
+  _CODE_MOD_CODE._serialized_start=1904
+  _CODE_MOD_CODE._serialized_end=1957
+  _DEMODULATOR_CONFIG_MSG._serialized_start=1959
+  _DEMODULATOR_CONFIG_MSG._serialized_end=1983
+  _DEBUG_MSG._serialized_start=1985
+  _DEBUG_MSG._serialized_end=2091
+  _TASK_STATS._serialized_start=2093
+  _TASK_STATS._serialized_end=2220
+  _GENERATOR_PERF._serialized_start=2223
+  _GENERATOR_PERF._serialized_end=2416
+  _STATS_MSG._serialized_start=2419
+  _STATS_MSG._serialized_end=2634
+  _TRACE_EVENT._serialized_start=2637
+  _TRACE_EVENT._serialized_end=2932
+  _TRACE_EVENT_STAGE._serialized_start=2756
+  _TRACE_EVENT_STAGE._serialized_end=2890
+  _TRACE_EVENT_PHASE._serialized_start=2892
+  _TRACE_EVENT_PHASE._serialized_end=2932
+  _TRACE_MSG._serialized_start=2934
+  _TRACE_MSG._serialized_end=2998
+  _SEQUENCE_ENTRY._serialized_start=3000
+  _SEQUENCE_ENTRY._serialized_end=3071
+  _SEQUENCE_MSG._serialized_start=3073
+  _SEQUENCE_MSG._serialized_end=3175
+  _SAVE_PRESET_MSG._serialized_start=3177
+  _SAVE_PRESET_MSG._serialized_end=3259
+  _RECALL_PRESET_MSG._serialized_start=3261
+  _RECALL_PRESET_MSG._serialized_end=3309
+  _FREQ_LAW_MOD._serialized_start=3311
+  _FREQ_LAW_MOD._serialized_end=3386
+  _HOP_MOD._serialized_start=3388
+  _HOP_MOD._serialized_end=3436
+  _CODE_TABLE_MSG._serialized_start=3438
+  _CODE_TABLE_MSG._serialized_end=3503
+  _FREQ_LAW_TABLE_MSG._serialized_start=3505
+  _FREQ_LAW_TABLE_MSG._serialized_end=3587
+  _HOP._serialized_start=3589
+  _HOP._serialized_end=3645
+  _HOP_TABLE_MSG._serialized_start=3647
+  _HOP_TABLE_MSG._serialized_end=3715
 # @@protoc_insertion_point(module_scope)
@@ -0,0 +1,119 @@
+/**
+ * @file phase_codes.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Phase code generators for the generator code table.
+ * @date 2020-08-09
+ */
+
+#include "phase_codes.h"
+
+#define PHASE_TURN (1ULL << CODE_PHASE_BITS)
+
+/* LFSR taps (register stages) by degree, Xilinx XAPP052 table */
+static const uint16_t mls_taps[MLS_MAX_DEGREE + 1] = {
+    [2] = (1 << 1) | (1 << 0),
+    [3] = (1 << 2) | (1 << 1),
+    [4] = (1 << 3) | (1 << 2),
+    [5] = (1 << 4) | (1 << 2),
+    [6] = (1 << 5) | (1 << 4),
+    [7] = (1 << 6) | (1 << 5),
+    [8] = (1 << 7) | (1 << 5) | (1 << 4) | (1 << 3),
+    [9] = (1 << 8) | (1 << 4),
+    [10] = (1 << 9) | (1 << 6),
+    [11] = (1 << 10) | (1 << 8),
+    [12] = (1 << 11) | (1 << 5) | (1 << 3) | (1 << 0),
+};
+
+/**
+ * @brief Converts a fraction of a turn to a chip phase.
+ *
+ * @param num Numerator, any value (whole turns are dropped)
+ * @param den Denominator
+ * @return uint32_t Chip phase
+ */
+static uint32_t _phase(uint64_t num, uint64_t den)
+{
+    return (uint32_t) (((num % den) * PHASE_TURN) / den);
+}
+
+int phase_code_frank(uint32_t n, uint32_t * phases, uint32_t max_chips)
+{
+    if (n == 0 || (uint64_t) n * n > max_chips)
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            phases[i * n + j] = _phase((uint64_t) i * j, n);
+        }
+    }
+
+    return n * n;
+}
+
+int phase_code_p3(uint32_t n, uint32_t * phases, uint32_t max_chips)
+{
+    if (n == 0 || n > max_chips)
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        phases[i] = _phase((uint64_t) i * i, 2 * (uint64_t) n);
+    }
+
+    return n;
+}
+
+int phase_code_p4(uint32_t n, uint32_t * phases, uint32_t max_chips)
+{
+    if (n == 0 || n > max_chips)
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        /* i^2 - N i is negative for every chip but the first one:
+         * add whole turns (2N each) to keep it positive */
+        uint64_t num = (uint64_t) i * i + 2 * (uint64_t) n * n - (uint64_t) n * i;
+        phases[i] = _phase(num, 2 * (uint64_t) n);
+    }
+
+    return n;
+}
+
+int phase_code_mls(uint32_t degree, uint32_t * phases, uint32_t max_chips)
+{
+    uint32_t chips;
+    uint32_t state;
+
+    if (degree < MLS_MIN_DEGREE || degree > MLS_MAX_DEGREE)
+    {
+        return -1;
+    }
+
+    chips = (1U << degree) - 1;
+    if (chips > max_chips)
+    {
+        return -1;
+    }
+
+    /* Any seed but all zeros runs the whole sequence */
+    state = chips;
+    for (uint32_t i = 0; i < chips; i++)
+    {
+        uint32_t feedback = __builtin_parity(state & mls_taps[degree]);
+
+        /* Output stage is the last one, 1 keeps the carrier phase */
+        phases[i] = ((state >> (degree - 1)) & 1) ? 0 : PHASE_TURN / 2;
+        state = ((state << 1) | feedback) & chips;
+    }
+
+    return chips;
+}
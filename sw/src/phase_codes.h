@@ -0,0 +1,61 @@
+/**
+ * @file phase_codes.h
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Phase code generators for the generator code table. Chip phases are
+ * fractions of a turn, 1 << CODE_PHASE_BITS is 360°.
+ * @date 2020-08-09
+ */
+#ifndef __PHASE_CODES
+#define __PHASE_CODES
+
+#include <stdint.h>
+
+#include "generator.h"
+
+/* Maximal length sequence degrees, 2^degree - 1 chips */
+#define MLS_MIN_DEGREE 2
+#define MLS_MAX_DEGREE 12
+
+/**
+ * @brief Frank code, N x N chips. Chip (i, j) phase is i * j / N turns.
+ *
+ * @param n Code order N
+ * @param phases Destination
+ * @param max_chips Destination size
+ * @return int Number of chips, -1 on ERROR
+ */
+int phase_code_frank(uint32_t n, uint32_t * phases, uint32_t max_chips);
+
+/**
+ * @brief P3 code, N chips. Chip n phase is n^2 / 2N turns.
+ *
+ * @param n Number of chips
+ * @param phases Destination
+ * @param max_chips Destination size
+ * @return int Number of chips, -1 on ERROR
+ */
+int phase_code_p3(uint32_t n, uint32_t * phases, uint32_t max_chips);
+
+/**
+ * @brief P4 code, N chips. Chip n phase is (n^2 - N n) / 2N turns.
+ *
+ * @param n Number of chips
+ * @param phases Destination
+ * @param max_chips Destination size
+ * @return int Number of chips, -1 on ERROR
+ */
+int phase_code_p4(uint32_t n, uint32_t * phases, uint32_t max_chips);
+
+/**
+ * @brief Maximal length sequence, binary phase code (0° / 180°) from a
+ * linear feedback shift register.
+ *
+ * @param degree Register length (MLS_MIN_DEGREE to MLS_MAX_DEGREE)
+ * @param phases Destination
+ * @param max_chips Destination size
+ * @return int Number of chips (2^degree - 1), -1 on ERROR
+ */
+int phase_code_mls(uint32_t degree, uint32_t * phases, uint32_t max_chips);
+
+#endif
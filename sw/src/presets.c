@@ -0,0 +1,125 @@
+/**
+ * @file presets.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Generator preset store. Presets are only accessed from the connection
+ * loop, so no locking is needed.
+ * @date 2020-08-09
+ */
+
+#include <string.h>
+
+#include "common.h"
+#include "presets.h"
+
+#if PRESETS_PERSIST
+#include "ff.h"
+#endif
+
+#define PRESETS_MAGIC 0x50525354U
+
+typedef struct{
+    uint32_t magic;
+    /* Layout check: file is discarded if preset_t changes */
+    uint32_t size;
+    preset_t presets[PRESETS_MAX];
+}presets_store_t;
+
+static presets_store_t store;
+
+#if PRESETS_PERSIST
+static FATFS fatfs;
+
+/**
+ * @brief Loads the store from PRESETS_FILE.
+ *
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int _presets_load(void){
+    FIL fil;
+    UINT read;
+    FRESULT res;
+
+    if (f_mount(&fatfs, "0:/", 1) != FR_OK ||
+        f_open(&fil, PRESETS_FILE, FA_READ) != FR_OK){
+        return -1;
+    }
+
+    res = f_read(&fil, &store, sizeof(store), &read);
+    f_close(&fil);
+
+    if (res != FR_OK || read != sizeof(store) ||
+        store.magic != PRESETS_MAGIC || store.size != sizeof(store)){
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes the whole store to PRESETS_FILE.
+ *
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+static int _presets_write(void){
+    FIL fil;
+    UINT written;
+    FRESULT res;
+
+    if (f_open(&fil, PRESETS_FILE, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK){
+        return -1;
+    }
+
+    res = f_write(&fil, &store, sizeof(store), &written);
+    f_close(&fil);
+
+    return (res == FR_OK && written == sizeof(store)) ? 0 : -1;
+}
+#endif
+
+int presets_init(void){
+    int retval = 0;
+
+#if PRESETS_PERSIST
+    if (_presets_load() < 0){
+        log_warn("%s: No saved presets \r\n",__FUNCTION__);
+        retval = -1;
+    }
+    else{
+        return 0;
+    }
+#endif
+
+    memset(&store, 0, sizeof(store));
+    store.magic = PRESETS_MAGIC;
+    store.size = sizeof(store);
+    return retval;
+}
+
+int presets_save(uint32_t id, const char *name, const uint32_t *image){
+    preset_t *preset;
+
+    if (id >= PRESETS_MAX){
+        return -1;
+    }
+
+    preset = &store.presets[id];
+    strncpy(preset->name, name, PRESETS_NAME_SIZE - 1);
+    preset->name[PRESETS_NAME_SIZE - 1] = '\0';
+    memcpy(preset->image, image, sizeof(preset->image));
+    preset->valid = 1;
+
+#if PRESETS_PERSIST
+    if (_presets_write() < 0){
+        log_warn("%s: Preset not persisted \r\n",__FUNCTION__);
+    }
+#endif
+    return 0;
+}
+
+const preset_t *presets_get(uint32_t id){
+
+    if (id >= PRESETS_MAX || !store.presets[id].valid){
+        return NULL;
+    }
+    return &store.presets[id];
+}
@@ -0,0 +1,57 @@
+/**
+ * @file presets.h
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Generator preset store. Validated configurations are kept as register
+ * images and recalled without recomputing them.
+ * @date 2020-08-09
+ */
+#ifndef __PRESETS
+#define __PRESETS
+
+#include <stdint.h>
+
+#include "generator.h"
+
+/* Persist store to a file on the SD card (requires xilffs in the BSP) */
+#ifndef PRESETS_PERSIST
+#define PRESETS_PERSIST 0
+#endif
+
+#define PRESETS_MAX 16
+/* Must match Save_preset_msg.name max_size in messages.options */
+#define PRESETS_NAME_SIZE 16
+#define PRESETS_FILE "0:/presets.bin"
+
+typedef struct{
+    uint32_t valid;
+    char name[PRESETS_NAME_SIZE];
+    uint32_t image[GENERATOR_IMAGE_REGS];
+}preset_t;
+
+/**
+ * @brief Initializes the store, loading saved presets if persistence is enabled.
+ *
+ * @return int -1 on ERROR (store starts empty) 0 on SUCCESS
+ */
+int presets_init(void);
+
+/**
+ * @brief Saves a register image as preset, overwriting any preset with the same id.
+ *
+ * @param id Preset id (0 to PRESETS_MAX - 1)
+ * @param name Preset name, truncated to PRESETS_NAME_SIZE - 1 characters
+ * @param image Register image, GENERATOR_IMAGE_REGS words
+ * @return int -1 on ERROR 0 on SUCCESS
+ */
+int presets_save(uint32_t id, const char *name, const uint32_t *image);
+
+/**
+ * @brief Gets a saved preset.
+ *
+ * @param id Preset id
+ * @return const preset_t* NULL if id is not a saved preset
+ */
+const preset_t *presets_get(uint32_t id);
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file stats.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Runtime statistics: per task CPU load and stack usage, heap usage.
+ * Requires configUSE_TRACE_FACILITY and configGENERATE_RUN_TIME_STATS in the BSP.
+ * @date 2020-08-09
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "stats.h"
+
+/* Task status snapshot, kept off the caller stack */
+static TaskStatus_t task_status[STATS_MAX_TASKS];
+
+void stats_collect(Stats_msg *stats){
+
+    uint32_t total_run_time = 0;
+    UBaseType_t num_tasks;
+
+    /* Returns 0 if there are more tasks than STATS_MAX_TASKS */
+    num_tasks = uxTaskGetSystemState(task_status, STATS_MAX_TASKS, &total_run_time);
+
+    stats->tasks_count = num_tasks;
+    stats->total_run_time = total_run_time;
+
+    /* Avoid divide by zero when computing percentages */
+    total_run_time /= 100;
+
+    for (UBaseType_t i = 0; i < num_tasks; i++){
+        Task_stats *task = &stats->tasks[i];
+
+        strncpy(task->name, task_status[i].pcTaskName, sizeof(task->name) - 1);
+        task->name[sizeof(task->name) - 1] = '\0';
+        task->run_time_counter = task_status[i].ulRunTimeCounter;
+        task->run_time_percent = total_run_time ? task_status[i].ulRunTimeCounter / total_run_time : 0;
+        /* Minimum free stack space ever, in words */
+        task->stack_high_water_mark = task_status[i].usStackHighWaterMark;
+        task->priority = task_status[i].uxCurrentPriority;
+    }
+
+    stats->free_heap = xPortGetFreeHeapSize();
+    stats->min_free_heap = xPortGetMinimumEverFreeHeapSize();
+}
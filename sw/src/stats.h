@@ -0,0 +1,27 @@
+/**
+ * @file stats.h
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Runtime statistics reported on GET_STATS: a snapshot of the task list
+ * (run time, stack high water mark, priority) and heap usage.
+ * @date 2020-08-09
+ */
+#ifndef __STATS
+#define __STATS
+
+#include "messages.pb.h"
+
+/* Must match Stats_msg.tasks max_count in messages.options */
+#define STATS_MAX_TASKS 16
+
+/**
+ * @brief Fills statistics message with a snapshot of every task
+ * and heap usage. Cost is a single pass over the task list.
+ * Fields owned by other modules (command switches, log overflows,
+ * generator counters) are left untouched.
+ * 
+ * @param stats Protobuf statistics message to fill.
+ */
+void stats_collect(Stats_msg *stats);
+
+#endif
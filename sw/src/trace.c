@@ -0,0 +1,70 @@
+/**
+ * @file trace.c
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Command path tracepoints. Events are timestamped with the Cortex-A9 global
+ * timer and stored in a per core ring, overwriting the oldest ones.
+ * Ring is dumped to the host on TRACE_DUMP.
+ * @date 2020-08-09
+ */
+
+#include "xtime_l.h"
+#include "xpseudo_asm.h"
+
+#include "trace.h"
+
+typedef struct{
+    XTime timestamp;
+    uint8_t stage;
+    uint8_t phase;
+}trace_record_t;
+
+typedef struct{
+    /* Free running write index, slot is index % TRACE_RING_SIZE */
+    uint32_t head;
+    trace_record_t records[TRACE_RING_SIZE];
+}trace_ring_t;
+
+static trace_ring_t trace_rings[TRACE_NUM_CORES];
+
+/**
+ * @brief Returns the core running the caller (MPIDR affinity level 0).
+ */
+static inline uint32_t _core_id(){
+    return mfcp(XREG_CP15_MULTI_PROC_AFFINITY) & (TRACE_NUM_CORES - 1);
+}
+
+void trace_event(Trace_event_Stage stage, Trace_event_Phase phase){
+    trace_ring_t *ring = &trace_rings[_core_id()];
+    uint32_t index = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+    trace_record_t *record = &ring->records[index & (TRACE_RING_SIZE - 1)];
+
+    XTime_GetTime(&record->timestamp);
+    record->stage = stage;
+    record->phase = phase;
+}
+
+void trace_dump(Trace_msg *msg){
+    uint32_t head, first;
+
+    msg->events_count = 0;
+    msg->timer_freq_hz = COUNTS_PER_SECOND;
+
+    for (uint32_t core = 0; core < TRACE_NUM_CORES; core++){
+        trace_ring_t *ring = &trace_rings[core];
+
+        head = __atomic_exchange_n(&ring->head, 0, __ATOMIC_RELAXED);
+        /* Ring wrapped: older events were overwritten */
+        first = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+
+        for (uint32_t i = first; i < head; i++){
+            trace_record_t *record = &ring->records[i & (TRACE_RING_SIZE - 1)];
+            Trace_event *event = &msg->events[msg->events_count++];
+
+            event->timestamp = record->timestamp;
+            event->stage = (Trace_event_Stage) record->stage;
+            event->phase = (Trace_event_Phase) record->phase;
+            event->core = core;
+        }
+    }
+}
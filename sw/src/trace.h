@@ -0,0 +1,60 @@
+/**
+ * @file trace.h
+ * @author Santiago Abbate
+ * @brief CESE - Trabajo Final - Control de etapa digital de RADAR pulsado multipropósito.
+ * Command path tracepoints, dumped to the host on TRACE_DUMP. Tracepoints
+ * cost a ring write and compile out with TRACE_ENABLED = 0.
+ * @date 2020-08-09
+ */
+#ifndef __TRACE
+#define __TRACE
+
+#include <stdint.h>
+
+#include "messages.pb.h"
+
+/* Set to 0 to compile every tracepoint out */
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+/* Events per core, must be a power of two */
+#define TRACE_RING_SIZE 256
+#define TRACE_NUM_CORES 2
+/* Must match Trace_msg.events max_count in messages.options */
+#define TRACE_MAX_EVENTS (TRACE_RING_SIZE * TRACE_NUM_CORES)
+
+/**
+ * Tracepoint macros, stage is a Trace_event_Stage name without prefix
+ * (e.g. TRACE_BEGIN(PB_DECODE)). Safe from any task or ISR.
+ */
+#if TRACE_ENABLED
+#define TRACE_BEGIN(stage)   trace_event(Trace_event_Stage_ ## stage, Trace_event_Phase_BEGIN)
+#define TRACE_END(stage)     trace_event(Trace_event_Stage_ ## stage, Trace_event_Phase_END)
+#define TRACE_INSTANT(stage) trace_event(Trace_event_Stage_ ## stage, Trace_event_Phase_INSTANT)
+#else
+#define TRACE_BEGIN(stage)
+#define TRACE_END(stage)
+#define TRACE_INSTANT(stage)
+#endif
+
+/**
+ * @brief Records a tracepoint in the ring of the running core.
+ * Slot is claimed atomically so it is safe from any task or ISR.
+ * Use the TRACE_* macros instead of calling it.
+ * 
+ * @param stage Command path stage.
+ * @param phase Stage begin, end or instant event.
+ */
+void trace_event(Trace_event_Stage stage, Trace_event_Phase phase);
+
+/**
+ * @brief Copies every ring, oldest event first, to the trace message
+ * and empties them. Events older than the last TRACE_RING_SIZE of a
+ * core are lost.
+ * 
+ * @param msg Protobuf trace message to fill.
+ */
+void trace_dump(Trace_msg *msg);
+
+#endif
@@ -1,6 +1,6 @@
 `timescale 1ns / 1ps
 
-module axi_lite_tb();
+module axi_lite_mm2dds_mod_registers_tb();
     localparam CLK = 8;
 
     logic [31:0] config_reg_0_o;
@@ -9,6 +9,11 @@ module axi_lite_tb();
     logic [31:0] config_reg_3_o;
     logic [31:0] config_reg_4_o;
     logic [31:0] config_reg_5_o;
+    logic [31:0] config_reg_6_o;
+    logic table_wr_en_o;
+    logic [8:0] table_wr_addr_o;
+    logic [31:0] table_wr_data_o;
+    logic [3:0] table_wr_strb_o;
 
     // ### AXI4-lite slave signals #########################################
     // *** Write address signals ***
@@ -35,6 +40,16 @@ module axi_lite_tb();
     logic         S_AXI_RVALID;
 
     logic m_axis_modulation_tlast = 0;
+    logic commit_done = 0;
+    logic [63:0] ts_now = 0;
+    logic [dds_modulator_pkg::PERF_COUNTERS*32-1:0] perf = {32'd7, 32'd6, 32'd5, 32'd4, 32'd3, 32'd2, 32'd1};
+    logic [31:0] config_writes;
+
+    /* Last responses seen on the bus */
+    logic [1:0] last_bresp;
+    logic [1:0] last_rresp;
+    logic [31:0] last_rdata;
+    int write_responses = 0;
 
     /**
      * Clock & Reset
@@ -45,6 +60,31 @@ module axi_lite_tb();
     always #(CLK/2) clk_i = !clk_i;
     initial #20 resetn_i = 1;
 
+    /**
+     * Test functions
+     */
+    int clocks = 0;
+    int errors = 0;
+
+    always @(posedge clk_i) clocks++;
+
+    function automatic void fail(input string msg);
+        errors++;
+        $error("%s", msg);
+    endfunction
+
+    always @(posedge clk_i)
+    begin
+        if (S_AXI_BVALID && S_AXI_BREADY) begin
+            last_bresp <= S_AXI_BRESP;
+            write_responses <= write_responses + 1;
+        end
+        if (S_AXI_RVALID && S_AXI_RREADY) begin
+            last_rresp <= S_AXI_RRESP;
+            last_rdata <= S_AXI_RDATA;
+        end
+    end
+
     initial begin
         S_AXI_AWADDR = 0;
         S_AXI_AWVALID = 0;
@@ -85,6 +125,99 @@ module axi_lite_tb();
         #CLK
         axi_read(8'h00);
 
+        // Commit bit stays set until modulator latches config
+        axi_write(8'h00, 4'h5);
+        axi_read(8'h00);
+        #1us
+        commit_done = 1;
+        #CLK
+        commit_done = 0;
+        #CLK
+        axi_read(8'h00);
+
+        // Sequencer length and table writes
+        axi_write(12'h018, 2);
+        axi_read(12'h018);
+        // Entry 1, word 5 (repeat count)
+        axi_write(12'h834, 3);
+
+        // Byte strobes: only lane 1 is written
+        axi_write(8'h08, 32'h11223344);
+        axi_write_strb(8'h08, 32'hAABBCCDD, 4'b0010);
+        if (config_reg_2_o != 32'h1122CC44)
+            fail($sformatf("WSTRB merge: REG_2 = %h", config_reg_2_o));
+
+        // Read only and unmapped addresses answer SLVERR
+        axi_write(8'h1c, 1);
+        if (last_bresp != 2'b10)
+            fail($sformatf("Write to REG_7: BRESP = %b", last_bresp));
+        axi_write(8'h68, 1);
+        if (last_bresp != 2'b10)
+            fail($sformatf("Write to unmapped address: BRESP = %b", last_bresp));
+        axi_write(8'h04, 1);
+        if (last_bresp != 2'b00)
+            fail($sformatf("Write to REG_1: BRESP = %b", last_bresp));
+        axi_read(12'h800);
+        if (last_rresp != 2'b10)
+            fail($sformatf("Read from table: RRESP = %b", last_rresp));
+        // DDS clock frequency is read only
+        axi_read(8'h20);
+        if (last_rresp != 2'b00 || last_rdata != 125000)
+            fail($sformatf("Read from REG_8: RRESP = %b, RDATA = %0d", last_rresp, last_rdata));
+        axi_write(8'h20, 1);
+        if (last_bresp != 2'b10)
+            fail($sformatf("Write to REG_8: BRESP = %b", last_bresp));
+        // Samples per DDS clock, read only
+        axi_read(8'h24);
+        if (last_rresp != 2'b00 || last_rdata != 1)
+            fail($sformatf("Read from REG_9: RRESP = %b, RDATA = %0d", last_rresp, last_rdata));
+        axi_write(8'h24, 1);
+        if (last_bresp != 2'b10)
+            fail($sformatf("Write to REG_9: BRESP = %b", last_bresp));
+        // Timestamp high word is held when the low word is read
+        ts_now = 64'h0000_0001_ffff_fffe;
+        axi_read(8'h28);
+        if (last_rresp != 2'b00 || last_rdata != 32'hffff_fffe)
+            fail($sformatf("Read from REG_10: RRESP = %b, RDATA = %h", last_rresp, last_rdata));
+        ts_now = 64'h0000_0002_0000_0001;
+        axi_read(8'h2c);
+        if (last_rresp != 2'b00 || last_rdata != 32'h0000_0001)
+            fail($sformatf("Read from REG_11: RRESP = %b, RDATA = %h", last_rresp, last_rdata));
+        axi_write(8'h28, 1);
+        if (last_bresp != 2'b10)
+            fail($sformatf("Write to REG_10: BRESP = %b", last_bresp));
+        // Performance counters: DDS side ones pass through, config writes
+        // count only accepted REG_0 to REG_6 writes
+        for (int c = 0; c < 5; c++) begin
+            axi_read(8'h48 + 4 * c);
+            if (last_rresp != 2'b00 || last_rdata != c + 1)
+                fail($sformatf("Read from REG_%0d: RRESP = %b, RDATA = %0d", 18 + c, last_rresp, last_rdata));
+        end
+        // Trigger counters, after the config writes counter
+        for (int c = 0; c < 2; c++) begin
+            axi_read(8'h60 + 4 * c);
+            if (last_rresp != 2'b00 || last_rdata != dds_modulator_pkg::PERF_TRIGGERS + c + 1)
+                fail($sformatf("Read from REG_%0d: RRESP = %b, RDATA = %0d", 24 + c, last_rresp, last_rdata));
+        end
+        axi_write(8'h60, 1);
+        if (last_bresp != 2'b10)
+            fail($sformatf("Write to REG_24: BRESP = %b", last_bresp));
+        axi_read(8'h5c);
+        config_writes = last_rdata;
+        axi_write(8'h04, 1);
+        axi_write(8'h48, 1);
+        axi_write(12'h800, 1);
+        axi_read(8'h5c);
+        if (last_rresp != 2'b00 || last_rdata != config_writes + 1)
+            fail($sformatf("Config writes: %0d, expected %0d", last_rdata, config_writes + 1));
+
+        // Register write throughput, one transaction at a time vs back to back
+        axi_write_throughput(12'h800, 64);
+
+        if (errors == 0)
+            $display("axi_lite_mm2dds_mod_registers_tb: PASS, %0d clocks", clocks);
+        else
+            $error("axi_lite_mm2dds_mod_registers_tb: FAIL, %0d clocks, %0d errors", clocks, errors);
         $finish;
     end
     
@@ -96,6 +229,17 @@ module axi_lite_tb();
     .config_reg_3_o,
     .config_reg_4_o,
     .config_reg_5_o,
+    .config_reg_6_o,
+    .table_wr_en_o,
+    .table_wr_addr_o,
+    .table_wr_data_o,
+    .table_wr_strb_o,
+    .seq_status_i(32'b0),
+    .ts_now_i(ts_now),
+    .ts_pulse_i(64'b0),
+    .ts_commit_i(64'b0),
+    .ts_capture_i(64'b0),
+    .perf_i(perf),
 
     // ### Clock and reset signals #########################################
     .S_AXI_CLK(clk_i),
@@ -125,13 +269,23 @@ module axi_lite_tb();
     .S_AXI_RRESP,
     .S_AXI_RVALID,
 
-    .dbg_tlast(m_axis_modulation_tlast) 
+    .dbg_tlast(m_axis_modulation_tlast),
+    .commit_done
 );
 
 
 task axi_write;
     input [31:0] awaddr;
     input [31:0] wdata; 
+    begin
+        axi_write_strb(awaddr, wdata, 4'hf);
+    end
+endtask
+
+task axi_write_strb;
+    input [31:0] awaddr;
+    input [31:0] wdata; 
+    input [3:0] wstrb;
     begin
         // *** Write address ***
         S_AXI_AWADDR = awaddr;
@@ -140,7 +294,7 @@ task axi_write;
         S_AXI_AWVALID = 0;
         // *** Write data ***
         S_AXI_WDATA = wdata;
-        S_AXI_WSTRB = 4'hf;
+        S_AXI_WSTRB = wstrb;
         S_AXI_WVALID = 1; 
         #CLK;
         S_AXI_WVALID = 0;
@@ -148,6 +302,60 @@ task axi_write;
     end
 endtask
 
+/*
+ * Writes count words from base, holding AWVALID and WVALID high.
+ * Address and data advance on every cycle the slave is ready.
+ */
+task axi_write_burst;
+    input [31:0] base;
+    input integer count;
+    integer sent;
+    begin
+        sent = 0;
+        S_AXI_WSTRB = 4'hf;
+        while (sent < count) begin
+            S_AXI_AWADDR = base + 4 * sent;
+            S_AXI_WDATA = sent;
+            S_AXI_AWVALID = 1;
+            S_AXI_WVALID = 1;
+            if (S_AXI_AWREADY && S_AXI_WREADY)
+                sent = sent + 1;
+            #CLK;
+        end
+        S_AXI_AWVALID = 0;
+        S_AXI_WVALID = 0;
+    end
+endtask
+
+/*
+ * Reports clock cycles per write for count writes done as separate
+ * address/data/response transactions and as a back to back burst.
+ */
+task axi_write_throughput;
+    input [31:0] base;
+    input integer count;
+    integer responses;
+    time t_start;
+    begin
+        responses = write_responses;
+        t_start = $time;
+        for (int i = 0; i < count; i++)
+            axi_write(base + 4 * i, i);
+        #CLK;
+        $display("Sequential writes: %0d writes, %0d cycles",
+                 write_responses - responses, ($time - t_start) / CLK);
+
+        responses = write_responses;
+        t_start = $time;
+        axi_write_burst(base, count);
+        #CLK;
+        $display("Back to back writes: %0d writes, %0d cycles",
+                 write_responses - responses, ($time - t_start) / CLK);
+        if (write_responses - responses != count)
+            fail($sformatf("Back to back writes: %0d responses", write_responses - responses));
+    end
+endtask
+
 task axi_read;
     input [31:0] araddr; 
     begin
@@ -2,8 +2,21 @@
 
 import dds_modulator_pkg::*;
 
+/**
+ * Self checking testbench of a generator channel from the AXI-Lite bus:
+ * registers, clock domain crossing, sequencer, table loader and
+ * modulator. The modulator output is compared every DDS clock by
+ * dds_modulator_scoreboard, register reads are checked here.
+ *
+ * Headless, see tb/Makefile:
+ *   make axi_lite_mm2dds_mod_tb         (Verilator)
+ *   make SIM=icarus axi_lite_mm2dds_mod_tb
+ */
 module axi_lite_mm2dds_mod_tb();
-    localparam CLK = 8;
+    // AXI clock, DDS clock runs apart as in mm2s_dds_modulator
+    localparam CLK = 10;
+    // Waveform values are computed for FCLK_MHZ
+    localparam DDS_CLK = 1000 / FCLK_MHZ;
 
     logic [31:0] config_reg_0;
     logic [31:0] config_reg_1;
@@ -11,6 +24,55 @@ module axi_lite_mm2dds_mod_tb();
     logic [31:0] config_reg_3;
     logic [31:0] config_reg_4;
     logic [31:0] config_reg_5;
+    logic [31:0] config_reg_6;
+
+    // Registers after clock domain crossing
+    logic [31:0] dds_reg_0;
+    logic [31:0] dds_reg_1;
+    logic [31:0] dds_reg_2;
+    logic [31:0] dds_reg_3;
+    logic [31:0] dds_reg_4;
+    logic [31:0] dds_reg_5;
+    logic [31:0] dds_reg_6;
+    logic dds_commit_done;
+    logic dbg_tlast;
+    logic [31:0] seq_status;
+    /* Timestamps, DDS side from modulator and AXI side to registers */
+    logic [TIMESTAMP_BITS-1:0] dds_ts_now, dds_ts_pulse, dds_ts_commit, dds_ts_capture;
+    logic [TIMESTAMP_BITS-1:0] ts_now, ts_pulse, ts_commit, ts_capture;
+    logic [PERF_COUNTERS*32-1:0] dds_perf, perf;
+
+    // Sequencer
+    logic table_wr_en;
+    logic [8:0] table_wr_addr;
+    logic [31:0] table_wr_data;
+    logic [3:0] table_wr_strb;
+    logic seq_wr_en;
+    logic [8:0] seq_wr_addr;
+    logic [31:0] seq_wr_data;
+    logic [3:0] seq_wr_strb;
+    logic code_wr_en;
+    logic [11:0] code_wr_addr;
+    logic [31:0] code_wr_data;
+    logic pinc_wr_en;
+    logic [11:0] pinc_wr_addr;
+    logic [31:0] pinc_wr_data;
+    logic hop_wr_en;
+    logic [9:0] hop_wr_addr;
+    logic [31:0] hop_wr_data;
+    logic [5:0] seq_index;
+
+    // Table loader stream (DMA MM2S)
+    logic [31:0] s_axis_table_tdata = 0;
+    logic s_axis_table_tvalid = 0;
+    logic s_axis_table_tlast = 0;
+    logic s_axis_table_tready;
+    logic [31:0] mod_reg_0;
+    logic [31:0] mod_reg_1;
+    logic [31:0] mod_reg_2;
+    logic [31:0] mod_reg_3;
+    logic [31:0] mod_reg_4;
+    logic [31:0] mod_reg_5;
 
     // ### AXI4-lite slave signals #########################################
     // *** Write address signals ***
@@ -40,7 +102,14 @@ module axi_lite_mm2dds_mod_tb();
     logic [71:0] m_axis_modulation_tdata;
     logic m_axis_modulation_tvalid;
     logic m_axis_modulation_tlast;
+    logic m_axis_modulation_tuser;
     logic m_axis_modulation_tready = 1;
+    logic dds_en;
+    logic commit_done;
+
+    /* Last read response seen on the bus */
+    logic [1:0] last_rresp;
+    logic [31:0] last_rdata;
 
     /**
      * Clock & Reset
@@ -49,13 +118,33 @@ module axi_lite_mm2dds_mod_tb();
     logic clk_i = 0;
     logic resetn_i = 0;
     always #(CLK/2) clk_i = !clk_i;
+    logic dds_clk_i = 0;
+    always #(DDS_CLK/2) dds_clk_i = !dds_clk_i;
     initial #20 resetn_i = 1;
 
+    always @(posedge clk_i)
+    begin
+        if (S_AXI_RVALID && S_AXI_RREADY) begin
+            last_rresp <= S_AXI_RRESP;
+            last_rdata <= S_AXI_RDATA;
+        end
+    end
+
     logic [31:0] cfg2 = 0;
     
     int unsigned pinc_low; 
     int unsigned pinc_high; 
     int unsigned delta_pinc;
+
+    // Phase code chips, in turns / 2^CODE_PHASE_BITS
+    logic [31:0] p4_code [];
+    // Frequency law entries, {PINC, slope} word pairs
+    logic [31:0] pinc_law [];
+    real law_x;
+    int law_pinc [33];
+    // Hop pattern, {PINC, phase/dwell} word pairs
+    logic [31:0] hops [];
+    int hop_order [8] = '{1, 3, 6, 2, 8, 7, 5, 4};
     
     /**
      * Test
@@ -109,6 +198,110 @@ module axi_lite_mm2dds_mod_tb();
         axi_write(8'h00,3);
         
         #1100us
+        // Capture is MAX_DEBUG_PACKETS clocks
+        scoreboard.check_count("captures", 1, scoreboard.captures);
+        // Live change: pulse length 100us, latched at next period wrap
+        cfg2 [30:16] = 100 * FCLK_MHZ;
+        axi_write(8'h08,cfg2);
+        axi_write(8'h00,1 | (1 << COMMIT_BIT));
+        // Commit bit reads 1 until latched
+        axi_read(8'h00);
+        scoreboard.check_count("REG_0 commit pending", 1, last_rdata[COMMIT_BIT]);
+        #300us
+        axi_read(8'h00);
+        scoreboard.check_count("REG_0 commit done", 0, last_rdata[COMMIT_BIT]);
+        scoreboard.check_count("commits", 1, scoreboard.commits);
+        #500us
+
+        // Sequencer: 1 MHz pulse (played twice), then 1 to 5 MHz chirp
+        axi_write(8'h00,0);
+        seq_write_entry(0, PULS_NO_MOD_TB, 20, 5, (1 * (2 ** PINC_BITS)) / FCLK_MHZ, 0, 0, 2);
+        // Entry 1 is loaded through the table loader stream
+        seq_load_entry(1, PULS_MOD_FREC, 30, 10, pinc_low, pinc_high,
+                       (pinc_high - pinc_low) / (10 * FCLK_MHZ), 1);
+        axi_write(12'h018, 2);
+        // Enable modulator from sequencer
+        axi_write(8'h00,1 | (1 << SEQ_EN_BIT));
+        #300us
+        // Current entry
+        axi_read(12'h01c);
+        if (last_rresp != 2'b00 || last_rdata >= 2)
+            scoreboard.mismatch("sequencer entry below 2", 1, last_rdata);
+        axi_write(8'h00,0);
+        #50us
+
+        // Polyphase code from code table: 16 chip P4 code at chip 100
+        p4_code = new[16];
+        for (int n = 0; n < 16; n++)
+            p4_code[n] = (((n * n - 16 * n) % 32 + 32) % 32) * (2 ** CODE_PHASE_BITS / 32);
+        table_load(TABLE_CODE, 100, p4_code);
+        axi_write(8'h04, PULS_MOD_PHASE | (1 << CODE_TABLE_BIT));
+        cfg2 [30:16] = 32 * FCLK_MHZ;
+        cfg2 [14:0] = 50 * FCLK_MHZ;
+        axi_write(8'h08, cfg2);
+        axi_write(8'h0c, (5 * (2 ** PINC_BITS)) / FCLK_MHZ);
+        // 2 us chips
+        axi_write(8'h10, 2 * FCLK_MHZ - 1);
+        axi_write(8'h14, (100 << 16) | 16);
+        axi_write(8'h00, 1);
+        #200us
+        axi_write(8'h00, 0);
+        #10us
+
+        // Non-linear FM from PINC table: cubic law 1 to 5 MHz, 32 entries
+        // of 125 clocks (32 us pulse), interpolated between entries
+        for (int k = 0; k <= 32; k++) begin
+            law_x = 2.0 * k / 32 - 1.0;
+            law_pinc[k] = int'((3.0 + 2.0 * law_x * law_x * law_x) * (2.0 ** PINC_BITS) / FCLK_MHZ);
+        end
+        pinc_law = new[64];
+        for (int k = 0; k < 32; k++) begin
+            pinc_law[2 * k] = law_pinc[k];
+            pinc_law[2 * k + 1] = ((law_pinc[k + 1] - law_pinc[k]) * (2 ** PINC_SLOPE_FRAC_BITS)) / 125;
+        end
+        table_load(TABLE_PINC, 0, pinc_law);
+        axi_write(8'h04, PULS_MOD_FREC | (1 << PINC_TABLE_BIT));
+        axi_write(8'h08, cfg2);
+        axi_write(8'h10, 125 - 1);
+        axi_write(8'h14, (0 << 16) | 32);
+        axi_write(8'h00, 1);
+        #200us
+        axi_write(8'h00, 0);
+        #10us
+
+        // Frequency hopping from hop table: 8 dwells of 4 us at 1..8 MHz
+        // (Costas-like order), odd dwells shifted 90°, at entry 10
+        hops = new[16];
+        foreach (hop_order[k]) begin
+            hops[2 * k] = (hop_order[k] * (2 ** PINC_BITS)) / FCLK_MHZ;
+            hops[2 * k + 1] = ((k % 2) * (2 ** CODE_PHASE_BITS / 4) << 16) | (4 * FCLK_MHZ - 1);
+        end
+        table_load(TABLE_HOP, 2 * 10, hops);
+        axi_write(8'h04, PULS_MOD_FREC | (1 << HOP_TABLE_BIT));
+        axi_write(8'h08, cfg2);
+        axi_write(8'h14, (10 << 16) | 8);
+        axi_write(8'h00, 1);
+        #200us
+        axi_write(8'h00, 0);
+        #10us
+
+        // Continuous modes from the same tables: P4 code and hop pattern
+        axi_write(8'h04, CONT_MOD_PHASE | (1 << CODE_TABLE_BIT));
+        axi_write(8'h0c, (5 * (2 ** PINC_BITS)) / FCLK_MHZ);
+        axi_write(8'h10, 2 * FCLK_MHZ - 1);
+        axi_write(8'h14, (100 << 16) | 16);
+        axi_write(8'h00, 1);
+        #100us
+        axi_write(8'h00, 0);
+        #10us
+        axi_write(8'h04, CONT_MOD_FREC | (1 << HOP_TABLE_BIT));
+        axi_write(8'h14, (10 << 16) | 8);
+        axi_write(8'h00, 1);
+        #100us
+        axi_write(8'h00, 0);
+        #10us
+
+        scoreboard.report("axi_lite_mm2dds_mod_tb", 1);
         $finish;
     end
     
@@ -120,6 +313,17 @@ module axi_lite_mm2dds_mod_tb();
     .config_reg_3_o(config_reg_3),
     .config_reg_4_o(config_reg_4),
     .config_reg_5_o(config_reg_5),
+    .config_reg_6_o(config_reg_6),
+    .table_wr_en_o(table_wr_en),
+    .table_wr_addr_o(table_wr_addr),
+    .table_wr_data_o(table_wr_data),
+    .table_wr_strb_o(table_wr_strb),
+    .seq_status_i(seq_status),
+    .ts_now_i(ts_now),
+    .ts_pulse_i(ts_pulse),
+    .ts_commit_i(ts_commit),
+    .ts_capture_i(ts_capture),
+    .perf_i(perf),
 
     // ### Clock and reset signals #########################################
     .S_AXI_CLK(clk_i),
@@ -149,23 +353,162 @@ module axi_lite_mm2dds_mod_tb();
     .S_AXI_RRESP,
     .S_AXI_RVALID,
 
-    .dbg_tlast(m_axis_modulation_tlast) 
+    .dbg_tlast(dbg_tlast),
+    .commit_done
 );
 
-dds_modulator modulator(
+dds_config_cdc config_cdc(
+        .axi_clk_i(clk_i),
+        .axi_resetn_i(resetn_i),
+        .config_reg_0_i(config_reg_0),
+        .config_reg_1_i(config_reg_1),
+        .config_reg_2_i(config_reg_2),
+        .config_reg_3_i(config_reg_3),
+        .config_reg_4_i(config_reg_4),
+        .config_reg_5_i(config_reg_5),
+        .config_reg_6_i(config_reg_6),
+        .commit_done_o(commit_done),
+        .dbg_tlast_o(dbg_tlast),
+        .seq_status_o(seq_status),
+        .ts_now_o(ts_now),
+        .ts_pulse_o(ts_pulse),
+        .ts_commit_o(ts_commit),
+        .ts_capture_o(ts_capture),
+        .perf_o(perf),
+        .dds_clk_i(dds_clk_i),
+        .dds_resetn_i(resetn_i),
+        .config_reg_0_o(dds_reg_0),
+        .config_reg_1_o(dds_reg_1),
+        .config_reg_2_o(dds_reg_2),
+        .config_reg_3_o(dds_reg_3),
+        .config_reg_4_o(dds_reg_4),
+        .config_reg_5_o(dds_reg_5),
+        .config_reg_6_o(dds_reg_6),
+        .commit_done_i(dds_commit_done),
+        .dbg_tlast_i(m_axis_modulation_tlast),
+        .seq_status_i({26'b0, seq_index}),
+        .ts_now_i(dds_ts_now),
+        .ts_pulse_i(dds_ts_pulse),
+        .ts_commit_i(dds_ts_commit),
+        .ts_capture_i(dds_ts_capture),
+        .perf_i(dds_perf)
+    );
+
+dds_sequencer sequencer(
+        .clk_i(dds_clk_i),
+        .resetn_i(resetn_i),
+        .wr_clk_i(clk_i),
+        .config_reg_0(dds_reg_0),
+        .config_reg_1(dds_reg_1),
+        .config_reg_2(dds_reg_2),
+        .config_reg_3(dds_reg_3),
+        .config_reg_4(dds_reg_4),
+        .config_reg_5(dds_reg_5),
+        .seq_length_i(dds_reg_6),
+        .table_wr_en_i(seq_wr_en),
+        .table_wr_addr_i(seq_wr_addr),
+        .table_wr_data_i(seq_wr_data),
+        .table_wr_strb_i(seq_wr_strb),
+        .mod_reg_0(mod_reg_0),
+        .mod_reg_1(mod_reg_1),
+        .mod_reg_2(mod_reg_2),
+        .mod_reg_3(mod_reg_3),
+        .mod_reg_4(mod_reg_4),
+        .mod_reg_5(mod_reg_5),
+        .commit_done_i(dds_commit_done),
+        .seq_index_o(seq_index)
+    );
+
+dds_table_loader #(.CHANNEL(0)) table_loader(
         .clk_i(clk_i),
         .resetn_i(resetn_i),
-        .dds_en_o(dds_en_o),
+        .s_axis_table_tdata,
+        .s_axis_table_tvalid,
+        .s_axis_table_tlast,
+        .s_axis_table_tready,
+        .axi_wr_en_i(table_wr_en),
+        .axi_wr_addr_i(table_wr_addr),
+        .axi_wr_data_i(table_wr_data),
+        .axi_wr_strb_i(table_wr_strb),
+        .seq_wr_en_o(seq_wr_en),
+        .seq_wr_addr_o(seq_wr_addr),
+        .seq_wr_data_o(seq_wr_data),
+        .seq_wr_strb_o(seq_wr_strb),
+        .code_wr_en_o(code_wr_en),
+        .code_wr_addr_o(code_wr_addr),
+        .code_wr_data_o(code_wr_data),
+        .pinc_wr_en_o(pinc_wr_en),
+        .pinc_wr_addr_o(pinc_wr_addr),
+        .pinc_wr_data_o(pinc_wr_data),
+        .hop_wr_en_o(hop_wr_en),
+        .hop_wr_addr_o(hop_wr_addr),
+        .hop_wr_data_o(hop_wr_data)
+    );
+
+dds_modulator modulator(
+        .clk_i(dds_clk_i),
+        .resetn_i(resetn_i),
+        .wr_clk_i(clk_i),
+        .dds_en_o(dds_en),
         .m_axis_modulation_tdata(m_axis_modulation_tdata),
         .m_axis_modulation_tvalid(m_axis_modulation_tvalid),
         .m_axis_modulation_tlast(m_axis_modulation_tlast),
+        .m_axis_modulation_tuser(m_axis_modulation_tuser),
+        .m_axis_modulation_tready(m_axis_modulation_tready),
+        .config_reg_0(mod_reg_0),
+        .config_reg_1(mod_reg_1),
+        .config_reg_2(mod_reg_2),
+        .config_reg_3(mod_reg_3),
+        .config_reg_4(mod_reg_4),
+        .config_reg_5(mod_reg_5),
+        .commit_done_o(dds_commit_done),
+        .capture_trig_i(1'b0),
+        .ts_now_o(dds_ts_now),
+        .ts_pulse_o(dds_ts_pulse),
+        .ts_commit_o(dds_ts_commit),
+        .ts_capture_o(dds_ts_capture),
+        .perf_o(dds_perf),
+        .trig_received_i(1'b0),
+        .trig_missed_i(1'b0),
+        .period_end_o(),
+        .code_wr_en_i(code_wr_en),
+        .code_wr_addr_i(code_wr_addr),
+        .code_wr_data_i(code_wr_data),
+        .pinc_wr_en_i(pinc_wr_en),
+        .pinc_wr_addr_i(pinc_wr_addr),
+        .pinc_wr_data_i(pinc_wr_data),
+        .hop_wr_en_i(hop_wr_en),
+        .hop_wr_addr_i(hop_wr_addr),
+        .hop_wr_data_i(hop_wr_data)
+    );
+
+dds_modulator_scoreboard scoreboard(
+        .clk_i(dds_clk_i),
+        .resetn_i(resetn_i),
+        .wr_clk_i(clk_i),
+        .config_reg_0(mod_reg_0),
+        .config_reg_1(mod_reg_1),
+        .config_reg_2(mod_reg_2),
+        .config_reg_3(mod_reg_3),
+        .config_reg_4(mod_reg_4),
+        .config_reg_5(mod_reg_5),
+        .capture_trig_i(1'b0),
         .m_axis_modulation_tready(m_axis_modulation_tready),
-        .config_reg_0(config_reg_0),
-        .config_reg_1(config_reg_1),
-        .config_reg_2(config_reg_2),
-        .config_reg_3(config_reg_3),
-        .config_reg_4(config_reg_4),
-        .config_reg_5(config_reg_5)
+        .code_wr_en_i(code_wr_en),
+        .code_wr_addr_i(code_wr_addr),
+        .code_wr_data_i(code_wr_data),
+        .pinc_wr_en_i(pinc_wr_en),
+        .pinc_wr_addr_i(pinc_wr_addr),
+        .pinc_wr_data_i(pinc_wr_data),
+        .hop_wr_en_i(hop_wr_en),
+        .hop_wr_addr_i(hop_wr_addr),
+        .hop_wr_data_i(hop_wr_data),
+        .dds_en_o(dds_en),
+        .m_axis_modulation_tdata(m_axis_modulation_tdata),
+        .m_axis_modulation_tvalid(m_axis_modulation_tvalid),
+        .m_axis_modulation_tlast(m_axis_modulation_tlast),
+        .m_axis_modulation_tuser(m_axis_modulation_tuser),
+        .commit_done_o(dds_commit_done)
     );
 
 task axi_write;
@@ -187,6 +530,71 @@ task axi_write;
     end
 endtask
 
+// Write a sequencer table entry (period and pulse length in us)
+task seq_write_entry;
+    input int unsigned index;
+    input [2:0] mode;
+    input int unsigned period_us;
+    input int unsigned pulse_us;
+    input [31:0] reg_3;
+    input [31:0] reg_4;
+    input [31:0] reg_5;
+    input int unsigned repeat_count;
+    logic [31:0] base;
+    begin
+        base = SEQ_TABLE_BASE + index * SEQ_ENTRY_WORDS * 4;
+        axi_write(base + 'h00, mode);
+        axi_write(base + 'h04, ((pulse_us * FCLK_MHZ) << 16) | (period_us * FCLK_MHZ));
+        axi_write(base + 'h08, reg_3);
+        axi_write(base + 'h0c, reg_4);
+        axi_write(base + 'h10, reg_5);
+        axi_write(base + 'h14, repeat_count);
+    end
+endtask
+
+// Table loader packet: header, then words from addr (one word per clock)
+task table_load;
+    input [3:0] target;
+    input [15:0] addr;
+    input logic [31:0] words [];
+    begin
+        s_axis_table_tdata = {target, 4'd0, 8'd0, addr};
+        s_axis_table_tlast = 0;
+        s_axis_table_tvalid = 1;
+        #CLK;
+        foreach (words[i]) begin
+            s_axis_table_tdata = words[i];
+            s_axis_table_tlast = (i == words.size() - 1);
+            #CLK;
+        end
+        s_axis_table_tvalid = 0;
+        s_axis_table_tlast = 0;
+    end
+endtask
+
+// Same as seq_write_entry, through the table loader
+task seq_load_entry;
+    input int unsigned index;
+    input [2:0] mode;
+    input int unsigned period_us;
+    input int unsigned pulse_us;
+    input [31:0] reg_3;
+    input [31:0] reg_4;
+    input [31:0] reg_5;
+    input int unsigned repeat_count;
+    logic [31:0] words [];
+    begin
+        words = new[SEQ_REPEAT_WORD + 1];
+        words[0] = mode;
+        words[1] = ((pulse_us * FCLK_MHZ) << 16) | (period_us * FCLK_MHZ);
+        words[2] = reg_3;
+        words[3] = reg_4;
+        words[4] = reg_5;
+        words[5] = repeat_count;
+        table_load(TABLE_SEQUENCER, index * SEQ_ENTRY_WORDS, words);
+    end
+endtask
+
 task axi_read;
     input [31:0] araddr; 
     begin
@@ -0,0 +1,382 @@
+`timescale 1ns / 1ps
+
+import dds_modulator_pkg::*;
+
+/**
+ * Scoreboard for dds_modulator, shared by the testbenches. Watches the
+ * modulator ports and compares every clock against a reference model.
+ *
+ * The reference is written from the waveform definitions, not from the
+ * RTL pipeline: a beat is a function of the latched config and of the
+ * position in the period (pulsed modes) or the clocks since the config
+ * was latched (continuous modes). Chips and table entries follow from
+ * the position, the linear ramp restarts when it reaches its stop value.
+ * Table contents are snooped from the write ports.
+ *
+ * Checked on every clock: tdata (valid and prime beats), tvalid, tlast,
+ * tuser, dds_en_o and commit_done_o. Debug captures are also framed: TUSER to
+ * TLAST must be DEBUG_PACKETS valid beats. errors, beats per mode and
+ * captures are read by the testbench, report() prints the summary.
+ */
+module dds_modulator_scoreboard #(parameter DDS_LANES = 1)(
+    input clk_i,
+    input resetn_i,
+    input wr_clk_i,
+    /* dds_modulator inputs */
+    input [31:0] config_reg_0,
+    input [31:0] config_reg_1,
+    input [31:0] config_reg_2,
+    input [31:0] config_reg_3,
+    input [31:0] config_reg_4,
+    input [31:0] config_reg_5,
+    input capture_trig_i,
+    input m_axis_modulation_tready,
+    input code_wr_en_i,
+    input [$clog2(CODE_DEPTH) - 1:0] code_wr_addr_i,
+    input [31:0] code_wr_data_i,
+    input pinc_wr_en_i,
+    input [$clog2(2 * PINC_DEPTH) - 1:0] pinc_wr_addr_i,
+    input [31:0] pinc_wr_data_i,
+    input hop_wr_en_i,
+    input [$clog2(2 * HOP_DEPTH) - 1:0] hop_wr_addr_i,
+    input [31:0] hop_wr_data_i,
+    /* dds_modulator outputs */
+    input dds_en_o,
+    input [71:0] m_axis_modulation_tdata,
+    input m_axis_modulation_tvalid,
+    input m_axis_modulation_tlast,
+    input m_axis_modulation_tuser,
+    input commit_done_o
+    );
+
+    localparam DEBUG_PACKETS = MAX_DEBUG_PACKETS / DDS_LANES;
+
+    /* Modes, index of beats[] */
+    localparam M_NONE = 0;
+    localparam M_CONT_NO_MOD = 1;
+    localparam M_CONT_MOD_FREC = 2;
+    localparam M_CONT_MOD_PHASE = 3;
+    localparam M_PULS_NO_MOD = 4;
+    localparam M_PULS_MOD_FREC = 5;
+    localparam M_PULS_MOD_PHASE = 6;
+
+    function automatic int ref_mode(input logic [31:0] reg_1);
+        casez (reg_1[STATE_BITS-1:0])
+            CONT_NO_MOD:    return M_CONT_NO_MOD;
+            CONT_MOD_FREC:  return M_CONT_MOD_FREC;
+            CONT_MOD_PHASE: return M_CONT_MOD_PHASE;
+            PULS_NO_MOD:    return M_PULS_NO_MOD;
+            PULS_MOD_FREC:  return M_PULS_MOD_FREC;
+            default:        return M_PULS_MOD_PHASE;
+        endcase
+    endfunction
+
+    /* Results, read by the testbench */
+    int clocks = 0;
+    int errors = 0;
+    int beats [7];
+    int captures = 0;
+    int commits = 0;
+    int primes = 0;
+
+    /**
+     * Tables, as written through the ports
+     */
+    logic [CODE_PHASE_BITS-1:0] code_mem [CODE_DEPTH];
+    logic [PINC_BITS-1:0] pinc_mem [PINC_DEPTH];
+    logic signed [31:0] slope_mem [PINC_DEPTH];
+    logic [PINC_BITS-1:0] hop_pinc_mem [HOP_DEPTH];
+    logic [31:0] hop_dwell_mem [HOP_DEPTH];
+
+    always @(posedge wr_clk_i)
+    begin
+        if (code_wr_en_i)
+            code_mem[code_wr_addr_i] = code_wr_data_i[CODE_PHASE_BITS-1:0];
+        if (pinc_wr_en_i && !pinc_wr_addr_i[0])
+            pinc_mem[pinc_wr_addr_i >> 1] = pinc_wr_data_i[PINC_BITS-1:0];
+        if (pinc_wr_en_i && pinc_wr_addr_i[0])
+            slope_mem[pinc_wr_addr_i >> 1] = pinc_wr_data_i;
+        if (hop_wr_en_i && !hop_wr_addr_i[0])
+            hop_pinc_mem[hop_wr_addr_i >> 1] = hop_wr_data_i[PINC_BITS-1:0];
+        if (hop_wr_en_i && hop_wr_addr_i[0])
+            hop_dwell_mem[hop_wr_addr_i >> 1] = hop_wr_data_i;
+    end
+
+    /**
+     * Reference model state
+     */
+    logic [31:0] act_1, act_2, act_3, act_4, act_5;   // Latched config
+    int mode = M_NONE;
+    int unsigned period_count = 0;      // Position in the period
+    longint unsigned since_load = 0;    // Clocks since the config was latched
+    int unsigned packets = 0;           // Capture beats sent
+    bit capture_done = 0;
+
+    /* Hop walk, entry and clock in the entry at hop_pos */
+    longint unsigned hop_pos = 0;
+    int unsigned hop_entry = 0, hop_clock = 0;
+
+    /* Expected registered outputs, compared on the next clock */
+    bit known = 0;
+    logic [71:0] exp_tdata = 0;
+    bit exp_tvalid = 0, exp_tlast = 0, exp_tuser = 0, exp_dds_en = 0, exp_prime = 0;
+
+    /* Capture framing */
+    bit in_capture = 0;
+    int unsigned capture_beats = 0;
+
+    /* Clocks of a table entry or chip, config_reg_4 = length - 1 */
+    function automatic longint unsigned chip_clocks();
+        return longint'(act_4[PINC_BITS-1:0]) + 1;
+    endfunction
+
+    /* Chips or entries before wrapping to the first one. With no count
+     * the counter never matches the last one and wraps on its own */
+    function automatic int unsigned chip_count();
+        int unsigned n;
+        if (act_1[CODE_TABLE_BIT] || act_1[PINC_TABLE_BIT] || act_1[HOP_TABLE_BIT])
+            n = act_5[15:0];
+        else
+            n = act_5[31:28];
+        return (n == 0 || n > CODE_DEPTH) ? CODE_DEPTH : n;
+    endfunction
+
+    /* Table address of entry n, from the first one */
+    function automatic int unsigned table_addr(input int unsigned n);
+        return (act_5[31:16] + n) % CODE_DEPTH;
+    endfunction
+
+    /* Clocks of a hop dwell, 2 minimum */
+    function automatic int unsigned hop_clocks(input int unsigned n);
+        int unsigned length;
+        length = hop_dwell_mem[table_addr(n) % HOP_DEPTH][HOP_DWELL_BITS-1:0];
+        return (length < 1 ? 1 : length) + 1;
+    endfunction
+
+    /* Hop entry played at pos, walked from the last call */
+    function automatic int unsigned hop_at(input longint unsigned pos);
+        if (pos == 0 || pos < hop_pos) begin
+            hop_pos = 0;
+            hop_entry = 0;
+            hop_clock = 0;
+        end
+        while (hop_pos < pos) begin
+            hop_pos++;
+            if (++hop_clock == hop_clocks(hop_entry)) begin
+                hop_clock = 0;
+                hop_entry = (hop_entry + 1) % chip_count();
+            end
+        end
+        return hop_entry;
+    endfunction
+
+    /* Linear ramp: start, start + delta, ... up to the first value at
+     * or past the stop one, then again from start */
+    function automatic logic [PINC_BITS-1:0] ramp_pinc(input longint unsigned pos);
+        longint unsigned start, stop, delta, steps;
+        start = act_3[PINC_BITS-1:0];
+        stop = act_4[PINC_BITS-1:0];
+        delta = act_5[PINC_BITS-1:0];
+        if (start >= stop)
+            steps = 0;
+        else if (delta == 0)
+            steps = pos;
+        else
+            steps = (stop - start + delta - 1) / delta;
+        return PINC_BITS'(start + (pos % (steps + 1)) * delta);
+    endfunction
+
+    /**
+     * Beat for the latched config. pos is the position in the period in
+     * pulsed modes, clocks since the config was latched in continuous
+     * ones. Between pulses the counters hold their first chip, but the
+     * clock right after the pulse still shows the chip that ended it
+     */
+    function automatic logic [71:0] ref_beat(input longint unsigned pos);
+        bit pulsed, resync;
+        longint unsigned chip_pos;
+        int unsigned chip, n;
+        logic [PINC_BITS-1:0] pinc, offset;
+        longint signed interp;
+
+        pulsed = mode >= M_PULS_NO_MOD;
+        resync = pulsed && pos >= act_2[31:16];
+        chip_pos = (pulsed && pos > act_2[31:16]) ? 0 : pos;
+        chip = (chip_pos / chip_clocks()) % chip_count();
+        pinc = act_3[PINC_BITS-1:0];
+        offset = 0;
+
+        case (mode)
+            M_CONT_MOD_FREC, M_PULS_MOD_FREC:
+                if (act_1[PINC_TABLE_BIT]) begin
+                    n = table_addr(chip) % PINC_DEPTH;
+                    interp = longint'(chip_pos % chip_clocks()) * longint'(slope_mem[n]);
+                    pinc = pinc_mem[n] + PINC_BITS'(interp >>> PINC_SLOPE_FRAC_BITS);
+                end
+                else if (act_1[HOP_TABLE_BIT]) begin
+                    n = table_addr(hop_at(chip_pos)) % HOP_DEPTH;
+                    pinc = hop_pinc_mem[n];
+                    offset = {hop_dwell_mem[n][31 -: CODE_PHASE_BITS], {(PINC_BITS - CODE_PHASE_BITS){1'b0}}};
+                end
+                else
+                    pinc = ramp_pinc(pos);
+            M_CONT_MOD_PHASE, M_PULS_MOD_PHASE:
+                if (act_1[CODE_TABLE_BIT])
+                    offset = {code_mem[table_addr(chip)], {(PINC_BITS - CODE_PHASE_BITS){1'b0}}};
+                else
+                    offset = act_5[chip] ? 0 : PHASE_OFFSET_180;
+            default: ;
+        endcase
+
+        return {7'b0, resync, 2'b00, offset, 2'b00, resync ? {PINC_BITS{1'b0}} : pinc};
+    endfunction
+
+    function automatic void mismatch(input string what, input logic [71:0] expected, input logic [71:0] actual);
+        errors++;
+        if (errors <= 10)
+            $error("dds_modulator_scoreboard: clock %0d, mode %0d: %s expected %h, got %h",
+                   clocks, mode, what, expected, actual);
+    endfunction
+
+    // Testbench level checks (counts, flags) go to the same error count
+    function automatic void check_count(input string what, input int expected, input int actual);
+        if (actual != expected)
+            mismatch(what, expected, actual);
+    endfunction
+
+    always @(posedge clk_i)
+    begin : reference
+        bit en, armed, dbg_en, commit, load, pulsed, capture_run;
+        logic [PERIOD_COUNTER_BITS-1:0] period;
+
+        clocks++;
+
+        /* Outputs of the last clock */
+        if (known) begin
+            if (m_axis_modulation_tvalid !== (exp_tvalid && m_axis_modulation_tready))
+                mismatch("tvalid", exp_tvalid && m_axis_modulation_tready, m_axis_modulation_tvalid);
+            else if ((m_axis_modulation_tvalid || exp_prime) && m_axis_modulation_tdata !== exp_tdata)
+                mismatch("tdata", exp_tdata, m_axis_modulation_tdata);
+            if (m_axis_modulation_tlast !== exp_tlast)
+                mismatch("tlast", exp_tlast, m_axis_modulation_tlast);
+            if (m_axis_modulation_tuser !== exp_tuser)
+                mismatch("tuser", exp_tuser, m_axis_modulation_tuser);
+            if (dds_en_o !== exp_dds_en)
+                mismatch("dds_en", exp_dds_en, dds_en_o);
+        end
+
+        /* Capture framing: DEBUG_PACKETS valid beats from TUSER to TLAST */
+        if (m_axis_modulation_tvalid) begin
+            if (m_axis_modulation_tuser) begin
+                in_capture = 1;
+                capture_beats = 0;
+            end
+            if (in_capture)
+                capture_beats++;
+            if (m_axis_modulation_tlast) begin
+                if (!in_capture || capture_beats != DEBUG_PACKETS)
+                    mismatch("capture beats", DEBUG_PACKETS, capture_beats);
+                in_capture = 0;
+                captures++;
+            end
+        end
+
+        if (resetn_i !== 1) begin
+            mode = M_NONE;
+            {act_1, act_2, act_3, act_4, act_5} = 0;
+            period_count = 0;
+            since_load = 0;
+            packets = 0;
+            capture_done = 0;
+            in_capture = 0;
+            {exp_tdata, exp_tvalid, exp_tlast, exp_tuser, exp_dds_en, exp_prime} = 0;
+            known = (resetn_i === 0);
+        end
+        else if (known) begin
+            en = config_reg_0[ENABLE_BIT];
+            armed = config_reg_0[ARM_BIT] && !en;
+            dbg_en = config_reg_0[DEBUG_BIT] || capture_trig_i;
+            pulsed = mode >= M_PULS_NO_MOD;
+            period = act_2[PERIOD_COUNTER_BITS-1:0];
+
+            /* Commit: right away while disabled or in continuous modes,
+             * on the period wrap in pulsed ones */
+            commit = config_reg_0[COMMIT_BIT] &&
+                     (!en || (mode != M_NONE && !pulsed) || (pulsed && period_count == period));
+            if (commit_done_o !== commit)
+                mismatch("commit_done", commit, commit_done_o);
+            load = !en || commit;
+            commits += commit;
+
+            /* Beat of this clock, prime beats while armed */
+            exp_dds_en = en || armed;
+            exp_tvalid = en && mode != M_NONE;
+            exp_prime = armed;
+            if (exp_tvalid) begin
+                exp_tdata = ref_beat(pulsed ? period_count : since_load);
+                beats[mode]++;
+            end
+            else if (armed) begin
+                exp_tdata = {6'b0, 2'b11, 64'b0};
+                primes++;
+            end
+
+            /* One capture per debug request */
+            capture_run = m_axis_modulation_tready && en && dbg_en && !capture_done;
+            exp_tuser = capture_run && packets == 0;
+            exp_tlast = capture_run && packets == DEBUG_PACKETS - 1;
+            if (!capture_run)
+                packets = 0;
+            else if (exp_tlast) begin
+                packets = 0;
+                capture_done = 1;
+            end
+            else
+                packets++;
+            if (!dbg_en)
+                capture_done = 0;
+
+            /* Position in the period, held while disabled, 0 while armed */
+            if (armed || period_count == (pulsed ? period : 0))
+                period_count = 0;
+            else if (en && pulsed)
+                period_count++;
+
+            if (load) begin
+                {act_1, act_2, act_3, act_4, act_5} = {config_reg_1, config_reg_2, config_reg_3, config_reg_4, config_reg_5};
+                mode = ref_mode(config_reg_1);
+                since_load = 0;
+            end
+            else
+                since_load++;
+        end
+    end
+
+    /* Valid beats must carry known data */
+    always @(posedge clk_i)
+        if (known && m_axis_modulation_tvalid && $isunknown(m_axis_modulation_tdata))
+            mismatch("tdata known", 0, m_axis_modulation_tdata);
+
+    /**
+     * Summary: clocks, beats per mode and captures. PASS needs no
+     * errors and, with check_modes, valid beats in every mode
+     */
+    function automatic void report(input string name, input bit check_modes);
+        bit covered;
+        covered = 1;
+        $display("%s: beats CONT_NO_MOD %0d, CONT_MOD_FREC %0d, CONT_MOD_PHASE %0d", name,
+                 beats[M_CONT_NO_MOD], beats[M_CONT_MOD_FREC], beats[M_CONT_MOD_PHASE]);
+        $display("%s: beats PULS_NO_MOD %0d, PULS_MOD_FREC %0d, PULS_MOD_PHASE %0d", name,
+                 beats[M_PULS_NO_MOD], beats[M_PULS_MOD_FREC], beats[M_PULS_MOD_PHASE]);
+        $display("%s: %0d captures, %0d commits, %0d prime beats", name, captures, commits, primes);
+        for (int m = M_CONT_NO_MOD; m <= M_PULS_MOD_PHASE; m++)
+            covered &= beats[m] != 0 || !check_modes;
+        if (!covered)
+            $error("%s: not every mode was played", name);
+        if (errors == 0 && covered)
+            $display("%s: PASS, %0d clocks", name, clocks);
+        else
+            $display("%s: FAIL, %0d clocks, %0d errors", name, clocks, errors);
+    endfunction
+
+endmodule
@@ -2,11 +2,19 @@
 
 import dds_modulator_pkg::*;
 
+/**
+ * Self checking testbench for dds_modulator. Every clock is compared by
+ * dds_modulator_scoreboard, for the six modes, live commits, DDS
+ * backpressure and debug captures (TUSER/TLAST, one capture per request).
+ * The DDS Compiler is not instantiated, tready is driven here.
+ *
+ * Headless, see tb/Makefile:
+ *   make dds_modulator_tb               (Verilator)
+ *   make SIM=icarus dds_modulator_tb
+ * +trace=<file> dumps the ports for sw/host/model (make check TRACE=<file>).
+ */
 module dds_modulator_tb();
     parameter PERIOD_COUNTER_BITS = 15;
-    logic [31:0] M_AXIS_DATA_0_tdata;
-    logic M_AXIS_DATA_0_tvalid;
-    logic M_AXIS_DATA_0_tready;
 
     /**
     * Inputs to dds_modulator
@@ -17,6 +25,19 @@ module dds_modulator_tb();
     logic [31:0] config_reg_3 = 0;
     logic [31:0] config_reg_4 = 0;
     logic [31:0] config_reg_5 = 0;
+    logic capture_trig = 0;
+    // Staged config latched by DUT
+    logic commit_done;
+
+    /**
+    * Outputs from dds_modulator
+    */
+    logic [71:0] m_axis_modulation_tdata;
+    logic m_axis_modulation_tvalid;
+    logic m_axis_modulation_tlast;
+    logic m_axis_modulation_tuser;
+    logic m_axis_modulation_tready = 1;
+    logic dds_en;
 
     /**
     *   Test functions
@@ -26,21 +47,40 @@ module dds_modulator_tb();
     function void modulator_enable(bit value);
         config_reg_0[ENABLE_BIT] = value;
     endfunction;
-    
+
     // Enable/Disable Debug
     function void modulator_debug_enable(bit value);
         config_reg_0[DEBUG_BIT] = value;
     endfunction;
 
+    // Config written while disabled is latched on the next clock,
+    // enable after it
+    task automatic modulator_start();
+        @(posedge clk_i);
+        @(negedge clk_i);
+        modulator_enable(1);
+    endtask;
+
+    // Commit staged config. Register bank clears the bit once latched,
+    // after the edge that latched it
+    task automatic modulator_commit();
+        config_reg_0[COMMIT_BIT] = 1;
+        @(posedge clk_i);
+        while (!commit_done)
+            @(posedge clk_i);
+        config_reg_0[COMMIT_BIT] <= 0;
+        // Stimulus changes on falling edges
+        @(negedge clk_i);
+    endtask;
+
     // Set mode in config register
     function automatic void modulator_mode(input logic [STATE_BITS - 1 :0] mode);
-        $display("OK");
        config_reg_1[STATE_BITS - 1 : 0] = mode;
     endfunction;
 
     // Configure PINC field for continuous frequency (f in MHz)
     function automatic void modulator_set_cont_freq(input int unsigned fout_MHz);
-        automatic int unsigned pinc; 
+        automatic int unsigned pinc;
         pinc = (fout_MHz * (2 ** PINC_BITS)) / FCLK_MHZ ;
         config_reg_3 [PINC_BITS-1:0] = pinc;
     endfunction;
@@ -49,9 +89,9 @@ module dds_modulator_tb();
     function automatic void modulator_set_frec_mod(int unsigned f_low_MHz,
                                                    int unsigned f_high_MHz,
                                                    int unsigned period_us);
-        automatic int unsigned pinc_low; 
-        automatic int unsigned pinc_high; 
-        automatic int unsigned delta_pinc; 
+        automatic int unsigned pinc_low;
+        automatic int unsigned pinc_high;
+        automatic int unsigned delta_pinc;
         pinc_low = (f_low_MHz * (2 ** PINC_BITS)) / FCLK_MHZ ;
         pinc_high = f_high_MHz * ((2 ** PINC_BITS) / FCLK_MHZ) ;
         delta_pinc = (pinc_high - pinc_low) / (period_us * FCLK_MHZ);
@@ -61,7 +101,7 @@ module dds_modulator_tb();
     endfunction;
 
     // Set phase modulation values (frec values in MHz, subpulse length values in us)
-    function automatic void modulator_set_phase_mod(int unsigned barker_code_num, 
+    function automatic void modulator_set_phase_mod(int unsigned barker_code_num,
                                                     int unsigned barker_subpulse_length_us,
                                                     int unsigned fout_MHz);
         automatic int unsigned pinc;
@@ -72,12 +112,12 @@ module dds_modulator_tb();
 
         // Set subpulse length
         config_reg_4 [PINC_BITS-1:0] = (barker_subpulse_length_us * FCLK_MHZ) - 1;
-        
+
         // Set barker code
         config_reg_5 [31:28] = barker_code_num;
-        
+
         case(barker_code_num)
-            2: config_reg_5 [13-1:0] = BARKER_2;     
+            2: config_reg_5 [13-1:0] = BARKER_2;
             3:  config_reg_5 [13-1:0] = BARKER_3;
             4:  config_reg_5 [13-1:0] = BARKER_4;
             5:  config_reg_5 [13-1:0] = BARKER_5;
@@ -96,13 +136,10 @@ module dds_modulator_tb();
         config_reg_2 [14:0] = period_us * FCLK_MHZ;
     endfunction;
 
-
-
-    // Output is not x or z when valid is high
-    DoutCheck: assert property (@(posedge clk_i)  (!$isunknown(M_AXIS_DATA_0_tdata)));
-
     /**
      * Clock & Initial Reset
+     * Stimulus changes on falling edges, every delay is a whole
+     * number of clocks
      */
 
     parameter T_INITIAL_RESET = 20us;
@@ -112,16 +149,19 @@ module dds_modulator_tb();
     logic resetn_i = 0;
     always #4 clk_i = !clk_i;
     initial #T_INITIAL_RESET resetn_i = 1;
-    
+
     int unsigned pulse_length = 5;
     int unsigned barkerseq = 13;
     int unsigned subpulse_length = 5;
 
-    initial M_AXIS_DATA_0_tready = 1'b1;
-    
+    // DDS backpressure, random tready
+    bit backpressure = 0;
+    always @(negedge clk_i)
+        m_axis_modulation_tready = !backpressure || $urandom_range(3) != 0;
+
     initial begin
         #T_INITIAL_RESET
-        
+
         /************************************
          * TEST: 1) Continuous frequency
          ************************************/
@@ -129,13 +169,14 @@ module dds_modulator_tb();
             modulator_mode(CONT_NO_MOD_TB);
             // 1 MHz
             modulator_set_cont_freq(1);
-            modulator_enable(1);
+            modulator_start();
             #20us
-            // Freq change 10 MHz
+            // Freq change 10 MHz, latched right away in continuous mode
             modulator_set_cont_freq(10);
-            #20us 
+            modulator_commit();
+            #20us
             modulator_enable(0);
-        
+
         /************************************
          * END TEST
          ************************************/
@@ -143,22 +184,22 @@ module dds_modulator_tb();
         resetn_i = 0;
         #T_BETWEEN_TESTS
         resetn_i = 1;
-        
+
         /************************************************
          * TEST: 2) Continuous mode frequency modulated
-         ************************************************/ 
-            
+         ************************************************/
+
             modulator_mode(CONT_MOD_FREC);
-            // Inital freq 0MHz, End freq 5MHz, Length 50us
+            // Inital freq 0MHz, End freq 5MHz, Length 100us
             modulator_set_frec_mod(0, 5, 100);
-            modulator_enable(1);
+            modulator_start();
             #200us
             modulator_enable(0);
-        
+
         /************************************************
          * END TEST
          ************************************************/
-        
+
         resetn_i = 0;
         #T_BETWEEN_TESTS
         resetn_i = 1;
@@ -166,18 +207,18 @@ module dds_modulator_tb();
         /************************************************
          * TEST: 3) Continuous mode phase modulated
          ************************************************/
-        
+
             modulator_mode(CONT_MOD_PHASE);
             // Barker seq N° 5, 2us per subpulse, 1 MHz freq.
             modulator_set_phase_mod(5, 2, 1);
-            modulator_enable(1);
+            modulator_start();
             #200us
             modulator_enable(0);
-        
+
         /************************************************
          * END TEST
          ************************************************/
-        
+
         resetn_i = 0;
         #T_BETWEEN_TESTS
         resetn_i = 1;
@@ -189,20 +230,22 @@ module dds_modulator_tb();
             // Pulse width 5 us, period 15 us
             modulator_set_period(5, 15);
             modulator_set_cont_freq(1);
-            modulator_enable(1);       
+            modulator_start();
             #300us
             modulator_enable(0);
 
         /************************************************
          * END TEST
          ************************************************/
-        
+
         resetn_i = 0;
         #T_BETWEEN_TESTS
         resetn_i = 1;
 
         /************************************************
-         * TEST: 5) Pulsed mode freq modulated
+         * TEST: 5) Pulsed mode freq modulated, with DDS
+         * backpressure: beats are dropped, the waveform
+         * keeps its timing
          ************************************************/
             modulator_mode(PULS_MOD_FREC);
             // Pulse width 5 us, period 15 us.
@@ -210,32 +253,36 @@ module dds_modulator_tb();
             modulator_set_period(pulse_length, 15);
             // Freq sweep 0 to 20 MHz, in pulse_length
             modulator_set_frec_mod(0, 20, pulse_length);
-            modulator_enable(1);
+            backpressure = 1;
+            modulator_start();
             #450us
             modulator_enable(0);
+            backpressure = 0;
 
         /************************************************
          * END TEST
          ************************************************/
-        
+
         resetn_i = 0;
         #T_BETWEEN_TESTS
         resetn_i = 1;
 
         /************************************************
          * TEST: 6) Pulsed mode phase modulated
+         * Capture is cut short by the disable
          ************************************************/
             modulator_mode(PULS_MOD_PHASE);
-            barkerseq = 13;         
-            subpulse_length = 1;    
+            barkerseq = 13;
+            subpulse_length = 1;
             modulator_set_period(barkerseq * subpulse_length, barkerseq * subpulse_length + 50);
             // 1MHz frequency
             modulator_set_phase_mod(barkerseq, subpulse_length, 1);
-            modulator_enable(1);
             modulator_debug_enable(1);
+            modulator_start();
             #300us
             modulator_enable(0);
-            
+            scoreboard.check_count("captures", 0, scoreboard.captures);
+
         /************************************************
          * END TEST
          ************************************************/
@@ -246,45 +293,110 @@ module dds_modulator_tb();
 
         /************************************************
          * TEST: 7) Continuous frequency - Debug enabled
+         * One capture per request: the debug bit takes
+         * one, then the shared capture trigger another
          ************************************************/
-            
+
             modulator_debug_enable(1);
             modulator_mode(CONT_NO_MOD_TB);
             // 1 MHz
             modulator_set_cont_freq(1);
-            modulator_enable(1);
+            modulator_start();
             #20us
-            // Freq change 10 MHz
+            // Freq change 10 MHz, latched right away in continuous mode
             modulator_set_cont_freq(10);
-            #20us 
+            modulator_commit();
+            // Capture is MAX_DEBUG_PACKETS clocks, no second one
+            #1200us
+            scoreboard.check_count("captures", 1, scoreboard.captures);
+            modulator_debug_enable(0);
+            #1us
+            capture_trig = 1;
+            #1100us
+            capture_trig = 0;
+            scoreboard.check_count("captures", 2, scoreboard.captures);
+            #20us
             modulator_enable(0);
-        
+
         /************************************************
          * END TEST
          ************************************************/
          #T_BETWEEN_TESTS
          /************************************************
-         * TEST: 6) Pulsed mode phase modulated
+         * TEST: 8) Pulsed mode phase modulated
+         * Capture over whole periods
          ************************************************/
             modulator_mode(PULS_MOD_PHASE);
-            barkerseq = 7;         
-            subpulse_length = 1;    
+            barkerseq = 7;
+            subpulse_length = 1;
             modulator_set_period(barkerseq * subpulse_length, barkerseq * subpulse_length + 50);
             // 1MHz frequency
             modulator_set_phase_mod(barkerseq, subpulse_length, 1);
-            modulator_enable(1);
             modulator_debug_enable(1);
-            #300us
+            modulator_start();
+            #1100us
+            modulator_enable(0);
+            scoreboard.check_count("captures", 3, scoreboard.captures);
+
+        /************************************************
+         * END TEST
+         ************************************************/
+
+        resetn_i = 0;
+        #T_BETWEEN_TESTS
+        resetn_i = 1;
+
+        /************************************************
+         * TEST: 9) Pulsed mode live reconfiguration
+         * New config is latched at the period wrap,
+         * running pulse is not truncated
+         ************************************************/
+            modulator_debug_enable(0);
+            modulator_mode(PULS_NO_MOD_TB);
+            // Pulse width 5 us, period 15 us
+            modulator_set_period(5, 15);
+            modulator_set_cont_freq(1);
+            modulator_start();
+            // Change in the middle of a pulse
+            #32us
+            modulator_mode(PULS_MOD_FREC);
+            modulator_set_period(10, 20);
+            modulator_set_frec_mod(1, 10, 10);
+            modulator_commit();
+            #100us
             modulator_enable(0);
-         
-         
+            #1us
 
+        scoreboard.report("dds_modulator_tb", 1);
         $finish;
     end
 
-    logic [71:0] m_axis_modulation_tdata;
-    logic m_axis_modulation_tvalid;
-    logic m_axis_modulation_tready;
+    /**
+    *   Trace for the golden model cross-check (sw/host/model), +trace=<file>.
+    *   One line per clk_i rising edge, values sampled by that edge:
+    *   resetn config_reg_0..5 tready capture_trig tdata tvalid tlast tuser dds_en commit_done
+    */
+    int trace_fd = 0;
+
+    initial begin
+        string trace_file;
+        if ($value$plusargs("trace=%s", trace_file))
+            trace_fd = $fopen(trace_file, "w");
+    end
+
+    // Inputs change on falling edges, outputs after the edge
+    always @(posedge clk_i)
+        if (trace_fd)
+            $fwrite(trace_fd, "%h %h %h %h %h %h %h %h %h %h %h %h %h %h %h\n",
+                    resetn_i, config_reg_0, config_reg_1, config_reg_2,
+                    config_reg_3, config_reg_4, config_reg_5,
+                    m_axis_modulation_tready, capture_trig, m_axis_modulation_tdata,
+                    m_axis_modulation_tvalid, m_axis_modulation_tlast,
+                    m_axis_modulation_tuser, dds_en, commit_done);
+
+    final
+        if (trace_fd)
+            $fclose(trace_fd);
 
 
     /**
@@ -294,31 +406,71 @@ module dds_modulator_tb();
     dds_modulator DUT(
         .clk_i,
         .resetn_i,
+        .wr_clk_i(clk_i),
         .dds_en_o(dds_en),
         .m_axis_modulation_tdata,
         .m_axis_modulation_tvalid,
+        .m_axis_modulation_tlast,
+        .m_axis_modulation_tuser,
         .m_axis_modulation_tready,
         .config_reg_0,
         .config_reg_1,
         .config_reg_2,
         .config_reg_3,
         .config_reg_4,
-        .config_reg_5
+        .config_reg_5,
+        .commit_done_o(commit_done),
+        .capture_trig_i(capture_trig),
+        .ts_now_o(),
+        .ts_pulse_o(),
+        .ts_commit_o(),
+        .ts_capture_o(),
+        .perf_o(),
+        .trig_received_i(1'b0),
+        .trig_missed_i(1'b0),
+        .period_end_o(),
+        .code_wr_en_i(1'b0),
+        .code_wr_addr_i('0),
+        .code_wr_data_i('0),
+        .pinc_wr_en_i(1'b0),
+        .pinc_wr_addr_i('0),
+        .pinc_wr_data_i('0),
+        .hop_wr_en_i(1'b0),
+        .hop_wr_addr_i('0),
+        .hop_wr_data_i('0)
     );
-    
+
     /**
-    *   DDS Compiler IP Wrapper
+    *   Scoreboard, reference model of the DUT ports
     */
 
-    dds_compiler_bd_wrapper dds_compiler           
-        (.M_AXIS_DATA_0_tdata,
-        .M_AXIS_DATA_0_tready,   
-        .M_AXIS_DATA_0_tvalid,
-        .S_AXIS_PHASE_tdata(m_axis_modulation_tdata),
-        .S_AXIS_PHASE_tvalid(m_axis_modulation_tvalid),
-        .S_AXIS_PHASE_tready(m_axis_modulation_tready),  
-        .aclk(clk_i),
-        .aclken(dds_en),
-        .aresetn(resetn_i));
-  
+    dds_modulator_scoreboard scoreboard(
+        .clk_i,
+        .resetn_i,
+        .wr_clk_i(clk_i),
+        .config_reg_0,
+        .config_reg_1,
+        .config_reg_2,
+        .config_reg_3,
+        .config_reg_4,
+        .config_reg_5,
+        .capture_trig_i(capture_trig),
+        .m_axis_modulation_tready,
+        .code_wr_en_i(1'b0),
+        .code_wr_addr_i('0),
+        .code_wr_data_i('0),
+        .pinc_wr_en_i(1'b0),
+        .pinc_wr_addr_i('0),
+        .pinc_wr_data_i('0),
+        .hop_wr_en_i(1'b0),
+        .hop_wr_addr_i('0),
+        .hop_wr_data_i('0),
+        .dds_en_o(dds_en),
+        .m_axis_modulation_tdata,
+        .m_axis_modulation_tvalid,
+        .m_axis_modulation_tlast,
+        .m_axis_modulation_tuser,
+        .commit_done_o(commit_done)
+    );
+
 endmodule
@@ -0,0 +1,176 @@
+`timescale 1ns / 1ps
+
+/**
+ * Self checking testbench for dds_polyphase. Every lane is compared against
+ * a single accumulator running at the sample rate (golden model), for a
+ * tone, a chirp, a phase code and random streams with ACLKEN gaps and
+ * prime beats.
+ *
+ * Vivado: dds_polyphase_tb simset. Headless, see tb/Makefile:
+ *   make dds_polyphase_tb               (Verilator)
+ *   make SIM=icarus dds_polyphase_tb
+ */
+module dds_polyphase_tb();
+    localparam CLK = 8;
+    localparam LANES = 4;
+    localparam PINC_BITS = 30;
+    localparam PHASE_OUT_BITS = 16;
+    localparam LATENCY = 3;
+    localparam OUT_BITS = LANES * PHASE_OUT_BITS;
+
+    /**
+     * Clock & Reset
+     */
+
+    logic clk_i = 0;
+    logic resetn_i = 0;
+    always #(CLK/2) clk_i = !clk_i;
+    initial #20 resetn_i = 1;
+    always @(posedge clk_i) clocks++;
+
+    /**
+     * DUT signals
+     */
+    logic en_i = 0;
+    logic [71:0] s_axis_tdata = 0;
+    logic s_axis_tvalid = 0;
+    logic s_axis_tlast = 0;
+    logic s_axis_tuser = 0;
+    logic [OUT_BITS-1:0] m_axis_tdata;
+    logic m_axis_tvalid;
+    logic m_axis_tlast;
+    logic m_axis_tuser;
+
+    /**
+     * Golden model: one accumulator at the sample rate, LANES steps per beat.
+     * Expected outputs are queued as {tuser, tlast, tvalid, lane phases}.
+     */
+    logic [PINC_BITS-1:0] gold_acc = 0;
+    logic [PINC_BITS-1:0] gold_pinc = 0;
+    logic [PINC_BITS-1:0] gold_offset = 0;
+    logic [OUT_BITS+2:0] expected_q [$];
+
+    function automatic void golden_beat(input logic [PINC_BITS-1:0] pinc,
+                                        input logic [PINC_BITS-1:0] offset,
+                                        input bit resync, input bit valid, input bit last, input bit user,
+                                        input bit prime);
+        logic [OUT_BITS-1:0] phases;
+        logic [PINC_BITS-1:0] phase;
+        // Prime beats load like valid ones, no sample
+        if (valid || prime) begin
+            gold_pinc = pinc;
+            gold_offset = offset;
+            if (resync)
+                gold_acc = 0;
+        end
+        for (int k = 0; k < LANES; k++) begin
+            phase = gold_acc + gold_offset;
+            phases[k*PHASE_OUT_BITS +: PHASE_OUT_BITS] = phase[PINC_BITS-1 -: PHASE_OUT_BITS];
+            gold_acc = gold_acc + gold_pinc;
+        end
+        expected_q.push_back({user, last, valid, phases});
+    endfunction
+
+    /**
+     * Test functions
+     */
+    int clocks = 0;
+    int beats = 0;
+    int errors = 0;
+    bit en_gaps = 0;
+
+    function automatic void check(input logic [OUT_BITS+2:0] expected);
+        logic [OUT_BITS+2:0] actual;
+        actual = {m_axis_tuser, m_axis_tlast, m_axis_tvalid, m_axis_tdata};
+        beats++;
+        if (actual !== expected) begin
+            errors++;
+            if (errors <= 10)
+                $error("Beat %0d: expected %h, got %h", beats, expected, actual);
+        end
+    endfunction
+
+    // One input beat. With en_gaps, random clocks with en_i low (and
+    // garbage on the input) go before it, the pipeline must hold
+    task automatic beat(input logic [PINC_BITS-1:0] pinc, input logic [PINC_BITS-1:0] offset,
+                        input bit resync, input bit valid, input bit last, input bit user = 0,
+                        input bit prime = 0);
+        while (en_gaps && $urandom_range(7) == 0) begin
+            en_i = 0;
+            s_axis_tdata = 72'({$urandom, $urandom, $urandom});
+            s_axis_tvalid = 1'($urandom);
+            s_axis_tlast = 1'($urandom);
+            s_axis_tuser = 1'($urandom);
+            @(negedge clk_i);
+        end
+        en_i = 1;
+        s_axis_tdata = {6'b0, prime, resync, 2'b00, offset, 2'b00, pinc};
+        s_axis_tvalid = valid;
+        s_axis_tlast = last;
+        s_axis_tuser = user;
+        golden_beat(pinc, offset, resync, valid, last, user, prime);
+        @(negedge clk_i);
+        // Output holds the beat LATENCY - 1 enabled clocks back
+        if (expected_q.size() == LATENCY)
+            check(expected_q.pop_front());
+    endtask
+
+    /**
+     * Test
+     */
+    localparam logic [PINC_BITS-1:0] TONE_PINC = 30'd53687091;     // 0.05 fs
+    localparam logic [PINC_BITS-1:0] OFFSET_180 = 30'h2000_0000;
+
+    initial begin
+        @(posedge resetn_i);
+        @(negedge clk_i);
+
+        // Continuous tone, resync on first beat
+        beat(TONE_PINC, 0, 1, 1, 0);
+        repeat(999) beat(TONE_PINC, 0, 0, 1, 0);
+
+        // Chirp, PINC steps every beat, wraps past fs. Framed like a capture
+        for (int n = 0; n < 2000; n++)
+            beat(PINC_BITS'(n * 30'd600000), 0, n == 0, 1, n == 1999, n == 0);
+
+        // Phase code, 180° chips of 8 beats
+        for (int n = 0; n < 1000; n++)
+            beat(TONE_PINC, (n / 8) % 2 ? OFFSET_180 : 0, n == 0, 1, 0);
+
+        // Armed start: prime beats (PINC 0, resync), then a tone from phase 0
+        repeat(10) beat(0, 0, 1, 0, 0, 0, 1);
+        repeat(1000) beat(TONE_PINC, 0, 0, 1, 0);
+
+        // Random stream, tvalid gaps (config holds), prime beats and ACLKEN gaps
+        en_gaps = 1;
+        repeat(20000)
+            beat(PINC_BITS'($urandom), PINC_BITS'($urandom), $urandom_range(63) == 0,
+                 $urandom_range(7) != 0, $urandom_range(31) == 0, $urandom_range(31) == 0,
+                 $urandom_range(15) == 0);
+        en_gaps = 0;
+
+        // Flush
+        repeat(LATENCY - 1) beat(0, 0, 0, 0, 0);
+
+        if (errors == 0)
+            $display("dds_polyphase_tb: PASS, %0d clocks, %0d beats, %0d lanes", clocks, beats, LANES);
+        else
+            $error("dds_polyphase_tb: FAIL, %0d clocks, %0d of %0d beats failed", clocks, errors, beats);
+        $finish;
+    end
+
+    dds_polyphase #(.LANES(LANES), .PINC_BITS(PINC_BITS), .PHASE_OUT_BITS(PHASE_OUT_BITS)) dut(
+        .clk_i,
+        .resetn_i,
+        .en_i,
+        .s_axis_tdata,
+        .s_axis_tvalid,
+        .s_axis_tlast,
+        .s_axis_tuser,
+        .m_axis_tdata,
+        .m_axis_tvalid,
+        .m_axis_tlast,
+        .m_axis_tuser
+    );
+
+endmodule
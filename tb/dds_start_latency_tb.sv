@@ -0,0 +1,280 @@
+`timescale 1ns / 1ps
+
+import dds_modulator_pkg::*;
+
+/**
+ * Self checking testbench for the armed start of a generator channel:
+ * dds_modulator, dds_polyphase and the DDS Compiler lanes as wired in
+ * mm2s_dds_modulator (LUT model from sw/host/cosim). The modulator is
+ * also checked every clock by dds_modulator_scoreboard.
+ *
+ * Starts are done after a stop in the middle of a pulse. With ARM_BIT set
+ * every start must:
+ *   - give no sample while armed, once the last run drained,
+ *   - give the first sample START_LATENCY clocks after the clock that
+ *     samples ENABLE_BIT, and a valid one on every clock of the pulse,
+ *   - start the pulse from phase 0 (lane phases against a single
+ *     accumulator) and give the same samples as every other start.
+ *
+ * Headless, see tb/Makefile:
+ *   make dds_start_latency_tb           (Verilator)
+ *   make SIM=icarus dds_start_latency_tb
+ */
+module dds_start_latency_tb();
+    localparam CLK = 8;
+    parameter LANES = 4;
+    /* DDS Compiler latency, dds_latency in bd/generator.bd.tcl */
+    parameter DDS_LATENCY = 6;
+    localparam POLYPHASE_LATENCY = 3;
+    /* Modulator output register, dds_polyphase and DDS Compiler */
+    localparam START_LATENCY = 1 + POLYPHASE_LATENCY + DDS_LATENCY;
+    localparam PHASE_OUT_BITS = 16;
+    localparam OUTPUT_BITS = 14;
+
+    /* Pulsed tone, pulse and period in clocks */
+    localparam TAU = 200;
+    localparam PERIOD = 500;
+    localparam logic [PINC_BITS-1:0] TONE_PINC = 30'd53687091;     // 0.05 fs
+
+    /**
+     * Clock & Reset
+     */
+
+    logic clk_i = 0;
+    logic resetn_i = 0;
+    always #(CLK/2) clk_i = !clk_i;
+    initial #20 resetn_i = 1;
+
+    /**
+     * DUT signals
+     */
+    logic [31:0] config_reg_0 = 0;
+    logic [31:0] config_reg_1 = 0;
+    logic [31:0] config_reg_2 = 0;
+    logic [31:0] config_reg_3 = 0;
+    logic [31:0] config_reg_4 = 0;
+    logic [31:0] config_reg_5 = 0;
+    logic commit_done;
+    logic dds_en;
+    logic [71:0] mod_tdata;
+    logic mod_tvalid;
+    logic mod_tlast;
+    logic mod_tuser;
+    logic [LANES*PHASE_OUT_BITS-1:0] phase_tdata;
+    logic phase_tvalid;
+    logic phase_tlast;
+    logic phase_tuser;
+    logic [LANES*32-1:0] dds_tdata;
+    logic [LANES-1:0] dds_tvalid;
+
+    /**
+     * Test functions
+     */
+
+    // Lane k phase of sample n from the pulse start, one accumulator
+    function automatic logic [PHASE_OUT_BITS-1:0] golden_phase(input int unsigned n);
+        logic [PINC_BITS-1:0] phase;
+        phase = PINC_BITS'(n) * TONE_PINC;
+        return phase[PINC_BITS-1 -: PHASE_OUT_BITS];
+    endfunction
+
+    // DDS output of every start, TAU beats from the first sample
+    logic [LANES*32-1:0] samples [2][TAU];
+
+    // Stop in the middle of a pulse, armed for armed_clocks, then start.
+    // Outputs are looked at on falling edges, clock c is the c-th rising
+    // edge from the one that samples ENABLE_BIT
+    task automatic armed_start(input int run, input int armed_clocks);
+        int first;
+        config_reg_0 = 1 << ARM_BIT;
+        for (int c = 1; c <= armed_clocks; c++) begin
+            @(negedge clk_i);
+            scoreboard.check_count("dds_en while armed", 1, dds_en);
+            // The last run drains first
+            if (c >= START_LATENCY)
+                scoreboard.check_count("no samples while armed", 0, dds_tvalid);
+        end
+
+        config_reg_0 = (1 << ARM_BIT) | (1 << ENABLE_BIT);
+        first = 0;
+        for (int c = 1; c < START_LATENCY + TAU; c++) begin
+            @(negedge clk_i);
+            // Lane phases, POLYPHASE_LATENCY clocks after the modulator
+            if (c >= 1 + POLYPHASE_LATENCY && c < 1 + POLYPHASE_LATENCY + TAU) begin
+                scoreboard.check_count("phase tvalid", 1, phase_tvalid);
+                for (int k = 0; k < LANES; k++)
+                    scoreboard.check_count($sformatf("lane %0d phase", k),
+                                golden_phase((c - 1 - POLYPHASE_LATENCY) * LANES + k),
+                                phase_tdata[k*PHASE_OUT_BITS +: PHASE_OUT_BITS]);
+            end
+            if (first == 0 && dds_tvalid[0])
+                first = c;
+            if (c >= START_LATENCY) begin
+                scoreboard.check_count("dds tvalid", {LANES{1'b1}}, dds_tvalid);
+                samples[run][c - START_LATENCY] = dds_tdata;
+            end
+        end
+        // Samples left from the last run are out before the enable when
+        // it was armed long enough
+        if (armed_clocks >= START_LATENCY)
+            scoreboard.check_count("start latency", START_LATENCY, first);
+        // [Sine|Cosine] of phase 0, full range amplitude
+        scoreboard.check_count("first sample at phase 0", (1 << (OUTPUT_BITS - 1)) - 1, samples[run][0][31:0]);
+
+        // Stop in the middle of the next pulse
+        repeat (PERIOD + TAU / 2)
+            @(negedge clk_i);
+    endtask
+
+    /**
+     * Test
+     */
+    initial begin
+        @(posedge resetn_i);
+        @(negedge clk_i);
+
+        // Pulsed tone, latched while disabled
+        config_reg_1[STATE_BITS-1:0] = PULS_NO_MOD_TB;
+        config_reg_2 = (TAU << 16) | PERIOD;
+        config_reg_3[PINC_BITS-1:0] = TONE_PINC;
+        @(negedge clk_i);
+
+        // Not armed, stopped in the middle of a pulse: pipeline frozen
+        // with a phase of its own
+        config_reg_0 = 1 << ENABLE_BIT;
+        repeat (PERIOD + TAU / 3)
+            @(negedge clk_i);
+
+        config_reg_0 = 0;
+        repeat (20)
+            @(negedge clk_i);
+
+        // Armed starts, the second one right after the pipeline drained
+        armed_start(0, 4 * START_LATENCY);
+        armed_start(1, START_LATENCY);
+        for (int n = 0; n < TAU; n++)
+            if (samples[1][n] !== samples[0][n])
+                scoreboard.mismatch($sformatf("start 2 sample %0d", n), samples[0][n], samples[1][n]);
+
+        // Short arm: the last run is still draining, first sample as usual
+        armed_start(1, 2);
+        for (int n = 0; n < TAU; n++)
+            if (samples[1][n] !== samples[0][n])
+                scoreboard.mismatch($sformatf("start 3 sample %0d", n), samples[0][n], samples[1][n]);
+
+        config_reg_0 = 0;
+        repeat (START_LATENCY)
+            @(negedge clk_i);
+        scoreboard.check_count("dds_en disarmed", 0, dds_en);
+
+        $display("dds_start_latency_tb: %0d lanes, DDS latency %0d, start latency %0d clocks",
+                 LANES, DDS_LATENCY, START_LATENCY);
+        scoreboard.report("dds_start_latency_tb", 0);
+        $finish;
+    end
+
+    /**
+     * DUT: modulator, polyphase and DDS Compiler lanes sharing ACLKEN
+     */
+
+    dds_modulator #(.DDS_LANES(LANES)) modulator(
+        .clk_i,
+        .resetn_i,
+        .wr_clk_i(clk_i),
+        .dds_en_o(dds_en),
+        .m_axis_modulation_tdata(mod_tdata),
+        .m_axis_modulation_tvalid(mod_tvalid),
+        .m_axis_modulation_tlast(mod_tlast),
+        .m_axis_modulation_tuser(mod_tuser),
+        .m_axis_modulation_tready(1'b1),
+        .config_reg_0,
+        .config_reg_1,
+        .config_reg_2,
+        .config_reg_3,
+        .config_reg_4,
+        .config_reg_5,
+        .commit_done_o(commit_done),
+        .capture_trig_i(1'b0),
+        .ts_now_o(),
+        .ts_pulse_o(),
+        .ts_commit_o(),
+        .ts_capture_o(),
+        .perf_o(),
+        .trig_received_i(1'b0),
+        .trig_missed_i(1'b0),
+        .period_end_o(),
+        .code_wr_en_i(1'b0),
+        .code_wr_addr_i('0),
+        .code_wr_data_i('0),
+        .pinc_wr_en_i(1'b0),
+        .pinc_wr_addr_i('0),
+        .pinc_wr_data_i('0),
+        .hop_wr_en_i(1'b0),
+        .hop_wr_addr_i('0),
+        .hop_wr_data_i('0)
+    );
+
+    dds_polyphase #(.LANES(LANES), .PINC_BITS(PINC_BITS), .PHASE_OUT_BITS(PHASE_OUT_BITS)) polyphase(
+        .clk_i,
+        .resetn_i,
+        .en_i(dds_en),
+        .s_axis_tdata(mod_tdata),
+        .s_axis_tvalid(mod_tvalid),
+        .s_axis_tlast(mod_tlast),
+        .s_axis_tuser(mod_tuser),
+        .m_axis_tdata(phase_tdata),
+        .m_axis_tvalid(phase_tvalid),
+        .m_axis_tlast(phase_tlast),
+        .m_axis_tuser(phase_tuser)
+    );
+
+    for (genvar k = 0; k < LANES; k++) begin : lane
+        dds_lut_model #(.PHASE_BITS(PHASE_OUT_BITS), .OUTPUT_BITS(OUTPUT_BITS), .LATENCY(DDS_LATENCY)) dds(
+            .aclk(clk_i),
+            .aclken(dds_en),
+            .aresetn(resetn_i),
+            .s_axis_phase_tdata(phase_tdata[k*PHASE_OUT_BITS +: PHASE_OUT_BITS]),
+            .s_axis_phase_tvalid(phase_tvalid),
+            .s_axis_phase_tlast(phase_tlast),
+            .s_axis_phase_tuser(phase_tuser),
+            .m_axis_data_tdata(dds_tdata[k*32 +: 32]),
+            .m_axis_data_tvalid(dds_tvalid[k]),
+            .m_axis_data_tlast(),
+            .m_axis_data_tuser()
+        );
+    end
+
+    /**
+    *   Scoreboard, reference model of the modulator ports
+    */
+
+    dds_modulator_scoreboard #(.DDS_LANES(LANES)) scoreboard(
+        .clk_i,
+        .resetn_i,
+        .wr_clk_i(clk_i),
+        .config_reg_0,
+        .config_reg_1,
+        .config_reg_2,
+        .config_reg_3,
+        .config_reg_4,
+        .config_reg_5,
+        .capture_trig_i(1'b0),
+        .m_axis_modulation_tready(1'b1),
+        .code_wr_en_i(1'b0),
+        .code_wr_addr_i('0),
+        .code_wr_data_i('0),
+        .pinc_wr_en_i(1'b0),
+        .pinc_wr_addr_i('0),
+        .pinc_wr_data_i('0),
+        .hop_wr_en_i(1'b0),
+        .hop_wr_addr_i('0),
+        .hop_wr_data_i('0),
+        .dds_en_o(dds_en),
+        .m_axis_modulation_tdata(mod_tdata),
+        .m_axis_modulation_tvalid(mod_tvalid),
+        .m_axis_modulation_tlast(mod_tlast),
+        .m_axis_modulation_tuser(mod_tuser),
+        .commit_done_o(commit_done)
+    );
+
+endmodule
@@ -0,0 +1,338 @@
+`timescale 1ns / 1ps
+
+import dds_modulator_pkg::*;
+
+/**
+ * Self checking testbench for the external trigger: dds_trigger driving
+ * dds_modulator as wired in mm2s_dds_modulator, armed (ARM_BIT) between
+ * triggers. The modulator is also checked every clock by
+ * dds_modulator_scoreboard.
+ *
+ * With TRIG_EN_BIT set, every accepted edge must:
+ *   - give the first modulator beat TRIGGER_LATENCY + 1 clocks after the
+ *     clock that samples the pin (0 to 1 clock later for an asynchronous
+ *     edge), on every start,
+ *   - give one PRI, PERIOD + 1 valid beats, or the train until TRIG_EN_BIT
+ *     is cleared (TRIG_TRAIN_BIT).
+ * Edges of the selected kind while running or in holdoff are missed, the
+ * others are not seen. Both are checked against the perf counters. A
+ * second dds_trigger (SYNC = 0) on trigger_sync_o, as channels 1.. in the
+ * block design, must enable on the same clocks.
+ *
+ * Headless, see tb/Makefile:
+ *   make dds_trigger_tb           (Verilator)
+ *   make SIM=icarus dds_trigger_tb
+ */
+module dds_trigger_tb();
+    localparam CLK = 8;
+    /* Sampling clock to the clock the modulator sees ENABLE_BIT */
+    localparam TRIGGER_LATENCY = CDC_SYNC_STAGES + 1;
+    /* dds_modulator output register */
+    localparam OUTPUT_LATENCY = 1;
+
+    /* Pulsed tone, pulse and period in clocks */
+    localparam TAU = 40;
+    localparam PERIOD = 100;
+    localparam HOLDOFF = 2 * PERIOD;
+    localparam logic [PINC_BITS-1:0] TONE_PINC = 30'd53687091;     // 0.05 fs
+
+    /**
+     * Clock & Reset
+     */
+
+    logic clk_i = 0;
+    logic resetn_i = 0;
+    always #(CLK/2) clk_i = !clk_i;
+    initial #20 resetn_i = 1;
+
+    /**
+     * DUT signals
+     */
+    logic trigger_i = 0;
+    logic trigger_sync;
+    logic [31:0] config_reg_0 = 0;
+    logic [31:0] config_reg_1 = 0;
+    logic [31:0] config_reg_2 = 0;
+    logic [31:0] config_reg_3 = 0;
+    logic [31:0] config_reg_4 = 0;
+    logic [31:0] config_reg_5 = 0;
+    logic [31:0] trig_reg_0;
+    logic [31:0] follower_reg_0;
+    logic trig_received;
+    logic trig_missed;
+    logic period_end;
+    logic commit_done;
+    logic dds_en;
+    logic [71:0] mod_tdata;
+    logic mod_tvalid;
+    logic mod_tlast;
+    logic mod_tuser;
+    logic [PERF_COUNTERS*32-1:0] perf;
+
+    /**
+     * Test functions
+     */
+
+    function automatic int unsigned perf_count(input int c);
+        return perf[c*32 +: 32];
+    endfunction
+
+    function automatic logic [31:0] trig_config(input logic [1:0] trig_edge, input bit train,
+                                               input int unsigned holdoff);
+        return (1 << ARM_BIT) | (1 << TRIG_EN_BIT) | (trig_edge << TRIG_EDGE_BIT) |
+               (train << TRIG_TRAIN_BIT) | (holdoff << TRIG_HOLDOFF_BIT);
+    endfunction
+
+    // Drives the pin to level on a falling edge and watches clocks
+    // rising edges from the one that samples it: first valid beat
+    // (0: none) and valid beats
+    task automatic drive(input logic level, input int clocks, output int first, output int beats);
+        trigger_i = level;
+        first = 0;
+        beats = 0;
+        for (int c = 1; c <= clocks; c++) begin
+            @(negedge clk_i);
+            if (mod_tvalid) begin
+                if (first == 0)
+                    first = c;
+                beats++;
+            end
+        end
+    endtask
+
+    // Edge that starts one PRI, then back to armed
+    task automatic pri_start(input string name, input logic level);
+        int first, beats;
+        drive(level, TRIGGER_LATENCY + OUTPUT_LATENCY + PERIOD + 10, first, beats);
+        scoreboard.check_count({name, ": latency"}, TRIGGER_LATENCY + OUTPUT_LATENCY, first);
+        scoreboard.check_count({name, ": PRI beats"}, PERIOD + 1, beats);
+        scoreboard.check_count({name, ": dds_en armed"}, 1, dds_en);
+    endtask
+
+    // Edge that must not start anything
+    task automatic no_start(input string name, input logic level, input int clocks);
+        int first, beats;
+        drive(level, clocks, first, beats);
+        scoreboard.check_count({name, ": beats"}, 0, beats);
+    endtask
+
+    /**
+     * Test
+     */
+    int unsigned received, missed;
+    int first, beats;
+    realtime t_trigger;
+
+    initial begin
+        @(posedge resetn_i);
+        @(negedge clk_i);
+
+        // Pulsed tone, latched while disabled
+        config_reg_1[STATE_BITS-1:0] = PULS_NO_MOD_TB;
+        config_reg_2 = (TAU << 16) | PERIOD;
+        config_reg_3[PINC_BITS-1:0] = TONE_PINC;
+        config_reg_0 = trig_config(TRIG_EDGE_RISING, 0, 0);
+        repeat (10)
+            @(negedge clk_i);
+
+        // One PRI per rising edge, falling edges are not seen
+        for (int k = 0; k < 3; k++) begin
+            pri_start("rising", 1);
+            no_start("rising, falling edge", 0, 10);
+        end
+        scoreboard.check_count("rising: triggers", 3, perf_count(PERF_TRIGGERS));
+        scoreboard.check_count("rising: missed", 0, perf_count(PERF_TRIGGERS_MISSED));
+
+        // Edge in the PRI started by the previous one
+        received = perf_count(PERF_TRIGGERS);
+        missed = perf_count(PERF_TRIGGERS_MISSED);
+        drive(1, PERIOD / 2, first, beats);
+        scoreboard.check_count("running: latency", TRIGGER_LATENCY + OUTPUT_LATENCY, first);
+        drive(0, 4, first, beats);
+        drive(1, PERIOD, first, beats);
+        scoreboard.check_count("running: missed", missed + 1, perf_count(PERF_TRIGGERS_MISSED));
+        scoreboard.check_count("running: triggers", received + 2, perf_count(PERF_TRIGGERS));
+        no_start("running, after the PRI", 0, PERIOD);
+
+        // Holdoff from the accepted edge
+        config_reg_0 = trig_config(TRIG_EDGE_RISING, 0, HOLDOFF);
+        @(negedge clk_i);
+        missed = perf_count(PERF_TRIGGERS_MISSED);
+        pri_start("holdoff", 1);
+        drive(0, 4, first, beats);
+        no_start("holdoff, in holdoff", 1, 10);
+        scoreboard.check_count("holdoff: missed", missed + 1, perf_count(PERF_TRIGGERS_MISSED));
+        no_start("holdoff, falling", 0, HOLDOFF - PERIOD);
+        pri_start("holdoff, after holdoff", 1);
+        drive(0, 4, first, beats);
+
+        // Falling edges
+        config_reg_0 = trig_config(TRIG_EDGE_FALLING, 0, 0);
+        @(negedge clk_i);
+        received = perf_count(PERF_TRIGGERS);
+        no_start("falling, rising edge", 1, 10);
+        pri_start("falling", 0);
+        scoreboard.check_count("falling: triggers", received + 1, perf_count(PERF_TRIGGERS));
+
+        // Both edges
+        config_reg_0 = trig_config(TRIG_EDGE_BOTH, 0, 0);
+        @(negedge clk_i);
+        pri_start("both, rising", 1);
+        pri_start("both, falling", 0);
+
+        // Train: runs until TRIG_EN_BIT is cleared, edges while running are missed
+        config_reg_0 = trig_config(TRIG_EDGE_RISING, 1, 0);
+        @(negedge clk_i);
+        missed = perf_count(PERF_TRIGGERS_MISSED);
+        drive(1, 4 * PERIOD, first, beats);
+        scoreboard.check_count("train: latency", TRIGGER_LATENCY + OUTPUT_LATENCY, first);
+        scoreboard.check_count("train: beats", 4 * PERIOD - first + 1, beats);
+        drive(0, 4, first, beats);
+        drive(1, PERIOD, first, beats);
+        scoreboard.check_count("train: beats while running", PERIOD, beats);
+        scoreboard.check_count("train: missed", missed + 1, perf_count(PERF_TRIGGERS_MISSED));
+        config_reg_0 = 1 << ARM_BIT;
+        repeat (OUTPUT_LATENCY + 1)
+            @(negedge clk_i);
+        scoreboard.check_count("train: stopped", 0, mod_tvalid);
+
+        // Not in triggered mode: edges are not looked at
+        received = perf_count(PERF_TRIGGERS);
+        no_start("disabled, falling", 0, 10);
+        no_start("disabled, rising", 1, 10);
+        scoreboard.check_count("disabled: triggers", received, perf_count(PERF_TRIGGERS));
+        drive(0, 4, first, beats);
+
+        // Asynchronous edges: first beat 0 to 1 clock after the synchronous case
+        config_reg_0 = trig_config(TRIG_EDGE_RISING, 0, 0);
+        for (int k = 0; k < 8; k++) begin
+            @(posedge clk_i);
+            #(0.5 + (k % CLK));
+            trigger_i = 1;
+            t_trigger = $realtime;
+            @(posedge mod_tvalid);
+            if ($realtime - t_trigger <= (TRIGGER_LATENCY + OUTPUT_LATENCY - 1) * CLK ||
+                $realtime - t_trigger > (TRIGGER_LATENCY + OUTPUT_LATENCY) * CLK)
+                scoreboard.mismatch($sformatf("async %0d: latency (ns)", k),
+                                    (TRIGGER_LATENCY + OUTPUT_LATENCY) * CLK, $realtime - t_trigger);
+            repeat (PERIOD + 10)
+                @(negedge clk_i);
+            trigger_i = 0;
+            repeat (4)
+                @(negedge clk_i);
+        end
+
+        config_reg_0 = 0;
+        repeat (10)
+            @(negedge clk_i);
+
+        $display("dds_trigger_tb: %0d triggers, %0d missed, latency %0d clocks to the modulator",
+                 perf_count(PERF_TRIGGERS), perf_count(PERF_TRIGGERS_MISSED), TRIGGER_LATENCY);
+        scoreboard.report("dds_trigger_tb", 0);
+        $finish;
+    end
+
+    // Channels on trigger_sync_o enable on the same clock
+    always @(negedge clk_i)
+        if (resetn_i && follower_reg_0[ENABLE_BIT] !== trig_reg_0[ENABLE_BIT])
+            scoreboard.mismatch("follower enable", trig_reg_0[ENABLE_BIT], follower_reg_0[ENABLE_BIT]);
+
+    /**
+     * DUT: trigger and modulator, a second trigger as channel 1
+     */
+
+    dds_trigger #(.SYNC(1)) trigger(
+        .clk_i,
+        .resetn_i,
+        .trigger_i,
+        .trigger_sync_o(trigger_sync),
+        .config_reg_0_i(config_reg_0),
+        .config_reg_0_o(trig_reg_0),
+        .period_end_i(period_end),
+        .trig_received_o(trig_received),
+        .trig_missed_o(trig_missed)
+    );
+
+    dds_trigger #(.SYNC(0)) follower(
+        .clk_i,
+        .resetn_i,
+        .trigger_i(trigger_sync),
+        .trigger_sync_o(),
+        .config_reg_0_i(config_reg_0),
+        .config_reg_0_o(follower_reg_0),
+        .period_end_i(period_end),
+        .trig_received_o(),
+        .trig_missed_o()
+    );
+
+    dds_modulator modulator(
+        .clk_i,
+        .resetn_i,
+        .wr_clk_i(clk_i),
+        .dds_en_o(dds_en),
+        .m_axis_modulation_tdata(mod_tdata),
+        .m_axis_modulation_tvalid(mod_tvalid),
+        .m_axis_modulation_tlast(mod_tlast),
+        .m_axis_modulation_tuser(mod_tuser),
+        .m_axis_modulation_tready(1'b1),
+        .config_reg_0(trig_reg_0),
+        .config_reg_1,
+        .config_reg_2,
+        .config_reg_3,
+        .config_reg_4,
+        .config_reg_5,
+        .commit_done_o(commit_done),
+        .capture_trig_i(1'b0),
+        .ts_now_o(),
+        .ts_pulse_o(),
+        .ts_commit_o(),
+        .ts_capture_o(),
+        .perf_o(perf),
+        .trig_received_i(trig_received),
+        .trig_missed_i(trig_missed),
+        .period_end_o(period_end),
+        .code_wr_en_i(1'b0),
+        .code_wr_addr_i('0),
+        .code_wr_data_i('0),
+        .pinc_wr_en_i(1'b0),
+        .pinc_wr_addr_i('0),
+        .pinc_wr_data_i('0),
+        .hop_wr_en_i(1'b0),
+        .hop_wr_addr_i('0),
+        .hop_wr_data_i('0)
+    );
+
+    /**
+    *   Scoreboard, reference model of the modulator ports
+    */
+
+    dds_modulator_scoreboard scoreboard(
+        .clk_i,
+        .resetn_i,
+        .wr_clk_i(clk_i),
+        .config_reg_0(trig_reg_0),
+        .config_reg_1,
+        .config_reg_2,
+        .config_reg_3,
+        .config_reg_4,
+        .config_reg_5,
+        .capture_trig_i(1'b0),
+        .m_axis_modulation_tready(1'b1),
+        .code_wr_en_i(1'b0),
+        .code_wr_addr_i('0),
+        .code_wr_data_i('0),
+        .pinc_wr_en_i(1'b0),
+        .pinc_wr_addr_i('0),
+        .pinc_wr_data_i('0),
+        .hop_wr_en_i(1'b0),
+        .hop_wr_addr_i('0),
+        .hop_wr_data_i('0),
+        .dds_en_o(dds_en),
+        .m_axis_modulation_tdata(mod_tdata),
+        .m_axis_modulation_tvalid(mod_tvalid),
+        .m_axis_modulation_tlast(mod_tlast),
+        .m_axis_modulation_tuser(mod_tuser),
+        .commit_done_o(commit_done)
+    );
+
+endmodule
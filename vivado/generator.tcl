@@ -30,6 +30,9 @@
 #    "/mnt/Archivos/cese/8MyS/generator/hdl/dds_modulator_package.sv"
 #    "/mnt/Archivos/cese/8MyS/generator/hdl/axi_lite_mm2dds_mod_registers.sv"
 #    "/mnt/Archivos/cese/8MyS/generator/hdl/dds_modulator.sv"
+#    "/mnt/Archivos/cese/8MyS/generator/hdl/dds_sequencer.sv"
+#    "/mnt/Archivos/cese/8MyS/generator/hdl/dds_capture_combiner.sv"
+#    "/mnt/Archivos/cese/8MyS/generator/hdl/dds_table_loader.sv"
 #    "/mnt/Archivos/cese/8MyS/generator/hdl/mm2s_dds_modulator.v"
 #    "/mnt/Archivos/cese/8MyS/generator/bd/generator/generator.bd"
 #    "/mnt/Archivos/cese/8MyS/generator/bd/generator/hdl/generator_wrapper.v"
@@ -152,6 +155,12 @@ set files [list \
  [file normalize "${origin_dir}/../hdl/dds_modulator_package.sv"] \
  [file normalize "${origin_dir}/../hdl/axi_lite_mm2dds_mod_registers.sv"] \
  [file normalize "${origin_dir}/../hdl/dds_modulator.sv"] \
+ [file normalize "${origin_dir}/../hdl/dds_sequencer.sv"] \
+ [file normalize "${origin_dir}/../hdl/dds_config_cdc.sv"] \
+ [file normalize "${origin_dir}/../hdl/dds_trigger.sv"] \
+ [file normalize "${origin_dir}/../hdl/dds_polyphase.sv"] \
+ [file normalize "${origin_dir}/../hdl/dds_capture_combiner.sv"] \
+ [file normalize "${origin_dir}/../hdl/dds_table_loader.sv"] \
  [file normalize "${origin_dir}/../hdl/mm2s_dds_modulator.v"] \
  [file normalize "${origin_dir}/../bd/generator/generator.bd"] \
  [file normalize "${origin_dir}/../bd/generator/hdl/generator_wrapper.v"] \
@@ -174,6 +183,36 @@ set file [file normalize $file]
 set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
 set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
 
+set file "$origin_dir/../hdl/dds_sequencer.sv"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
+
+set file "$origin_dir/../hdl/dds_config_cdc.sv"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
+
+set file "$origin_dir/../hdl/dds_trigger.sv"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
+
+set file "$origin_dir/../hdl/dds_polyphase.sv"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
+
+set file "$origin_dir/../hdl/dds_capture_combiner.sv"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
+
+set file "$origin_dir/../hdl/dds_table_loader.sv"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
+
 set file "$origin_dir/../bd/generator/generator.bd"
 set file [file normalize $file]
 set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
@@ -204,6 +243,14 @@ set file [file normalize $file]
 set file_obj [get_files -of_objects [get_filesets constrs_1] [list "*$file"]]
 set_property -name "file_type" -value "XDC" -objects $file_obj
 
+# Clock domain crossing constraints
+set file "[file normalize "$origin_dir/../xdc/generator_clocks.xdc"]"
+set file_added [add_files -norecurse -fileset $obj [list $file]]
+set file "$origin_dir/../xdc/generator_clocks.xdc"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets constrs_1] [list "*$file"]]
+set_property -name "file_type" -value "XDC" -objects $file_obj
+
 # Set 'constrs_1' fileset properties
 set obj [get_filesets constrs_1]
 set_property -name "target_constrs_file" -value "[file normalize "$origin_dir/../xdc/Arty-Z7-10-Master.xdc"]" -objects $obj
@@ -276,7 +323,7 @@ set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
 
 # Set 'axi_lite_registers_tb' fileset properties
 set obj [get_filesets axi_lite_registers_tb]
-set_property -name "top" -value "axi_lite_tb" -objects $obj
+set_property -name "top" -value "axi_lite_mm2dds_mod_registers_tb" -objects $obj
 set_property -name "top_auto_set" -value "0" -objects $obj
 set_property -name "top_lib" -value "xil_defaultlib" -objects $obj
 
@@ -309,6 +356,40 @@ set_property -name "top" -value "axi_lite_mm2dds_mod_tb" -objects $obj
 set_property -name "top_auto_set" -value "0" -objects $obj
 set_property -name "top_lib" -value "xil_defaultlib" -objects $obj
 
+# Create 'dds_polyphase_tb' fileset (if not found)
+if {[string equal [get_filesets -quiet dds_polyphase_tb] ""]} {
+  create_fileset -simset dds_polyphase_tb
+}
+
+# Set 'dds_polyphase_tb' fileset object
+set obj [get_filesets dds_polyphase_tb]
+set files [list \
+ [file normalize "${origin_dir}/../hdl/dds_polyphase.sv"] \
+ [file normalize "${origin_dir}/../tb/dds_polyphase_tb.sv"] \
+]
+add_files -norecurse -fileset $obj $files
+
+# Set 'dds_polyphase_tb' fileset file properties for remote files
+set file "$origin_dir/../hdl/dds_polyphase.sv"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets dds_polyphase_tb] [list "*$file"]]
+set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
+
+set file "$origin_dir/../tb/dds_polyphase_tb.sv"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets dds_polyphase_tb] [list "*$file"]]
+set_property -name "file_type" -value "SystemVerilog" -objects $file_obj
+
+
+# Set 'dds_polyphase_tb' fileset file properties for local files
+# None
+
+# Set 'dds_polyphase_tb' fileset properties
+set obj [get_filesets dds_polyphase_tb]
+set_property -name "top" -value "dds_polyphase_tb" -objects $obj
+set_property -name "top_auto_set" -value "0" -objects $obj
+set_property -name "top_lib" -value "xil_defaultlib" -objects $obj
+
 # Set 'utils_1' fileset object
 set obj [get_filesets utils_1]
 # Empty (no sources present)
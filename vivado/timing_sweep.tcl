@@ -0,0 +1,97 @@
+#*****************************************************************************************
+# timing_sweep.tcl: Timing characterisation of one generator channel
+#
+# Runs out of context synthesis and implementation of mm2s_dds_modulator
+# (registers, table loader, sequencer, modulator and polyphase phase
+# generator) for a list of DDS clock periods and reports worst slack for
+# each one, to find the fastest clock the modulator datapath closes at.
+# S_AXI_CLK stays at FCLK0 (8 ns), the clock domain crossing is excluded
+# from timing. --lanes sets DDS_LANES (samples per DDS clock).
+#
+# Usage (from this folder):
+#   vivado -mode batch -source timing_sweep.tcl
+#   vivado -mode batch -source timing_sweep.tcl -tclargs --periods "8.0 5.0 4.0" --out sweep.csv
+#   vivado -mode batch -source timing_sweep.tcl -tclargs --lanes 4
+#
+# Results: one CSV row per period (period_ns, freq_mhz, wns_ns, tns_ns,
+# whs_ns, fmax_mhz) and a timing report per period in timing_sweep/.
+#*****************************************************************************************
+
+set origin_dir [file dirname [file normalize [info script]]]
+set part "xc7z010clg400-1"
+set top "mm2s_dds_modulator"
+set periods {8.000 6.000 5.000 4.500 4.000 3.800 3.600}
+set axi_period 8.000
+set lanes 1
+set out_dir "$origin_dir/timing_sweep"
+set out_csv "$out_dir/timing_sweep.csv"
+
+if { $::argc > 0 } {
+  for {set i 0} {$i < $::argc} {incr i} {
+    set option [string trim [lindex $::argv $i]]
+    switch -regexp -- $option {
+      "--periods" { incr i; set periods [lindex $::argv $i] }
+      "--part"    { incr i; set part [lindex $::argv $i] }
+      "--lanes"   { incr i; set lanes [lindex $::argv $i] }
+      "--out"     { incr i; set out_csv [file normalize [lindex $::argv $i]] }
+      default {
+        puts "ERROR: Unknown option '$option'"
+        return 1
+      }
+    }
+  }
+}
+
+set sources [list \
+  "$origin_dir/../hdl/dds_modulator_package.sv" \
+  "$origin_dir/../hdl/axi_lite_mm2dds_mod_registers.sv" \
+  "$origin_dir/../hdl/dds_modulator.sv" \
+  "$origin_dir/../hdl/dds_config_cdc.sv" \
+  "$origin_dir/../hdl/dds_trigger.sv" \
+  "$origin_dir/../hdl/dds_polyphase.sv" \
+  "$origin_dir/../hdl/dds_sequencer.sv" \
+  "$origin_dir/../hdl/dds_table_loader.sv" \
+  "$origin_dir/../hdl/mm2s_dds_modulator.v" \
+]
+
+file mkdir $out_dir
+set csv [open $out_csv w]
+puts $csv "period_ns,freq_mhz,wns_ns,tns_ns,whs_ns,fmax_mhz"
+
+foreach period $periods {
+  close_project -quiet
+  create_project -in_memory -part $part
+
+  read_verilog -sv [lrange $sources 0 end-1]
+  read_verilog [lindex $sources end]
+
+  synth_design -top $top -part $part -mode out_of_context -flatten_hierarchy rebuilt -generic DDS_LANES=$lanes
+  create_clock -name S_AXI_CLK -period $axi_period [get_ports S_AXI_CLK]
+  create_clock -name DDS_CLK -period $period [get_ports DDS_CLK]
+  set_clock_groups -asynchronous -group [get_clocks S_AXI_CLK] -group [get_clocks DDS_CLK]
+
+  opt_design
+  place_design
+  phys_opt_design
+  route_design
+
+  set wns [get_property SLACK [get_timing_paths -delay_type max -max_paths 1 -group DDS_CLK]]
+  set whs [get_property SLACK [get_timing_paths -delay_type min -max_paths 1 -group DDS_CLK]]
+  set tns 0.0
+  foreach path [get_timing_paths -delay_type max -max_paths 1000 -slack_lesser_than 0 -group DDS_CLK] {
+    set tns [expr {$tns + [get_property SLACK $path]}]
+  }
+  # Period the worst path would close at
+  set fmax [format "%.1f" [expr {1000.0 / ($period - $wns)}]]
+
+  report_timing_summary -max_paths 10 -file "$out_dir/timing_${period}ns.rpt"
+  report_utilization -file "$out_dir/utilization_${period}ns.rpt"
+
+  puts $csv "$period,[format "%.1f" [expr {1000.0 / $period}]],$wns,[format "%.3f" $tns],$whs,$fmax"
+  flush $csv
+  puts "INFO: period $period ns: WNS $wns ns, fmax $fmax MHz"
+}
+
+close $csv
+close_project -quiet
+puts "INFO: Results written to $out_csv"